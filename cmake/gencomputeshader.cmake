@@ -1,6 +1,14 @@
+#
+# Generates the c++ bindings for the given compute shaders of the target. If the CPU option is given, the
+# bindings also contain host implementations of the kernels for the cpu backend of the compute module.
+#
 function(generate_compute_shaders TARGET)
-	set(files ${ARGV})
-	list(REMOVE_AT files 0)
+	cmake_parse_arguments(_gen "CPU" "" "" ${ARGN})
+	set(files ${_gen_UNPARSED_ARGUMENTS})
+	set(_cpu)
+	if (_gen_CPU)
+		set(_cpu "--cpu")
+	endif()
 	set(GEN_DIR ${GENERATE_DIR}/compute-shaders/${TARGET}/)
 	set(_template ${ROOT_DIR}/src/tools/computeshadertool/ComputeShaderTemplate.h.in)
 	file(MAKE_DIRECTORY ${GEN_DIR})
@@ -42,7 +50,7 @@ function(generate_compute_shaders TARGET)
 				OUTPUT ${_shader}.in
 				IMPLICIT_DEPENDS C ${_shaders}
 				COMMENT "Validate ${_file} and generate ${_shaderfile}"
-				COMMAND ${CMAKE_COMMAND} -E env "APP_HOMEPATH=${CMAKE_CURRENT_BINARY_DIR}/" "LSAN_OPTIONS=exitcode=0" $<TARGET_FILE:computeshadertool> --shader ${_dir}/${_file} -I ${_dir} ${SHADERTOOL_INCLUDE_DIRS_PARAM} --postfix .in --shadertemplate ${_template} --sourcedir ${GEN_DIR}
+				COMMAND ${CMAKE_COMMAND} -E env "APP_HOMEPATH=${CMAKE_CURRENT_BINARY_DIR}/" "LSAN_OPTIONS=exitcode=0" $<TARGET_FILE:computeshadertool> --shader ${_dir}/${_file} -I ${_dir} ${SHADERTOOL_INCLUDE_DIRS_PARAM} --postfix .in --shadertemplate ${_template} --sourcedir ${GEN_DIR} ${_cpu}
 				DEPENDS computeshadertool ${_shaders} ${_template}
 				VERBATIM
 			)
@@ -20,6 +20,7 @@
 #include "network/EntityRemoveHandler.h"
 #include "network/EntitySpawnHandler.h"
 #include "network/EntityUpdateHandler.h"
+#include "network/EntitySnapshotHandler.h"
 #include "network/UserSpawnHandler.h"
 #include "network/UserInfoHandler.h"
 #include "network/VarUpdateHandler.h"
@@ -97,6 +98,7 @@ void Client::sendMovement() {
 
 void Client::onEvent(const network::DisconnectEvent& event) {
 	_network->destroy();
+	_snapshotHistory.reset();
 	rootWindow("main");
 	pushWindow("disconnect_info");
 }
@@ -160,6 +162,7 @@ app::AppState Client::onInit() {
 	r->registerHandler(network::ServerMsgType::EntitySpawn, std::make_shared<EntitySpawnHandler>());
 	r->registerHandler(network::ServerMsgType::EntityRemove, std::make_shared<EntityRemoveHandler>());
 	r->registerHandler(network::ServerMsgType::EntityUpdate, std::make_shared<EntityUpdateHandler>());
+	r->registerHandler(network::ServerMsgType::EntitySnapshot, std::make_shared<EntitySnapshotHandler>());
 	r->registerHandler(network::ServerMsgType::UserSpawn, std::make_shared<UserSpawnHandler>());
 	r->registerHandler(network::ServerMsgType::AuthFailed, std::make_shared<AuthFailedHandler>());
 	r->registerHandler(network::ServerMsgType::StartCooldown, std::make_shared<StartCooldownHandler>());
@@ -402,6 +405,24 @@ void Client::entityRemove(frontend::ClientEntityId id) {
 	_worldRenderer.entityMgr().removeEntity(id);
 }
 
+void Client::entitySnapshot(const network::EntitySnapshot* snapshot) {
+	const bool applied = _snapshotHistory.apply(snapshot, [this] (int64_t id, const shared::QuantizedEntityState& state) {
+		const frontend::ClientEntityPtr& entity = getEntity(id);
+		if (!entity) {
+			return;
+		}
+		entity->setPosition(state.pos());
+		entity->setOrientation(state.orientation());
+		entity->setAnimation((network::Animation)state.animation, true);
+	});
+	if (!applied) {
+		Log::debug("Could not apply snapshot %u with base %u", snapshot->sequence(), snapshot->base());
+		return;
+	}
+	_messageSender->sendClientMessage(_snapshotAckFbb, network::ClientMsgType::EntitySnapshotAck,
+			network::CreateEntitySnapshotAck(_snapshotAckFbb, snapshot->sequence()).Union(), 0u);
+}
+
 void Client::spawn(frontend::ClientEntityId id, const char *name, const glm::vec3& pos, float orientation) {
 	Log::info("User %li (%s) logged in at pos %f:%f:%f with orientation: %f", id, name, pos.x, pos.y, pos.z, orientation);
 	_camera.setTarget(pos);
@@ -460,7 +481,8 @@ bool Client::connect(uint16_t port, const core::String& hostname) {
 		Log::error("No hostname given");
 		return false;
 	}
-	ENetPeer* peer = _network->connect(port, hostname);
+	// the entity snapshots are sent on their own channel
+	ENetPeer* peer = _network->connect(port, hostname, shared::SnapshotChannel + 1);
 	if (peer == nullptr) {
 		Log::error("Failed to connect to server %s:%i", hostname.c_str(), port);
 		return false;
@@ -26,6 +26,7 @@
 #include "stock/StockDataProvider.h"
 #include "voxel/ClientPager.h"
 #include "cooldown/CooldownHandler.h"
+#include "shared/EntitySnapshot.h"
 
 class Client: public ui::nuklear::LUAUIApp, public core::IEventBusHandler<network::NewConnectionEvent>, public core::IEventBusHandler<
 		network::DisconnectEvent>, public core::IEventBusHandler<voxelworld::WorldCreatedEvent> {
@@ -41,6 +42,8 @@ protected:
 	flatbuffers::FlatBufferBuilder _moveFbb;
 	frontend::PlayerMovement _movement;
 	flatbuffers::FlatBufferBuilder _actionFbb;
+	flatbuffers::FlatBufferBuilder _snapshotAckFbb;
+	shared::EntitySnapshotHistory _snapshotHistory;
 	frontend::PlayerAction _action;
 	client::CooldownHandler _cooldownHandler;
 	network::MoveDirection _lastMoveMask = network::MoveDirection::NONE;
@@ -115,6 +118,10 @@ public:
 
 	void entitySpawn(frontend::ClientEntityId id, network::EntityType type, float orientation, const glm::vec3& pos, animation::Animation animation);
 	void entityRemove(frontend::ClientEntityId id);
+	/**
+	 * @brief Applies the entity states of the snapshot and acknowledges it to the server
+	 */
+	void entitySnapshot(const network::EntitySnapshot* snapshot);
 	frontend::ClientEntityPtr getEntity(frontend::ClientEntityId id) const;
 };
 
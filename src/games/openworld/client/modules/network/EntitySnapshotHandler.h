@@ -0,0 +1,14 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "IClientProtocolHandler.h"
+
+/**
+ * Updates all @c frontend::ClientEntity instances that are part of the delta encoded snapshot
+ */
+CLIENTPROTOHANDLERIMPL(EntitySnapshot) {
+	client->entitySnapshot(message);
+}
@@ -9,6 +9,9 @@
 
 /**
  * Updates @c frontend::ClientEntity instances identified by the given @c frontend::ClientEntityId
+ *
+ * @note The other entities are updated by the @c EntitySnapshot messages. The server only sends this message
+ * with the authoritative position of the player's own entity - which is not part of the snapshots.
  */
 CLIENTPROTOHANDLERIMPL(EntityUpdate) {
 	const frontend::ClientEntityId id = message->id();
@@ -56,6 +56,7 @@ app::AppState Server::onConstruct() {
 	core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
 	core::Var::get(cfg::DatabaseMinConnections, "2");
 	core::Var::get(cfg::DatabaseMaxConnections, "100");
+	core::Var::get(cfg::DatabaseWriters, "4");
 
 	const core::VarPtr& chunkUrl = core::Var::get(cfg::ServerChunkBaseUrl, "", core::CV_REPLICATE);
 	if (chunkUrl->strVal().empty()) {
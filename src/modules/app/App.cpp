@@ -31,6 +31,7 @@ namespace app {
 
 static void catch_function(int signo) {
 	core_stacktrace();
+	Log::flush();
 	abort();
 }
 
@@ -74,12 +75,13 @@ App::App(const metric::MetricPtr& metric, const io::FilesystemPtr& filesystem, c
 
 App::~App() {
 	core_trace_set(nullptr);
-	if (_metricSender) {
-		_metricSender->shutdown();
-	}
+	// the metrics are flushed on shutdown - shut them down before the sender
 	if (_metric) {
 		_metric->shutdown();
 	}
+	if (_metricSender) {
+		_metricSender->shutdown();
+	}
 	Log::shutdown();
 	_threadPool = core::ThreadPoolPtr();
 }
@@ -244,6 +246,9 @@ AppState App::onConstruct() {
 		logVar->setVal(logLevelVal);
 	}
 	core::Var::get(cfg::CoreSysLog, _syslog ? "true" : "false", "Log to the system log", core::Var::boolValidator);
+	core::Var::get(cfg::CoreLogAsync, "false", "Write the log messages in a background thread", core::Var::boolValidator);
+	core::Var::get(cfg::CoreLogAsyncBlock, "false", "Wait for the log thread instead of dropping messages if its queue is full", core::Var::boolValidator);
+	core::Var::get(cfg::CoreLogRateLimit, "0", "The max amount of log messages per second for each call site - 0 disables the limit");
 
 	Log::init();
 
@@ -286,6 +291,7 @@ AppState App::onConstruct() {
 	}
 
 	core::Var::get(cfg::MetricFlavor, "telegraf");
+	core::Var::get(cfg::MetricFlushMillis, "1000");
 	const core::String& host = core::Var::get(cfg::MetricHost, "127.0.0.1")->strVal();
 	const int port = core::Var::get(cfg::MetricPort, "8125")->intVal();
 	_metricSender = std::make_shared<metric::UDPMetricSender>(host, port);
@@ -391,6 +397,7 @@ AppState App::onInit() {
 	Log::init();
 	_logLevelVar = core::Var::getSafe(cfg::CoreLogLevel);
 	_syslogVar = core::Var::getSafe(cfg::CoreSysLog);
+	_logAsyncVar = core::Var::getSafe(cfg::CoreLogAsync);
 
 	core::Var::visit([&] (const core::VarPtr& var) {
 		var->markClean();
@@ -456,10 +463,11 @@ void App::onAfterInit() {
 	}
 
 	// we might have changed the loglevel from the commandline
-	if (_logLevelVar->isDirty() || _syslogVar->isDirty()) {
+	if (_logLevelVar->isDirty() || _syslogVar->isDirty() || _logAsyncVar->isDirty()) {
 		Log::init();
 		_logLevelVar->markClean();
 		_syslogVar->markClean();
+		_logAsyncVar->markClean();
 	}
 }
 
@@ -562,10 +570,11 @@ void App::onBeforeRunning() {
 }
 
 AppState App::onRunning() {
-	if (_logLevelVar->isDirty() || _syslogVar->isDirty()) {
+	if (_logLevelVar->isDirty() || _syslogVar->isDirty() || _logAsyncVar->isDirty()) {
 		Log::init();
 		_logLevelVar->markClean();
 		_syslogVar->markClean();
+		_logAsyncVar->markClean();
 	}
 
 	command::Command::update(_deltaFrameSeconds);
@@ -575,6 +584,7 @@ AppState App::onRunning() {
 		Log::debug("Remaining events in queue: %i", remaining);
 	}
 	_filesystem->update();
+	_metric->update();
 
 	if (!_failedToSaveConfiguration && core::Var::needsSaving()) {
 		if (!saveConfiguration()) {
@@ -722,12 +732,13 @@ AppState App::onCleanup() {
 
 	core_trace_shutdown();
 
-	if (_metricSender) {
-		_metricSender->shutdown();
-	}
+	// the metrics are flushed on shutdown - shut them down before the sender
 	if (_metric) {
 		_metric->shutdown();
 	}
+	if (_metricSender) {
+		_metricSender->shutdown();
+	}
 
 	SDL_Quit();
 
@@ -0,0 +1,74 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "backend/entity/ai/AI.h"
+#include "backend/entity/ai/ICharacter.h"
+#include "backend/entity/ai/group/GroupMgr.h"
+#include <vector>
+
+namespace {
+
+const int GroupCount = 16;
+const int MembersPerGroup = 32;
+
+backend::GroupMgr* groupMgr = nullptr;
+std::vector<backend::AIPtr> ais;
+
+void setupGroups(bool publish) {
+	groupMgr = new backend::GroupMgr();
+	for (int i = 0; i < GroupCount * MembersPerGroup; ++i) {
+		const backend::AIPtr& ai = std::make_shared<backend::AI>(backend::TreeNodePtr());
+		const backend::ICharacterPtr& chr = core::make_shared<backend::ICharacter>(i + 1);
+		chr->setPosition(glm::vec3((float)i, 0.0f, (float)i));
+		ai->setCharacter(chr);
+		groupMgr->add(i % GroupCount, ai);
+		ais.push_back(ai);
+	}
+	groupMgr->update(0);
+	if (!publish) {
+		// the groups were modified after the last update - the readers have to lock
+		groupMgr->remove(0, ais[0]);
+		groupMgr->add(0, ais[0]);
+	}
+}
+
+void shutdownGroups() {
+	ais.clear();
+	delete groupMgr;
+	groupMgr = nullptr;
+}
+
+void readGroups(benchmark::State& state, bool publish) {
+	if (state.thread_index == 0) {
+		setupGroups(publish);
+	}
+	// the setup of the first thread is done once all threads entered the loop
+	size_t i = (size_t)state.thread_index;
+	for (auto _ : state) {
+		const backend::AIPtr& ai = ais[i % ais.size()];
+		const backend::GroupId groupId = (backend::GroupId)(i % GroupCount);
+		glm::vec3 pos;
+		benchmark::DoNotOptimize(groupMgr->getPosition(groupId, pos));
+		benchmark::DoNotOptimize(groupMgr->isGroupLeader(groupId, ai));
+		benchmark::DoNotOptimize(groupMgr->isInGroup(groupId, ai));
+		++i;
+	}
+	if (state.thread_index == 0) {
+		shutdownGroups();
+	}
+}
+
+}
+
+static void groupReadSnapshot(benchmark::State& state) {
+	readGroups(state, true);
+}
+
+static void groupReadLocked(benchmark::State& state) {
+	readGroups(state, false);
+}
+
+BENCHMARK(groupReadSnapshot)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(groupReadLocked)->ThreadRange(1, 8)->UseRealTime();
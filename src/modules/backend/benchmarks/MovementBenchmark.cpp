@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "backend/entity/ai/AI.h"
+#include "backend/entity/ai/ICharacter.h"
+#include "backend/entity/ai/condition/True.h"
+#include "backend/entity/ai/movement/Wander.h"
+#include "backend/entity/ai/movement/WeightedSteering.h"
+#include "backend/entity/ai/tree/Steer.h"
+#include "backend/entity/ai/zone/Zone.h"
+#include <vector>
+
+class MovementBenchmark: public app::AbstractBenchmark {
+protected:
+	std::vector<backend::AIPtr> _ais;
+
+	std::shared_ptr<backend::Steer> createSteer() const {
+		backend::movement::WeightedSteerings steerings;
+		steerings.push_back(backend::movement::WeightedData(std::make_shared<backend::movement::Wander>("")));
+		const backend::movement::WeightedSteering w(steerings);
+		return std::make_shared<backend::Steer>("wander", "", backend::True::get(), w);
+	}
+
+	void createAIs(int n, const std::shared_ptr<backend::Steer>& steer) {
+		_ais.clear();
+		_ais.reserve(n);
+		for (int i = 0; i < n; ++i) {
+			const backend::AIPtr& ai = std::make_shared<backend::AI>(steer);
+			const backend::ICharacterPtr& chr = core::make_shared<backend::ICharacter>(i + 1);
+			chr->setCurrent(attrib::Type::SPEED, 10.0);
+			chr->setPosition(glm::vec3((float)(i % 100), 0.0f, (float)(i / 100)));
+			ai->setCharacter(chr);
+			_ais.push_back(ai);
+		}
+	}
+};
+
+BENCHMARK_DEFINE_F(MovementBenchmark, wanderDirect) (benchmark::State& state) {
+	const std::shared_ptr<backend::Steer>& steer = createSteer();
+	createAIs((int)state.range(0), steer);
+	// not part of a zone - the steerings are evaluated for each ai on its own
+	for (auto _ : state) {
+		for (const backend::AIPtr& ai : _ais) {
+			steer->doAction(ai, 100);
+		}
+	}
+	_ais.clear();
+}
+
+BENCHMARK_DEFINE_F(MovementBenchmark, wanderBatched) (benchmark::State& state) {
+	const std::shared_ptr<backend::Steer>& steer = createSteer();
+	createAIs((int)state.range(0), steer);
+	backend::Zone zone("benchmark");
+	zone.addAIs(_ais);
+	zone.update(0);
+	backend::movement::MovementSystem& movementSystem = zone.getMovementSystem();
+	for (auto _ : state) {
+		for (const backend::AIPtr& ai : _ais) {
+			steer->doAction(ai, 100);
+		}
+		movementSystem.update();
+	}
+	for (const backend::AIPtr& ai : _ais) {
+		zone.removeAI(ai->getId());
+	}
+	zone.update(0);
+	_ais.clear();
+}
+
+BENCHMARK_REGISTER_F(MovementBenchmark, wanderDirect)->Arg(1000)->Arg(10000);
+BENCHMARK_REGISTER_F(MovementBenchmark, wanderBatched)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -202,11 +202,7 @@ void Entity::updateVisible(const EntitySet& set) {
 	_visible = core::setUnion(stillVisible, add);
 	_visibleLock.unlockWrite();
 
-	_visibleLock.lockRead();
-	for (const auto& e : _visible) {
-		sendEntityUpdate(e);
-	}
-	_visibleLock.unlockRead();
+	sendEntitySnapshot();
 
 	if (!add.empty()) {
 		visibleAdd(add);
@@ -216,15 +212,26 @@ void Entity::updateVisible(const EntitySet& set) {
 	}
 }
 
-void Entity::sendEntityUpdate(const EntityPtr& entity) const {
-	if (_peer == nullptr) {
+void Entity::sendEntitySnapshot() {
+	_snapshotBytes = 0u;
+	ENetPeer* p = peer();
+	if (p == nullptr) {
+		return;
+	}
+	core_trace_scoped(SendEntitySnapshot);
+	_entitySnapshotFBB.Clear();
+	flatbuffers::Offset<network::EntitySnapshot> snapshot;
+	{
+		core::ScopedReadLock lock(_visibleLock);
+		snapshot = _snapshotBuilder.build(_entitySnapshotFBB, _visible);
+	}
+	if (snapshot.IsNull()) {
 		return;
 	}
-	const glm::vec3& _pos = entity->pos();
-	const network::Vec3 pos { _pos.x, _pos.y, _pos.z };
-	_entityUpdateFBB.Clear();
-	_messageSender->sendServerMessage(_peer, _entityUpdateFBB, network::ServerMsgType::EntityUpdate,
-			network::CreateEntityUpdate(_entityUpdateFBB, entity->id(), &pos, entity->orientation(), entity->animation()).Union());
+	// the size of the builder is only the payload - but that's what we want to measure here
+	_snapshotBytes = _entitySnapshotFBB.GetSize();
+	_messageSender->sendServerMessage(&p, 1, _entitySnapshotFBB, network::ServerMsgType::EntitySnapshot,
+			snapshot.Union(), 0u, shared::SnapshotChannel);
 }
 
 void Entity::sendEntitySpawn(const EntityPtr& entity) const {
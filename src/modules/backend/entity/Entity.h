@@ -12,6 +12,7 @@
 #include "attrib/Attributes.h"
 #include "poi/Type.h"
 #include "backend/ForwardDecl.h"
+#include "EntitySnapshotBuilder.h"
 #include "ServerMessages_generated.h"
 #include "network/IProtocolHandler.h"
 #include "core/Trace.h"
@@ -26,10 +27,11 @@ typedef std::unordered_set<EntityPtr> EntitySet;
 /**
  * @brief Every actor in the world is an entity
  *
- * Entities are updated via @c network::ServerMsgType::EntityUpdate
+ * Entities are updated via @c network::ServerMsgType::EntitySnapshot
  * message for the clients that are seeing the entity
  *
- * @sa EntityUpdateHandler
+ * @sa EntitySnapshotHandler
+ * @sa EntitySnapshotBuilder
  */
 class Entity {
 private:
@@ -37,7 +39,7 @@ private:
 	EntitySet _visible core_thread_guarded_by(_visibleLock);
 	// they are stored as members to reduce memory allocations
 	mutable flatbuffers::FlatBufferBuilder _attribUpdateFBB;
-	mutable flatbuffers::FlatBufferBuilder _entityUpdateFBB;
+	flatbuffers::FlatBufferBuilder _entitySnapshotFBB;
 	mutable flatbuffers::FlatBufferBuilder _entitySpawnFBB;
 	mutable flatbuffers::FlatBufferBuilder _entityRemoveFBB;
 
@@ -46,6 +48,9 @@ protected:
 	network::ServerMessageSenderPtr _messageSender;
 	ENetPeer *_peer = nullptr;
 
+	EntitySnapshotBuilder _snapshotBuilder;
+	uint32_t _snapshotBytes = 0u;
+
 	network::Animation _animation = network::Animation::IDLE;
 
 	// attribute stuff
@@ -72,7 +77,10 @@ protected:
 	void visibleRemove(const EntitySet& entities);
 
 	void broadcastAttribUpdate();
-	void sendEntityUpdate(const EntityPtr& entity) const;
+	/**
+	 * @brief Sends one snapshot with all changed visible entities to the peer of this entity
+	 */
+	void sendEntitySnapshot();
 	void sendEntitySpawn(const EntityPtr& entity) const;
 	void sendEntityRemove(const EntityPtr& entity) const;
 
@@ -122,6 +130,15 @@ public:
 
 	int visibleCount() const;
 
+	/**
+	 * @brief The client acknowledged the receiving of the snapshot with the given sequence number
+	 */
+	void ackEntitySnapshot(uint32_t sequence);
+	/**
+	 * @return The amount of bytes of the entity snapshot that was sent in the last tick
+	 */
+	uint32_t snapshotBytes() const;
+
 	/**
 	 * @brief Allows to execute a functor/lambda on the visible objects
 	 * @note This is thread safe
@@ -205,6 +222,14 @@ inline const MapPtr& Entity::map() const {
 	return _map;
 }
 
+inline void Entity::ackEntitySnapshot(uint32_t sequence) {
+	_snapshotBuilder.ack(sequence);
+}
+
+inline uint32_t Entity::snapshotBytes() const {
+	return _snapshotBytes;
+}
+
 inline network::Animation Entity::animation() const {
 	return _animation;
 }
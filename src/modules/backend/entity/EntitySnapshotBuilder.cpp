@@ -0,0 +1,108 @@
+/**
+ * @file
+ */
+
+#include "EntitySnapshotBuilder.h"
+#include "Entity.h"
+#include "core/Trace.h"
+#include <algorithm>
+
+namespace backend {
+
+void EntitySnapshotBuilder::ack(uint32_t sequence) {
+	if (sequence <= _ackedSequence || sequence > _history.lastSequence()) {
+		return;
+	}
+	_ackedSequence = sequence;
+}
+
+void EntitySnapshotBuilder::reset() {
+	_tracked.clear();
+	_history.reset();
+	_ackedSequence = 0u;
+}
+
+uint32_t EntitySnapshotBuilder::baseSequence() const {
+	// the client only keeps the last n snapshots - so we can't use an older one as base
+	const uint32_t sequence = _history.lastSequence() + 1u;
+	if (_ackedSequence == 0u || sequence - _ackedSequence >= shared::SnapshotHistorySize) {
+		return 0u;
+	}
+	if (_history.get(_ackedSequence) == nullptr) {
+		return 0u;
+	}
+	return _ackedSequence;
+}
+
+flatbuffers::Offset<network::EntitySnapshot> EntitySnapshotBuilder::build(flatbuffers::FlatBufferBuilder& fbb, const std::unordered_set<EntityPtr>& visible) {
+	core_trace_scoped(EntitySnapshotBuild);
+	const uint32_t sequence = _history.lastSequence() + 1u;
+	const uint32_t baseSeq = baseSequence();
+	const shared::EntitySnapshotState* base = _history.get(baseSeq);
+
+	_sorted.assign(visible.begin(), visible.end());
+	std::sort(_sorted.begin(), _sorted.end(), [] (const EntityPtr& lhs, const EntityPtr& rhs) {
+		return lhs->id() < rhs->id();
+	});
+
+	_current.clear(sequence);
+	_deltas.clear();
+	for (const EntityPtr& entity : _sorted) {
+		const EntityId id = entity->id();
+		const shared::QuantizedEntityState& state = shared::QuantizedEntityState::quantize(entity->pos(), entity->orientation(), entity->animation());
+		_current.add(id, state);
+
+		auto i = _tracked.find(id);
+		if (i == _tracked.end()) {
+			i = _tracked.emplace(id, TrackedEntity{state, sequence, sequence}).first;
+		} else {
+			if (i->second.state != state) {
+				i->second.state = state;
+				i->second.changedSequence = sequence;
+			}
+			i->second.seenSequence = sequence;
+		}
+
+		const shared::QuantizedEntityState* baseState = base != nullptr ? base->find(id) : nullptr;
+		if (baseState != nullptr && i->second.changedSequence <= baseSeq) {
+			// the client already has this state
+			continue;
+		}
+		network::EntityDeltaBuilder delta(fbb);
+		delta.add_id(id);
+		if (baseState == nullptr) {
+			delta.add_absolute(true);
+			delta.add_x(state.x);
+			delta.add_y(state.y);
+			delta.add_z(state.z);
+			delta.add_rotation(state.rotation);
+			delta.add_animation(state.animation);
+		} else {
+			delta.add_x(state.x - baseState->x);
+			delta.add_y(state.y - baseState->y);
+			delta.add_z(state.z - baseState->z);
+			delta.add_rotation((uint16_t)(state.rotation - baseState->rotation));
+			delta.add_animation((uint8_t)(state.animation - baseState->animation));
+		}
+		_deltas.push_back(delta.Finish());
+	}
+
+	for (auto i = _tracked.begin(); i != _tracked.end();) {
+		if (i->second.seenSequence != sequence) {
+			i = _tracked.erase(i);
+		} else {
+			++i;
+		}
+	}
+
+	if (_deltas.empty()) {
+		// nothing changed - the sequence is reused for the next snapshot
+		return flatbuffers::Offset<network::EntitySnapshot>();
+	}
+	// the base snapshot can't be overwritten here - it's at max SnapshotHistorySize - 1 entries behind
+	shared::EntitySnapshotState& stored = _history.next(sequence);
+	std::swap(stored.entities, _current.entities);
+	return network::CreateEntitySnapshot(fbb, sequence, baseSeq, fbb.CreateVector(_deltas));
+}
+
+}
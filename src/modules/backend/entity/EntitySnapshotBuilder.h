@@ -0,0 +1,70 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "backend/ForwardDecl.h"
+#include "shared/EntitySnapshot.h"
+#include "ServerMessages_generated.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace backend {
+
+/**
+ * @brief Builds the per tick @c network::EntitySnapshot for one observing peer
+ *
+ * The entity states are quantized and delta encoded against the last snapshot that
+ * was acknowledged by the client. Entities that didn't change since then are not part
+ * of the message at all. Changed entities are repeated until a snapshot that contains
+ * the change was acknowledged - this is what allows us to send the snapshots unreliable.
+ */
+class EntitySnapshotBuilder {
+private:
+	struct TrackedEntity {
+		shared::QuantizedEntityState state;
+		/** the sequence of the snapshot where the state was changed the last time */
+		uint32_t changedSequence = 0u;
+		/** the sequence of the snapshot where the entity was visible the last time */
+		uint32_t seenSequence = 0u;
+	};
+	std::unordered_map<EntityId, TrackedEntity> _tracked;
+	shared::EntitySnapshotHistory _history;
+	shared::EntitySnapshotState _current;
+	std::vector<EntityPtr> _sorted;
+	std::vector<flatbuffers::Offset<network::EntityDelta>> _deltas;
+	uint32_t _ackedSequence = 0u;
+
+	uint32_t baseSequence() const;
+public:
+	/**
+	 * @brief Called whenever the client acknowledged the receiving of a snapshot
+	 */
+	void ack(uint32_t sequence);
+
+	/**
+	 * @param[in] visible The entities that are currently visible for the observer
+	 * @return A null offset if there is nothing to send
+	 */
+	flatbuffers::Offset<network::EntitySnapshot> build(flatbuffers::FlatBufferBuilder& fbb, const std::unordered_set<EntityPtr>& visible);
+
+	/**
+	 * @brief Start over with absolute snapshots - e.g. after a reconnect
+	 */
+	void reset();
+
+	uint32_t sequence() const;
+	uint32_t ackedSequence() const;
+};
+
+inline uint32_t EntitySnapshotBuilder::sequence() const {
+	return _history.lastSequence();
+}
+
+inline uint32_t EntitySnapshotBuilder::ackedSequence() const {
+	return _ackedSequence;
+}
+
+}
@@ -95,6 +95,8 @@ void User::onConnect() {
 
 void User::onReconnect() {
 	Log::info("reconnect user");
+	// the new client doesn't know any of our snapshots
+	_snapshotBuilder.reset();
 	visitVisible([&] (const EntityPtr& e) {
 		sendEntitySpawn(e);
 	});
@@ -14,9 +14,25 @@ ai::CharacterId AI::getId() const {
 	return _character->getId();
 }
 
+void AI::compileBehaviour() {
+	if (!_behaviour) {
+		return;
+	}
+	if (!_behaviour->isCompiled()) {
+		TreeNode::compile(_behaviour.get());
+	}
+	const size_t nodes = (size_t)_behaviour->compiledNodes();
+	if (_nodeStates.size() < nodes) {
+		_nodeStates.resize(nodes);
+	}
+}
+
 TreeNodePtr AI::setBehaviour(const TreeNodePtr& newBehaviour) {
 	TreeNodePtr current = _behaviour;
 	_behaviour = newBehaviour;
+	if (_behaviour && !_behaviour->isCompiled()) {
+		TreeNode::compile(_behaviour.get());
+	}
 	_reset = true;
 	return current;
 }
@@ -33,11 +49,10 @@ void AI::update(int64_t dt, bool debuggingActive) {
 	if (_reset) {
 		// safe to do it like this, because update is not called from multiple threads
 		_reset = false;
-		_lastStatus.clear();
-		_lastExecMillis.clear();
+		_nodeStates.clear();
 		_filteredEntities.clear();
-		_selectorStates.clear();
 	}
+	compileBehaviour();
 
 	_debuggingActive = debuggingActive;
 	_time += dt;
@@ -14,6 +14,7 @@
 #include "AIMessages_generated.h"
 
 #include <memory>
+#include <vector>
 #include <glm/vec3.hpp>
 
 namespace backend {
@@ -28,6 +29,9 @@ typedef std::shared_ptr<TreeNode> TreeNodePtr;
 class ICharacter;
 typedef core::SharedPtr<ICharacter> ICharacterPtr;
 class Zone;
+namespace movement {
+class MovementSystem;
+}
 
 /**
  * @brief This is the type the library works with. It interacts with it's real world entity by
@@ -45,18 +49,9 @@ class AI : public core::NonCopyable {
 	friend class IFilter;
 	friend class Filter;
 	friend class Server;
+	friend class AIScheduler;
+	friend class movement::MovementSystem;
 protected:
-	/**
-	 * This map is only filled if we are in debugging mode for this entity
-	 */
-	typedef core::Map<int, ai::TreeNodeStatus> NodeStates;
-	NodeStates _lastStatus;
-	/**
-	 * This map is only filled if we are in debugging mode for this entity
-	 */
-	typedef core::Map<int, uint64_t> LastExecMap;
-	LastExecMap _lastExecMillis;
-
 	/**
 	 * @note The filtered entities are kept even over several ticks. The caller should decide
 	 * whether he still needs an old/previous filtered selection
@@ -64,18 +59,46 @@ protected:
 	 */
 	mutable FilteredEntities _filteredEntities;
 
+public:
+	/**
+	 * @brief The runtime state of one @c TreeNode of the behaviour for this entity
+	 */
+	struct NodeState {
+		/**
+		 * Only set if we are in debugging mode for this entity
+		 */
+		int64_t lastExecMillis = -1L;
+		/**
+		 * Often @ai{Selector} states must be stored to continue in the next step at a particular
+		 * position in the behaviour tree.
+		 */
+		int selectorState = AI_NOTHING_SELECTED;
+		/**
+		 * The amount of executions for the @ai{Limit} node
+		 */
+		int limitState = 0;
+		/**
+		 * Only set if we are in debugging mode for this entity
+		 */
+		ai::TreeNodeStatus lastStatus = ai::TreeNodeStatus::UNKNOWN;
+	};
+protected:
+	/**
+	 * The node states indexed by the dense index of the compiled behaviour tree
+	 * @sa TreeNode::compile()
+	 */
+	std::vector<NodeState> _nodeStates;
+
 	/**
-	 * Often @ai{Selector} states must be stored to continue in the next step at a particular
-	 * position in the behaviour tree. This map is doing exactly this.
+	 * @return @c nullptr if the node is not part of a compiled tree
 	 */
-	typedef core::Map<int, int> SelectorStates;
-	SelectorStates _selectorStates;
+	NodeState* nodeState(int index);
+	const NodeState* nodeState(int index) const;
 
 	/**
-	 * This map stores the amount of execution for the @ai{Limit} node. The key is the node id
+	 * @brief Makes sure the behaviour is compiled and the node states are big enough for it
 	 */
-	typedef core::Map<int, int> LimitStates;
-	LimitStates _limitStates;
+	void compileBehaviour();
 
 	TreeNodePtr _behaviour;
 	AggroMgr _aggroMgr;
@@ -87,6 +110,17 @@ protected:
 
 	int64_t _time;
 
+	/**
+	 * The scheduling state that is maintained by the @c AIScheduler of the @c Zone
+	 */
+	int64_t _scheduledDt = 0;
+	uint32_t _scheduledTick = 0u;
+	int _scheduledTier = 0;
+	/**
+	 * The slot in the @c movement::MovementSystem of the @c Zone
+	 */
+	uint32_t _movementSlot = (uint32_t)-1;
+
 	Zone* _zone;
 
 	core::AtomicBool _reset;
@@ -96,6 +130,7 @@ public:
 	 */
 	explicit AI(const TreeNodePtr& behaviour) :
 			_behaviour(behaviour), _pause(false), _debuggingActive(false), _time(0L), _zone(nullptr), _reset(false) {
+		compileBehaviour();
 	}
 	virtual ~AI() {
 	}
@@ -185,6 +220,24 @@ public:
 	const FilteredEntities& getFilteredEntities() const;
 };
 
+inline AI::NodeState* AI::nodeState(int index) {
+	if (index < 0) {
+		return nullptr;
+	}
+	if ((size_t)index >= _nodeStates.size()) {
+		// the tree was extended after the last compilation
+		_nodeStates.resize(index + 1);
+	}
+	return &_nodeStates[index];
+}
+
+inline const AI::NodeState* AI::nodeState(int index) const {
+	if (index < 0 || (size_t)index >= _nodeStates.size()) {
+		return nullptr;
+	}
+	return &_nodeStates[index];
+}
+
 inline TreeNodePtr AI::getBehaviour() const {
 	return _behaviour;
 }
@@ -130,10 +130,19 @@ static int luaAI_nodetostring(lua_State* s) {
 static int luaAI_createnode(lua_State* s) {
 	LUAAIRegistry* r = luaAI_toregistry(s);
 	const core::String type = luaL_checkstring(s, -1);
-	const LUATreeNodeFactoryPtr& factory = std::make_shared<LuaNodeFactory>(s, type);
-	const bool inserted = r->registerNodeFactory(type, *factory);
-	if (!inserted) {
-		return clua_error(s, "tree node %s is already registered", type.c_str());
+	LUATreeNodeFactoryPtr factory;
+	if (s != r->getLuaState()) {
+		// the script is replayed in the lua state of a worker thread - the factory was already registered
+		factory = r->treeNodeFactory(type);
+		if (!factory) {
+			return clua_error(s, "tree node %s is not registered", type.c_str());
+		}
+	} else {
+		factory = std::make_shared<LuaNodeFactory>(r, type, r->nextSlot());
+		const bool inserted = r->registerNodeFactory(type, *factory);
+		if (!inserted) {
+			return clua_error(s, "tree node %s is already registered", type.c_str());
+		}
 	}
 
 	clua_newuserdata<LuaNodeFactory*>(s, factory.get());
@@ -171,10 +180,19 @@ static int luaAI_conditiontostring(lua_State* s) {
 static int luaAI_createcondition(lua_State* s) {
 	LUAAIRegistry* r = luaAI_toregistry(s);
 	const core::String type = luaL_checkstring(s, -1);
-	const LUAConditionFactoryPtr& factory = std::make_shared<LuaConditionFactory>(s, type);
-	const bool inserted = r->registerConditionFactory(type, *factory);
-	if (!inserted) {
-		return clua_error(s, "condition %s is already registered", type.c_str());
+	LUAConditionFactoryPtr factory;
+	if (s != r->getLuaState()) {
+		// the script is replayed in the lua state of a worker thread - the factory was already registered
+		factory = r->conditionFactory(type);
+		if (!factory) {
+			return clua_error(s, "condition %s is not registered", type.c_str());
+		}
+	} else {
+		factory = std::make_shared<LuaConditionFactory>(r, type, r->nextSlot());
+		const bool inserted = r->registerConditionFactory(type, *factory);
+		if (!inserted) {
+			return clua_error(s, "condition %s is already registered", type.c_str());
+		}
 	}
 
 	clua_newuserdata<LuaConditionFactory*>(s, factory.get());
@@ -208,10 +226,19 @@ static int luaAI_filtertostring(lua_State* s) {
 static int luaAI_createfilter(lua_State* s) {
 	LUAAIRegistry* r = luaAI_toregistry(s);
 	const core::String type = luaL_checkstring(s, -1);
-	const LUAFilterFactoryPtr& factory = std::make_shared<LuaFilterFactory>(s, type);
-	const bool inserted = r->registerFilterFactory(type, *factory);
-	if (!inserted) {
-		return clua_error(s, "filter %s is already registered", type.c_str());
+	LUAFilterFactoryPtr factory;
+	if (s != r->getLuaState()) {
+		// the script is replayed in the lua state of a worker thread - the factory was already registered
+		factory = r->filterFactory(type);
+		if (!factory) {
+			return clua_error(s, "filter %s is not registered", type.c_str());
+		}
+	} else {
+		factory = std::make_shared<LuaFilterFactory>(r, type, r->nextSlot());
+		const bool inserted = r->registerFilterFactory(type, *factory);
+		if (!inserted) {
+			return clua_error(s, "filter %s is already registered", type.c_str());
+		}
 	}
 
 	clua_newuserdata<LuaFilterFactory*>(s, factory.get());
@@ -240,10 +267,19 @@ static int luaAI_steeringtostring(lua_State* s) {
 static int luaAI_createsteering(lua_State* s) {
 	LUAAIRegistry* r = luaAI_toregistry(s);
 	const core::String type = luaL_checkstring(s, -1);
-	const LUASteeringFactoryPtr& factory = std::make_shared<LuaSteeringFactory>(s, type);
-	const bool inserted = r->registerSteeringFactory(type, *factory);
-	if (!inserted) {
-		return clua_error(s, "steering %s is already registered", type.c_str());
+	LUASteeringFactoryPtr factory;
+	if (s != r->getLuaState()) {
+		// the script is replayed in the lua state of a worker thread - the factory was already registered
+		factory = r->steeringFactory(type);
+		if (!factory) {
+			return clua_error(s, "steering %s is not registered", type.c_str());
+		}
+	} else {
+		factory = std::make_shared<LuaSteeringFactory>(r, type, r->nextSlot());
+		const bool inserted = r->registerSteeringFactory(type, *factory);
+		if (!inserted) {
+			return clua_error(s, "steering %s is already registered", type.c_str());
+		}
 	}
 
 	clua_newuserdata<LuaSteeringFactory*>(s, factory.get());
@@ -258,11 +294,25 @@ static int luaAI_createsteering(lua_State* s) {
 	return 1;
 }
 
-LUAAIRegistry::LUAAIRegistry() {
+static core::AtomicInt registryIds { 1 };
+
+thread_local LUAAIRegistry::ThreadState LUAAIRegistry::_threadState;
+
+LUAAIRegistry::LUAAIRegistry() :
+		_id(registryIds.increment(1)), _mainThread(std::this_thread::get_id()) {
 	_s = _lua.state();
+	initState(_s);
+
+	const LUAStatePtr& state = std::make_shared<LUAState>();
+	state->s = _s;
+	core::ScopedLock lock(_stateLock);
+	_states.emplace(_mainThread, state);
+}
+
+void LUAAIRegistry::initState(lua_State* s) {
 	// TODO: random module
 
-	lua_gc(_s, LUA_GCSTOP, 0);
+	lua_gc(s, LUA_GCSTOP, 0);
 
 	static const luaL_Reg registryFuncs[] = {
 		{"createNode", luaAI_createnode},
@@ -271,10 +321,72 @@ LUAAIRegistry::LUAAIRegistry() {
 		{"createSteering", luaAI_createsteering},
 		{nullptr, nullptr}
 	};
-	clua_registerfuncsglobal(_s, registryFuncs, "META_REGISTRY", "REGISTRY");
+	clua_registerfuncsglobal(s, registryFuncs, "META_REGISTRY", "REGISTRY");
+
+	luaAI_globalpointer(s, this, luaAI_metaregistry());
+	luaAI_registerAll(s);
+}
+
+LUAAIRegistry::LUAState* LUAAIRegistry::threadState() {
+	LUAState* state;
+	if (_threadState.registry == (int)_id) {
+		state = _threadState.state;
+	} else {
+		const std::thread::id threadId = std::this_thread::get_id();
+		core::ScopedLock lock(_stateLock);
+		auto i = _states.find(threadId);
+		if (i == _states.end()) {
+			const LUAStatePtr& newState = std::make_shared<LUAState>();
+			newState->lua = std::make_shared<lua::LUA>();
+			newState->s = newState->lua->state();
+			initState(newState->s);
+			i = _states.emplace(threadId, newState).first;
+			Log::debug("Created lua state for thread %i", (int)_states.size());
+		}
+		state = i->second.get();
+		_threadState.registry = _id;
+		_threadState.state = state;
+	}
+	if (state->scripts < (int)_scriptCount) {
+		replay(state);
+	}
+	return state;
+}
+
+void LUAAIRegistry::replay(LUAState* state) {
+	core_trace_scoped(LUAAIRegistryReplay);
+	core::ScopedLock lock(_stateLock);
+	lua_State* s = state->s;
+	for (; state->scripts < (int)_scripts.size(); ++state->scripts) {
+		const core::String& script = _scripts[state->scripts];
+		if (luaL_loadbufferx(s, script.c_str(), script.size(), "", nullptr) || lua_pcall(s, 0, 0, 0)) {
+			Log::error("%s", lua_tostring(s, -1));
+			lua_pop(s, 1);
+		}
+	}
+}
 
-	luaAI_globalpointer(_s, this, luaAI_metaregistry());
-	luaAI_registerAll(_s);
+int LUAAIRegistry::nextSlot() {
+	return _slots.increment(1);
+}
+
+lua_State* LUAAIRegistry::pushFactory(int slot, const char *metaName) {
+	LUAState* state = threadState();
+	lua_State* s = state->s;
+	if (slot >= (int)state->refs.size()) {
+		state->refs.resize(slot + 1, LUA_NOREF);
+	}
+	int& ref = state->refs[slot];
+	if (ref != LUA_NOREF) {
+		lua_rawgeti(s, LUA_REGISTRYINDEX, ref);
+		return s;
+	}
+	lua_getfield(s, LUA_REGISTRYINDEX, metaName);
+	if (!lua_isnil(s, -1)) {
+		lua_pushvalue(s, -1);
+		ref = luaL_ref(s, LUA_REGISTRYINDEX);
+	}
+	return s;
 }
 
 lua_State* LUAAIRegistry::getLuaState() {
@@ -295,9 +407,7 @@ bool LUAAIRegistry::init(const core::String& file) {
 	const char* script = ""
 		"UNKNOWN, CANNOTEXECUTE, RUNNING, FINISHED, FAILED, EXCEPTION = 0, 1, 2, 3, 4, 5\n";
 
-	if (luaL_loadbufferx(_s, script, SDL_strlen(script), "", nullptr) || lua_pcall(_s, 0, 0, 0)) {
-		Log::error("%s", lua_tostring(_s, -1));
-		lua_pop(_s, 1);
+	if (!evaluate(script, SDL_strlen(script))) {
 		return false;
 	}
 	const core::String& btScript = io::filesystem()->load(file);
@@ -317,6 +427,20 @@ void LUAAIRegistry::shutdown() {
 		_filterFactories.clear();
 		_steeringFactories.clear();
 	}
+	{
+		core::ScopedLock lock(_stateLock);
+		for (auto i = _states.begin(); i != _states.end();) {
+			if (i->second->lua) {
+				i = _states.erase(i);
+			} else {
+				++i;
+			}
+		}
+		_scripts.clear();
+		_scriptCount = 0;
+		// invalidate the cached thread states
+		_id = registryIds.increment(1);
+	}
 	_s = nullptr;
 }
 
@@ -334,6 +458,10 @@ bool LUAAIRegistry::evaluate(const char* luaBuffer, size_t size) {
 		lua_pop(_s, 1);
 		return false;
 	}
+	core::ScopedLock lock(_stateLock);
+	_scripts.emplace_back(luaBuffer, size);
+	_states[_mainThread]->scripts = (int)_scripts.size();
+	_scriptCount = (int)_scripts.size();
 	return true;
 }
 
@@ -357,4 +485,33 @@ void LUAAIRegistry::addSteeringFactory(const core::String& type, const LUASteeri
 	_steeringFactories.emplace(type, factory);
 }
 
+template<class MAP>
+static typename MAP::mapped_type findFactory(const MAP& map, const core::String& type) {
+	auto i = map.find(type);
+	if (i == map.end()) {
+		return typename MAP::mapped_type();
+	}
+	return i->second;
+}
+
+LUATreeNodeFactoryPtr LUAAIRegistry::treeNodeFactory(const core::String& type) {
+	core::ScopedLock scopedLock(_lock);
+	return findFactory(_treeNodeFactories, type);
+}
+
+LUAConditionFactoryPtr LUAAIRegistry::conditionFactory(const core::String& type) {
+	core::ScopedLock scopedLock(_lock);
+	return findFactory(_conditionFactories, type);
+}
+
+LUAFilterFactoryPtr LUAAIRegistry::filterFactory(const core::String& type) {
+	core::ScopedLock scopedLock(_lock);
+	return findFactory(_filterFactories, type);
+}
+
+LUASteeringFactoryPtr LUAAIRegistry::steeringFactory(const core::String& type) {
+	core::ScopedLock scopedLock(_lock);
+	return findFactory(_steeringFactories, type);
+}
+
 }
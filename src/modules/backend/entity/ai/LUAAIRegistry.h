@@ -7,6 +7,7 @@
 
 #include "AIRegistry.h"
 #include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/Concurrency.h"
 #include "core/concurrent/Lock.h"
 #include "commonlua/LUA.h"
@@ -15,6 +16,8 @@
 #include "backend/entity/ai/filter/LUAFilter.h"
 #include "backend/entity/ai/movement/LUASteering.h"
 #include <map>
+#include <thread>
+#include <vector>
 
 namespace backend {
 
@@ -86,12 +89,58 @@ typedef std::map<core::String, LUASteeringFactoryPtr> SteeringFactoryMap;
  * @par AI metatable
  * There is a metatable that you can modify by calling @ai{LUAAIRegistry::pushAIMetatable()}.
  * This metatable is applied to all @ai{AI} pointers that are forwarded to the lua functions.
+ *
+ * @par Threading
+ * The @ai{Zone} executes the behaviour trees of its @ai{AI} instances in parallel. A lua state must not be used
+ * by more than one thread at a time - that's why every thread that executes lua nodes, conditions, filters or
+ * steerings gets its own lua state. These states are initialized like the main state of the registry and all
+ * scripts that were passed to @c evaluate() are replayed in them - scripts that are evaluated later on (e.g. to
+ * reload a changed function) are picked up by the thread states before their next execution. The thread that
+ * created the registry uses the main state.
  */
 class LUAAIRegistry : public AIRegistry {
 protected:
 	lua::LUA _lua;
 	lua_State* _s = nullptr;
 
+	/**
+	 * @brief A lua state that is only used by one thread
+	 */
+	struct LUAState {
+		/** @c nullptr for the main state, which is owned by the registry */
+		std::shared_ptr<lua::LUA> lua;
+		lua_State* s = nullptr;
+		/** the amount of evaluated scripts that were executed in this state */
+		int scripts = 0;
+		/** the lua registry references of the factory userdata - indexed by the slot of the factory */
+		std::vector<int> refs;
+	};
+	typedef std::shared_ptr<LUAState> LUAStatePtr;
+
+	struct ThreadState {
+		int registry = 0;
+		LUAState* state = nullptr;
+	};
+	/**
+	 * @brief Avoids the lookup in @c _states for the registry that was used last by this thread
+	 */
+	static thread_local ThreadState _threadState;
+
+	/**
+	 * @brief Unique id of this registry to validate the @c _threadState cache. Changed on @c shutdown().
+	 */
+	core::AtomicInt _id;
+	const std::thread::id _mainThread;
+	core_trace_mutex(core::Lock, _stateLock, "LUAAIRegistryStates");
+	std::map<std::thread::id, LUAStatePtr> _states core_thread_guarded_by(_stateLock);
+	std::vector<core::String> _scripts core_thread_guarded_by(_stateLock);
+	core::AtomicInt _scriptCount { 0 };
+	core::AtomicInt _slots { 0 };
+
+	void initState(lua_State* s);
+	LUAState* threadState();
+	void replay(LUAState* state);
+
 	core_trace_mutex(core::Lock, _lock, "LUAAIRegistry");
 	TreeNodeFactoryMap _treeNodeFactories core_thread_guarded_by(_lock);
 	ConditionFactoryMap _conditionFactories core_thread_guarded_by(_lock);
@@ -105,8 +154,28 @@ public:
 	void addFilterFactory(const core::String& type, const LUAFilterFactoryPtr& factory);
 	void addSteeringFactory(const core::String& type, const LUASteeringFactoryPtr& factory);
 
+	LUATreeNodeFactoryPtr treeNodeFactory(const core::String& type);
+	LUAConditionFactoryPtr conditionFactory(const core::String& type);
+	LUAFilterFactoryPtr filterFactory(const core::String& type);
+	LUASteeringFactoryPtr steeringFactory(const core::String& type);
+
+	/**
+	 * @return A new index for the thread local references of the userdata of a lua factory
+	 * @see pushFactory()
+	 */
+	int nextSlot();
+
+	/**
+	 * @brief Pushes the userdata of a lua factory onto the stack of the lua state of the calling thread.
+	 * @param[in] slot The slot of the factory - see @c nextSlot()
+	 * @param[in] metaName The name of the userdata in the lua registry - this is only looked up once per thread
+	 * @return The lua state of the calling thread
+	 */
+	lua_State* pushFactory(int slot, const char *metaName);
+
 	/**
-	 * @brief Access to the lua state.
+	 * @brief Access to the main lua state.
+	 * @note Changes to this state are not visible in the lua states of the other threads - use @c evaluate() for this.
 	 * @see pushAIMetatable()
 	 */
 	lua_State* getLuaState();
@@ -144,7 +213,8 @@ public:
 
 	/**
 	 * @brief Load your lua scripts into the lua state of the registry.
-	 * This can be called multiple times to e.g. load multiple files.
+	 * This can be called multiple times to e.g. load multiple files. The scripts are replayed in the lua
+	 * states of all threads that execute lua nodes.
 	 * @return @c true if the lua script was loaded, @c false otherwise
 	 * @note you have to call init() before
 	 */
@@ -3,6 +3,8 @@
  */
 
 #include "GroupMgr.h"
+#include <algorithm>
+#include <limits>
 #include <list>
 
 namespace backend {
@@ -13,7 +15,52 @@ struct AveragePositionFunctor {
 	}
 };
 
+const GroupMgr::GroupSnapshot* GroupMgr::Snapshot::find(GroupId id) const {
+	auto i = std::lower_bound(groups.begin(), groups.end(), id, [] (const GroupSnapshot& group, GroupId groupId) {
+		return group.id < groupId;
+	});
+	if (i == groups.end() || i->id != id) {
+		return nullptr;
+	}
+	return &*i;
+}
+
+const GroupMgr::Snapshot* GroupMgr::snapshot() const {
+	if (_dirty) {
+		return nullptr;
+	}
+	return &_snapshots[(int)_currentSnapshot];
+}
+
+void GroupMgr::publishSnapshot() {
+	// the readers are still allowed to use the current snapshot - so fill the other one
+	const int next = 1 - (int)_currentSnapshot;
+	Snapshot& s = _snapshots[next];
+	// keep the capacity of the member vectors of the previous snapshot
+	s.groups.resize(_groups.size());
+	s.memberships.clear();
+	size_t n = 0u;
+	for (auto i = _groups.begin(); i != _groups.end(); ++i, ++n) {
+		const Group& group = i->second;
+		GroupSnapshot& groupSnapshot = s.groups[n];
+		groupSnapshot.id = i->first;
+		groupSnapshot.leader = group.leader;
+		groupSnapshot.position = group.position;
+		groupSnapshot.members.assign(group.members.begin(), group.members.end());
+		for (const AIPtr& ai : group.members) {
+			s.memberships.emplace_back(ai.get(), i->first);
+		}
+	}
+	std::sort(s.groups.begin(), s.groups.end(), [] (const GroupSnapshot& lhs, const GroupSnapshot& rhs) {
+		return lhs.id < rhs.id;
+	});
+	std::sort(s.memberships.begin(), s.memberships.end());
+	_currentSnapshot = next;
+	_dirty = false;
+}
+
 void GroupMgr::update(int64_t) {
+	core_trace_scoped(GroupMgrUpdate);
 	core::ScopedLock scopedLock(_lock);
 	for (auto i = _groups.begin(); i != _groups.end(); ++i) {
 		Group& group = i->second;
@@ -22,6 +69,7 @@ void GroupMgr::update(int64_t) {
 		averagePosition *= 1.0f / (float) group.members.size();
 		group.position = averagePosition;
 	}
+	publishSnapshot();
 }
 
 bool GroupMgr::add(GroupId id, const AIPtr& ai) {
@@ -38,6 +86,7 @@ bool GroupMgr::add(GroupId id, const AIPtr& ai) {
 	std::pair<GroupMembersSetIter, bool> ret = group.members.insert(ai);
 	if (ret.second) {
 		_groupMembers.insert(GroupMembers::value_type(ai, id));
+		_dirty = true;
 		return true;
 	}
 	return false;
@@ -64,6 +113,7 @@ bool GroupMgr::remove(GroupId id, const AIPtr& ai) {
 			group.leader = *group.members.begin();
 		}
 	}
+	_dirty = true;
 
 	auto range = _groupMembers.equal_range(ai);
 	for (auto it = range.first; it != range.second; ++it) {
@@ -91,6 +141,10 @@ bool GroupMgr::removeFromAllGroups(const AIPtr& ai) {
 }
 
 AIPtr GroupMgr::getLeader(GroupId id) const {
+	if (const Snapshot* s = snapshot()) {
+		const GroupSnapshot* group = s->find(id);
+		return group == nullptr ? AIPtr() : group->leader;
+	}
 	core::ScopedLock scopedLock(_lock);
 	const GroupsConstIter& i = _groups.find(id);
 	if (i == _groups.end()) {
@@ -102,6 +156,14 @@ AIPtr GroupMgr::getLeader(GroupId id) const {
 }
 
 bool GroupMgr::getPosition(GroupId id, glm::vec3& position) const {
+	if (const Snapshot* s = snapshot()) {
+		const GroupSnapshot* group = s->find(id);
+		if (group == nullptr) {
+			return false;
+		}
+		position = group->position;
+		return true;
+	}
 	core::ScopedLock scopedLock(_lock);
 	const GroupsConstIter& i = _groups.find(id);
 	if (i == _groups.end()) {
@@ -114,6 +176,10 @@ bool GroupMgr::getPosition(GroupId id, glm::vec3& position) const {
 }
 
 bool GroupMgr::isGroupLeader(GroupId id, const AIPtr& ai) const {
+	if (const Snapshot* s = snapshot()) {
+		const GroupSnapshot* group = s->find(id);
+		return group != nullptr && group->leader == ai;
+	}
 	core::ScopedLock scopedLock(_lock);
 	const GroupsConstIter& i = _groups.find(id);
 	if (i == _groups.end()) {
@@ -124,6 +190,10 @@ bool GroupMgr::isGroupLeader(GroupId id, const AIPtr& ai) const {
 }
 
 int GroupMgr::getGroupSize(GroupId id) const {
+	if (const Snapshot* s = snapshot()) {
+		const GroupSnapshot* group = s->find(id);
+		return group == nullptr ? 0 : (int)group->members.size();
+	}
 	core::ScopedLock scopedLock(_lock);
 	const GroupsConstIter& i = _groups.find(id);
 	if (i == _groups.end()) {
@@ -134,11 +204,18 @@ int GroupMgr::getGroupSize(GroupId id) const {
 }
 
 bool GroupMgr::isInAnyGroup(const AIPtr& ai) const {
+	if (const Snapshot* s = snapshot()) {
+		auto i = std::lower_bound(s->memberships.begin(), s->memberships.end(), std::make_pair((const AI*)ai.get(), std::numeric_limits<GroupId>::min()));
+		return i != s->memberships.end() && i->first == ai.get();
+	}
 	core::ScopedLock scopedLock(_lock);
 	return _groupMembers.find(ai) != _groupMembers.end();
 }
 
 bool GroupMgr::isInGroup(GroupId id, const AIPtr& ai) const {
+	if (const Snapshot* s = snapshot()) {
+		return std::binary_search(s->memberships.begin(), s->memberships.end(), std::make_pair((const AI*)ai.get(), id));
+	}
 	core::ScopedLock scopedLock(_lock);
 	auto range = _groupMembers.equal_range(ai);
 	for (auto it = range.first; it != range.second; ++it) {
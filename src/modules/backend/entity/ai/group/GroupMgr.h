@@ -6,6 +6,7 @@
 
 #include "core/Trace.h"
 #include "core/concurrent/Lock.h"
+#include "core/concurrent/Atomic.h"
 #include "backend/entity/ai/common/Math.h"
 #include "backend/entity/ai/ICharacter.h"
 #include "backend/entity/ai/AI.h"
@@ -13,6 +14,7 @@
 #include <numeric>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace backend {
 
@@ -23,6 +25,14 @@ namespace backend {
  *
  * Every @ai{Zone} has its own @c GroupMgr instance. It is automatically updated with the zone.
  * The average group position is only updated once per @c update() call.
+ *
+ * Each @c update() call publishes an immutable snapshot of all groups (position, leader and members)
+ * into a double buffer. The read methods that are called from the parallel @c AI ticks use this
+ * snapshot without taking any lock. Only if the groups were modified since the last @c update() call,
+ * the read methods fall back to the locked data to return the current state.
+ *
+ * @note A snapshot is valid until the next but one @c update() call - the zone is only updating the
+ * @c GroupMgr after all @c AI instances were ticked.
  */
 class GroupMgr {
 private:
@@ -46,6 +56,30 @@ private:
 	Groups _groups core_thread_guarded_by(_lock);
 	GroupMembers _groupMembers core_thread_guarded_by(_lock);
 
+	struct GroupSnapshot {
+		GroupId id;
+		AIPtr leader;
+		glm::vec3 position;
+		std::vector<AIPtr> members;
+	};
+	struct Snapshot {
+		/** sorted by group id */
+		std::vector<GroupSnapshot> groups;
+		/** sorted by ai pointer - a member is in here once for each group */
+		std::vector<std::pair<const AI*, GroupId>> memberships;
+
+		const GroupSnapshot* find(GroupId id) const;
+	};
+	Snapshot _snapshots[2];
+	core::AtomicInt _currentSnapshot { 0 };
+	/**
+	 * @c true if the groups were modified after the last snapshot was published
+	 */
+	core::AtomicBool _dirty { true };
+
+	const Snapshot* snapshot() const;
+	void publishSnapshot();
+
 public:
 	GroupMgr () {
 	}
@@ -117,6 +151,17 @@ public:
 	 */
 	template<typename Func>
 	void visit(GroupId id, Func& func) const {
+		if (const Snapshot* s = snapshot()) {
+			const GroupSnapshot* group = s->find(id);
+			if (group == nullptr) {
+				return;
+			}
+			for (const AIPtr& chr : group->members) {
+				if (!func(chr))
+					break;
+			}
+			return;
+		}
 		core::ScopedLock scopedLock(_lock);
 		const GroupsConstIter& i = _groups.find(id);
 		if (i == _groups.end()) {
@@ -5,6 +5,7 @@
 
 #include "LUASteering.h"
 #include "backend/entity/ai/LUAFunctions.h"
+#include "backend/entity/ai/LUAAIRegistry.h"
 #include "core/Log.h"
 #include "backend/entity/ai/AI.h"
 #include "backend/entity/ai/common/Math.h"
@@ -14,79 +15,78 @@ namespace movement {
 
 MoveVector LUASteering::executeLUA(const AIPtr& entity, float speed) const {
 	// get userdata of the behaviour tree steering
-	const core::String name = "__meta_steering_" + _type;
-	lua_getfield(_s, LUA_REGISTRYINDEX, name.c_str());
+	const char *name = _metaName.c_str();
+	lua_State* s = _registry->pushFactory(_slot, name);
 #if AI_LUA_SANTITY > 0
-	if (lua_isnil(_s, -1)) {
-		Log::error("LUA steering: could not find lua userdata for %s", name.c_str());
+	if (lua_isnil(s, -1)) {
+		Log::error("LUA steering: could not find lua userdata for %s", name);
 		return MoveVector::Invalid;
 	}
 #endif
 	// get metatable
-	lua_getmetatable(_s, -1);
+	lua_getmetatable(s, -1);
 #if AI_LUA_SANTITY > 0
-	if (!lua_istable(_s, -1)) {
-		Log::error("LUA steering: userdata for %s doesn't have a metatable assigned", name.c_str());
+	if (!lua_istable(s, -1)) {
+		Log::error("LUA steering: userdata for %s doesn't have a metatable assigned", name);
 		return MoveVector::Invalid;
 	}
 #endif
 	// get execute() method
-	lua_getfield(_s, -1, "execute");
-	if (!lua_isfunction(_s, -1)) {
-		Log::error("LUA steering: metatable for %s doesn't have the execute() function assigned", name.c_str());
+	lua_getfield(s, -1, "execute");
+	if (!lua_isfunction(s, -1)) {
+		Log::error("LUA steering: metatable for %s doesn't have the execute() function assigned", name);
 		return MoveVector::Invalid;
 	}
 
 	// push self onto the stack
-	lua_getfield(_s, LUA_REGISTRYINDEX, name.c_str());
+	lua_pushvalue(s, -3);
 
 	// first parameter is ai
-	if (luaAI_pushai(_s, entity) == 0) {
+	if (luaAI_pushai(s, entity) == 0) {
 		return MoveVector::Invalid;
 	}
 
 	// second parameter is speed
-	lua_pushnumber(_s, speed);
+	lua_pushnumber(s, speed);
 
 #if AI_LUA_SANTITY > 0
-	if (!lua_isfunction(_s, -4)) {
+	if (!lua_isfunction(s, -4)) {
 		Log::error("LUA steering: expected to find a function on stack -4");
 		return MoveVector::Invalid;
 	}
-	if (!lua_isuserdata(_s, -3)) {
+	if (!lua_isuserdata(s, -3)) {
 		Log::error("LUA steering: expected to find the userdata on -3");
 		return MoveVector::Invalid;
 	}
-	if (!lua_isuserdata(_s, -2)) {
+	if (!lua_isuserdata(s, -2)) {
 		Log::error("LUA steering: second parameter should be the ai");
 		return MoveVector::Invalid;
 	}
-	if (!lua_isnumber(_s, -1)) {
+	if (!lua_isnumber(s, -1)) {
 		Log::error("LUA steering: first parameter should be the speed");
 		return MoveVector::Invalid;
 	}
 #endif
-	const int error = lua_pcall(_s, 3, 4, 0);
+	const int error = lua_pcall(s, 3, 4, 0);
 	if (error) {
-		Log::error("LUA steering script: %s", lua_isstring(_s, -1) ? lua_tostring(_s, -1) : "Unknown Error");
+		Log::error("LUA steering script: %s", lua_isstring(s, -1) ? lua_tostring(s, -1) : "Unknown Error");
 		// reset stack
-		lua_pop(_s, lua_gettop(_s));
+		lua_pop(s, lua_gettop(s));
 		return MoveVector::Invalid;
 	}
 	// we get four values back, the direction vector and the
-	const lua_Number x = luaL_checknumber(_s, -1);
-	const lua_Number y = luaL_checknumber(_s, -2);
-	const lua_Number z = luaL_checknumber(_s, -3);
-	const lua_Number rotation = luaL_checknumber(_s, -4);
+	const lua_Number x = luaL_checknumber(s, -1);
+	const lua_Number y = luaL_checknumber(s, -2);
+	const lua_Number z = luaL_checknumber(s, -3);
+	const lua_Number rotation = luaL_checknumber(s, -4);
 
 	// reset stack
-	lua_pop(_s, lua_gettop(_s));
+	lua_pop(s, lua_gettop(s));
 	return MoveVector(glm::vec3((float)x, (float)y, (float)z), (float)rotation);
 }
 
-LUASteering::LUASteering(lua_State* s, const core::String& type) :
-		ISteering(), _s(s) {
-	_type = type;
+LUASteering::LUASteering(LUAAIRegistry* registry, const core::String& type, int slot) :
+		ISteering(), _registry(registry), _type(type), _metaName("__meta_steering_" + type), _slot(slot) {
 }
 
 MoveVector LUASteering::execute(const AIPtr& entity, float speed) const {
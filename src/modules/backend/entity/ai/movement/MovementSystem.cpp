@@ -0,0 +1,168 @@
+/**
+ * @file
+ */
+
+#include "MovementSystem.h"
+#include "backend/entity/ai/AI.h"
+#include "backend/entity/ai/ICharacter.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/constants.hpp>
+
+namespace backend {
+namespace movement {
+
+bool MovementSystem::add(const AIPtr& ai) {
+	if (ai->_movementSlot != InvalidSlot) {
+		return false;
+	}
+	uint32_t slot;
+	if (_freeSlots.empty()) {
+		slot = (uint32_t)_characters.size();
+		const size_t size = _characters.size() + 1;
+		_characters.resize(size, nullptr);
+		_active.resize(size, 0u);
+		_steeringCount.resize(size, 0u);
+		_posX.resize(size);
+		_posY.resize(size);
+		_posZ.resize(size);
+		_orientation.resize(size);
+		_speed.resize(size);
+		_deltaSeconds.resize(size);
+		const size_t steeringSize = size * MaxSteerings;
+		_type.resize(steeringSize);
+		_weight.resize(steeringSize);
+		_rotation.resize(steeringSize);
+		_targetX.resize(steeringSize);
+		_targetY.resize(steeringSize);
+		_targetZ.resize(steeringSize);
+	} else {
+		slot = _freeSlots.back();
+		_freeSlots.pop_back();
+	}
+	ai->_movementSlot = slot;
+	return true;
+}
+
+bool MovementSystem::remove(const AIPtr& ai) {
+	const uint32_t slot = ai->_movementSlot;
+	if (slot == InvalidSlot) {
+		return false;
+	}
+	_characters[slot] = nullptr;
+	_active[slot] = 0u;
+	_freeSlots.push_back(slot);
+	ai->_movementSlot = InvalidSlot;
+	return true;
+}
+
+bool MovementSystem::submit(const AIPtr& ai, float speed, int64_t deltaMillis, const BatchedSteering* steerings, int amount) {
+	core_assert(amount > 0 && amount <= MaxSteerings);
+	const uint32_t slot = ai->_movementSlot;
+	if (slot == InvalidSlot || !ai->_character) {
+		return false;
+	}
+	ICharacter* chr = ai->_character.get();
+	const glm::vec3& pos = chr->getPosition();
+	_characters[slot] = chr;
+	_active[slot] = 1u;
+	_steeringCount[slot] = (uint8_t)amount;
+	_posX[slot] = pos.x;
+	_posY[slot] = pos.y;
+	_posZ[slot] = pos.z;
+	_orientation[slot] = chr->getOrientation();
+	_speed[slot] = speed;
+	_deltaSeconds[slot] = static_cast<float>(deltaMillis) / 1000.0f;
+	const size_t offset = (size_t)slot * MaxSteerings;
+	for (int i = 0; i < amount; ++i) {
+		const BatchedSteering& steering = steerings[i];
+		_type[offset + i] = steering.type;
+		_weight[offset + i] = steering.weight;
+		_rotation[offset + i] = steering.rotation;
+		_targetX[offset + i] = steering.target.x;
+		_targetY[offset + i] = steering.target.y;
+		_targetZ[offset + i] = steering.target.z;
+	}
+	return true;
+}
+
+void MovementSystem::update() {
+	core_trace_scoped(MovementSystemUpdate);
+	const size_t n = _characters.size();
+	for (size_t slot = 0; slot < n; ++slot) {
+		if (_active[slot] == 0u) {
+			continue;
+		}
+		_active[slot] = 0u;
+
+		const float px = _posX[slot];
+		const float py = _posY[slot];
+		const float pz = _posZ[slot];
+		const float orientation = _orientation[slot];
+		const float speed = _speed[slot];
+		float vx = 0.0f;
+		float vy = 0.0f;
+		float vz = 0.0f;
+		float angular = 0.0f;
+		float totalWeight = 0.0f;
+		bool reached = false;
+
+		const size_t offset = slot * MaxSteerings;
+		const int amount = _steeringCount[slot];
+		for (int i = 0; i < amount; ++i) {
+			const size_t idx = offset + i;
+			const float weight = _weight[idx];
+			// only the last steering decides whether the target was reached - see WeightedSteering::execute()
+			reached = false;
+			if (_type[idx] == BatchedSteeringType::Wander) {
+				vx += glm::cos(orientation) * speed * weight;
+				vz += glm::sin(orientation) * speed * weight;
+				angular += _rotation[idx] * weight;
+				totalWeight += weight;
+				continue;
+			}
+			const float sign = _type[idx] == BatchedSteeringType::Seek ? 1.0f : -1.0f;
+			const float dx = (_targetX[idx] - px) * sign;
+			const float dy = (_targetY[idx] - py) * sign;
+			const float dz = (_targetZ[idx] - pz) * sign;
+			const float length2 = dx * dx + dy * dy + dz * dz;
+			if (length2 <= glm::epsilon<float>()) {
+				reached = true;
+				continue;
+			}
+			const float scale = glm::inversesqrt(length2);
+			const float s = speed * weight * scale;
+			vx += dx * s;
+			vy += dy * s;
+			vz += dz * s;
+			angular += glm::atan(dz * scale, dx * scale) * weight;
+			totalWeight += weight;
+		}
+		if (reached || totalWeight <= 0.0f) {
+			continue;
+		}
+
+		const float scale = 1.0f / totalWeight;
+		const float dt = _deltaSeconds[slot];
+		const float rotation = glm::mod(angular * scale, glm::two_pi<float>());
+		const float src = orientation - glm::pi<float>();
+		const float dest = rotation - glm::pi<float>();
+		ICharacter* chr = _characters[slot];
+		chr->setPosition(glm::vec3(px + vx * scale * dt, py + vy * scale * dt, pz + vz * scale * dt));
+		chr->setOrientation(src + (dest - src) * dt + glm::pi<float>());
+	}
+}
+
+size_t MovementSystem::submitted() const {
+	size_t amount = 0u;
+	for (uint8_t active : _active) {
+		amount += active;
+	}
+	return amount;
+}
+
+}
+}
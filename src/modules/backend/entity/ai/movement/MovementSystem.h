@@ -0,0 +1,122 @@
+/**
+ * @file
+ */
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+namespace backend {
+
+class AI;
+typedef std::shared_ptr<AI> AIPtr;
+class ICharacter;
+
+namespace movement {
+
+enum class BatchedSteeringType : uint8_t {
+	Wander, Seek, Flee
+};
+
+/**
+ * @brief The input of one steering for the batched evaluation in the @c MovementSystem
+ * @sa ISteering::batch()
+ */
+struct BatchedSteering {
+	BatchedSteeringType type = BatchedSteeringType::Wander;
+	float weight = 1.0f;
+	/**
+	 * @brief The rotation for @c BatchedSteeringType::Wander
+	 */
+	float rotation = 0.0f;
+	/**
+	 * @brief The target for @c BatchedSteeringType::Seek and @c BatchedSteeringType::Flee
+	 */
+	glm::vec3 target { 0.0f };
+};
+
+/**
+ * @brief Data oriented evaluation of the @c WeightedSteering of all characters of a @c Zone
+ *
+ * Every @c AI of the zone owns a slot in contiguous arrays (struct of arrays) for the position,
+ * orientation, speed and the steering inputs. The @c Steer nodes only fill their slot while the
+ * behaviour trees are executed - this doesn't need any locking as every @c AI is only executed by
+ * one worker. The steerings of all slots are evaluated in one tight loop without virtual calls and
+ * the movement is integrated for all characters at once. The results are written back to the
+ * @c ICharacter instances only once per tick in @c update().
+ *
+ * This produces the same movement as @c WeightedSteering::execute() followed by the integration
+ * in @c Steer::doAction().
+ */
+class MovementSystem {
+public:
+	static constexpr int MaxSteerings = 4;
+	static constexpr uint32_t InvalidSlot = (uint32_t)-1;
+
+private:
+	// per slot
+	std::vector<ICharacter*> _characters;
+	std::vector<uint8_t> _active;
+	std::vector<uint8_t> _steeringCount;
+	std::vector<float> _posX;
+	std::vector<float> _posY;
+	std::vector<float> _posZ;
+	std::vector<float> _orientation;
+	std::vector<float> _speed;
+	std::vector<float> _deltaSeconds;
+
+	// per slot and steering - MaxSteerings entries for each slot
+	std::vector<BatchedSteeringType> _type;
+	std::vector<float> _weight;
+	std::vector<float> _rotation;
+	std::vector<float> _targetX;
+	std::vector<float> _targetY;
+	std::vector<float> _targetZ;
+
+	std::vector<uint32_t> _freeSlots;
+
+public:
+	/**
+	 * @brief Reserves a slot for the given @c AI
+	 * @note Must not be called in parallel to @c submit() or @c update()
+	 */
+	bool add(const AIPtr& ai);
+	/**
+	 * @note Must not be called in parallel to @c submit() or @c update()
+	 */
+	bool remove(const AIPtr& ai);
+
+	/**
+	 * @brief Queue the steerings of a character for the next @c update()
+	 *
+	 * @note This is called from the behaviour tree execution in the zone workers. This is safe as long
+	 * as the steerings of an @c AI are submitted by only one thread at a time.
+	 * @note Submitting again in the same tick replaces the previous steerings of the @c AI
+	 * @return @c false if the @c AI doesn't have a slot in this system
+	 */
+	bool submit(const AIPtr& ai, float speed, int64_t deltaMillis, const BatchedSteering* steerings, int amount);
+
+	/**
+	 * @brief Evaluates all submitted steerings and moves the characters
+	 * @note Must not be called in parallel to @c submit()
+	 */
+	void update();
+
+	/**
+	 * @return The amount of @c AI instances with a slot in this system
+	 */
+	size_t size() const;
+	/**
+	 * @return The amount of characters that were submitted since the last @c update()
+	 */
+	size_t submitted() const;
+};
+
+inline size_t MovementSystem::size() const {
+	return _characters.size() - _freeSlots.size();
+}
+
+}
+}
@@ -32,6 +32,13 @@ bool SelectionSteering::getSelectionTarget(const AIPtr& entity, size_t index, gl
 	return true;
 }
 
+MoveVectorState ISteering::seekState(const glm::vec3& pos, const glm::vec3& target) const {
+	if (glm::length2(target - pos) <= glm::epsilon<float>()) {
+		return MoveVectorState::TargetReached;
+	}
+	return MoveVectorState::Valid;
+}
+
 MoveVector ISteering::seek(const glm::vec3& pos, const glm::vec3& target, float speed) const {
 	const glm::vec3& dist = target - pos;
 	const float dot = glm::length2(dist);
@@ -15,6 +15,8 @@ typedef std::shared_ptr<AI> AIPtr;
 
 namespace movement {
 
+struct BatchedSteering;
+
 #define STEERING_FACTORY(SteeringName) \
 public: \
 	class Factory: public ISteeringFactory { \
@@ -54,7 +56,28 @@ public:
 	 */
 	virtual MoveVector execute (const AIPtr& ai, float speed) const = 0;
 
+	/**
+	 * @return @c true if this steering can be evaluated in a batch by the @c MovementSystem.
+	 * @c execute() is used otherwise.
+	 */
+	virtual bool canBatch() const {
+		return false;
+	}
+
+	/**
+	 * @brief Fills the input for the batched evaluation in the @c MovementSystem
+	 * @note Only called if @c canBatch() returned @c true
+	 * @return The state of the @c MoveVector that @c execute() would return
+	 */
+	virtual MoveVectorState batch(const AIPtr& /*ai*/, BatchedSteering& /*steering*/) const {
+		return MoveVectorState::Invalid;
+	}
+
 	MoveVector seek(const glm::vec3& pos, const glm::vec3& target, float speed) const;
+	/**
+	 * @return The state of the @c MoveVector that @c seek() or @c flee() would return
+	 */
+	MoveVectorState seekState(const glm::vec3& pos, const glm::vec3& target) const;
 	inline MoveVector flee(const glm::vec3& pos, const glm::vec3& target, float speed) const {
 		return seek(target, pos, speed);
 	}
@@ -3,6 +3,7 @@
  */
 
 #include "TargetFlee.h"
+#include "MovementSystem.h"
 #include "backend/entity/ai/AI.h"
 #include "backend/entity/ai/common/Math.h"
 
@@ -26,5 +27,15 @@ MoveVector TargetFlee::execute (const AIPtr& ai, float speed) const {
 
 }
 
+bool TargetFlee::canBatch() const {
+	return isValid();
+}
+
+MoveVectorState TargetFlee::batch(const AIPtr& ai, BatchedSteering& steering) const {
+	steering.type = BatchedSteeringType::Flee;
+	steering.target = _target;
+	return seekState(ai->getCharacter()->getPosition(), _target);
+}
+
 }
 }
@@ -3,6 +3,7 @@
  */
 
 #include "TargetSeek.h"
+#include "MovementSystem.h"
 #include "backend/entity/ai/AI.h"
 #include "backend/entity/ai/common/Math.h"
 
@@ -26,5 +27,15 @@ MoveVector TargetSeek::execute (const AIPtr& ai, float speed) const {
 
 }
 
+bool TargetSeek::canBatch() const {
+	return isValid();
+}
+
+MoveVectorState TargetSeek::batch(const AIPtr& ai, BatchedSteering& steering) const {
+	steering.type = BatchedSteeringType::Seek;
+	steering.target = _target;
+	return seekState(ai->getCharacter()->getPosition(), _target);
+}
+
 }
 }
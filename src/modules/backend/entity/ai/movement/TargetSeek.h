@@ -23,6 +23,8 @@ public:
 	inline bool isValid () const;
 
 	virtual MoveVector execute (const AIPtr& ai, float speed) const override;
+	bool canBatch() const override;
+	MoveVectorState batch(const AIPtr& ai, BatchedSteering& steering) const override;
 };
 
 }
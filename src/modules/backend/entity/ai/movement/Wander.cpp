@@ -3,6 +3,7 @@
  */
 
 #include "Wander.h"
+#include "MovementSystem.h"
 #include "core/StringUtil.h"
 #include "backend/entity/ai/AI.h"
 #include "backend/entity/ai/common/Math.h"
@@ -26,5 +27,15 @@ MoveVector Wander::execute (const AIPtr& ai, float speed) const {
 	return MoveVector(v * speed, chr->random().randomBinomial() * _rotation);
 }
 
+bool Wander::canBatch() const {
+	return true;
+}
+
+MoveVectorState Wander::batch(const AIPtr& ai, BatchedSteering& steering) const {
+	steering.type = BatchedSteeringType::Wander;
+	steering.rotation = ai->getCharacter()->random().randomBinomial() * _rotation;
+	return MoveVectorState::Valid;
+}
+
 }
 }
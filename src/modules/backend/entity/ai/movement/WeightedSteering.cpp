@@ -3,6 +3,7 @@
  */
 
 #include "WeightedSteering.h"
+#include "MovementSystem.h"
 #include "backend/entity/ai/AI.h"
 #include "backend/entity/ai/common/Math.h"
 #include "common/MoveVector.h"
@@ -20,7 +21,13 @@ WeightedData::WeightedData(const SteeringPtr& _steering, float _weight) :
 }
 
 WeightedSteering::WeightedSteering(const WeightedSteerings& steerings) :
-		_steerings(steerings) {
+		_steerings(steerings), _batchable(!steerings.empty() && (int)steerings.size() <= MovementSystem::MaxSteerings) {
+	for (const WeightedData& wd : _steerings) {
+		if (!wd.steering->canBatch()) {
+			_batchable = false;
+			break;
+		}
+	}
 }
 
 MoveVector WeightedSteering::execute (const AIPtr& ai, float speed) const {
@@ -52,5 +59,24 @@ MoveVector WeightedSteering::execute (const AIPtr& ai, float speed) const {
 	return MoveVector(vecBlended * scale, glm::mod(angularBlended * scale, glm::two_pi<float>()));
 }
 
+bool WeightedSteering::submit(const AIPtr& ai, float speed, int64_t deltaMillis, MovementSystem& movementSystem, MoveVectorState& state) const {
+	if (!_batchable) {
+		return false;
+	}
+	BatchedSteering steerings[MovementSystem::MaxSteerings];
+	int amount = 0;
+	state = MoveVectorState::Invalid;
+	for (const WeightedData& wd : _steerings) {
+		BatchedSteering& steering = steerings[amount++];
+		// only the last steering decides about the state - see execute()
+		state = wd.steering->batch(ai, steering);
+		steering.weight = wd.weight;
+	}
+	if (state != MoveVectorState::Valid) {
+		return true;
+	}
+	return movementSystem.submit(ai, speed, deltaMillis, steerings, amount);
+}
+
 }
 }
@@ -9,6 +9,8 @@
 namespace backend {
 namespace movement {
 
+class MovementSystem;
+
 /**
  * @brief Steering and weight as input for @c WeightedSteering
  */
@@ -27,10 +29,20 @@ typedef WeightedSteerings::const_iterator WeightedSteeringsIter;
 class WeightedSteering {
 private:
 	WeightedSteerings _steerings;
+	bool _batchable;
 public:
 	explicit WeightedSteering(const WeightedSteerings& steerings);
 
 	MoveVector execute (const AIPtr& ai, float speed) const;
+
+	/**
+	 * @brief Submit the steerings to the @c MovementSystem instead of evaluating them directly
+	 * @param[out] state The state of the @c MoveVector that @c execute() would return. The steerings
+	 * are only submitted if this is @c MoveVectorState::Valid - nothing is moved otherwise.
+	 * @return @c false if at least one of the steerings can't be evaluated in a batch. Use
+	 * @c execute() in this case.
+	 */
+	bool submit(const AIPtr& ai, float speed, int64_t deltaMillis, MovementSystem& movementSystem, MoveVectorState& state) const;
 };
 
 }
@@ -14,28 +14,24 @@ AIServerNetwork::AIServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandl
 		Super(protocolHandlerRegistry, eventBus, metric) {
 }
 
-bool AIServerNetwork::packetReceived(ENetEvent& event) {
-	flatbuffers::Verifier v(event.packet->data, event.packet->dataLength);
+ProtocolHandlerPtr AIServerNetwork::route(const ENetPacket* packet, const void** message, const char** msgType) {
+	flatbuffers::Verifier v(packet->data, packet->dataLength);
 
 	if (!ai::VerifyAIRootMessageBuffer(v)) {
-		Log::error("Illegal ai packet received with length: %i", (int)event.packet->dataLength);
-		return false;
+		Log::error("Illegal ai packet received with length: %i", (int)packet->dataLength);
+		return ProtocolHandlerPtr();
 	}
-	const ai::AIRootMessage *req = ai::GetAIRootMessage(event.packet->data);
+	const ai::AIRootMessage *req = ai::GetAIRootMessage(packet->data);
 	ai::MsgType type = req->data_type();
 	const char *clientMsgType = ai::EnumNameMsgType(type);
-	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(type);
+	const ProtocolHandlerPtr& handler = _protocolHandlerRegistry->getHandler(type);
 	if (!handler) {
 		Log::error("No handler for ai msg type %s", clientMsgType);
-		return false;
+		return ProtocolHandlerPtr();
 	}
-	const metric::TagMap& tags  {{"direction", "in"}, {"type", clientMsgType}};
-	_metric->count("network_packet_count", 1, tags);
-	_metric->count("network_packet_size", (int)event.packet->dataLength, tags);
-
-	Log::debug("Received %s", clientMsgType);
-	handler->executeWithRaw(event.peer, req->data(), (const uint8_t*)event.packet->data, event.packet->dataLength);
-	return true;
+	*message = req->data();
+	*msgType = clientMsgType;
+	return handler;
 }
 
 }
@@ -11,11 +11,11 @@ namespace network {
 class AIServerNetwork : public AbstractServerNetwork {
 private:
 	using Super = AbstractServerNetwork;
+protected:
+	ProtocolHandlerPtr route(const ENetPacket* packet, const void** message, const char** msgType) override;
 public:
 	AIServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry,
 			const core::EventBusPtr& eventBus, const metric::MetricPtr& metric);
-
-	bool packetReceived(ENetEvent& event) override;
 };
 
 typedef std::shared_ptr<AIServerNetwork> AIServerNetworkPtr;
@@ -9,22 +9,27 @@
 
 namespace backend {
 
+class LUAAIRegistry;
+
 /**
  * @see @ai{LUAAIRegistry}
  */
 class LUATreeNode : public TreeNode {
 protected:
-	lua_State* _s;
+	LUAAIRegistry* _registry;
+	core::String _metaName;
+	int _slot;
 
 	ai::TreeNodeStatus runLUA(const AIPtr& entity, int64_t deltaMillis);
 
 public:
 	class LUATreeNodeFactory : public ITreeNodeFactory {
 	private:
-		lua_State* _s;
+		LUAAIRegistry* _registry;
 		core::String _type;
+		int _slot;
 	public:
-		LUATreeNodeFactory(lua_State* s, const core::String& typeStr);
+		LUATreeNodeFactory(LUAAIRegistry* registry, const core::String& typeStr, int slot);
 
 		inline const core::String& type() const {
 			return _type;
@@ -33,7 +38,7 @@ public:
 		TreeNodePtr create(const TreeNodeFactoryContext* ctx) const override;
 	};
 
-	LUATreeNode(const core::String& name, const core::String& parameters, const ConditionPtr& condition, lua_State* s, const core::String& type);
+	LUATreeNode(const core::String& name, const core::String& parameters, const ConditionPtr& condition, LUAAIRegistry* registry, const core::String& type, int slot);
 	~LUATreeNode();
 
 	ai::TreeNodeStatus execute(const AIPtr& entity, int64_t deltaMillis) override;
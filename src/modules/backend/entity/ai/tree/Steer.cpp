@@ -6,6 +6,7 @@
 #include "backend/entity/ai/common/Math.h"
 #include "backend/entity/ai/common/Random.h"
 #include "backend/entity/ai/AI.h"
+#include "backend/entity/ai/zone/Zone.h"
 #include "core/StringUtil.h"
 #include "core/GLM.h"
 #include "core/Assert.h"
@@ -43,6 +44,15 @@ TreeNodePtr Steer::Factory::create (const SteerNodeFactoryContext *ctx) const {
 ai::TreeNodeStatus Steer::doAction(const AIPtr& entity, int64_t deltaMillis) {
 	const ICharacterPtr& chr = entity->getCharacter();
 	const double speed = chr->getCurrent(attrib::Type::SPEED);
+	Zone* zone = entity->getZone();
+	MoveVectorState state;
+	if (zone != nullptr && _w.submit(entity, (float)speed, deltaMillis, zone->getMovementSystem(), state)) {
+		// the movement is applied for all characters of the zone at once at the end of the tick
+		if (state == MoveVectorState::Invalid) {
+			return ai::TreeNodeStatus::FAILED;
+		}
+		return ai::TreeNodeStatus::FINISHED;
+	}
 	const MoveVector& mv = _w.execute(entity, (float)speed);
 	if (mv.isTargetReached()) {
 		return ai::TreeNodeStatus::FINISHED;
@@ -7,13 +7,40 @@
 #include "backend/entity/ai/condition/ICondition.h"
 #include "core/Assert.h"
 #include "core/Algorithm.h"
+#include "core/Trace.h"
+#include "core/concurrent/Lock.h"
 
 namespace backend {
 
+core::AtomicInt TreeNode::_revision { 0 };
+
+static core_trace_mutex(core::Lock, _compileLock, "TreeNodeCompile");
+
 int TreeNode::getId() const {
 	return _id;
 }
 
+void TreeNode::compile_r(int& index) {
+	if (_index < 0) {
+		_index = index++;
+	}
+	for (const TreeNodePtr& child : _children) {
+		child->compile_r(index);
+	}
+}
+
+void TreeNode::compile(TreeNode* root) {
+	core_trace_scoped(TreeNodeCompile);
+	// the same tree is shared by several ai instances - only compile it once
+	core::ScopedLock lock(_compileLock);
+	const int revision = _revision;
+	if (root->_compiledRevision == revision) {
+		return;
+	}
+	root->compile_r(root->_compiledNodes);
+	root->_compiledRevision = revision;
+}
+
 void TreeNode::setName(const core::String& name) {
 	if (name.empty()) {
 		return;
@@ -51,6 +78,7 @@ TreeNodes& TreeNode::getChildren() {
 
 bool TreeNode::addChild(const TreeNodePtr& child) {
 	_children.push_back(child);
+	_revision.increment(1);
 	return true;
 }
 
@@ -71,38 +99,46 @@ void TreeNode::setLastExecMillis(const AIPtr& entity) {
 	if (!entity->_debuggingActive) {
 		return;
 	}
-	entity->_lastExecMillis.put(getId(), entity->_time);
+	if (AI::NodeState* nodeState = entity->nodeState(_index)) {
+		nodeState->lastExecMillis = entity->_time;
+	}
 }
 
 int TreeNode::getSelectorState(const AIPtr& entity) const {
-	auto i = entity->_selectorStates.find(getId());
-	if (i == entity->_selectorStates.end()) {
+	const AI::NodeState* nodeState = entity->nodeState(_index);
+	if (nodeState == nullptr) {
 		return AI_NOTHING_SELECTED;
 	}
-	return i->second;
+	return nodeState->selectorState;
 }
 
 void TreeNode::setSelectorState(const AIPtr& entity, int selected) {
-	entity->_selectorStates.put(getId(), selected);
+	if (AI::NodeState* nodeState = entity->nodeState(_index)) {
+		nodeState->selectorState = selected;
+	}
 }
 
 int TreeNode::getLimitState(const AIPtr& entity) const {
-	auto i = entity->_limitStates.find(getId());
-	if (i == entity->_limitStates.end()) {
+	const AI::NodeState* nodeState = entity->nodeState(_index);
+	if (nodeState == nullptr) {
 		return 0;
 	}
-	return i->second;
+	return nodeState->limitState;
 }
 
 void TreeNode::setLimitState(const AIPtr& entity, int amount) {
-	entity->_limitStates.put(getId(), amount);
+	if (AI::NodeState* nodeState = entity->nodeState(_index)) {
+		nodeState->limitState = amount;
+	}
 }
 
 ai::TreeNodeStatus TreeNode::state(const AIPtr& entity, ai::TreeNodeStatus treeNodeState) {
 	if (!entity->_debuggingActive) {
 		return treeNodeState;
 	}
-	entity->_lastStatus.put(getId(), treeNodeState);
+	if (AI::NodeState* nodeState = entity->nodeState(_index)) {
+		nodeState->lastStatus = treeNodeState;
+	}
 	return treeNodeState;
 }
 
@@ -110,22 +146,22 @@ int64_t TreeNode::getLastExecMillis(const AIPtr& entity) const {
 	if (!entity->_debuggingActive) {
 		return -1L;
 	}
-	auto i = entity->_lastExecMillis.find(getId());
-	if (i == entity->_lastExecMillis.end()) {
+	const AI::NodeState* nodeState = entity->nodeState(_index);
+	if (nodeState == nullptr) {
 		return -1L;
 	}
-	return i->second;
+	return nodeState->lastExecMillis;
 }
 
 ai::TreeNodeStatus TreeNode::getLastStatus(const AIPtr& entity) const {
 	if (!entity->_debuggingActive) {
 		return ai::TreeNodeStatus::UNKNOWN;
 	}
-	auto i = entity->_lastStatus.find(getId());
-	if (i == entity->_lastStatus.end()) {
+	const AI::NodeState* nodeState = entity->nodeState(_index);
+	if (nodeState == nullptr) {
 		return ai::TreeNodeStatus::UNKNOWN;
 	}
-	return i->second;
+	return nodeState->lastStatus;
 }
 
 TreeNodePtr TreeNode::getChild(int id) const {
@@ -147,6 +183,7 @@ bool TreeNode::replaceChild(int id, const TreeNodePtr& newNode) {
 		return false;
 	}
 
+	_revision.increment(1);
 	if (newNode) {
 		*i = newNode;
 		return true;
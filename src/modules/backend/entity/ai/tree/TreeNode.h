@@ -7,6 +7,7 @@
 #include "backend/entity/ai/common/MemoryAllocator.h"
 #include "AIMessages_generated.h"
 #include "core/String.h"
+#include "core/concurrent/Atomic.h"
 
 #include <vector>
 #include <memory>
@@ -71,6 +72,21 @@ protected:
 	 * @brief Every node has an id to identify it. It's unique per type.
 	 */
 	int _id;
+	/**
+	 * @brief The dense index of this node in the compiled behaviour tree. The per @c AI node
+	 * states are stored in an array at this index.
+	 * @sa compile()
+	 */
+	int _index = -1;
+	/**
+	 * @brief The amount of indices that were assigned if this node is the root of a compiled tree
+	 */
+	int _compiledNodes = 0;
+	core::AtomicInt _compiledRevision { -1 };
+	/**
+	 * @brief Increased with every change of the tree structure of any tree
+	 */
+	static core::AtomicInt _revision;
 	TreeNodes _children;
 	core::String _name;
 	core::String _type;
@@ -85,6 +101,7 @@ protected:
 	void setLastExecMillis(const AIPtr& entity);
 
 	TreeNodePtr getParent_r(const TreeNodePtr& parent, int id) const;
+	void compile_r(int& index);
 
 public:
 	/**
@@ -104,6 +121,25 @@ public:
 	 */
 	int getId() const;
 
+	/**
+	 * @brief Assigns a dense index to every node of the given tree. The per @c AI states of the nodes
+	 * are stored in a flat array that is indexed by this value - see @c AI::nodeState()
+	 *
+	 * Nodes that were added after the last compilation get new indices appended, the indices of
+	 * the existing nodes don't change. Calling this for an already compiled tree is cheap.
+	 *
+	 * @note A node must not be part of more than one tree.
+	 */
+	static void compile(TreeNode* root);
+	/**
+	 * @return @c true if the tree structure was not modified after the last @c compile() call
+	 */
+	bool isCompiled() const;
+	/**
+	 * @return The amount of node states an @c AI needs to execute this tree
+	 */
+	int compiledNodes() const;
+
 	/**
 	 * @brief Each node can have a user defines name that can be retrieved with this method.
 	 */
@@ -173,4 +209,12 @@ public:
 	TreeNodePtr getParent(const TreeNodePtr& self, int id) const;
 };
 
+inline bool TreeNode::isCompiled() const {
+	return _compiledRevision == _revision;
+}
+
+inline int TreeNode::compiledNodes() const {
+	return _compiledNodes;
+}
+
 }
@@ -0,0 +1,134 @@
+/**
+ * @file
+ */
+
+#include "AIScheduler.h"
+#include "backend/entity/ai/AI.h"
+#include "core/StringUtil.h"
+#include "core/Log.h"
+
+namespace backend {
+
+bool AIScheduler::setTiers(const core::String& tiers) {
+	core::DynamicArray<core::String> tokens;
+	core::string::splitString(tiers, tokens);
+	if (tokens.empty() || (int)tokens.size() > MaxTiers) {
+		Log::warn("Invalid amount of ai scheduler tiers given: '%s'", tiers.c_str());
+		return false;
+	}
+	Tier parsed[MaxTiers];
+	int amount = 0;
+	for (const core::String& token : tokens) {
+		const size_t sep = token.find_first_of(':');
+		if (sep == core::String::npos) {
+			Log::warn("Invalid ai scheduler tier given: '%s' - expected distance:interval", token.c_str());
+			return false;
+		}
+		const int interval = core::string::toInt(token.substr(sep + 1));
+		if (interval <= 0) {
+			Log::warn("Invalid ai scheduler tier interval given: '%s'", token.c_str());
+			return false;
+		}
+		Tier& tier = parsed[amount++];
+		tier.maxDistance = core::string::toFloat(token.substr(0, sep));
+		tier.interval = (uint32_t)interval;
+	}
+	return setTiers(parsed, amount);
+}
+
+bool AIScheduler::setTiers(const Tier* tiers, int amount) {
+	if (amount <= 0 || amount > MaxTiers) {
+		return false;
+	}
+	for (int i = 0; i < amount; ++i) {
+		if (tiers[i].interval == 0u || tiers[i].maxDistance < 0.0f) {
+			Log::warn("Invalid ai scheduler tier %i", i);
+			return false;
+		}
+		if (i == 0) {
+			continue;
+		}
+		// only the last tier may have an unlimited distance
+		const bool unlimited = tiers[i - 1].maxDistance <= 0.0f;
+		if (unlimited || (tiers[i].maxDistance > 0.0f && tiers[i].maxDistance <= tiers[i - 1].maxDistance)) {
+			Log::warn("The ai scheduler tier distances must be ascending (tier %i)", i);
+			return false;
+		}
+	}
+	for (int i = 0; i < amount; ++i) {
+		_tiers[i] = tiers[i];
+		_count[i] = 0;
+		_updates[i] = 0;
+		_micros[i] = 0;
+	}
+	_tierCount = amount;
+	return true;
+}
+
+float AIScheduler::maxDistance() const {
+	float distance = 0.0f;
+	for (int i = 0; i < _tierCount; ++i) {
+		if (_tiers[i].maxDistance > distance) {
+			distance = _tiers[i].maxDistance;
+		}
+	}
+	return distance;
+}
+
+void AIScheduler::beginTick() {
+	++_tick;
+	for (int i = 0; i < _tierCount; ++i) {
+		_count[i] = 0;
+		_updates[i] = 0;
+		_micros[i] = 0;
+	}
+}
+
+void AIScheduler::assign(AI& ai, float distance) {
+	int tier = _tierCount - 1;
+	for (int i = 0; i < _tierCount - 1; ++i) {
+		if (distance <= _tiers[i].maxDistance) {
+			tier = i;
+			break;
+		}
+	}
+	// the assignment is for the upcoming tick
+	const uint32_t tick = _tick + 1u;
+	if (ai._scheduledTick == tick && ai._scheduledTier <= tier) {
+		return;
+	}
+	ai._scheduledTick = tick;
+	ai._scheduledTier = tier;
+}
+
+int AIScheduler::schedule(AI& ai, int64_t dt, int64_t& scheduledDt) {
+	const int tier = ai._scheduledTick == _tick ? ai._scheduledTier : _tierCount - 1;
+	++_count[tier];
+	ai._scheduledDt += dt;
+	const uint32_t interval = _tiers[tier].interval;
+	if (interval > 1u) {
+		// spread the ai instances of a tier over the ticks of the interval
+		const uint32_t bucket = (uint32_t)ai.getCharacter()->getId();
+		if ((_tick + bucket) % interval != 0u) {
+			return -1;
+		}
+	}
+	scheduledDt = ai._scheduledDt;
+	ai._scheduledDt = 0;
+	++_updates[tier];
+	return tier;
+}
+
+void AIScheduler::record(int tier, uint64_t micros) {
+	_micros[tier].increment((int)micros);
+}
+
+AIScheduler::TierStats AIScheduler::stats(int tier) const {
+	TierStats stats;
+	stats.count = _count[tier];
+	stats.updates = _updates[tier];
+	stats.micros = _micros[tier];
+	return stats;
+}
+
+}
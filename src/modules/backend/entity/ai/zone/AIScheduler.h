@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @ingroup Zone
+ */
+#pragma once
+
+#include "core/concurrent/Atomic.h"
+#include "core/String.h"
+#include <stdint.h>
+
+namespace backend {
+
+class AI;
+
+/**
+ * @brief Level of detail for the @c AI updates of a @c Zone
+ *
+ * Every @c AI is assigned to a tier by the distance to the nearest player. Each tier has
+ * an update interval in ticks. The @c AI instances of a tier are spread over the ticks of
+ * this interval by their id - this keeps the amount of work per tick stable. The time of
+ * the skipped ticks is accumulated and handed over to the next update of the @c AI.
+ *
+ * By default there is only one tier that updates every @c AI in every tick.
+ *
+ * @note @c assign() and @c beginTick() must be called from the thread that calls @c Zone::update,
+ * while @c schedule() and @c record() are called from the zone workers.
+ */
+class AIScheduler {
+public:
+	static constexpr int MaxTiers = 8;
+
+	struct Tier {
+		/**
+		 * @brief The max distance to the nearest player - @c 0.0f means unlimited
+		 */
+		float maxDistance = 0.0f;
+		/**
+		 * @brief Update the @c AI every n ticks
+		 */
+		uint32_t interval = 1u;
+	};
+
+	struct TierStats {
+		/** the amount of @c AI instances that are assigned to the tier */
+		int count = 0;
+		/** the amount of @c AI instances that were updated in the last tick */
+		int updates = 0;
+		/** the microseconds that were spent in the updates of the last tick */
+		int micros = 0;
+	};
+
+private:
+	Tier _tiers[MaxTiers];
+	int _tierCount = 1;
+	uint32_t _tick = 0u;
+
+	core::AtomicInt _count[MaxTiers];
+	core::AtomicInt _updates[MaxTiers];
+	core::AtomicInt _micros[MaxTiers];
+
+public:
+	/**
+	 * @brief Configure the tiers from a string like @c "48:1 96:2 0:8"
+	 *
+	 * Each entry is the max distance to the nearest player and the update interval in ticks.
+	 * The distances must be ascending, the last tier should have an unlimited (@c 0) distance.
+	 * @return @c false if the string could not be parsed - the tiers are not changed in this case.
+	 */
+	bool setTiers(const core::String& tiers);
+	bool setTiers(const Tier* tiers, int amount);
+
+	int tiers() const;
+	const Tier& tier(int index) const;
+	/**
+	 * @return The largest finite tier distance. Every @c AI that is farther away from all players
+	 * belongs to the last tier. @c 0.0f if there are no finite distances.
+	 */
+	float maxDistance() const;
+
+	/**
+	 * @brief Starts a new tick - the tier assignments of the previous tick are discarded
+	 */
+	void beginTick();
+
+	/**
+	 * @brief Assign the @c AI to the tier for the given distance to a player. If the @c AI was
+	 * already assigned in this tick, the nearest tier is kept.
+	 *
+	 * @c AI instances that are not assigned in a tick end up in the last tier.
+	 */
+	void assign(AI& ai, float distance);
+
+	/**
+	 * @brief Accumulates the delta time and checks whether the @c AI should be updated in this tick
+	 * @param[in] dt The delta time of the tick
+	 * @param[out] scheduledDt The accumulated delta time since the last update of the @c AI
+	 * @return The tier index or @c -1 if the @c AI should not get updated in this tick
+	 */
+	int schedule(AI& ai, int64_t dt, int64_t& scheduledDt);
+
+	/**
+	 * @brief Record the time that was spent in the update of an @c AI of the given tier
+	 */
+	void record(int tier, uint64_t micros);
+
+	/**
+	 * @return The stats of the given tier for the last tick
+	 */
+	TierStats stats(int tier) const;
+};
+
+inline int AIScheduler::tiers() const {
+	return _tierCount;
+}
+
+inline const AIScheduler::Tier& AIScheduler::tier(int index) const {
+	return _tiers[index];
+}
+
+}
@@ -4,6 +4,7 @@
 
 #include "Zone.h"
 #include "core/Trace.h"
+#include "core/TimeProvider.h"
 #include "backend/entity/ai/tree/TreeNode.h"
 
 namespace backend {
@@ -13,6 +14,7 @@ Zone::~Zone() {
 	for (const auto& e : _ais) {
 		e.second->setZone(nullptr);
 		_groupManager.removeFromAllGroups(e.second);
+		_movementSystem.remove(e.second);
 	}
 	for (const auto& ai : _scheduledAdd) {
 		ai->setZone(nullptr);
@@ -48,6 +50,7 @@ bool Zone::doAddAI(const AIPtr& ai) {
 		return false;
 	}
 	_ais.insert(std::make_pair(id, ai));
+	_movementSystem.add(ai);
 	ai->setZone(this);
 	return true;
 }
@@ -59,6 +62,7 @@ bool Zone::doRemoveAI(const ai::CharacterId& id) {
 	}
 	i->second->setZone(nullptr);
 	_groupManager.removeFromAllGroups(i->second);
+	_movementSystem.remove(i->second);
 	_ais.erase(i);
 	return true;
 }
@@ -68,6 +72,7 @@ bool Zone::doDestroyAI(const ai::CharacterId& id) {
 	if (i == _ais.end()) {
 		return false;
 	}
+	_movementSystem.remove(i->second);
 	_ais.erase(i);
 	return true;
 }
@@ -120,14 +125,24 @@ void Zone::update(int64_t dt) {
 		scheduledDestroy.clear();
 	}
 
+	_scheduler.beginTick();
 	auto func = [&] (const AIPtr& ai) {
 		if (ai->isPause()) {
 			return;
 		}
-		ai->update(dt, _debug);
-		ai->getBehaviour()->execute(ai, dt);
+		int64_t scheduledDt;
+		const int tier = _scheduler.schedule(*ai, dt, scheduledDt);
+		if (tier < 0) {
+			return;
+		}
+		const uint64_t start = core::TimeProvider::highResTime();
+		ai->update(scheduledDt, _debug);
+		ai->getBehaviour()->execute(ai, scheduledDt);
+		const uint64_t delta = core::TimeProvider::highResTime() - start;
+		_scheduler.record(tier, delta * 1000000u / core::TimeProvider::highResTimeResolution());
 	};
 	executeParallel(func);
+	_movementSystem.update();
 	_groupManager.update(dt);
 }
 
@@ -15,6 +15,8 @@
 
 #include "backend/entity/ai/ICharacter.h"
 #include "backend/entity/ai/group/GroupMgr.h"
+#include "AIScheduler.h"
+#include "backend/entity/ai/movement/MovementSystem.h"
 #include "core/concurrent/ThreadPool.h"
 #include "core/concurrent/Lock.h"
 #include "core/Trace.h"
@@ -56,6 +58,8 @@ protected:
 	mutable core_trace_mutex(core::Lock, _lock, "AIZone");
 	core_trace_mutex(core::Lock, _scheduleLock, "AIScheduleZone");
 	GroupMgr _groupManager;
+	AIScheduler _scheduler;
+	movement::MovementSystem _movementSystem;
 	mutable core::ThreadPool _threadPool;
 
 	/**
@@ -90,6 +94,8 @@ public:
 	 * @brief Update all the @c ICharacter and @c AI instances in this zone.
 	 * @param dt Delta time in millis since the last update call happened
 	 * @note You have to call this on your own.
+	 * @note Not every @c AI is updated in every call - this depends on the tier
+	 * it is assigned to in the @c AIScheduler.
 	 */
 	void update(int64_t dt);
 
@@ -163,6 +169,15 @@ public:
 
 	const GroupMgr& getGroupMgr() const;
 
+	AIScheduler& getScheduler();
+
+	/**
+	 * @brief The batched steering evaluation that is applied at the end of @c update()
+	 */
+	movement::MovementSystem& getMovementSystem();
+
+	const AIScheduler& getScheduler() const;
+
 	/**
 	 * @brief Lookup for a particular @c AI in the zone.
 	 *
@@ -346,4 +361,16 @@ inline const GroupMgr& Zone::getGroupMgr() const {
 	return _groupManager;
 }
 
+inline AIScheduler& Zone::getScheduler() {
+	return _scheduler;
+}
+
+inline const AIScheduler& Zone::getScheduler() const {
+	return _scheduler;
+}
+
+inline movement::MovementSystem& Zone::getMovementSystem() {
+	return _movementSystem;
+}
+
 }
@@ -37,10 +37,12 @@ void UserMovementMgr::update(long dt) {
 	_user->setAnimation(_movement.animation());
 
 	if (_sendUpdate || _movement.animation() != oldAnimation || !glm::all(glm::epsilonEqual(oldPos, newPos, glm::epsilon<float>()))) {
+		// the other users get the movement with their entity snapshots - but the own entity is not part of
+		// the snapshots, so the authoritative position is sent to the user itself
 		const network::Vec3 netPos { newPos.x, newPos.y, newPos.z };
-		_user->sendToVisible(_entityUpdateFBB,
+		_user->sendMessage(_entityUpdateFBB,
 				network::ServerMsgType::EntityUpdate,
-				network::CreateEntityUpdate(_entityUpdateFBB, _user->id(), &netPos, orientation, _movement.animation()).Union(), true, 0u);
+				network::CreateEntityUpdate(_entityUpdateFBB, _user->id(), &netPos, orientation, _movement.animation()).Union());
 		_sendUpdate = false;
 	}
 
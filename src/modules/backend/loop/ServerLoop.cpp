@@ -25,6 +25,7 @@
 #include "backend/network/TriggerActionHandler.h"
 #include "backend/network/VarUpdateHandler.h"
 #include "backend/network/MoveHandler.h"
+#include "backend/network/EntitySnapshotAckHandler.h"
 #include "backend/network/SignupHandler.h"
 #include "backend/network/SignupValidateHandler.h"
 #include "persistence/PersistenceMgr.h"
@@ -333,6 +334,7 @@ bool ServerLoop::init() {
 	r->registerHandler(network::ClientMsgType::TriggerAction, std::make_shared<TriggerActionHandler>());
 	r->registerHandler(network::ClientMsgType::Move, std::make_shared<MoveHandler>());
 	r->registerHandler(network::ClientMsgType::VarUpdate, std::make_shared<VarUpdateHandler>());
+	r->registerHandler(network::ClientMsgType::EntitySnapshotAck, std::make_shared<EntitySnapshotAckHandler>());
 
 	Log::info("Init material");
 	if (!voxel::initDefaultPalette()) {
@@ -362,8 +364,15 @@ bool ServerLoop::init() {
 		const ServerLoop* loop = (const ServerLoop*)handle->data;
 		const long dt = handle->repeat;
 		const persistence::PersistenceMgrPtr& persistenceMgr = loop->_persistenceMgr;
+		const core::EventBusPtr& eventBus = loop->_eventBus;
+		// the models that are still waiting for the database from the previous update
+		eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::gauge("persistence.pending", persistenceMgr->stats().pending)));
 		app::App::getInstance()->threadPool().enqueue([=] () {
 			persistenceMgr->update(dt);
+			const persistence::PersistenceMgr::Stats& stats = persistenceMgr->stats();
+			eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::histogram("persistence.micros", stats.micros)));
+			eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::gauge("persistence.written", stats.written)));
+			eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::gauge("persistence.failed", stats.failed)));
 		});
 	}, 10000);
 
@@ -0,0 +1,19 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "network/Network.h"
+#include "IUserProtocolHandler.h"
+
+namespace backend {
+
+/**
+ * The client acknowledged an @c network::EntitySnapshot - future snapshots are delta encoded against it.
+ */
+USERPROTOHANDLERIMPL(EntitySnapshotAck) {
+	user->ackEntitySnapshot(message->sequence());
+}
+
+}
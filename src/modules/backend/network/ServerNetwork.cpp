@@ -6,6 +6,8 @@
 #include "ServerNetwork.h"
 #include "core/Trace.h"
 #include "core/Log.h"
+#include "core/GameConfig.h"
+#include "core/Var.h"
 
 namespace network {
 
@@ -14,28 +16,32 @@ ServerNetwork::ServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRe
 		Super(protocolHandlerRegistry, eventBus, metric) {
 }
 
-bool ServerNetwork::packetReceived(ENetEvent& event) {
-	flatbuffers::Verifier v(event.packet->data, event.packet->dataLength);
+bool ServerNetwork::init() {
+	if (!Super::init()) {
+		return false;
+	}
+	initIngress(core::Var::get(cfg::ServerNetworkWorkers, "2")->intVal());
+	return true;
+}
+
+ProtocolHandlerPtr ServerNetwork::route(const ENetPacket* packet, const void** message, const char** msgType) {
+	flatbuffers::Verifier v(packet->data, packet->dataLength);
 
 	if (!VerifyClientMessageBuffer(v)) {
-		Log::error("Illegal client packet received with length: %i", (int)event.packet->dataLength);
-		return false;
+		Log::error("Illegal client packet received with length: %i", (int)packet->dataLength);
+		return ProtocolHandlerPtr();
 	}
-	const ClientMessage *req = GetClientMessage(event.packet->data);
+	const ClientMessage *req = GetClientMessage(packet->data);
 	ClientMsgType type = req->data_type();
 	const char *clientMsgType = EnumNameClientMsgType(type);
-	ProtocolHandlerPtr handler = _protocolHandlerRegistry->getHandler(type);
+	const ProtocolHandlerPtr& handler = _protocolHandlerRegistry->getHandler(type);
 	if (!handler) {
 		Log::error("No handler for client msg type %s", clientMsgType);
-		return false;
+		return ProtocolHandlerPtr();
 	}
-	const metric::TagMap& tags  {{"direction", "in"}, {"type", clientMsgType}};
-	_metric->count("network_packet_count", 1, tags);
-	_metric->count("network_packet_size", (int)event.packet->dataLength, tags);
-
-	Log::debug("Received %s", clientMsgType);
-	handler->executeWithRaw(event.peer, req->data(), (const uint8_t*)event.packet->data, event.packet->dataLength);
-	return true;
+	*message = req->data();
+	*msgType = clientMsgType;
+	return handler;
 }
 
 }
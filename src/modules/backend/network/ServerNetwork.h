@@ -11,11 +11,16 @@ namespace network {
 class ServerNetwork : public AbstractServerNetwork {
 private:
 	using Super = AbstractServerNetwork;
+protected:
+	ProtocolHandlerPtr route(const ENetPacket* packet, const void** message, const char** msgType) override;
 public:
 	ServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry,
 			const core::EventBusPtr& eventBus, const metric::MetricPtr& metric);
 
-	bool packetReceived(ENetEvent& event) override;
+	/**
+	 * @note Reads the @c sv_networkworkers cvar to configure the amount of ingress workers
+	 */
+	bool init() override;
 };
 
 typedef std::shared_ptr<ServerNetwork> ServerNetworkPtr;
@@ -20,6 +20,13 @@ public:
 	SignupHandler(const persistence::DBHandlerPtr& dbHandler);
 
 	void executeWithRaw(ENetPeer* peer, const void* message, const uint8_t* rawData, size_t rawDataLength) override;
+
+	/**
+	 * @brief Hashing the password and querying the database doesn't need the main thread
+	 */
+	bool concurrent() const override {
+		return true;
+	}
 };
 
 }
@@ -0,0 +1,130 @@
+/**
+ * @file
+ */
+
+#include "NpcTest.h"
+#include "backend/entity/EntitySnapshotBuilder.h"
+#include "shared/EntitySnapshot.h"
+#include <glm/gtc/constants.hpp>
+
+namespace backend {
+
+class EntitySnapshotTest: public NpcTest {
+protected:
+	flatbuffers::FlatBufferBuilder _fbb;
+
+	const network::EntitySnapshot* build(EntitySnapshotBuilder& builder, const EntitySet& visible) {
+		_fbb.Clear();
+		const flatbuffers::Offset<network::EntitySnapshot>& offset = builder.build(_fbb, visible);
+		if (offset.IsNull()) {
+			return nullptr;
+		}
+		_fbb.Finish(offset);
+		return flatbuffers::GetRoot<network::EntitySnapshot>(_fbb.GetBufferPointer());
+	}
+
+	int apply(shared::EntitySnapshotHistory& history, const network::EntitySnapshot* snapshot, const EntityPtr& entity) {
+		int visited = 0;
+		const bool applied = history.apply(snapshot, [&] (int64_t id, const shared::QuantizedEntityState& state) {
+			if (id == entity->id()) {
+				EXPECT_NEAR(entity->pos().x, state.pos().x, 1.0f / shared::SnapshotPositionScale);
+				EXPECT_NEAR(entity->pos().y, state.pos().y, 1.0f / shared::SnapshotPositionScale);
+				EXPECT_NEAR(entity->pos().z, state.pos().z, 1.0f / shared::SnapshotPositionScale);
+			}
+			++visited;
+		});
+		if (!applied) {
+			return -1;
+		}
+		return visited;
+	}
+};
+
+TEST_F(EntitySnapshotTest, testQuantize) {
+	const glm::vec3 pos(1.5f, -32.25f, 1000.125f);
+	const shared::QuantizedEntityState& state = shared::QuantizedEntityState::quantize(pos, glm::pi<float>(), network::Animation::RUN);
+	EXPECT_FLOAT_EQ(pos.x, state.pos().x);
+	EXPECT_FLOAT_EQ(pos.y, state.pos().y);
+	EXPECT_FLOAT_EQ(pos.z, state.pos().z);
+	EXPECT_NEAR(glm::pi<float>(), state.orientation(), 0.001f);
+	EXPECT_EQ((uint8_t)network::Animation::RUN, state.animation);
+}
+
+TEST_F(EntitySnapshotTest, testDeltaAgainstAckedSnapshot) {
+	const NpcPtr& npc1 = create();
+	const NpcPtr& npc2 = create();
+	npc1->setPos(glm::vec3(10.0f, 1.0f, 10.0f));
+	npc2->setPos(glm::vec3(20.0f, 1.0f, 20.0f));
+	const EntitySet visible {npc1, npc2};
+
+	EntitySnapshotBuilder builder;
+	shared::EntitySnapshotHistory history;
+
+	// nothing acked yet - everything is absolute
+	const network::EntitySnapshot* snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+	EXPECT_EQ(0u, snapshot->base());
+	EXPECT_EQ(2u, snapshot->entities()->size());
+	ASSERT_EQ(2, apply(history, snapshot, npc1));
+	builder.ack(snapshot->sequence());
+
+	// nothing changed since the acked snapshot
+	EXPECT_EQ(nullptr, build(builder, visible));
+
+	// only the moved entity is part of the delta
+	npc1->setPos(glm::vec3(11.0f, 1.0f, 10.0f));
+	snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+	EXPECT_EQ(1u, snapshot->base());
+	ASSERT_EQ(1u, snapshot->entities()->size());
+	const network::EntityDelta* delta = snapshot->entities()->Get(0);
+	EXPECT_FALSE(delta->absolute());
+	EXPECT_EQ((int)shared::SnapshotPositionScale, delta->x());
+	EXPECT_EQ(0, delta->z());
+	ASSERT_EQ(1, apply(history, snapshot, npc1));
+}
+
+TEST_F(EntitySnapshotTest, testLostSnapshotIsRepeated) {
+	const NpcPtr& npc = create();
+	npc->setPos(glm::vec3(10.0f, 1.0f, 10.0f));
+	const EntitySet visible {npc};
+
+	EntitySnapshotBuilder builder;
+	shared::EntitySnapshotHistory history;
+
+	const network::EntitySnapshot* snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+	ASSERT_EQ(1, apply(history, snapshot, npc));
+	builder.ack(snapshot->sequence());
+
+	// this snapshot gets lost
+	npc->setPos(glm::vec3(12.0f, 1.0f, 10.0f));
+	ASSERT_NE(nullptr, build(builder, visible));
+
+	// the change is not acked yet - so it must be repeated even though nothing changed
+	snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+	EXPECT_EQ(1u, snapshot->base());
+	ASSERT_EQ(1, apply(history, snapshot, npc));
+	builder.ack(snapshot->sequence());
+	EXPECT_EQ(nullptr, build(builder, visible));
+}
+
+TEST_F(EntitySnapshotTest, testUnknownBase) {
+	const NpcPtr& npc = create();
+	const EntitySet visible {npc};
+
+	EntitySnapshotBuilder builder;
+	const network::EntitySnapshot* snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+	builder.ack(snapshot->sequence());
+	npc->setPos(glm::vec3(1.0f, 1.0f, 1.0f));
+	snapshot = build(builder, visible);
+	ASSERT_NE(nullptr, snapshot);
+
+	// the client never received the base snapshot
+	shared::EntitySnapshotHistory history;
+	EXPECT_EQ(-1, apply(history, snapshot, npc));
+}
+
+}
@@ -148,6 +148,34 @@ TEST_F(GroupTest, testGroupAveragePosition) {
 	ASSERT_EQ(glm::vec3(2.0f, 2.0f, 0.0f), avg);
 }
 
+TEST_F(GroupTest, testGroupSnapshot) {
+	const GroupId id = -1;
+	GroupMgr groupMgr;
+	AIPtr entity1 = std::make_shared<AI>(TreeNodePtr());
+	entity1->setCharacter(core::make_shared<ICharacter>(1));
+	AIPtr entity2 = std::make_shared<AI>(TreeNodePtr());
+	entity2->setCharacter(core::make_shared<ICharacter>(2));
+	ASSERT_TRUE(groupMgr.add(id, entity1));
+	ASSERT_TRUE(groupMgr.add(id, entity2));
+	groupMgr.update(0);
+	// read from the published snapshot
+	EXPECT_EQ(2, groupMgr.getGroupSize(id));
+	EXPECT_TRUE(groupMgr.isGroupLeader(id, entity1));
+	EXPECT_TRUE(groupMgr.isInGroup(id, entity2));
+	EXPECT_TRUE(groupMgr.isInAnyGroup(entity2));
+	EXPECT_FALSE(groupMgr.isInGroup(id + 1, entity2));
+	EXPECT_EQ(entity1, groupMgr.getLeader(id));
+	// modifications are visible before the next update
+	ASSERT_TRUE(groupMgr.remove(id, entity1));
+	EXPECT_FALSE(groupMgr.isInAnyGroup(entity1));
+	EXPECT_TRUE(groupMgr.isGroupLeader(id, entity2));
+	EXPECT_EQ(1, groupMgr.getGroupSize(id));
+	groupMgr.update(0);
+	EXPECT_FALSE(groupMgr.isInAnyGroup(entity1));
+	EXPECT_TRUE(groupMgr.isGroupLeader(id, entity2));
+	EXPECT_EQ(1, groupMgr.getGroupSize(id));
+}
+
 TEST_F(GroupTest, testGroupMass1000) {
 	doMassTest(1000);
 }
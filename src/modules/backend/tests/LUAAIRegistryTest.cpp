@@ -7,6 +7,7 @@
 #include "io/Filesystem.h"
 #include "backend/entity/ai/zone/Zone.h"
 #include "backend/entity/ai/condition/True.h"
+#include "core/concurrent/ThreadPool.h"
 #include <fstream>
 #include <streambuf>
 
@@ -158,4 +159,27 @@ TEST_F(LUAAIRegistryTest, testSteeringEmpty) {
 	testSteering("LuaSteeringTest");
 }
 
+TEST_F(LUAAIRegistryTest, testThreadStates) {
+	const ConditionPtr& condition = _registry.createCondition("LuaTest", ctxCondition);
+	ASSERT_TRUE((bool)condition);
+	const AIPtr& ai = std::make_shared<AI>(TreeNodePtr());
+	ai->setCharacter(_chr);
+	core::ThreadPool pool(1, "LUAAIRegistryTest");
+	pool.init();
+	EXPECT_TRUE(pool.enqueue([&] () { return condition->evaluate(ai); }).get());
+	EXPECT_TRUE(condition->evaluate(ai));
+
+	// scripts that are evaluated later on must be visible in the lua states of the other threads, too
+	ASSERT_TRUE(_registry.evaluate(
+		"local c = REGISTRY.createCondition(\"LuaTestReload\")\n"
+		"function c:evaluate(ai)\n"
+		"	return false\n"
+		"end\n"));
+	const ConditionPtr& reloaded = _registry.createCondition("LuaTestReload", ctxCondition);
+	ASSERT_TRUE((bool)reloaded);
+	EXPECT_TRUE(pool.enqueue([&] () { return !reloaded->evaluate(ai) && condition->evaluate(ai); }).get());
+	EXPECT_FALSE(reloaded->evaluate(ai));
+	pool.shutdown();
+}
+
 }
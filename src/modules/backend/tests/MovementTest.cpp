@@ -7,6 +7,7 @@
 #include "backend/entity/ai/movement/SelectionFlee.h"
 #include "backend/entity/ai/movement/GroupFlee.h"
 #include "backend/entity/ai/movement/GroupSeek.h"
+#include "backend/entity/ai/movement/MovementSystem.h"
 #include "backend/entity/ai/movement/Steering.h"
 #include "backend/entity/ai/movement/TargetFlee.h"
 #include "backend/entity/ai/movement/TargetSeek.h"
@@ -15,6 +16,7 @@
 #include "backend/entity/ai/zone/Zone.h"
 #include "backend/entity/ai/common/Random.h"
 #include <glm/gtc/constants.hpp>
+#include <glm/common.hpp>
 
 namespace backend {
 
@@ -120,4 +122,82 @@ TEST_F(MovementTest, testWeightedSteering) {
 	EXPECT_EQ(result, mv.getVector());
 }
 
+TEST_F(MovementTest, testMovementSystemMatchesWeightedSteering) {
+	const backend::SteeringPtr& flee = std::make_shared<backend::movement::TargetFlee>("1:0:0");
+	const backend::SteeringPtr& wander = std::make_shared<backend::movement::Wander>("0");
+	backend::movement::WeightedSteerings s;
+	s.push_back(backend::movement::WeightedData(flee, 0.8f));
+	s.push_back(backend::movement::WeightedData(wander, 0.2f));
+	const backend::movement::WeightedSteering w(s);
+
+	const AIPtr& ai = std::make_shared<AI>(TreeNodePtr());
+	const ICharacterPtr& entity = core::make_shared<ICharacter>(1);
+	ai->setCharacter(entity);
+	entity->setOrientation(0.5f);
+	entity->setPosition(glm::vec3(3, 1, 2));
+
+	const int64_t deltaMillis = 100;
+	const float deltaSeconds = 0.1f;
+	const MoveVector& mv = w.execute(ai, _speed);
+	ASSERT_TRUE(mv.isValid());
+	const glm::vec3 expectedPos = entity->getPosition() + mv.getVector() * deltaSeconds;
+	const float src = entity->getOrientation() - glm::pi<float>();
+	const float dest = mv.getRotation() - glm::pi<float>();
+	const float expectedOrientation = glm::mix(src, dest, deltaSeconds) + glm::pi<float>();
+
+	movement::MovementSystem movementSystem;
+	MoveVectorState state;
+	EXPECT_FALSE(w.submit(ai, _speed, deltaMillis, movementSystem, state)) << "The ai doesn't have a slot yet";
+	ASSERT_TRUE(movementSystem.add(ai));
+	ASSERT_TRUE(w.submit(ai, _speed, deltaMillis, movementSystem, state));
+	EXPECT_EQ(MoveVectorState::Valid, state);
+	EXPECT_EQ(1u, movementSystem.submitted());
+	movementSystem.update();
+	EXPECT_EQ(0u, movementSystem.submitted());
+	EXPECT_NEAR(expectedPos.x, entity->getPosition().x, 0.0001f);
+	EXPECT_NEAR(expectedPos.y, entity->getPosition().y, 0.0001f);
+	EXPECT_NEAR(expectedPos.z, entity->getPosition().z, 0.0001f);
+	EXPECT_NEAR(expectedOrientation, entity->getOrientation(), 0.0001f);
+}
+
+TEST_F(MovementTest, testMovementSystemTargetReached) {
+	const backend::SteeringPtr& seek = std::make_shared<backend::movement::TargetSeek>("1:0:0");
+	backend::movement::WeightedSteerings s;
+	s.push_back(backend::movement::WeightedData(seek, 1.0f));
+	const backend::movement::WeightedSteering w(s);
+
+	const AIPtr& ai = std::make_shared<AI>(TreeNodePtr());
+	const ICharacterPtr& entity = core::make_shared<ICharacter>(1);
+	ai->setCharacter(entity);
+	entity->setPosition(glm::vec3(1, 0, 0));
+	entity->setOrientation(1.0f);
+
+	movement::MovementSystem movementSystem;
+	ASSERT_TRUE(movementSystem.add(ai));
+	MoveVectorState state;
+	ASSERT_TRUE(w.submit(ai, _speed, 100, movementSystem, state));
+	EXPECT_EQ(MoveVectorState::TargetReached, state);
+	EXPECT_EQ(0u, movementSystem.submitted());
+	movementSystem.update();
+	EXPECT_EQ(glm::vec3(1, 0, 0), entity->getPosition());
+	EXPECT_FLOAT_EQ(1.0f, entity->getOrientation());
+}
+
+TEST_F(MovementTest, testMovementSystemFallback) {
+	const backend::SteeringPtr& seek = std::make_shared<backend::movement::TargetSeek>("invalid");
+	backend::movement::WeightedSteerings s;
+	s.push_back(backend::movement::WeightedData(seek, 1.0f));
+	const backend::movement::WeightedSteering w(s);
+
+	const AIPtr& ai = std::make_shared<AI>(TreeNodePtr());
+	ai->setCharacter(core::make_shared<ICharacter>(1));
+	movement::MovementSystem movementSystem;
+	ASSERT_TRUE(movementSystem.add(ai));
+	MoveVectorState state;
+	EXPECT_FALSE(w.submit(ai, _speed, 100, movementSystem, state));
+	EXPECT_EQ(0u, movementSystem.submitted());
+	EXPECT_TRUE(movementSystem.remove(ai));
+	EXPECT_EQ(0u, movementSystem.size());
+}
+
 }
@@ -178,4 +178,46 @@ TEST_F(NodeTest, testPrioritySelectorWithCondition) {
 	ASSERT_EQ(ai::TreeNodeStatus::FINISHED, idle2->getLastStatus(e));
 }
 
+TEST_F(NodeTest, testCompile) {
+	backend::Sequence::Factory f;
+	backend::TreeNodeFactoryContext ctx("testsequence", "", backend::True::get());
+	TreeNodePtr node = f.create(&ctx);
+
+	backend::Idle::Factory idleFac;
+	backend::TreeNodeFactoryContext idleCtx1("testidle", "2", backend::True::get());
+	TreeNodePtr idle1 = idleFac.create(&idleCtx1);
+	node->addChild(idle1);
+	ASSERT_FALSE(node->isCompiled());
+
+	AIPtr e1 = std::make_shared<AI>(node);
+	e1->setCharacter(core::make_shared<ICharacter>(1));
+	ASSERT_TRUE(node->isCompiled());
+	ASSERT_EQ(2, node->compiledNodes());
+
+	// extend the tree after it was compiled and shared with an ai
+	backend::TreeNodeFactoryContext idleCtx2("testidle2", "2", backend::True::get());
+	TreeNodePtr idle2 = idleFac.create(&idleCtx2);
+	node->addChild(idle2);
+	ASSERT_FALSE(node->isCompiled());
+
+	AIPtr e2 = std::make_shared<AI>(node);
+	e2->setCharacter(core::make_shared<ICharacter>(2));
+	ASSERT_TRUE(node->isCompiled());
+	ASSERT_EQ(3, node->compiledNodes());
+
+	// the node states are not shared between the ai instances
+	e1->update(1, true);
+	e1->getBehaviour()->execute(e1, 1);
+	ASSERT_EQ(ai::TreeNodeStatus::RUNNING, idle1->getLastStatus(e1));
+	ASSERT_EQ(ai::TreeNodeStatus::UNKNOWN, idle2->getLastStatus(e1));
+	e2->update(1, true);
+	ASSERT_EQ(ai::TreeNodeStatus::UNKNOWN, idle1->getLastStatus(e2));
+	e1->update(1, true);
+	e1->getBehaviour()->execute(e1, 1);
+	e1->update(1, true);
+	e1->getBehaviour()->execute(e1, 1);
+	ASSERT_EQ(ai::TreeNodeStatus::FINISHED, idle1->getLastStatus(e1));
+	ASSERT_EQ(ai::TreeNodeStatus::RUNNING, idle2->getLastStatus(e1));
+}
+
 }
@@ -52,4 +52,39 @@ TEST_F(ZoneTest, testAdd100) {
 	ASSERT_EQ(n, (int)zone.size());
 }
 
+TEST_F(ZoneTest, testSchedulerTiers) {
+	Zone zone("test1");
+	AIScheduler& scheduler = zone.getScheduler();
+	ASSERT_TRUE(scheduler.setTiers("10:1 0:4"));
+	ASSERT_EQ(2, scheduler.tiers());
+	EXPECT_FLOAT_EQ(10.0f, scheduler.maxDistance());
+	EXPECT_FALSE(scheduler.setTiers("0:1 10:4")) << "Only the last tier may have an unlimited distance";
+	EXPECT_FALSE(scheduler.setTiers("10:0"));
+
+	TreeNodePtr root = std::make_shared<PrioritySelector>("test", "", True::get());
+	AIPtr nearAI = std::make_shared<AI>(root);
+	nearAI->setCharacter(core::make_shared<TestEntity>(1));
+	AIPtr farAI = std::make_shared<AI>(root);
+	farAI->setCharacter(core::make_shared<TestEntity>(2));
+	ASSERT_TRUE(zone.addAI(nearAI));
+	ASSERT_TRUE(zone.addAI(farAI));
+
+	const int64_t dt = 100;
+	const int ticks = 8;
+	int farUpdates = 0;
+	for (int i = 0; i < ticks; ++i) {
+		scheduler.assign(*nearAI, 5.0f);
+		zone.update(dt);
+		EXPECT_EQ(1, scheduler.stats(0).count);
+		EXPECT_EQ(1, scheduler.stats(0).updates);
+		EXPECT_EQ(1, scheduler.stats(1).count);
+		farUpdates += scheduler.stats(1).updates;
+	}
+	EXPECT_EQ(ticks / 4, farUpdates) << "The far ai should only be updated every 4th tick";
+	EXPECT_EQ(ticks * dt, nearAI->getTime());
+	// the skipped time is handed over to the next update
+	EXPECT_LE(farAI->getTime(), ticks * dt);
+	EXPECT_GT(farAI->getTime(), (ticks - 4) * dt);
+}
+
 }
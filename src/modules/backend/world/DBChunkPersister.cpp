@@ -50,7 +50,7 @@ persistence::Blob DBChunkPersister::load(int x, int y, int z, MapId mapId, unsig
 	return model.data();
 }
 
-bool DBChunkPersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) {
+bool DBChunkPersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, voxelworld::ChunkColumnSummary* summary) {
 	core_trace_scoped(DBChunkPersisterLoad);
 	const glm::ivec3& region = chunk->chunkPos();
 	persistence::Blob blob = load(region.x, region.y, region.z, _mapId, seed);
@@ -59,7 +59,7 @@ bool DBChunkPersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned
 		blob.release();
 		return false;
 	}
-	if (!loadCompressed(chunk, blob.data, blob.length)) {
+	if (!loadCompressed(chunk, blob.data, blob.length, summary)) {
 		Log::warn("Failed to uncompress the model");
 		blob.release();
 		return false;
@@ -69,10 +69,10 @@ bool DBChunkPersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned
 }
 
 // TODO: this must be done async
-bool DBChunkPersister::save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) {
+bool DBChunkPersister::save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, const voxelworld::ChunkColumnSummary* summary) {
 	core_trace_scoped(DBChunkPersisterSave);
 	io::BufferedReadWriteStream out(10);
-	if (!saveCompressed(chunk, out)) {
+	if (!saveCompressed(chunk, out, summary)) {
 		return false;
 	}
 
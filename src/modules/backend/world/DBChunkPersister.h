@@ -29,8 +29,8 @@ public:
 	 */
 	bool truncate(unsigned int seed);
 
-	bool load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) override;
-	bool save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) override;
+	bool load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, voxelworld::ChunkColumnSummary* summary = nullptr) override;
+	bool save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, const voxelworld::ChunkColumnSummary* summary = nullptr) override;
 	void erase(const voxel::Region& region, unsigned int seed) override;
 };
 
@@ -19,6 +19,7 @@
 #include "backend/spawn/SpawnMgr.h"
 #include "persistence/PersistenceMgr.h"
 #include "attrib/ContainerProvider.h"
+#include <glm/geometric.hpp>
 
 namespace backend {
 
@@ -78,16 +79,53 @@ bool Map::updateEntity(const EntityPtr& entity, long dt) {
 	return true;
 }
 
+void Map::scheduleAIs() {
+	core_trace_scoped(MapScheduleAIs);
+	AIScheduler& scheduler = _zone->getScheduler();
+	const float maxDistance = scheduler.maxDistance();
+	if (maxDistance <= 0.0f) {
+		return;
+	}
+	math::QuadTree<QuadTreeNode, float>::Contents contents;
+	for (const auto& e : _users) {
+		const glm::vec3& pos = e.second->pos();
+		contents.clear();
+		_quadTree.query(math::RectFloat(pos.x - maxDistance, pos.z - maxDistance, pos.x + maxDistance, pos.z + maxDistance), contents);
+		for (const QuadTreeNode& node : contents) {
+			auto i = _npcs.find(node.entity->id());
+			if (i == _npcs.end()) {
+				continue;
+			}
+			scheduler.assign(*i->second->ai(), glm::distance(pos, node.entity->pos()));
+		}
+	}
+}
+
+void Map::sendAIMetrics() {
+	const AIScheduler& scheduler = _zone->getScheduler();
+	for (int i = 0; i < scheduler.tiers(); ++i) {
+		const AIScheduler::TierStats& stats = scheduler.stats(i);
+		const metric::TagMap tags {{"map", _mapIdStr}, {"tier", core::string::toString(i)}};
+		_eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::gauge("ai.tier.count", stats.count, tags)));
+		_eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::gauge("ai.tier.updates", stats.updates, tags)));
+		_eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::histogram("ai.tier.micros", stats.micros, tags)));
+	}
+}
+
 void Map::update(long dt) {
 	core_trace_scoped(MapUpdate);
 	Log::trace("tick map %i", (int)_mapId);
 	_spawnMgr.update(dt);
+	scheduleAIs();
 	_zone->update(dt);
+	sendAIMetrics();
 	_attackMgr.update(dt);
 
+	uint32_t snapshotBytes = 0u;
 	for (auto i = _users.begin(); i != _users.end();) {
 		UserPtr user = i->second;
 		if (updateEntity(user, dt)) {
+			snapshotBytes += user->snapshotBytes();
 			++i;
 			continue;
 		}
@@ -108,6 +146,9 @@ void Map::update(long dt) {
 		_zone->removeAI(npc->id());
 		_eventBus->enqueue(std::make_shared<EntityDeleteEvent>(npc->id(), npc->entityType()));
 	}
+	if (!_users.empty()) {
+		_eventBus->enqueue(std::make_shared<metric::MetricEvent>(metric::histogram("network.snapshot.bytes", snapshotBytes, {{"map", _mapIdStr}})));
+	}
 }
 
 bool Map::init() {
@@ -137,6 +178,10 @@ bool Map::init() {
 
 	_voxelWorldMgr->setSeed(seed->uintVal());
 	_zone = new Zone(core::string::format("Zone %i", _mapId));
+	const core::VarPtr& aiTiers = core::Var::get(cfg::ServerAITiers, "64:1 128:2 256:4 0:10");
+	if (!_zone->getScheduler().setTiers(aiTiers->strVal())) {
+		Log::warn("Failed to configure the ai update tiers - updating all ais in every tick");
+	}
 
 	if (!_spawnMgr.init()) {
 		Log::error("Failed to init the spawn manager");
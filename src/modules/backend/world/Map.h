@@ -70,6 +70,11 @@ private:
 	 * @return @c false if the entity should be removed from the server.
 	 */
 	bool updateEntity(const EntityPtr& entity, long dt);
+	/**
+	 * @brief Assigns the npcs near the players to the update tiers of the @c AIScheduler
+	 */
+	void scheduleAIs();
+	void sendAIMetrics();
 
 	glm::vec3 findStartPosition(const EntityPtr& entity, poi::Type type = poi::Type::GENERIC) const;
 
@@ -3,7 +3,9 @@
  * @defgroup Compute
  * @{
  *
- * The compute module contains wrappers around OpenCL.
+ * The compute module contains wrappers around OpenCL. Without OpenCL headers the cpu backend
+ * executes the host implementations of the kernels that the computeshadertool generates on a
+ * thread pool.
  *
  * @see compute::Shader
  * @see ComputeShaderTool
@@ -25,6 +27,11 @@
 
 namespace compute {
 
+namespace cpu {
+class WorkGroup;
+typedef void (*KernelFunc)(const WorkGroup &group);
+}
+
 enum class Feature {
 	VideoSharing,
 	VideoSharingEvent,
@@ -91,6 +98,10 @@ size_t requiredAlignment();
 bool configureProgram(Id program);
 bool deleteProgram(Id& program);
 
+/**
+ * @brief Registers the host implementation of a kernel for the cpu backend. The OpenCL backend ignores this.
+ */
+bool registerKernel(Id program, const char *name, cpu::KernelFunc func);
 Id createKernel(Id program, const char *name);
 bool deleteKernel(Id& kernel);
 bool kernelArg(Id kernel, uint32_t index, const Texture& texture, int32_t samplerIndex = -1);
@@ -773,6 +773,10 @@ bool kernelRun(Id kernel, const glm::ivec3& workSize, int workDim, bool blocking
 	return false;
 }
 
+bool registerKernel(Id program, const char *name, cpu::KernelFunc func) {
+	return true;
+}
+
 Id createKernel(Id program, const char *name) {
 	if (program == InvalidId) {
 		return InvalidId;
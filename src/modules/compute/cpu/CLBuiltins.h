@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * The OpenCL C types and built-in functions for the host implementations of the kernels that are
+ * generated by the computeshadertool. The kernel sources are translated into C++ code that is compiled
+ * against these definitions.
+ *
+ * @ingroup Compute
+ */
+#pragma once
+
+#include "CPUKernel.h"
+#include <math.h>
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+namespace compute {
+namespace cpu {
+
+typedef uint8_t uchar;
+typedef uint16_t ushort;
+typedef uint32_t uint;
+typedef uint64_t ulong;
+
+typedef glm::i8vec2 char2;
+typedef glm::i8vec3 char3;
+typedef glm::i8vec4 char4;
+typedef glm::u8vec2 uchar2;
+typedef glm::u8vec3 uchar3;
+typedef glm::u8vec4 uchar4;
+typedef glm::i16vec2 short2;
+typedef glm::i16vec3 short3;
+typedef glm::i16vec4 short4;
+typedef glm::u16vec2 ushort2;
+typedef glm::u16vec3 ushort3;
+typedef glm::u16vec4 ushort4;
+typedef glm::ivec2 int2;
+typedef glm::ivec3 int3;
+typedef glm::ivec4 int4;
+typedef glm::uvec2 uint2;
+typedef glm::uvec3 uint3;
+typedef glm::uvec4 uint4;
+typedef glm::i64vec2 long2;
+typedef glm::i64vec3 long3;
+typedef glm::i64vec4 long4;
+typedef glm::u64vec2 ulong2;
+typedef glm::u64vec3 ulong3;
+typedef glm::u64vec4 ulong4;
+typedef glm::vec2 float2;
+typedef glm::vec3 float3;
+typedef glm::vec4 float4;
+typedef glm::dvec2 double2;
+typedef glm::dvec3 double3;
+typedef glm::dvec4 double4;
+
+typedef const Image *image2d_t;
+typedef const Image *image3d_t;
+typedef const Sampler *sampler_t;
+
+glm::vec4 readImagef(const Image *image, const Sampler *sampler, const glm::vec4 &coord);
+glm::ivec4 readImagei(const Image *image, const Sampler *sampler, const glm::vec4 &coord);
+glm::uvec4 readImageui(const Image *image, const Sampler *sampler, const glm::vec4 &coord);
+void writeImagef(const Image *image, const glm::ivec4 &coord, const glm::vec4 &color);
+void writeImagei(const Image *image, const glm::ivec4 &coord, const glm::ivec4 &color);
+void writeImageui(const Image *image, const glm::ivec4 &coord, const glm::uvec4 &color);
+
+// work item functions
+
+inline uint get_work_dim() {
+	return (uint)_priv::workItem.workDim;
+}
+
+inline size_t get_global_id(uint dim) {
+	return dim < 3u ? (size_t)_priv::workItem.globalId[dim] : 0u;
+}
+
+inline size_t get_global_size(uint dim) {
+	return dim < 3u ? (size_t)_priv::workItem.globalSize[dim] : 1u;
+}
+
+inline size_t get_global_offset(uint dim) {
+	return 0u;
+}
+
+inline size_t get_local_id(uint dim) {
+	return dim < 3u ? (size_t)(_priv::workItem.globalId[dim] - _priv::workItem.groupOffset[dim]) : 0u;
+}
+
+inline size_t get_local_size(uint dim) {
+	return dim < 3u ? (size_t)_priv::workItem.groupSize[dim] : 1u;
+}
+
+inline size_t get_group_id(uint dim) {
+	return dim < 3u ? (size_t)_priv::workItem.groupId[dim] : 0u;
+}
+
+inline size_t get_num_groups(uint dim) {
+	return dim < 3u ? (size_t)_priv::workItem.numGroups[dim] : 1u;
+}
+
+// math functions - scalar and vector versions are forwarded to glm
+
+#define CL_BUILTIN1(name, func) \
+	template<class T> \
+	inline auto name(const T &x) -> decltype(func(x)) { \
+		return func(x); \
+	}
+#define CL_BUILTIN2(name, func) \
+	template<class A, class B> \
+	inline auto name(const A &x, const B &y) -> decltype(func(x, y)) { \
+		return func(x, y); \
+	}
+#define CL_BUILTIN3(name, func) \
+	template<class A, class B, class C> \
+	inline auto name(const A &x, const B &y, const C &z) -> decltype(func(x, y, z)) { \
+		return func(x, y, z); \
+	}
+
+CL_BUILTIN1(sin, glm::sin)
+CL_BUILTIN1(cos, glm::cos)
+CL_BUILTIN1(tan, glm::tan)
+CL_BUILTIN1(asin, glm::asin)
+CL_BUILTIN1(acos, glm::acos)
+CL_BUILTIN1(atan, glm::atan)
+CL_BUILTIN2(atan2, glm::atan)
+CL_BUILTIN1(sinh, glm::sinh)
+CL_BUILTIN1(cosh, glm::cosh)
+CL_BUILTIN1(tanh, glm::tanh)
+CL_BUILTIN1(exp, glm::exp)
+CL_BUILTIN1(exp2, glm::exp2)
+CL_BUILTIN1(log, glm::log)
+CL_BUILTIN1(log2, glm::log2)
+CL_BUILTIN2(pow, glm::pow)
+CL_BUILTIN2(powr, glm::pow)
+CL_BUILTIN1(sqrt, glm::sqrt)
+CL_BUILTIN1(rsqrt, glm::inversesqrt)
+CL_BUILTIN1(floor, glm::floor)
+CL_BUILTIN1(ceil, glm::ceil)
+CL_BUILTIN1(round, glm::round)
+CL_BUILTIN1(trunc, glm::trunc)
+CL_BUILTIN1(fabs, glm::abs)
+CL_BUILTIN1(abs, glm::abs)
+CL_BUILTIN1(sign, glm::sign)
+CL_BUILTIN1(degrees, glm::degrees)
+CL_BUILTIN1(radians, glm::radians)
+CL_BUILTIN2(min, glm::min)
+CL_BUILTIN2(max, glm::max)
+CL_BUILTIN2(fmin, glm::min)
+CL_BUILTIN2(fmax, glm::max)
+CL_BUILTIN3(clamp, glm::clamp)
+CL_BUILTIN3(mix, glm::mix)
+CL_BUILTIN2(step, glm::step)
+CL_BUILTIN3(smoothstep, glm::smoothstep)
+CL_BUILTIN2(dot, glm::dot)
+CL_BUILTIN2(cross, glm::cross)
+CL_BUILTIN1(length, glm::length)
+CL_BUILTIN2(distance, glm::distance)
+CL_BUILTIN1(normalize, glm::normalize)
+CL_BUILTIN1(native_sin, glm::sin)
+CL_BUILTIN1(native_cos, glm::cos)
+CL_BUILTIN1(native_tan, glm::tan)
+CL_BUILTIN1(native_exp, glm::exp)
+CL_BUILTIN1(native_exp2, glm::exp2)
+CL_BUILTIN1(native_log, glm::log)
+CL_BUILTIN1(native_log2, glm::log2)
+CL_BUILTIN2(native_powr, glm::pow)
+CL_BUILTIN1(native_sqrt, glm::sqrt)
+CL_BUILTIN1(native_rsqrt, glm::inversesqrt)
+CL_BUILTIN1(fast_length, glm::length)
+CL_BUILTIN2(fast_distance, glm::distance)
+CL_BUILTIN1(fast_normalize, glm::normalize)
+
+#undef CL_BUILTIN1
+#undef CL_BUILTIN2
+#undef CL_BUILTIN3
+
+inline float fmod(float x, float y) {
+	return ::fmodf(x, y);
+}
+
+template<class T>
+inline T mad(const T &a, const T &b, const T &c) {
+	return a * b + c;
+}
+
+template<class T, class S>
+inline T select(const T &a, const T &b, const S &c) {
+	return c ? b : a;
+}
+
+/**
+ * @brief The OpenCL version of fract that also returns the floor of the value
+ */
+template<class T>
+inline T fract(const T &x, T *iptr) {
+	const T f = glm::floor(x);
+	*iptr = f;
+	return glm::min(x - f, T(0x1.fffffep-1f));
+}
+
+// image functions
+
+inline int get_image_width(const Image *image) {
+	return image->size.x;
+}
+
+inline int get_image_height(const Image *image) {
+	return image->size.y;
+}
+
+inline int get_image_depth(const Image *image) {
+	return image->size.z;
+}
+
+inline float4 read_imagef(const Image *image, const Sampler *sampler, const float2 &coord) {
+	return readImagef(image, sampler, float4(coord, 0.0f, 0.0f));
+}
+
+inline float4 read_imagef(const Image *image, const Sampler *sampler, const float4 &coord) {
+	return readImagef(image, sampler, coord);
+}
+
+inline float4 read_imagef(const Image *image, const Sampler *sampler, const int2 &coord) {
+	return readImagef(image, sampler, float4(coord, 0, 0));
+}
+
+inline float4 read_imagef(const Image *image, const Sampler *sampler, const int4 &coord) {
+	return readImagef(image, sampler, float4(coord));
+}
+
+inline float4 read_imagef(const Image *image, const int2 &coord) {
+	return readImagef(image, nullptr, float4(coord, 0, 0));
+}
+
+inline float4 read_imagef(const Image *image, const int4 &coord) {
+	return readImagef(image, nullptr, float4(coord));
+}
+
+inline int4 read_imagei(const Image *image, const Sampler *sampler, const float2 &coord) {
+	return readImagei(image, sampler, float4(coord, 0.0f, 0.0f));
+}
+
+inline int4 read_imagei(const Image *image, const Sampler *sampler, const float4 &coord) {
+	return readImagei(image, sampler, coord);
+}
+
+inline int4 read_imagei(const Image *image, const Sampler *sampler, const int2 &coord) {
+	return readImagei(image, sampler, float4(coord, 0, 0));
+}
+
+inline int4 read_imagei(const Image *image, const Sampler *sampler, const int4 &coord) {
+	return readImagei(image, sampler, float4(coord));
+}
+
+inline int4 read_imagei(const Image *image, const int2 &coord) {
+	return readImagei(image, nullptr, float4(coord, 0, 0));
+}
+
+inline int4 read_imagei(const Image *image, const int4 &coord) {
+	return readImagei(image, nullptr, float4(coord));
+}
+
+inline uint4 read_imageui(const Image *image, const Sampler *sampler, const float2 &coord) {
+	return readImageui(image, sampler, float4(coord, 0.0f, 0.0f));
+}
+
+inline uint4 read_imageui(const Image *image, const Sampler *sampler, const float4 &coord) {
+	return readImageui(image, sampler, coord);
+}
+
+inline uint4 read_imageui(const Image *image, const Sampler *sampler, const int2 &coord) {
+	return readImageui(image, sampler, float4(coord, 0, 0));
+}
+
+inline uint4 read_imageui(const Image *image, const Sampler *sampler, const int4 &coord) {
+	return readImageui(image, sampler, float4(coord));
+}
+
+inline uint4 read_imageui(const Image *image, const int2 &coord) {
+	return readImageui(image, nullptr, float4(coord, 0, 0));
+}
+
+inline uint4 read_imageui(const Image *image, const int4 &coord) {
+	return readImageui(image, nullptr, float4(coord));
+}
+
+inline void write_imagef(const Image *image, const int2 &coord, const float4 &color) {
+	writeImagef(image, int4(coord, 0, 0), color);
+}
+
+inline void write_imagef(const Image *image, const int4 &coord, const float4 &color) {
+	writeImagef(image, coord, color);
+}
+
+inline void write_imagei(const Image *image, const int2 &coord, const int4 &color) {
+	writeImagei(image, int4(coord, 0, 0), color);
+}
+
+inline void write_imagei(const Image *image, const int4 &coord, const int4 &color) {
+	writeImagei(image, coord, color);
+}
+
+inline void write_imageui(const Image *image, const int2 &coord, const uint4 &color) {
+	writeImageui(image, int4(coord, 0, 0), color);
+}
+
+inline void write_imageui(const Image *image, const int4 &coord, const uint4 &color) {
+	writeImageui(image, coord, color);
+}
+
+}
+}
@@ -0,0 +1,517 @@
+/**
+ * @file
+ *
+ * The cpu backend executes the host implementations of the kernels that the computeshadertool generates
+ * next to the OpenCL bindings. Buffers and textures are plain host memory and the global work size is split
+ * into work groups that are executed on a thread pool.
+ *
+ * @ingroup Compute
+ */
+#include "compute/Compute.h"
+#include "CPUKernel.h"
+#include "CPUMapping.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "core/StandardLib.h"
+#include "core/SharedPtr.h"
+#include "core/Trace.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/StringMap.h"
+#include "core/concurrent/Concurrency.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ThreadPool.h"
+#include <future>
+#include <vector>
+
+namespace compute {
+
+namespace _priv {
+
+struct Program {
+	core::StringMap<cpu::KernelFunc> kernels;
+};
+
+struct Kernel {
+	cpu::KernelFunc func = nullptr;
+	core::DynamicArray<cpu::KernelArg> args;
+};
+
+/**
+ * @brief The state of one kernelRun() call that is shared by all work groups
+ */
+struct Run {
+	cpu::KernelFunc func = nullptr;
+	core::DynamicArray<cpu::KernelArg> args;
+};
+
+struct Context {
+	core::SharedPtr<core::ThreadPool> threadPool;
+	core_trace_mutex(core::Lock, pendingLock, "ComputePending");
+	/**
+	 * The work groups of kernels that were started in non-blocking mode
+	 */
+	std::vector<std::future<void>> pending core_thread_guarded_by(pendingLock);
+	bool features[core::enumVal(Feature::Max)] {};
+};
+
+static Context _ctx;
+
+/**
+ * @brief Wait for all kernels that were started in non-blocking mode - just like the in-order command
+ * queue of OpenCL, every memory operation sees the results of the previously started kernels.
+ */
+static void waitPending() {
+	std::vector<std::future<void>> pending;
+	{
+		core::ScopedLock lock(_ctx.pendingLock);
+		pending.swap(_ctx.pending);
+	}
+	for (std::future<void> &f : pending) {
+		f.wait();
+	}
+}
+
+static void runGroup(const Run &run, const cpu::WorkItem &item) {
+	core_trace_scoped(ComputeRunGroup);
+	const uint32_t argCount = (uint32_t)run.args.size();
+	core::DynamicArray<void *> localMemory;
+	localMemory.resize(argCount);
+	for (uint32_t i = 0; i < argCount; ++i) {
+		localMemory[i] = nullptr;
+		const cpu::KernelArg &arg = run.args[i];
+		if (!arg.local) {
+			continue;
+		}
+		localMemory[i] = core_malloc(arg.size);
+		core_memset(localMemory[i], 0, arg.size);
+	}
+	const cpu::WorkGroup group(run.args.data(), argCount, localMemory.data(), item);
+	run.func(group);
+	for (void *mem : localMemory) {
+		core_free(mem);
+	}
+}
+
+}
+
+size_t requiredAlignment() {
+	// cache line size
+	return 64u;
+}
+
+bool configureProgram(Id program) {
+	return program != InvalidId;
+}
+
+bool deleteProgram(Id& program) {
+	if (program == InvalidId) {
+		return true;
+	}
+	delete (_priv::Program *)program;
+	program = InvalidId;
+	return true;
+}
+
+Id createBuffer(BufferFlag flags, size_t size, void* data) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	core_assert(size > 0);
+	// the memory is always owned by the buffer - even for UseHostPointer. The generated shaders keep
+	// their buffers alive between the calls, but the host memory of the caller might already be gone.
+	cpu::Buffer *buffer = new cpu::Buffer();
+	buffer->data = (uint8_t *)core_malloc(size);
+	buffer->size = size;
+	if (data != nullptr) {
+		core_memcpy(buffer->data, data, size);
+	} else {
+		core_memset(buffer->data, 0, size);
+	}
+	return (Id)buffer;
+}
+
+bool deleteBuffer(Id& buffer) {
+	if (buffer == InvalidId) {
+		return true;
+	}
+	_priv::waitPending();
+	cpu::Buffer *b = (cpu::Buffer *)buffer;
+	core_free(b->data);
+	delete b;
+	buffer = InvalidId;
+	return true;
+}
+
+bool updateBuffer(Id buffer, size_t size, const void* data, bool blockingWrite) {
+	if (buffer == InvalidId) {
+		return false;
+	}
+	if (data == nullptr || size == 0u) {
+		return false;
+	}
+	_priv::waitPending();
+	cpu::Buffer *b = (cpu::Buffer *)buffer;
+	if (size > b->size) {
+		b->data = (uint8_t *)core_realloc(b->data, size);
+		b->size = size;
+	}
+	core_memcpy(b->data, data, size);
+	return true;
+}
+
+bool readBuffer(Id buffer, size_t size, void* data) {
+	if (buffer == InvalidId) {
+		return false;
+	}
+	if (size <= 0) {
+		return false;
+	}
+	if (data == nullptr) {
+		return false;
+	}
+	_priv::waitPending();
+	const cpu::Buffer *b = (const cpu::Buffer *)buffer;
+	if (size > b->size) {
+		Log::error("Expected to read %i bytes, but the buffer only has %i", (int)size, (int)b->size);
+		return false;
+	}
+	core_memcpy(data, b->data, size);
+	return true;
+}
+
+Id createTexture(const Texture& texture, const uint8_t* data) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	const int channelSize = _priv::TextureDataFormatSizes[core::enumVal(texture.dataformat())];
+	if (channelSize == 0) {
+		Log::error("Texture data format %i is not supported", (int)core::enumVal(texture.dataformat()));
+		return InvalidId;
+	}
+	if (texture.width() <= 0) {
+		Log::error("Texture width is 0");
+		return InvalidId;
+	}
+	if (texture.height() <= 0) {
+		Log::error("Texture height is 0");
+		return InvalidId;
+	}
+	cpu::Image *image = new cpu::Image();
+	image->type = texture.type();
+	image->format = texture.format();
+	image->dataformat = texture.dataformat();
+	image->components = _priv::TextureFormatComponents[core::enumVal(texture.format())];
+	image->channelSize = channelSize;
+	image->size.x = texture.width();
+	image->size.y = texture.type() == TextureType::Texture1D ? 1 : texture.height();
+	image->size.z = texture.type() == TextureType::Texture3D ? texture.layers() : 1;
+	const size_t size = image->slicePitch() * (size_t)image->size.z;
+	image->data = (uint8_t *)core_malloc(size);
+	if (data != nullptr) {
+		core_memcpy(image->data, data, size);
+	} else {
+		core_memset(image->data, 0, size);
+	}
+	return (Id)image;
+}
+
+void deleteTexture(Id& id) {
+	if (id == InvalidId) {
+		return;
+	}
+	_priv::waitPending();
+	cpu::Image *image = (cpu::Image *)id;
+	core_free(image->data);
+	delete image;
+	id = InvalidId;
+}
+
+Id createSampler(const TextureConfig& config) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	if (config.filter() == TextureFilter::Linear) {
+		Log::debug("Linear filtering is not supported - using nearest filtering");
+	}
+	cpu::Sampler *sampler = new cpu::Sampler();
+	sampler->normalizedCoordinates = config.normalizedCoordinates();
+	sampler->wrap = config.wrap();
+	sampler->filter = config.filter();
+	return (Id)sampler;
+}
+
+void deleteSampler(Id& id) {
+	if (id == InvalidId) {
+		return;
+	}
+	delete (cpu::Sampler *)id;
+	id = InvalidId;
+}
+
+static bool validRegion(const cpu::Image *image, const glm::ivec3& origin, const glm::ivec3& region) {
+	if (region.x <= 0 || region.y <= 0 || region.z <= 0) {
+		Log::debug("Region must be bigger than 0 in every dimension");
+		return false;
+	}
+	for (int i = 0; i < 3; ++i) {
+		if (origin[i] < 0 || origin[i] + region[i] > image->size[i]) {
+			Log::debug("region (%i:%i:%i) and offset (%i:%i:%i) exceed the texture boundaries (%i,%i,%i)",
+				region.x, region.y, region.z, origin.x, origin.y, origin.z, image->size.x, image->size.y, image->size.z);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool readTexture(compute::Texture& texture, void *data, const glm::ivec3& origin, const glm::ivec3& region, bool blocking) {
+	if (data == nullptr) {
+		return false;
+	}
+	const compute::Id textureId = texture.handle();
+	if (textureId == compute::InvalidId) {
+		Log::debug("Invalid texture given");
+		return false;
+	}
+	const cpu::Image *image = (const cpu::Image *)textureId;
+	if (!validRegion(image, origin, region)) {
+		return false;
+	}
+	_priv::waitPending();
+	const size_t rowSize = image->texelSize() * (size_t)region.x;
+	uint8_t *target = (uint8_t *)data;
+	for (int z = 0; z < region.z; ++z) {
+		for (int y = 0; y < region.y; ++y) {
+			core_memcpy(target, image->texel(origin + glm::ivec3(0, y, z)), rowSize);
+			target += rowSize;
+		}
+	}
+	return true;
+}
+
+bool copyBufferToImage(compute::Id buffer, compute::Id image, size_t bufferOffset, const glm::ivec3& origin, const glm::ivec3& region) {
+	if (buffer == InvalidId || image == InvalidId) {
+		return false;
+	}
+	const cpu::Buffer *b = (const cpu::Buffer *)buffer;
+	const cpu::Image *img = (const cpu::Image *)image;
+	if (!validRegion(img, origin, region)) {
+		return false;
+	}
+	const size_t rowSize = img->texelSize() * (size_t)region.x;
+	if (bufferOffset + rowSize * (size_t)region.y * (size_t)region.z > b->size) {
+		Log::debug("The buffer doesn't contain enough data for the given region");
+		return false;
+	}
+	_priv::waitPending();
+	const uint8_t *source = b->data + bufferOffset;
+	for (int z = 0; z < region.z; ++z) {
+		for (int y = 0; y < region.y; ++y) {
+			core_memcpy(img->texel(origin + glm::ivec3(0, y, z)), source, rowSize);
+			source += rowSize;
+		}
+	}
+	return true;
+}
+
+Id createProgram(const core::String& source) {
+	if (!supported()) {
+		return InvalidId;
+	}
+	// the source is not needed - the kernels are registered by the generated shader code
+	return (Id)new _priv::Program();
+}
+
+bool registerKernel(Id program, const char *name, cpu::KernelFunc func) {
+	if (program == InvalidId) {
+		return false;
+	}
+	core_assert(name != nullptr);
+	core_assert(func != nullptr);
+	_priv::Program *p = (_priv::Program *)program;
+	p->kernels.put(name, func);
+	return true;
+}
+
+Id createKernel(Id program, const char *name) {
+	if (program == InvalidId) {
+		return InvalidId;
+	}
+	core_assert(name != nullptr);
+	const _priv::Program *p = (const _priv::Program *)program;
+	auto i = p->kernels.find(name);
+	if (i == p->kernels.end()) {
+		Log::warn("No host implementation for kernel %s", name);
+		return InvalidId;
+	}
+	_priv::Kernel *kernel = new _priv::Kernel();
+	kernel->func = i->value;
+	return (Id)kernel;
+}
+
+bool deleteKernel(Id& kernel) {
+	if (kernel == InvalidId) {
+		return false;
+	}
+	_priv::waitPending();
+	delete (_priv::Kernel *)kernel;
+	kernel = InvalidId;
+	return true;
+}
+
+static cpu::KernelArg *kernelArgSlot(Id kernel, uint32_t index) {
+	_priv::Kernel *k = (_priv::Kernel *)kernel;
+	if (index >= k->args.size()) {
+		k->args.resize(index + 1);
+	}
+	return &k->args[index];
+}
+
+bool kernelArg(Id kernel, uint32_t index, const Texture& texture, int32_t samplerIndex) {
+	if (kernel == InvalidId) {
+		return false;
+	}
+	Log::debug("Set kernel arg for index %u to texture %p", index, texture.handle());
+	const Id textureId = texture.handle();
+	if (!kernelArg(kernel, index, sizeof(Id), &textureId)) {
+		return false;
+	}
+	if (samplerIndex >= 0) {
+		const Id samplerId = texture.sampler();
+		return kernelArg(kernel, samplerIndex, sizeof(Id), &samplerId);
+	}
+	return true;
+}
+
+bool kernelArg(Id kernel, uint32_t index, size_t size, const void* data) {
+	if (kernel == InvalidId) {
+		return false;
+	}
+	if (size > cpu::KernelArg::MaxSize && data != nullptr) {
+		Log::error("Kernel argument %u exceeds the max size of %i bytes", index, (int)cpu::KernelArg::MaxSize);
+		return false;
+	}
+	Log::debug("Set kernel arg for index %u", index);
+	cpu::KernelArg *arg = kernelArgSlot(kernel, index);
+	arg->size = size;
+	// a null pointer specifies the size of a __local argument
+	arg->local = data == nullptr;
+	if (data != nullptr) {
+		core_memcpy(arg->value, data, size);
+	}
+	return true;
+}
+
+/**
+ * The work groups are slices of the global work size along the highest used dimension. Their amount depends
+ * on the thread pool size to balance the work between the threads.
+ */
+bool kernelRun(Id kernel, const glm::ivec3& workSize, int workDim, bool blocking) {
+	if (kernel == InvalidId) {
+		Log::error("Given kernel handle is invalid");
+		return false;
+	}
+	core_assert_always(workDim > 0);
+	core_assert_always(workDim <= 3);
+	if (!supported()) {
+		return false;
+	}
+	core_trace_scoped(ComputeKernelRun);
+	glm::ivec3 globalSize(1);
+	for (int i = 0; i < workDim; ++i) {
+		if (workSize[i] <= 0) {
+			Log::error("Invalid work size for dimension %i: %i", i, workSize[i]);
+			return false;
+		}
+		globalSize[i] = workSize[i];
+	}
+	const _priv::Kernel *k = (const _priv::Kernel *)kernel;
+	const core::SharedPtr<_priv::Run> run = core::make_shared<_priv::Run>();
+	run->func = k->func;
+	run->args = k->args;
+
+	const int axis = workDim - 1;
+	const int extent = globalSize[axis];
+	const int maxGroups = (int)_priv::_ctx.threadPool->size() * 4;
+	const int groupExtent = (extent + maxGroups - 1) / maxGroups;
+	const int numGroups = (extent + groupExtent - 1) / groupExtent;
+
+	cpu::WorkItem item;
+	item.workDim = workDim;
+	item.globalSize = globalSize;
+	item.groupSize = globalSize;
+	item.numGroups[axis] = numGroups;
+	// the kernel might read the output of a previous non-blocking kernel
+	_priv::waitPending();
+	if (numGroups == 1 && blocking) {
+		_priv::runGroup(*run.get(), item);
+		return true;
+	}
+
+	std::vector<std::future<void>> futures;
+	futures.reserve(numGroups);
+	for (int g = 0; g < numGroups; ++g) {
+		item.groupId[axis] = g;
+		item.groupOffset[axis] = g * groupExtent;
+		item.groupSize[axis] = core_min(groupExtent, extent - g * groupExtent);
+		std::future<void> f = _priv::_ctx.threadPool->enqueue([run, item] () {
+			_priv::runGroup(*run.get(), item);
+		});
+		if (!f.valid()) {
+			Log::error("Failed to enqueue work group %i", g);
+			return false;
+		}
+		futures.emplace_back(core::move(f));
+	}
+	if (!blocking) {
+		core::ScopedLock lock(_priv::_ctx.pendingLock);
+		for (std::future<void> &f : futures) {
+			_priv::_ctx.pending.emplace_back(core::move(f));
+		}
+		return true;
+	}
+	for (std::future<void> &f : futures) {
+		f.wait();
+	}
+	return true;
+}
+
+bool finish() {
+	if (!supported()) {
+		return true;
+	}
+	_priv::waitPending();
+	return true;
+}
+
+bool supported() {
+	return _priv::_ctx.threadPool;
+}
+
+bool init() {
+	core_assert(!_priv::_ctx.threadPool);
+	const uint32_t threads = core::cpus();
+	_priv::_ctx.threadPool = core::make_shared<core::ThreadPool>(threads, "Compute");
+	_priv::_ctx.threadPool->init();
+	_priv::_ctx.features[core::enumVal(Feature::Write3dTextures)] = true;
+	Log::info("CPU compute backend with %u threads", threads);
+	return true;
+}
+
+void shutdown() {
+	if (!_priv::_ctx.threadPool) {
+		return;
+	}
+	_priv::waitPending();
+	_priv::_ctx.threadPool->shutdown(true);
+	_priv::_ctx.threadPool = core::SharedPtr<core::ThreadPool>();
+	for (int i = 0; i < core::enumVal(Feature::Max); ++i) {
+		_priv::_ctx.features[i] = false;
+	}
+}
+
+bool hasFeature(Feature f) {
+	return _priv::_ctx.features[core::enumVal(f)];
+}
+
+}
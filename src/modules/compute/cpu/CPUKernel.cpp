@@ -0,0 +1,239 @@
+/**
+ * @file
+ *
+ * @ingroup Compute
+ */
+#include "CLBuiltins.h"
+#include "core/Common.h"
+#include <glm/common.hpp>
+
+namespace compute {
+namespace cpu {
+
+namespace _priv {
+
+thread_local WorkItem workItem;
+
+/**
+ * @brief Maps the texel coordinate according to the addressing mode of the sampler
+ * @return @c false if the coordinate is outside of the image and the border color should be used
+ */
+static bool address(int &coord, int size, TextureWrap wrap) {
+	switch (wrap) {
+	case TextureWrap::Repeat:
+		coord %= size;
+		if (coord < 0) {
+			coord += size;
+		}
+		return true;
+	case TextureWrap::MirroredRepeat: {
+		const int period = 2 * size;
+		coord %= period;
+		if (coord < 0) {
+			coord += period;
+		}
+		if (coord >= size) {
+			coord = period - coord - 1;
+		}
+		return true;
+	}
+	case TextureWrap::ClampToBorder:
+		return coord >= 0 && coord < size;
+	case TextureWrap::ClampToEdge:
+	case TextureWrap::None:
+	default:
+		// for None the coordinates must be inside of the image - clamp them anyway to not read outside of the memory
+		coord = glm::clamp(coord, 0, size - 1);
+		return true;
+	}
+}
+
+static bool texelCoord(const Image *image, const Sampler *sampler, const glm::vec4 &coord, glm::ivec3 &pos) {
+	const bool normalized = sampler != nullptr && sampler->normalizedCoordinates;
+	const TextureWrap wrap = sampler != nullptr ? sampler->wrap : TextureWrap::ClampToEdge;
+	const int dimensions = image->type == TextureType::Texture3D ? 3 : (image->type == TextureType::Texture2D ? 2 : 1);
+	bool inside = true;
+	for (int i = 0; i < 3; ++i) {
+		if (i >= dimensions) {
+			pos[i] = 0;
+			continue;
+		}
+		const float c = normalized ? coord[i] * (float)image->size[i] : coord[i];
+		pos[i] = (int)glm::floor(c);
+		inside &= address(pos[i], image->size[i], wrap);
+	}
+	return inside;
+}
+
+/**
+ * @brief The position of the red, green, blue and alpha channel in the texel or @c -1 if the channel doesn't exist
+ */
+static const int *channelOrder(TextureFormat format) {
+	static const int rgba[] = {0, 1, 2, 3};
+	static const int rgb[] = {0, 1, 2, -1};
+	static const int bgra[] = {2, 1, 0, 3};
+	static const int argb[] = {1, 2, 3, 0};
+	static const int rg[] = {0, 1, -1, -1};
+	static const int r[] = {0, -1, -1, -1};
+	switch (format) {
+	case TextureFormat::RGB:
+		return rgb;
+	case TextureFormat::BGRA:
+		return bgra;
+	case TextureFormat::ARGB:
+		return argb;
+	case TextureFormat::RG:
+		return rg;
+	case TextureFormat::R:
+		return r;
+	case TextureFormat::RGBA:
+	default:
+		return rgba;
+	}
+}
+
+static bool isNormalized(TextureDataFormat format) {
+	return format == TextureDataFormat::SNORM_INT8 || format == TextureDataFormat::SNORM_INT16
+		|| format == TextureDataFormat::UNORM_INT8 || format == TextureDataFormat::UNORM_INT16
+		|| format == TextureDataFormat::FLOAT;
+}
+
+/**
+ * @return The channel value - normalized formats are converted into floating point values
+ */
+static double readChannel(const uint8_t *data, TextureDataFormat format) {
+	switch (format) {
+	case TextureDataFormat::SNORM_INT8:
+		return core_max(-1.0, *(const int8_t *)data / 127.0);
+	case TextureDataFormat::SNORM_INT16:
+		return core_max(-1.0, *(const int16_t *)data / 32767.0);
+	case TextureDataFormat::UNORM_INT8:
+		return *data / 255.0;
+	case TextureDataFormat::UNORM_INT16:
+		return *(const uint16_t *)data / 65535.0;
+	case TextureDataFormat::SIGNED_INT8:
+		return *(const int8_t *)data;
+	case TextureDataFormat::SIGNED_INT16:
+		return *(const int16_t *)data;
+	case TextureDataFormat::SIGNED_INT32:
+		return *(const int32_t *)data;
+	case TextureDataFormat::UNSIGNED_INT8:
+		return *data;
+	case TextureDataFormat::UNSIGNED_INT16:
+		return *(const uint16_t *)data;
+	case TextureDataFormat::UNSIGNED_INT32:
+		return *(const uint32_t *)data;
+	case TextureDataFormat::FLOAT:
+		return *(const float *)data;
+	default:
+		return 0.0;
+	}
+}
+
+static void writeChannel(uint8_t *data, TextureDataFormat format, double value) {
+	switch (format) {
+	case TextureDataFormat::SNORM_INT8:
+		*(int8_t *)data = (int8_t)glm::round(glm::clamp(value, -1.0, 1.0) * 127.0);
+		break;
+	case TextureDataFormat::SNORM_INT16:
+		*(int16_t *)data = (int16_t)glm::round(glm::clamp(value, -1.0, 1.0) * 32767.0);
+		break;
+	case TextureDataFormat::UNORM_INT8:
+		*data = (uint8_t)glm::round(glm::clamp(value, 0.0, 1.0) * 255.0);
+		break;
+	case TextureDataFormat::UNORM_INT16:
+		*(uint16_t *)data = (uint16_t)glm::round(glm::clamp(value, 0.0, 1.0) * 65535.0);
+		break;
+	case TextureDataFormat::SIGNED_INT8:
+		*(int8_t *)data = (int8_t)glm::clamp(value, -128.0, 127.0);
+		break;
+	case TextureDataFormat::SIGNED_INT16:
+		*(int16_t *)data = (int16_t)glm::clamp(value, -32768.0, 32767.0);
+		break;
+	case TextureDataFormat::SIGNED_INT32:
+		*(int32_t *)data = (int32_t)value;
+		break;
+	case TextureDataFormat::UNSIGNED_INT8:
+		*data = (uint8_t)glm::clamp(value, 0.0, 255.0);
+		break;
+	case TextureDataFormat::UNSIGNED_INT16:
+		*(uint16_t *)data = (uint16_t)glm::clamp(value, 0.0, 65535.0);
+		break;
+	case TextureDataFormat::UNSIGNED_INT32:
+		*(uint32_t *)data = (uint32_t)value;
+		break;
+	case TextureDataFormat::FLOAT:
+		*(float *)data = (float)value;
+		break;
+	default:
+		break;
+	}
+}
+
+static glm::dvec4 readTexel(const Image *image, const Sampler *sampler, const glm::vec4 &coord) {
+	glm::ivec3 pos;
+	const int *order = channelOrder(image->format);
+	if (!texelCoord(image, sampler, coord, pos)) {
+		// the border color has an alpha value of 1 if the image doesn't have an alpha channel
+		return glm::dvec4(0.0, 0.0, 0.0, order[3] == -1 ? 1.0 : 0.0);
+	}
+	const uint8_t *texel = image->texel(pos);
+	glm::dvec4 color(0.0, 0.0, 0.0, 1.0);
+	for (int i = 0; i < 4; ++i) {
+		if (order[i] == -1) {
+			continue;
+		}
+		color[i] = readChannel(texel + order[i] * image->channelSize, image->dataformat);
+	}
+	return color;
+}
+
+static void writeTexel(const Image *image, const glm::ivec4 &coord, const glm::dvec4 &color) {
+	const glm::ivec3 pos(coord);
+	for (int i = 0; i < 3; ++i) {
+		if (pos[i] < 0 || pos[i] >= image->size[i]) {
+			// writes outside of the image are ignored
+			return;
+		}
+	}
+	uint8_t *texel = image->texel(pos);
+	const int *order = channelOrder(image->format);
+	for (int i = 0; i < 4; ++i) {
+		if (order[i] == -1) {
+			continue;
+		}
+		writeChannel(texel + order[i] * image->channelSize, image->dataformat, color[i]);
+	}
+}
+
+}
+
+glm::vec4 readImagef(const Image *image, const Sampler *sampler, const glm::vec4 &coord) {
+	core_assert_msg(_priv::isNormalized(image->dataformat), "read_imagef needs a normalized or float image");
+	return glm::vec4(_priv::readTexel(image, sampler, coord));
+}
+
+glm::ivec4 readImagei(const Image *image, const Sampler *sampler, const glm::vec4 &coord) {
+	core_assert_msg(!_priv::isNormalized(image->dataformat), "read_imagei needs an integer image");
+	return glm::ivec4(_priv::readTexel(image, sampler, coord));
+}
+
+glm::uvec4 readImageui(const Image *image, const Sampler *sampler, const glm::vec4 &coord) {
+	core_assert_msg(!_priv::isNormalized(image->dataformat), "read_imageui needs an integer image");
+	return glm::uvec4(_priv::readTexel(image, sampler, coord));
+}
+
+void writeImagef(const Image *image, const glm::ivec4 &coord, const glm::vec4 &color) {
+	_priv::writeTexel(image, coord, glm::dvec4(color));
+}
+
+void writeImagei(const Image *image, const glm::ivec4 &coord, const glm::ivec4 &color) {
+	_priv::writeTexel(image, coord, glm::dvec4(color));
+}
+
+void writeImageui(const Image *image, const glm::ivec4 &coord, const glm::uvec4 &color) {
+	_priv::writeTexel(image, coord, glm::dvec4(color));
+}
+
+}
+}
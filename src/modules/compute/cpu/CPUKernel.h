@@ -0,0 +1,210 @@
+/**
+ * @file
+ *
+ * @ingroup Compute
+ */
+#pragma once
+
+#include "compute/Types.h"
+#include "core/Assert.h"
+#include "core/StandardLib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+namespace compute {
+namespace cpu {
+
+/**
+ * @brief Host memory of a buffer object of the cpu backend
+ */
+struct Buffer {
+	uint8_t *data = nullptr;
+	size_t size = 0u;
+};
+
+/**
+ * @brief Host memory of a texture object of the cpu backend. The texels are stored as a linear sequence
+ * of slices, rows and texels without any padding.
+ */
+struct Image {
+	TextureType type = TextureType::Texture2D;
+	TextureFormat format = TextureFormat::RGBA;
+	TextureDataFormat dataformat = TextureDataFormat::UNORM_INT8;
+	glm::ivec3 size {1};
+	int components = 4;
+	int channelSize = 1;
+	uint8_t *data = nullptr;
+
+	size_t texelSize() const;
+	size_t rowPitch() const;
+	size_t slicePitch() const;
+	uint8_t *texel(const glm::ivec3 &pos) const;
+};
+
+/**
+ * @note Only nearest filtering is supported - linear filtering falls back to nearest.
+ */
+struct Sampler {
+	bool normalizedCoordinates = false;
+	TextureWrap wrap = TextureWrap::ClampToEdge;
+	TextureFilter filter = TextureFilter::Nearest;
+};
+
+/**
+ * @brief A kernel argument as it was given to compute::kernelArg()
+ */
+struct KernelArg {
+	static constexpr size_t MaxSize = 128u;
+	alignas(16) uint8_t value[MaxSize];
+	size_t size = 0u;
+	/**
+	 * @c __local arguments only specify the size - each work group gets its own memory of that size
+	 */
+	bool local = false;
+};
+
+/**
+ * @brief The state of the work item that is executed by the calling thread. This is what the work item
+ * functions like @c get_global_id() are returning.
+ */
+struct WorkItem {
+	glm::ivec3 globalId {0};
+	glm::ivec3 globalSize {1};
+	glm::ivec3 groupOffset {0};
+	glm::ivec3 groupSize {1};
+	glm::ivec3 groupId {0};
+	glm::ivec3 numGroups {1};
+	int workDim = 1;
+};
+
+namespace _priv {
+extern thread_local WorkItem workItem;
+}
+
+/**
+ * @brief A tile of the global work size that is executed by one thread of the cpu backend. The host
+ * implementation of a kernel fetches its arguments from here and executes all work items of the group.
+ */
+class WorkGroup {
+private:
+	const KernelArg *_args;
+	const uint32_t _argCount;
+	/**
+	 * The memory for @c __local arguments or @c nullptr
+	 */
+	void *const *_localMemory;
+	WorkItem _item;
+
+	const KernelArg &arg(uint32_t index) const;
+	template<class T>
+	T *handle(uint32_t index) const;
+public:
+	WorkGroup(const KernelArg *args, uint32_t argCount, void *const *localMemory, const WorkItem &item);
+
+	/**
+	 * @return The host memory of the buffer or the work group memory of a @c __local argument
+	 */
+	template<class T>
+	T *buffer(uint32_t index) const;
+	template<class T>
+	T value(uint32_t index) const;
+	const Image *image(uint32_t index) const;
+	const Sampler *sampler(uint32_t index) const;
+
+	/**
+	 * @brief Executes the given functor for each work item of the group
+	 */
+	template<class FUNC>
+	void run(FUNC &&func) const;
+};
+
+/**
+ * @brief Host implementation of a kernel - generated by the computeshadertool
+ */
+typedef void (*KernelFunc)(const WorkGroup &group);
+
+inline size_t Image::texelSize() const {
+	return (size_t)components * (size_t)channelSize;
+}
+
+inline size_t Image::rowPitch() const {
+	return texelSize() * (size_t)size.x;
+}
+
+inline size_t Image::slicePitch() const {
+	return rowPitch() * (size_t)size.y;
+}
+
+inline uint8_t *Image::texel(const glm::ivec3 &pos) const {
+	return data + (size_t)pos.z * slicePitch() + (size_t)pos.y * rowPitch() + (size_t)pos.x * texelSize();
+}
+
+inline WorkGroup::WorkGroup(const KernelArg *args, uint32_t argCount, void *const *localMemory, const WorkItem &item) :
+		_args(args), _argCount(argCount), _localMemory(localMemory), _item(item) {
+}
+
+inline const KernelArg &WorkGroup::arg(uint32_t index) const {
+	core_assert_msg(index < _argCount, "Kernel argument %u was not set", index);
+	return _args[index];
+}
+
+template<class T>
+inline T *WorkGroup::handle(uint32_t index) const {
+	const KernelArg &a = arg(index);
+	core_assert(a.size >= sizeof(Id));
+	Id id;
+	core_memcpy(&id, a.value, sizeof(id));
+	return (T *)id;
+}
+
+template<class T>
+inline T *WorkGroup::buffer(uint32_t index) const {
+	if (arg(index).local) {
+		return (T *)_localMemory[index];
+	}
+	const Buffer *b = handle<const Buffer>(index);
+	if (b == nullptr) {
+		return nullptr;
+	}
+	return (T *)b->data;
+}
+
+template<class T>
+inline T WorkGroup::value(uint32_t index) const {
+	const KernelArg &a = arg(index);
+	core_assert_msg(a.size >= sizeof(T), "Kernel argument %u has %i bytes, but %i are needed", index, (int)a.size, (int)sizeof(T));
+	T v;
+	core_memcpy((void *)&v, a.value, sizeof(T));
+	return v;
+}
+
+inline const Image *WorkGroup::image(uint32_t index) const {
+	return handle<const Image>(index);
+}
+
+inline const Sampler *WorkGroup::sampler(uint32_t index) const {
+	return handle<const Sampler>(index);
+}
+
+template<class FUNC>
+inline void WorkGroup::run(FUNC &&func) const {
+	WorkItem &item = _priv::workItem;
+	item = _item;
+	const glm::ivec3 &mins = _item.groupOffset;
+	const glm::ivec3 maxs = mins + _item.groupSize;
+	for (int z = mins.z; z < maxs.z; ++z) {
+		item.globalId.z = z;
+		for (int y = mins.y; y < maxs.y; ++y) {
+			item.globalId.y = y;
+			for (int x = mins.x; x < maxs.x; ++x) {
+				item.globalId.x = x;
+				func();
+			}
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,48 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "compute/Types.h"
+#include "core/ArrayLength.h"
+
+namespace compute {
+
+namespace _priv {
+
+static int TextureFormatComponents[] {
+	4,
+	3,
+	4,
+	4,
+	2,
+	1
+};
+static_assert(core::enumVal(TextureFormat::Max) == lengthof(TextureFormatComponents), "Array sizes don't match Max");
+
+/**
+ * The packed and half float formats are not supported by the cpu backend - their size is @c 0
+ */
+static int TextureDataFormatSizes[] {
+	1,
+	2,
+	1,
+	2,
+	0,
+	0,
+	0,
+	1,
+	2,
+	4,
+	1,
+	2,
+	4,
+	0,
+	4
+};
+static_assert(core::enumVal(TextureDataFormat::Max) == lengthof(TextureDataFormatSizes), "Array sizes don't match Max");
+
+}
+
+}
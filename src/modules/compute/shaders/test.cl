@@ -53,12 +53,11 @@ __kernel void exampleVectorAddFloat3(__global const float3 *A, __global const fl
 }
 
 __kernel void exampleVectorAddFloat3NoPointer(const float3 A, const float3 B, float3 C) {
-	int i1 = get_global_id(0);
 }
 
 __kernel void examplePointertest(__global const float*A, __global const float*B, __global float3*C) {
 	int i1 = get_global_id(0);
-	C[i1] = A[i1] + B[i1];
+	C[i1] = (float3)(A[i1] + B[i1]);
 }
 
 __kernel void exampleLocal(__local const char *  bufLocal, __global const char* buf, __global char* buf2) {
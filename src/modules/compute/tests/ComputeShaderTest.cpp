@@ -3,6 +3,7 @@
  */
 
 #include "app/tests/AbstractTest.h"
+#include "core/StringUtil.h"
 #include "TestsComputeShaders.h"
 
 namespace compute {
@@ -101,12 +102,33 @@ TEST_F(ComputeShaderTest, testExecuteExampleVectorAddFloat3) {
 	}
 	compute::TestShader shader;
 	ASSERT_TRUE(shader.setup());
-	const std::vector<glm::vec3> A {glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 2.0f}};
-	const std::vector<glm::vec3> B {glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{0.0f, 2.0f, 4.0f}};
-	std::vector<glm::vec3> C(2);
+	const std::vector<glm::vec3> A {glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 2.0f}, glm::vec3{0.0f, 1.0f, 2.0f}};
+	const std::vector<glm::vec3> B {glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{0.0f, 2.0f, 4.0f}, glm::vec3{0.0f, 2.0f, 4.0f}};
+	std::vector<glm::vec3> C(3);
 	ASSERT_TRUE(shader.exampleVectorAddFloat3(A, B, C, glm::ivec1(3)));
 	ASSERT_FLOAT_EQ(C[0][0], 0.0f);
-	ASSERT_FLOAT_EQ(C[2][1], 6.0f);
+	ASSERT_FLOAT_EQ(C[2][1], 3.0f);
+	ASSERT_FLOAT_EQ(C[2][2], 6.0f);
+}
+
+TEST_F(ComputeShaderTest, testExecuteExampleDataStruct) {
+	if (!_supported) {
+		return;
+	}
+	compute::TestShader shader;
+	ASSERT_TRUE(shader.setup());
+	compute::TestShader::Data in {};
+	in.foo_int32_t = 42;
+	compute::TestShader::Data out {};
+	compute::Id inBuffer = compute::createBuffer(compute::BufferFlag::ReadOnly, sizeof(in), &in);
+	compute::Id outBuffer = compute::createBuffer(compute::BufferFlag::ReadWrite, sizeof(out), &out);
+	ASSERT_NE(compute::InvalidId, inBuffer);
+	ASSERT_NE(compute::InvalidId, outBuffer);
+	EXPECT_TRUE(shader.exampleDataStruct(inBuffer, outBuffer, glm::ivec1(1)));
+	EXPECT_TRUE(compute::readBuffer(outBuffer, sizeof(out), &out));
+	EXPECT_EQ(42, out.foo_int32_t);
+	compute::deleteBuffer(inBuffer);
+	compute::deleteBuffer(outBuffer);
 }
 
 // just for comparing runtimes
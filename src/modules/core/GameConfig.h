@@ -62,8 +62,11 @@ constexpr const char *ServerSeed = "sv_seed";
 constexpr const char *ServerHost = "sv_host";
 constexpr const char *ServerPort = "sv_port";
 constexpr const char *ServerMaxClients = "sv_maxclients";
+constexpr const char *ServerNetworkWorkers = "sv_networkworkers";
 constexpr const char *ServerPostgresLib = "sv_postgreslib";
 constexpr const char *ServerHttpPort = "sv_httpport";
+// the ai update tiers by distance to the nearest player - see backend::AIScheduler
+constexpr const char *ServerAITiers = "sv_aitiers";
 // the download urls for the chunks
 constexpr const char *ServerChunkBaseUrl = "sv_httpchunkurl";
 
@@ -72,6 +75,9 @@ constexpr const char *ConsoleCurses = "con_curses";
 constexpr const char *CoreMaxFPS = "core_maxfps";
 constexpr const char *CoreLogLevel = "core_loglevel";
 constexpr const char *CoreSysLog = "core_syslog";
+constexpr const char *CoreLogAsync = "core_logasync";
+constexpr const char *CoreLogAsyncBlock = "core_logasyncblock";
+constexpr const char *CoreLogRateLimit = "core_lograte";
 constexpr const char *CorePath = "core_path";
 
 // The size of the chunk that is extracted with each step
@@ -84,12 +90,15 @@ constexpr const char *DatabasePassword = "db_pw";
 constexpr const char *DatabaseUser = "db_user";
 constexpr const char *DatabaseMinConnections = "db_minconnections";
 constexpr const char *DatabaseMaxConnections = "db_maxconnections";
+// The amount of connections that are used in parallel to write the dirty states
+constexpr const char *DatabaseWriters = "db_writers";
 
 constexpr const char *AppHomePath = "app_homepath";
 
 constexpr const char *MetricPort = "metric_port";
 constexpr const char *MetricHost = "metric_host";
 constexpr const char *MetricFlavor = "metric_flavor";
+constexpr const char *MetricFlushMillis = "metric_flushmillis";
 
 constexpr const char *VoxelPalette = "palette";
 constexpr const char *VoxformatMergequads = "voxformat_mergequads";
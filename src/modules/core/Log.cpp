@@ -10,9 +10,16 @@
 #include "core/Enum.h"
 #include "core/ArrayLength.h"
 #include "core/Assert.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/Thread.h"
+#include "core/Trace.h"
 #include <string.h>
 #include <stdio.h>
 #include <unordered_map>
+#include <new>
+#include <SDL_timer.h>
 
 #ifdef HAVE_SYSLOG_H
 #include <syslog.h>
@@ -64,6 +71,340 @@ static void sysLogOutputFunction(void *userdata, int category, SDL_LogPriority p
 	}
 }
 #endif
+
+/**
+ * @brief Writes the message to the log file and to the SDL log output on the calling thread
+ */
+static void output(SDL_LogPriority priority, uint32_t id, const char *buf) {
+	const char *name;
+	const char *color;
+	switch (priority) {
+	case SDL_LOG_PRIORITY_VERBOSE:
+		name = "TRACE";
+		color = ANSI_COLOR_GREEN;
+		break;
+	case SDL_LOG_PRIORITY_DEBUG:
+		name = "DEBUG";
+		color = ANSI_COLOR_BLUE;
+		break;
+	case SDL_LOG_PRIORITY_INFO:
+		name = "INFO";
+		color = ANSI_COLOR_GREEN;
+		break;
+	case SDL_LOG_PRIORITY_WARN:
+		name = "WARN";
+		color = ANSI_COLOR_YELLOW;
+		break;
+	default:
+		name = "ERROR";
+		color = ANSI_COLOR_RED;
+		break;
+	}
+	if (_logfile) {
+		fprintf(_logfile, "[%s] (%u) %s\n", name, id, buf);
+	}
+	if (_syslog) {
+		SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, priority, "(%u) %s\n", id, buf);
+	} else {
+		SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, priority, "(%u) %s%s" ANSI_COLOR_RESET "\n", id, color, buf);
+	}
+}
+
+/**
+ * @brief Messages per second that are logged for each call site - @c 0 disables the rate limiting
+ */
+static int _rateLimit = 0;
+static core::AtomicInt _rateLimited { 0 };
+
+struct RateLimit {
+	core::AtomicPtr<const char> site;
+	core::AtomicInt second { 0 };
+	core::AtomicInt count { 0 };
+};
+static RateLimit _rateLimits[256];
+static constexpr int RateLimitProbes = 8;
+
+/**
+ * @brief Open addressed table of the call sites - a slot is claimed once and keeps its call site. Call sites that
+ * don't find their own slot within a few probes share their first slot and are counted together.
+ */
+static RateLimit &rateLimitSlot(const char *msg) {
+	const size_t start = ((uintptr_t)msg >> 3) % lengthof(_rateLimits);
+	for (int i = 0; i < RateLimitProbes; ++i) {
+		RateLimit &r = _rateLimits[(start + i) % lengthof(_rateLimits)];
+		const char *site = r.site;
+		if (site == nullptr) {
+			// another call site might claim the slot at the same time
+			r.site.compare_exchange(nullptr, msg);
+			site = r.site;
+		}
+		if (site == msg) {
+			return r;
+		}
+	}
+	return _rateLimits[start];
+}
+
+/**
+ * @brief The format string pointer identifies the call site - the limit is not exact but doesn't need any lock.
+ */
+static bool rateLimited(const char *msg) {
+	if (_rateLimit <= 0) {
+		return false;
+	}
+	RateLimit &r = rateLimitSlot(msg);
+	const int second = (int)(SDL_GetTicks() / 1000u);
+	const int last = r.second;
+	if (last != second && r.second.compare_exchange(last, second)) {
+		r.count = 0;
+	}
+	if (r.count.increment(1) < _rateLimit) {
+		return false;
+	}
+	_rateLimited.increment(1);
+	return true;
+}
+
+/**
+ * @brief Bounded multi producer single consumer queue of formatted log records.
+ *
+ * The logging threads claim a record by advancing the enqueue position with a compare and swap and
+ * format the message directly into the record. The sequence number of the record tells the writer
+ * thread that the record was published. No lock is involved as long as the writer thread is awake.
+ */
+class AsyncLog {
+public:
+	static constexpr int Records = 2048;
+	static constexpr int MessageSize = 1024 - 2 * sizeof(int) - sizeof(uint32_t);
+private:
+	struct Record {
+		core::AtomicInt sequence;
+		SDL_LogPriority priority;
+		uint32_t id;
+		char message[MessageSize];
+	};
+	Record *_records = nullptr;
+	core::AtomicInt _enqueuePos { 0 };
+	// only modified by the writer thread
+	int _dequeuePos = 0;
+	core::AtomicInt _written { 0 };
+	core::AtomicInt _dropped { 0 };
+	core::AtomicBool _active { false };
+	// producers between enter() and leave() - stop() waits for them before the queue is drained
+	core::AtomicInt _inFlight { 0 };
+	core::AtomicBool _running { false };
+	core::AtomicBool _sleeping { false };
+	bool _block = false;
+	core_trace_mutex(core::Lock, _lock, "AsyncLog");
+	core::ConditionVariable _wakeup;
+	core::Thread *_thread = nullptr;
+
+	static inline int advance(int pos, int n) {
+		// the positions are allowed to wrap around
+		return (int)((unsigned int)pos + (unsigned int)n);
+	}
+
+	static int writer(void *data) {
+		((AsyncLog*)data)->run();
+		return 0;
+	}
+
+	void wakeup() {
+		if (_sleeping) {
+			core::ScopedLock lock(_lock);
+			_wakeup.notify_one();
+		}
+	}
+
+	bool pending() {
+		Record &record = _records[_dequeuePos & (Records - 1)];
+		return record.sequence == advance(_dequeuePos, 1);
+	}
+
+	int drain() {
+		int n = 0;
+		while (pending()) {
+			Record &record = _records[_dequeuePos & (Records - 1)];
+			output(record.priority, record.id, record.message);
+			record.sequence = advance(_dequeuePos, Records);
+			_dequeuePos = advance(_dequeuePos, 1);
+			++n;
+		}
+		if (n > 0) {
+			if (_logfile) {
+				fflush(_logfile);
+			}
+			_written = _dequeuePos;
+		}
+		const int dropped = _dropped.exchange(0);
+		const int rateLimited = _rateLimited.exchange(0);
+		if (dropped > 0 || rateLimited > 0) {
+			char buf[128];
+			SDL_snprintf(buf, sizeof(buf), "Dropped %i log messages - %i because of the rate limit", dropped + rateLimited, rateLimited);
+			output(SDL_LOG_PRIORITY_WARN, 0u, buf);
+		}
+		return n;
+	}
+
+	void run() {
+		for (;;) {
+			const bool running = _running;
+			if (drain() > 0) {
+				continue;
+			}
+			if (!running) {
+				break;
+			}
+			core::ScopedLock lock(_lock);
+			_sleeping = true;
+			// a producer might have published a record before it saw the flag
+			if (!pending()) {
+				_wakeup.waitTimeout(_lock, 10);
+			}
+			_sleeping = false;
+		}
+	}
+
+public:
+	static constexpr uint32_t FlushTimeoutMillis = 1000u;
+
+	/**
+	 * @return @c false if the asynchronous output is not active - call @c leave() after @c enqueue() otherwise
+	 */
+	bool enter() {
+		_inFlight.increment(1);
+		if (_active) {
+			return true;
+		}
+		_inFlight.decrement(1);
+		return false;
+	}
+
+	void leave() {
+		_inFlight.decrement(1);
+	}
+
+	void start(bool block) {
+		_block = block;
+		if (_thread != nullptr) {
+			return;
+		}
+		if (_records == nullptr) {
+			_records = (Record*)SDL_malloc(sizeof(Record) * Records);
+			for (int i = 0; i < Records; ++i) {
+				new (&_records[i].sequence) core::AtomicInt(i);
+			}
+			_enqueuePos = 0;
+			_dequeuePos = 0;
+			_written = 0;
+		}
+		_running = true;
+		_thread = new core::Thread("AsyncLog", writer, this);
+		_active = true;
+	}
+
+	void stop() {
+		if (_thread == nullptr) {
+			return;
+		}
+		_active = false;
+		// a producer that saw the active flag might still write its record - the writer is still running and
+		// frees the records a blocking producer waits for
+		while (_inFlight > 0) {
+			SDL_Delay(1);
+		}
+		_running = false;
+		wakeup();
+		_thread->join();
+		delete _thread;
+		_thread = nullptr;
+		// records of producers that were still in flight when the writer stopped
+		drain();
+	}
+
+	void release() {
+		stop();
+		SDL_free(_records);
+		_records = nullptr;
+	}
+
+	/**
+	 * @return @c false if the message was dropped
+	 */
+	bool enqueue(SDL_LogPriority priority, uint32_t id, const char *msg, va_list args) {
+		int pos = _enqueuePos;
+		Record *record;
+		for (;;) {
+			record = &_records[pos & (Records - 1)];
+			const int diff = (int)((unsigned int)(int)record->sequence - (unsigned int)pos);
+			if (diff == 0) {
+				if (_enqueuePos.compare_exchange(pos, advance(pos, 1))) {
+					break;
+				}
+			} else if (diff < 0) {
+				// the queue is full
+				if (!_block) {
+					_dropped.increment(1);
+					return false;
+				}
+				wakeup();
+				SDL_Delay(1);
+			}
+			pos = _enqueuePos;
+		}
+		record->priority = priority;
+		record->id = id;
+		SDL_vsnprintf(record->message, sizeof(record->message), msg, args);
+		record->message[sizeof(record->message) - 1] = '\0';
+		record->sequence = advance(pos, 1);
+		wakeup();
+		return true;
+	}
+
+	/**
+	 * @brief Waits until the records that were queued so far are written - but not longer than @c FlushTimeoutMillis
+	 * @note This is also called from the crash signal handler - it doesn't lock, as the crashed thread might be the
+	 * writer or a producer that never publishes its record. The writer wakes up by its timeout.
+	 */
+	void flush() {
+		if (_thread == nullptr) {
+			return;
+		}
+		const int target = _enqueuePos;
+		const uint32_t deadline = SDL_GetTicks() + FlushTimeoutMillis;
+		while ((int)((unsigned int)(int)_written - (unsigned int)target) < 0 && _active) {
+			if (SDL_TICKS_PASSED(SDL_GetTicks(), deadline)) {
+				break;
+			}
+			SDL_Delay(1);
+		}
+	}
+};
+
+static AsyncLog _async;
+
+static void logVA(SDL_LogPriority priority, uint32_t id, const char *msg, va_list args) {
+	if (rateLimited(msg)) {
+		return;
+	}
+	if (_async.enter()) {
+		_async.enqueue(priority, id, msg, args);
+		_async.leave();
+		return;
+	}
+	char buf[bufSize];
+	SDL_vsnprintf(buf, sizeof(buf), msg, args);
+	buf[sizeof(buf) - 1] = '\0';
+	output(priority, id, buf);
+	if (_rateLimit > 0) {
+		const int rateLimited = _rateLimited.exchange(0);
+		if (rateLimited > 0) {
+			SDL_snprintf(buf, sizeof(buf), "Dropped %i log messages because of the rate limit", rateLimited);
+			output(SDL_LOG_PRIORITY_WARN, 0u, buf);
+		}
+	}
+}
+
 }
 
 void Log::setLogLevel(Level level) {
@@ -144,11 +485,29 @@ void Log::init(const char *logfile) {
 #endif
 		priv::_syslog = false;
 	}
+
+	const core::VarPtr& rateLimit = core::Var::get(cfg::CoreLogRateLimit);
+	priv::_rateLimit = rateLimit ? rateLimit->intVal() : 0;
+	const core::VarPtr& async = core::Var::get(cfg::CoreLogAsync);
+	if (async && async->boolVal()) {
+		const core::VarPtr& block = core::Var::get(cfg::CoreLogAsyncBlock);
+		priv::_async.start(block && block->boolVal());
+	} else {
+		priv::_async.stop();
+	}
+}
+
+void Log::flush() {
+	priv::_async.flush();
+	if (priv::_logfile) {
+		fflush(priv::_logfile);
+	}
 }
 
 void Log::shutdown() {
 	// this is one of the last methods that is executed - so don't rely on anything
 	// still being available here - it won't
+	priv::_async.release();
 #ifdef HAVE_SYSLOG_H
 	if (priv::_syslog) {
 		SDL_LogSetOutputFunction(priv::_syslogLogCallback, priv::_syslogLogCallbackUserData);
@@ -165,76 +524,7 @@ void Log::shutdown() {
 	priv::_logActive.clear();
 	priv::_logLevel = SDL_LOG_PRIORITY_INFO;
 	priv::_syslog = false;
-}
-
-static void traceVA(uint32_t id, const char *msg, va_list args) {
-	char buf[priv::bufSize];
-	SDL_vsnprintf(buf, sizeof(buf), msg, args);
-	buf[sizeof(buf) - 1] = '\0';
-	if (priv::_logfile) {
-		fprintf(priv::_logfile, "[TRACE] (%u) %s\n", id, buf);
-	}
-	if (priv::_syslog) {
-		SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "(%u) %s\n", id, buf);
-	} else {
-		SDL_LogVerbose(SDL_LOG_CATEGORY_APPLICATION, "(%u) " ANSI_COLOR_GREEN "%s" ANSI_COLOR_RESET "\n", id, buf);
-	}
-}
-
-static void debugVA(uint32_t id, const char *msg, va_list args) {
-	char buf[priv::bufSize];
-	SDL_vsnprintf(buf, sizeof(buf), msg, args);
-	buf[sizeof(buf) - 1] = '\0';
-	if (priv::_logfile) {
-		fprintf(priv::_logfile, "[DEBUG] (%u) %s\n", id, buf);
-	}
-	if (priv::_syslog) {
-		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "(%u) %s\n", id, buf);
-	} else {
-		SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "(%u) " ANSI_COLOR_BLUE "%s" ANSI_COLOR_RESET "\n", id, buf);
-	}
-}
-
-static void infoVA(uint32_t id, const char *msg, va_list args) {
-	char buf[priv::bufSize];
-	SDL_vsnprintf(buf, sizeof(buf), msg, args);
-	buf[sizeof(buf) - 1] = '\0';
-	if (priv::_logfile) {
-		fprintf(priv::_logfile, "[INFO] (%u) %s\n", id, buf);
-	}
-	if (priv::_syslog) {
-		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "(%u) %s\n", id, buf);
-	} else {
-		SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "(%u) " ANSI_COLOR_GREEN "%s" ANSI_COLOR_RESET "\n", id, buf);
-	}
-}
-
-static void warnVA(uint32_t id, const char *msg, va_list args) {
-	char buf[priv::bufSize];
-	SDL_vsnprintf(buf, sizeof(buf), msg, args);
-	buf[sizeof(buf) - 1] = '\0';
-	if (priv::_logfile) {
-		fprintf(priv::_logfile, "[WARN] (%u) %s\n", id, buf);
-	}
-	if (priv::_syslog) {
-		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "(%u) %s\n", id, buf);
-	} else {
-		SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "(%u) " ANSI_COLOR_YELLOW "%s" ANSI_COLOR_RESET "\n", id, buf);
-	}
-}
-
-static void errorVA(uint32_t id, const char *msg, va_list args) {
-	char buf[priv::bufSize];
-	SDL_vsnprintf(buf, sizeof(buf), msg, args);
-	buf[sizeof(buf) - 1] = '\0';
-	if (priv::_logfile) {
-		fprintf(priv::_logfile, "[ERROR] (%u) %s\n", id, buf);
-	}
-	if (priv::_syslog) {
-		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "(%u) %s\n", id, buf);
-	} else {
-		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "(%u) " ANSI_COLOR_RED "%s" ANSI_COLOR_RESET "\n", id, buf);
-	}
+	priv::_rateLimit = 0;
 }
 
 void Log::trace(const char* msg, ...) {
@@ -243,7 +533,7 @@ void Log::trace(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	traceVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_VERBOSE, 0u, msg, args);
 	va_end(args);
 }
 
@@ -253,7 +543,7 @@ void Log::debug(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	debugVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_DEBUG, 0u, msg, args);
 	va_end(args);
 }
 
@@ -263,7 +553,7 @@ void Log::info(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	infoVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_INFO, 0u, msg, args);
 	va_end(args);
 }
 
@@ -273,7 +563,7 @@ void Log::warn(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	warnVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_WARN, 0u, msg, args);
 	va_end(args);
 }
 
@@ -283,7 +573,7 @@ void Log::error(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	errorVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_ERROR, 0u, msg, args);
 	va_end(args);
 }
 
@@ -299,7 +589,7 @@ void Log::trace(uint32_t id, const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	traceVA(id, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_VERBOSE, id, msg, args);
 	va_end(args);
 }
 
@@ -315,7 +605,7 @@ void Log::debug(uint32_t id, const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	debugVA(id, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_DEBUG, id, msg, args);
 	va_end(args);
 }
 
@@ -331,7 +621,7 @@ void Log::info(uint32_t id, const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	infoVA(id, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_INFO, id, msg, args);
 	va_end(args);
 }
 
@@ -347,7 +637,7 @@ void Log::warn(uint32_t id, const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	warnVA(id, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_WARN, id, msg, args);
 	va_end(args);
 }
 
@@ -363,7 +653,7 @@ void Log::error(uint32_t id, const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	errorVA(id, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_ERROR, id, msg, args);
 	va_end(args);
 }
 
@@ -381,7 +671,7 @@ void c_logtrace(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	traceVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_VERBOSE, 0u, msg, args);
 	va_end(args);
 }
 
@@ -391,7 +681,7 @@ void c_logdebug(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	debugVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_DEBUG, 0u, msg, args);
 	va_end(args);
 }
 
@@ -401,7 +691,7 @@ void c_loginfo(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	infoVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_INFO, 0u, msg, args);
 	va_end(args);
 }
 
@@ -411,7 +701,7 @@ void c_logwarn(const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	warnVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_WARN, 0u, msg, args);
 	va_end(args);
 }
 
@@ -421,7 +711,7 @@ void c_logerror(CORE_FORMAT_STRING const char* msg, ...) {
 	}
 	va_list args;
 	va_start(args, msg);
-	errorVA(0u, msg, args);
+	priv::logVA(SDL_LOG_PRIORITY_ERROR, 0u, msg, args);
 	va_end(args);
 }
 
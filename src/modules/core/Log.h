@@ -26,8 +26,21 @@ public:
 	static Level toLogLevel(const char* level);
 	static const char* toLogLevel(Level level);
 
+	/**
+	 * @brief Applies the log configuration vars
+	 *
+	 * If @c core_logasync is enabled, the messages are formatted on the calling thread and handed over to a
+	 * background thread that writes them. If the queue is full, the messages are dropped - or the calling
+	 * thread waits if @c core_logasyncblock is enabled. @c core_lograte limits the messages per second of
+	 * each call site.
+	 */
 	static void init(const char *logfile = nullptr);
 	static void shutdown();
+	/**
+	 * @brief Blocks until all messages that were queued for the asynchronous output were written - but at most
+	 * a second, as this is also called from the crash handler
+	 */
+	static void flush();
 	static void trace(CORE_FORMAT_STRING const char* msg, ...) CORE_PRINTF_VARARG_FUNC(1);
 	static void debug(CORE_FORMAT_STRING const char* msg, ...) CORE_PRINTF_VARARG_FUNC(1);
 	static void info(CORE_FORMAT_STRING const char* msg, ...) CORE_PRINTF_VARARG_FUNC(1);
@@ -1,5 +1,7 @@
 #include "app/benchmark/AbstractBenchmark.h"
 #include "core/collection/Map.h"
+#include "core/collection/HashMap.h"
+#include "core/GLM.h"
 #include "core/Assert.h"
 #include <unordered_map>
 #include <map>
@@ -53,8 +55,87 @@ BENCHMARK_DEFINE_F(MapBenchmark, compareToMapCore) (benchmark::State& state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(MapBenchmark, compareToHashMapCore) (benchmark::State& state) {
+	core::HashMap<int64_t, int64_t, std::hash<int64_t>> map;
+	for (auto _ : state) {
+		const int64_t n = state.range(0);
+		for (int64_t i = 0; i < n; ++i) {
+			map.put(i, i);
+			int64_t value;
+			const bool found = map.get(i, value);
+			if (!found || value != i) {
+				state.SkipWithError("Failed!");
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief Fill a map with glm::ivec3 keys like the voxelizer does and look up all of them and the same amount of
+ * missing keys. The bucket count of the chained map is fixed - the amount of entries per bucket grows with the range.
+ */
+template<class MAP, class PUT, class GET>
+static void lookupIVec3(benchmark::State& state, PUT&& put, GET&& get) {
+	const int side = (int)state.range(0);
+	for (auto _ : state) {
+		MAP map(side * side * side);
+		for (int x = 0; x < side; ++x) {
+			for (int y = 0; y < side; ++y) {
+				for (int z = 0; z < side; ++z) {
+					put(map, glm::ivec3(x, y, z));
+				}
+			}
+		}
+		int found = 0;
+		for (int x = 0; x < side; ++x) {
+			for (int y = 0; y < side; ++y) {
+				for (int z = 0; z < side * 2; ++z) {
+					found += get(map, glm::ivec3(x, y, z)) ? 1 : 0;
+				}
+			}
+		}
+		if (found != side * side * side) {
+			state.SkipWithError("Failed!");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * 3 * state.range(0) * state.range(0) * state.range(0));
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, lookupIVec3MapCore) (benchmark::State& state) {
+	using MapType = core::Map<glm::ivec3, int, 64, glm::hash<glm::ivec3>>;
+	lookupIVec3<MapType>(state, [] (MapType& map, const glm::ivec3& p) {
+		map.put(p, p.x);
+	}, [] (const MapType& map, const glm::ivec3& p) {
+		return map.hasKey(p);
+	});
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, lookupIVec3HashMapCore) (benchmark::State& state) {
+	using MapType = core::HashMap<glm::ivec3, int, glm::hash<glm::ivec3>>;
+	lookupIVec3<MapType>(state, [] (MapType& map, const glm::ivec3& p) {
+		map.put(p, p.x);
+	}, [] (const MapType& map, const glm::ivec3& p) {
+		return map.hasKey(p);
+	});
+}
+
+BENCHMARK_DEFINE_F(MapBenchmark, lookupIVec3UnorderedMapStd) (benchmark::State& state) {
+	using MapType = std::unordered_map<glm::ivec3, int, glm::hash<glm::ivec3>>;
+	lookupIVec3<MapType>(state, [] (MapType& map, const glm::ivec3& p) {
+		map.emplace(p, p.x);
+	}, [] (const MapType& map, const glm::ivec3& p) {
+		return map.find(p) != map.end();
+	});
+}
+
 BENCHMARK_REGISTER_F(MapBenchmark, compareToMapCore)->RangeMultiplier(2)->Range(8, 512);
 BENCHMARK_REGISTER_F(MapBenchmark, compareToMapStd)->RangeMultiplier(2)->Range(8, 512);
 BENCHMARK_REGISTER_F(MapBenchmark, compareToUnorderedMapStd)->RangeMultiplier(2)->Range(8, 512);
+BENCHMARK_REGISTER_F(MapBenchmark, compareToHashMapCore)->RangeMultiplier(2)->Range(8, 512);
+BENCHMARK_REGISTER_F(MapBenchmark, lookupIVec3MapCore)->RangeMultiplier(2)->Range(8, 32);
+BENCHMARK_REGISTER_F(MapBenchmark, lookupIVec3HashMapCore)->RangeMultiplier(2)->Range(8, 32);
+BENCHMARK_REGISTER_F(MapBenchmark, lookupIVec3UnorderedMapStd)->RangeMultiplier(2)->Range(8, 32);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/Log.h"
+#include "core/Var.h"
+#include "core/GameConfig.h"
+#include <stdio.h>
+
+namespace {
+
+FILE *output = nullptr;
+
+// the console output would dominate the measurement - write into a temp file instead
+void fileOutput(void *userdata, int category, SDL_LogPriority priority, const char *message) {
+	fputs(message, output);
+}
+
+void setupLog(bool async, bool block) {
+	output = tmpfile();
+	SDL_LogSetOutputFunction(fileOutput, nullptr);
+	core::Var::get(cfg::CoreLogLevel, "3")->setVal(SDL_LOG_PRIORITY_INFO);
+	core::Var::get(cfg::CoreSysLog, "false");
+	core::Var::get(cfg::CoreLogAsync, "false")->setVal(async);
+	core::Var::get(cfg::CoreLogAsyncBlock, "false")->setVal(block);
+	Log::init();
+}
+
+void shutdownLog() {
+	Log::shutdown();
+	SDL_LogSetOutputFunction(nullptr, nullptr);
+	fclose(output);
+	output = nullptr;
+}
+
+void logMessages(benchmark::State& state, bool async, bool block) {
+	if (state.thread_index == 0) {
+		setupLog(async, block);
+	}
+	int i = 0;
+	for (auto _ : state) {
+		Log::info("Benchmark message %i from thread %i with some payload %f", i++, state.thread_index, 1.0f);
+	}
+	state.SetItemsProcessed(state.iterations());
+	if (state.thread_index == 0) {
+		Log::flush();
+		shutdownLog();
+	}
+}
+
+}
+
+static void BM_LogSync(benchmark::State& state) {
+	logMessages(state, false, false);
+}
+
+static void BM_LogAsyncDrop(benchmark::State& state) {
+	logMessages(state, true, false);
+}
+
+static void BM_LogAsyncBlock(benchmark::State& state) {
+	logMessages(state, true, true);
+}
+
+BENCHMARK(BM_LogSync)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LogAsyncDrop)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LogAsyncBlock)->ThreadRange(1, 8)->UseRealTime();
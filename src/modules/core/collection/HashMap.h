@@ -0,0 +1,540 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "core/collection/Map.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
+#include "core/StandardLib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <initializer_list>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CORE_HASHMAP_SSE2 1
+#endif
+
+namespace core {
+
+namespace priv {
+
+/**
+ * @brief A group of 16 control bytes that is probed at once - with sse2 the matching is done
+ * with one compare and a movemask, the fallback builds the same bitmask byte by byte.
+ */
+class HashMapGroup {
+public:
+	static constexpr size_t Width = 16u;
+	static constexpr int8_t Empty = -128;  // 0b10000000
+	static constexpr int8_t Deleted = -2;  // 0b11111110
+
+	explicit HashMapGroup(const int8_t *ctrl) {
+#ifdef CORE_HASHMAP_SSE2
+		_ctrl = _mm_loadu_si128((const __m128i *)ctrl);
+#else
+		_ctrl = ctrl;
+#endif
+	}
+
+	/**
+	 * @return Bitmask of the slots that have the given 7 bit hash fragment
+	 */
+	inline uint32_t match(int8_t h2) const {
+#ifdef CORE_HASHMAP_SSE2
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+#else
+		uint32_t mask = 0u;
+		for (size_t i = 0u; i < Width; ++i) {
+			mask |= (uint32_t)(_ctrl[i] == h2) << i;
+		}
+		return mask;
+#endif
+	}
+
+	inline uint32_t matchEmpty() const {
+		return match(Empty);
+	}
+
+	/**
+	 * @return Bitmask of the slots that can take a new entry - the sign bit is only set for empty and deleted slots
+	 */
+	inline uint32_t matchEmptyOrDeleted() const {
+#ifdef CORE_HASHMAP_SSE2
+		return (uint32_t)_mm_movemask_epi8(_ctrl);
+#else
+		uint32_t mask = 0u;
+		for (size_t i = 0u; i < Width; ++i) {
+			mask |= (uint32_t)(_ctrl[i] < 0) << i;
+		}
+		return mask;
+#endif
+	}
+
+	static inline int lowestBit(uint32_t mask) {
+		core_assert(mask != 0u);
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctz(mask);
+#else
+		int idx = 0;
+		while ((mask & 1u) == 0u) {
+			mask >>= 1;
+			++idx;
+		}
+		return idx;
+#endif
+	}
+
+private:
+#ifdef CORE_HASHMAP_SSE2
+	__m128i _ctrl;
+#else
+	const int8_t *_ctrl;
+#endif
+};
+
+}
+
+/**
+ * @brief Open addressing hash map that grows automatically.
+ *
+ * The layout follows the swiss table design: a control byte per slot holds 7 bits of the hash (or the
+ * empty/deleted markers) and lookups compare a whole group of 16 control bytes at once. Only slots whose
+ * hash fragment matches are compared with the @c COMPARE functor, which keeps the probe cost low even for
+ * maps with millions of entries - unlike @c core::Map there is no bucket count or max size to pick up front.
+ *
+ * The api mirrors @c core::Map (put(), emplace(), get(), find(), remove(), ...), but the entries only
+ * expose @c key and @c value - there are no @c first and @c second aliases to keep the slots small.
+ *
+ * @note Inserting may rehash the map, which invalidates all iterators and pointers to entries.
+ *
+ * @ingroup Collections
+ */
+template<typename KEYTYPE, typename VALUETYPE, typename HASHER = priv::DefaultHasher, typename COMPARE = priv::EqualCompare>
+class HashMap {
+public:
+	using value_type = VALUETYPE;
+	using key_type = KEYTYPE;
+
+	struct KeyValue {
+		inline KeyValue(const KEYTYPE& _key, const VALUETYPE& _value) :
+				key(_key), value(_value) {
+		}
+
+		inline KeyValue(const KEYTYPE& _key, VALUETYPE&& _value) :
+				key(_key), value(core::forward<VALUETYPE>(_value)) {
+		}
+
+		KEYTYPE key;
+		VALUETYPE value;
+	};
+
+private:
+	using Group = priv::HashMapGroup;
+
+	int8_t *_ctrl = nullptr;
+	KeyValue *_slots = nullptr;
+	size_t _capacity = 0u;
+	size_t _size = 0u;
+	// the amount of empty slots that may still be filled before we have to rehash
+	size_t _growthLeft = 0u;
+	HASHER _hasher;
+
+	static constexpr size_t maxLoad(size_t capacity) {
+		return capacity - capacity / 8u;
+	}
+
+	// mix the bits - a lot of hashers (like the default one) just return the value itself
+	inline uint64_t hash(const KEYTYPE& key) const {
+		uint64_t h = (uint64_t)_hasher(key) * UINT64_C(0x9E3779B97F4A7C15);
+		return h ^ (h >> 32);
+	}
+
+	static inline size_t h1(uint64_t hash) {
+		return (size_t)(hash >> 7);
+	}
+
+	static inline int8_t h2(uint64_t hash) {
+		return (int8_t)(hash & 0x7F);
+	}
+
+	inline size_t groups() const {
+		return _capacity / Group::Width;
+	}
+
+	inline bool isFull(size_t idx) const {
+		return _ctrl[idx] >= 0;
+	}
+
+	/**
+	 * @brief Triangular probing over the groups - visits every group once for a power of two group count
+	 * @return The slot index of the key or @c _capacity if it is not part of the map
+	 */
+	size_t findIndex(const KEYTYPE& key, uint64_t hashValue) const {
+		if (_capacity == 0u) {
+			return _capacity;
+		}
+		const size_t groupMask = groups() - 1u;
+		size_t group = h1(hashValue) & groupMask;
+		const int8_t fragment = h2(hashValue);
+		for (size_t step = 1u; step <= groups(); ++step) {
+			const size_t base = group * Group::Width;
+			const Group g(_ctrl + base);
+			for (uint32_t mask = g.match(fragment); mask != 0u; mask &= mask - 1u) {
+				const size_t idx = base + Group::lowestBit(mask);
+				if (COMPARE()(_slots[idx].key, key)) {
+					return idx;
+				}
+			}
+			if (g.matchEmpty() != 0u) {
+				break;
+			}
+			group = (group + step) & groupMask;
+		}
+		return _capacity;
+	}
+
+	size_t findFreeIndex(uint64_t hashValue) const {
+		const size_t groupMask = groups() - 1u;
+		size_t group = h1(hashValue) & groupMask;
+		for (size_t step = 1u;; ++step) {
+			const size_t base = group * Group::Width;
+			const uint32_t mask = Group(_ctrl + base).matchEmptyOrDeleted();
+			if (mask != 0u) {
+				return base + Group::lowestBit(mask);
+			}
+			core_assert(step <= groups());
+			group = (group + step) & groupMask;
+		}
+	}
+
+	void allocate(size_t capacity) {
+		core_assert(capacity >= Group::Width && (capacity & (capacity - 1u)) == 0u);
+		_ctrl = (int8_t *)core_malloc(capacity);
+		core_memset(_ctrl, Group::Empty, capacity);
+		_slots = (KeyValue *)core_malloc(capacity * sizeof(KeyValue));
+		_capacity = capacity;
+		_growthLeft = maxLoad(capacity) - _size;
+	}
+
+	void release() {
+		for (size_t i = 0u; i < _capacity; ++i) {
+			if (isFull(i)) {
+				_slots[i].~KeyValue();
+			}
+		}
+		core_free(_ctrl);
+		core_free(_slots);
+		_ctrl = nullptr;
+		_slots = nullptr;
+		_capacity = 0u;
+		_size = 0u;
+		_growthLeft = 0u;
+	}
+
+	static size_t capacityFor(size_t entries) {
+		size_t capacity = Group::Width;
+		while (maxLoad(capacity) < entries) {
+			capacity *= 2u;
+		}
+		return capacity;
+	}
+
+	/**
+	 * @brief Moves all entries into a new slot array - this also gets rid of the deleted markers
+	 */
+	void rehash(size_t capacity) {
+		core_trace_scoped(HashMapRehash);
+		int8_t *oldCtrl = _ctrl;
+		KeyValue *oldSlots = _slots;
+		const size_t oldCapacity = _capacity;
+		allocate(capacity);
+		for (size_t i = 0u; i < oldCapacity; ++i) {
+			if (oldCtrl[i] < 0) {
+				continue;
+			}
+			KeyValue &kv = oldSlots[i];
+			const uint64_t hashValue = hash(kv.key);
+			const size_t idx = findFreeIndex(hashValue);
+			_ctrl[idx] = h2(hashValue);
+			new (&_slots[idx]) KeyValue(kv.key, core::move(kv.value));
+			kv.~KeyValue();
+		}
+		core_free(oldCtrl);
+		core_free(oldSlots);
+	}
+
+	/**
+	 * @return The slot index the new entry for the given hash should be constructed in
+	 */
+	size_t prepareInsert(uint64_t hashValue) {
+		if (_capacity == 0u) {
+			allocate(Group::Width);
+		}
+		size_t idx = findFreeIndex(hashValue);
+		if (_growthLeft == 0u && _ctrl[idx] == Group::Empty) {
+			// if a lot of the used slots are only deleted markers, we don't have to grow
+			rehash(_size * 32u <= _capacity * 25u ? _capacity : _capacity * 2u);
+			idx = findFreeIndex(hashValue);
+		}
+		if (_ctrl[idx] == Group::Empty) {
+			--_growthLeft;
+		}
+		_ctrl[idx] = h2(hashValue);
+		++_size;
+		return idx;
+	}
+
+	void eraseIndex(size_t idx) {
+		core_assert(isFull(idx));
+		_slots[idx].~KeyValue();
+		--_size;
+		// a probe sequence only continues past a group if it was full at some point. If there is still an
+		// empty slot in this group no lookup ever passed it and we can mark the slot as empty again.
+		const size_t base = idx - idx % Group::Width;
+		if (Group(_ctrl + base).matchEmpty() != 0u) {
+			_ctrl[idx] = Group::Empty;
+			++_growthLeft;
+		} else {
+			_ctrl[idx] = Group::Deleted;
+		}
+	}
+
+	void copyFrom(const HashMap& other) {
+		if (other._size == 0u) {
+			return;
+		}
+		reserve(other._size);
+		for (auto i = other.begin(); i != other.end(); ++i) {
+			put(i->key, i->value);
+		}
+	}
+
+public:
+	HashMap(std::initializer_list<KeyValue> other) {
+		reserve(other.size());
+		for (auto i = other.begin(); i != other.end(); ++i) {
+			put(i->key, i->value);
+		}
+	}
+
+	/**
+	 * @param[in] initialSize The amount of entries the map should be able to hold without rehashing. This
+	 * is only a hint - the map grows on demand.
+	 */
+	HashMap(size_t initialSize = 0u) {
+		reserve(initialSize);
+	}
+
+	HashMap(const HashMap& other) : _hasher(other._hasher) {
+		copyFrom(other);
+	}
+
+	HashMap(HashMap&& other) noexcept :
+			_ctrl(other._ctrl), _slots(other._slots), _capacity(other._capacity), _size(other._size),
+			_growthLeft(other._growthLeft), _hasher(other._hasher) {
+		other._ctrl = nullptr;
+		other._slots = nullptr;
+		other._capacity = 0u;
+		other._size = 0u;
+		other._growthLeft = 0u;
+	}
+
+	~HashMap() {
+		release();
+	}
+
+	HashMap &operator=(HashMap &&other) noexcept {
+		if (this != &other) {
+			release();
+			_ctrl = other._ctrl;
+			_slots = other._slots;
+			_capacity = other._capacity;
+			_size = other._size;
+			_growthLeft = other._growthLeft;
+			_hasher = other._hasher;
+			other._ctrl = nullptr;
+			other._slots = nullptr;
+			other._capacity = 0u;
+			other._size = 0u;
+			other._growthLeft = 0u;
+		}
+		return *this;
+	}
+
+	HashMap& operator=(const HashMap& other) {
+		if (this != &other) {
+			clear();
+			_hasher = other._hasher;
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	class iterator {
+	private:
+		const HashMap* _map;
+		size_t _idx;
+
+		void skipFree() {
+			while (_idx < _map->_capacity && !_map->isFull(_idx)) {
+				++_idx;
+			}
+		}
+	public:
+		constexpr iterator() :
+			_map(nullptr), _idx(0) {
+		}
+
+		iterator(const HashMap* map, size_t idx) :
+				_map(map), _idx(idx) {
+			skipFree();
+		}
+
+		inline KeyValue* operator*() const {
+			return _map != nullptr && _idx < _map->_capacity ? &_map->_slots[_idx] : nullptr;
+		}
+
+		iterator& operator++() {
+			++_idx;
+			skipFree();
+			return *this;
+		}
+
+		inline KeyValue* operator->() const {
+			return &_map->_slots[_idx];
+		}
+
+		inline bool operator!=(const iterator& rhs) const {
+			return **this != *rhs;
+		}
+
+		inline bool operator==(const iterator& rhs) const {
+			return **this == *rhs;
+		}
+	};
+
+	inline size_t size() const {
+		return _size;
+	}
+
+	inline bool empty() const {
+		return _size == 0u;
+	}
+
+	/**
+	 * @return The amount of slots - the map rehashes before all of them are used
+	 */
+	inline size_t capacity() const {
+		return _capacity;
+	}
+
+	/**
+	 * @brief Make sure that the given amount of entries fits into the map without rehashing
+	 */
+	void reserve(size_t entries) {
+		if (entries == 0u) {
+			return;
+		}
+		const size_t capacity = capacityFor(entries);
+		if (capacity <= _capacity) {
+			return;
+		}
+		if (_capacity == 0u) {
+			allocate(capacity);
+			return;
+		}
+		rehash(capacity);
+	}
+
+	bool get(const KEYTYPE& key, VALUETYPE& value) const {
+		const size_t idx = findIndex(key, hash(key));
+		if (idx == _capacity) {
+			return false;
+		}
+		value = _slots[idx].value;
+		return true;
+	}
+
+	bool hasKey(const KEYTYPE& key) const {
+		return findIndex(key, hash(key)) != _capacity;
+	}
+
+	iterator find(const KEYTYPE& key) const {
+		const size_t idx = findIndex(key, hash(key));
+		if (idx == _capacity) {
+			return end();
+		}
+		return iterator(this, idx);
+	}
+
+	void emplace(const KEYTYPE& key, VALUETYPE&& value) {
+		const uint64_t hashValue = hash(key);
+		const size_t idx = findIndex(key, hashValue);
+		if (idx != _capacity) {
+			_slots[idx].value = core::forward<VALUETYPE>(value);
+			return;
+		}
+		// the insert might (re-)allocate the slots
+		const size_t newIdx = prepareInsert(hashValue);
+		new (&_slots[newIdx]) KeyValue(key, core::forward<VALUETYPE>(value));
+	}
+
+	void put(const KEYTYPE& key, const VALUETYPE& value) {
+		const uint64_t hashValue = hash(key);
+		const size_t idx = findIndex(key, hashValue);
+		if (idx != _capacity) {
+			_slots[idx].value = value;
+			return;
+		}
+		// the insert might (re-)allocate the slots
+		const size_t newIdx = prepareInsert(hashValue);
+		new (&_slots[newIdx]) KeyValue(key, value);
+	}
+
+	iterator begin() const {
+		if (_size == 0u) {
+			return end();
+		}
+		return iterator(this, 0u);
+	}
+
+	constexpr iterator end() const {
+		return iterator();
+	}
+
+	/**
+	 * @brief Removes all entries but keeps the allocated slots
+	 */
+	void clear() {
+		for (size_t i = 0u; i < _capacity; ++i) {
+			if (isFull(i)) {
+				_slots[i].~KeyValue();
+			}
+		}
+		if (_capacity > 0u) {
+			core_memset(_ctrl, Group::Empty, _capacity);
+		}
+		_size = 0u;
+		_growthLeft = maxLoad(_capacity);
+	}
+
+	inline void erase(const iterator& iter) {
+		KeyValue *kv = *iter;
+		core_assert(kv != nullptr);
+		eraseIndex((size_t)(kv - _slots));
+	}
+
+	bool remove(const KEYTYPE& key) {
+		const size_t idx = findIndex(key, hash(key));
+		if (idx == _capacity) {
+			return false;
+		}
+		eraseIndex(idx);
+		return true;
+	}
+};
+
+}
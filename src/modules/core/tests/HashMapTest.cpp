@@ -0,0 +1,176 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "core/collection/HashMap.h"
+#include "core/SharedPtr.h"
+#include "core/String.h"
+#include <functional>
+#include <unordered_map>
+
+namespace core {
+
+TEST(OpenAddressingHashMapTest, testPutGet) {
+	core::HashMap<int64_t, int64_t, std::hash<int64_t>> map;
+	map.put(1, 1);
+	map.put(1, 2);
+	map.put(2, 1);
+	map.put(3, 1337);
+	EXPECT_EQ(3u, map.size());
+	int64_t value;
+	EXPECT_TRUE(map.get(1, value));
+	EXPECT_EQ(2, value);
+	EXPECT_TRUE(map.get(2, value));
+	EXPECT_EQ(1, value);
+	EXPECT_TRUE(map.get(3, value));
+	EXPECT_EQ(1337, value);
+	EXPECT_FALSE(map.get(4, value));
+	EXPECT_FALSE(map.hasKey(4));
+}
+
+TEST(OpenAddressingHashMapTest, testEmptyMap) {
+	core::HashMap<int64_t, int64_t> map;
+	EXPECT_EQ(0u, map.capacity());
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.begin(), map.end());
+	EXPECT_EQ(map.end(), map.find(42));
+	EXPECT_FALSE(map.remove(42));
+	map.clear();
+	EXPECT_TRUE(map.empty());
+}
+
+TEST(OpenAddressingHashMapTest, testGrow) {
+	core::HashMap<int64_t, int64_t> map;
+	for (int64_t i = 0; i < 100000; ++i) {
+		map.put(i, i * 2);
+	}
+	EXPECT_EQ(100000u, map.size());
+	EXPECT_GE(map.capacity(), map.size());
+	int64_t value;
+	for (int64_t i = 0; i < 100000; ++i) {
+		ASSERT_TRUE(map.get(i, value)) << "Failed to find " << i;
+		ASSERT_EQ(i * 2, value);
+	}
+}
+
+TEST(OpenAddressingHashMapTest, testReserve) {
+	core::HashMap<int64_t, int64_t> map(1000);
+	const size_t capacity = map.capacity();
+	EXPECT_GE(capacity, 1000u);
+	for (int64_t i = 0; i < 1000; ++i) {
+		map.put(i, i);
+	}
+	EXPECT_EQ(capacity, map.capacity());
+}
+
+TEST(OpenAddressingHashMapTest, testRemove) {
+	core::HashMap<int64_t, int64_t> map;
+	for (int64_t i = 0; i < 1024; ++i) {
+		map.put(i, i);
+	}
+	for (int64_t i = 0; i < 1024; i += 2) {
+		EXPECT_TRUE(map.remove(i));
+		EXPECT_FALSE(map.remove(i));
+	}
+	EXPECT_EQ(512u, map.size());
+	for (int64_t i = 0; i < 1024; ++i) {
+		EXPECT_EQ(i % 2 == 1, map.hasKey(i)) << "Unexpected state for " << i;
+	}
+}
+
+TEST(OpenAddressingHashMapTest, testRemoveInsertChurn) {
+	// keep the size constant while replacing the keys - this must not grow the map but reuse the deleted slots
+	core::HashMap<int64_t, int64_t> map;
+	for (int64_t i = 0; i < 64; ++i) {
+		map.put(i, i);
+	}
+	const size_t capacity = map.capacity();
+	for (int64_t i = 64; i < 100000; ++i) {
+		ASSERT_TRUE(map.remove(i - 64));
+		map.put(i, i);
+	}
+	EXPECT_EQ(64u, map.size());
+	EXPECT_EQ(capacity, map.capacity());
+	for (int64_t i = 100000 - 64; i < 100000; ++i) {
+		EXPECT_TRUE(map.hasKey(i));
+	}
+}
+
+TEST(OpenAddressingHashMapTest, testMatchesUnorderedMap) {
+	core::HashMap<uint32_t, uint32_t> map;
+	std::unordered_map<uint32_t, uint32_t> expected;
+	uint32_t seed = 42u;
+	for (int i = 0; i < 50000; ++i) {
+		seed = seed * 1664525u + 1013904223u;
+		const uint32_t key = (seed >> 8) % 4096u;
+		if ((seed & 3u) == 0u) {
+			EXPECT_EQ(expected.erase(key) == 1u, map.remove(key));
+		} else {
+			map.put(key, seed);
+			expected[key] = seed;
+		}
+	}
+	ASSERT_EQ(expected.size(), map.size());
+	size_t cnt = 0u;
+	for (auto iter : map) {
+		auto i = expected.find(iter->key);
+		ASSERT_NE(expected.end(), i);
+		EXPECT_EQ(i->second, iter->value);
+		++cnt;
+	}
+	EXPECT_EQ(expected.size(), cnt);
+}
+
+TEST(OpenAddressingHashMapTest, testFindAndModify) {
+	core::HashMap<int64_t, int64_t> map;
+	map.put(1, 1);
+	auto iter = map.find(1);
+	ASSERT_NE(map.end(), iter);
+	iter->value = 42;
+	int64_t value;
+	EXPECT_TRUE(map.get(1, value));
+	EXPECT_EQ(42, value);
+	EXPECT_EQ(++map.find(1), map.end());
+}
+
+TEST(OpenAddressingHashMapTest, testEraseIterator) {
+	core::HashMap<core::String, core::SharedPtr<core::String>, core::StringHash> map;
+	map.put("foobar", core::SharedPtr<core::String>::create("barfoo"));
+	map.put("barfoo", core::SharedPtr<core::String>::create("foobar"));
+	auto iter = map.find("foobar");
+	ASSERT_NE(iter, map.end());
+	map.erase(iter);
+	EXPECT_EQ(1u, map.size());
+	EXPECT_FALSE(map.hasKey("foobar"));
+	EXPECT_TRUE(map.hasKey("barfoo"));
+}
+
+TEST(OpenAddressingHashMapTest, testCopyAndMove) {
+	core::HashMap<core::String, core::SharedPtr<core::String>, core::StringHash> map;
+	auto ptr = core::SharedPtr<core::String>::create("barfoo");
+	map.put("foobar", ptr);
+	core::HashMap<core::String, core::SharedPtr<core::String>, core::StringHash> map2 = map;
+	EXPECT_EQ(1u, map2.size());
+	core::HashMap<core::String, core::SharedPtr<core::String>, core::StringHash> map3;
+	map3 = core::move(map2);
+	EXPECT_EQ(0u, map2.size());
+	EXPECT_EQ(1u, map3.size());
+	auto iter = map3.find("foobar");
+	ASSERT_NE(map3.end(), iter);
+	EXPECT_EQ(ptr.get(), iter->value.get());
+	map3.clear();
+	EXPECT_TRUE(map3.empty());
+	EXPECT_EQ(1u, map.size());
+}
+
+TEST(OpenAddressingHashMapTest, testEmplace) {
+	core::HashMap<int, core::String> map;
+	map.emplace(1, core::String("foo"));
+	map.emplace(1, core::String("bar"));
+	core::String value;
+	EXPECT_TRUE(map.get(1, value));
+	EXPECT_EQ("bar", value);
+}
+
+}
@@ -4,13 +4,133 @@
 
 #include <gtest/gtest.h>
 #include "core/Log.h"
+#include "core/Var.h"
+#include "core/GameConfig.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include <future>
+#include <vector>
 
 namespace core {
 
-TEST(LogTest, testLogId) {
+namespace {
+
+core::AtomicInt received { 0 };
+
+void countOutput(void *userdata, int category, SDL_LogPriority priority, const char *message) {
+	if (SDL_strstr(message, "logtest") != nullptr) {
+		received.increment(1);
+	}
+}
+
+}
+
+class LogTest : public testing::Test {
+protected:
+	SDL_LogOutputFunction _outputFunction = nullptr;
+	void *_outputUserData = nullptr;
+
+	void SetUp() override {
+		core::Var::get(cfg::CoreLogLevel, "3");
+		core::Var::get(cfg::CoreSysLog, "false");
+		SDL_LogGetOutputFunction(&_outputFunction, &_outputUserData);
+		SDL_LogSetOutputFunction(countOutput, nullptr);
+		received = 0;
+	}
+
+	void TearDown() override {
+		core::Var::get(cfg::CoreLogAsync, "false")->setVal(false);
+		core::Var::get(cfg::CoreLogRateLimit, "0")->setVal(0);
+		Log::init();
+		SDL_LogSetOutputFunction(_outputFunction, _outputUserData);
+	}
+};
+
+TEST_F(LogTest, testLogId) {
 	const auto logid1 = Log::logid("LogTest1");
 	const auto logid2 = Log::logid("LogTest2");
 	ASSERT_NE(logid1, logid2);
 }
 
+TEST_F(LogTest, testAsync) {
+	core::Var::get(cfg::CoreLogAsync, "true")->setVal(true);
+	core::Var::get(cfg::CoreLogAsyncBlock, "true")->setVal(true);
+	Log::init();
+
+	const int threads = 4;
+	const int messages = 5000;
+	core::ThreadPool pool(threads, "LogTest");
+	pool.init();
+	std::vector<std::future<void>> futures;
+	for (int t = 0; t < threads; ++t) {
+		futures.emplace_back(pool.enqueue([t] () {
+			for (int i = 0; i < messages; ++i) {
+				Log::info("logtest %i %i", t, i);
+			}
+		}));
+	}
+	for (std::future<void>& f : futures) {
+		f.get();
+	}
+	Log::flush();
+	// nothing is dropped if the producers are blocked while the queue is full
+	EXPECT_EQ(threads * messages, (int)received);
+	pool.shutdown();
+}
+
+TEST_F(LogTest, testRateLimit) {
+	core::Var::get(cfg::CoreLogRateLimit, "10")->setVal(10);
+	Log::init();
+	for (int i = 0; i < 100; ++i) {
+		Log::info("logtest %i", i);
+	}
+	// the limit is per second - the loop might cross a second boundary
+	EXPECT_GE((int)received, 10);
+	EXPECT_LE((int)received, 20);
+}
+
+TEST_F(LogTest, testRateLimitSharedSlot) {
+	core::Var::get(cfg::CoreLogRateLimit, "10")->setVal(10);
+	Log::init();
+	// two call sites that start at the same slot - each of them is limited on its own
+	static char formats[4096 + 16];
+	char *first = (char *)(((uintptr_t)formats + 7u) & ~(uintptr_t)7u);
+	char *second = first + 256 * 8;
+	SDL_strlcpy(first, "logtest %i", 16);
+	SDL_strlcpy(second, "logtest %i", 16);
+	for (int i = 0; i < 100; ++i) {
+		Log::info(first, i);
+		Log::info(second, i);
+	}
+	EXPECT_GE((int)received, 20);
+	EXPECT_LE((int)received, 40);
+}
+
+TEST_F(LogTest, testAsyncStop) {
+	core::Var::get(cfg::CoreLogAsync, "true")->setVal(true);
+	core::Var::get(cfg::CoreLogAsyncBlock, "true")->setVal(true);
+	Log::init();
+
+	const int threads = 4;
+	const int messages = 2000;
+	core::ThreadPool pool(threads, "LogTest");
+	pool.init();
+	std::vector<std::future<void>> futures;
+	for (int t = 0; t < threads; ++t) {
+		futures.emplace_back(pool.enqueue([t] () {
+			for (int i = 0; i < messages; ++i) {
+				Log::info("logtest %i %i", t, i);
+			}
+		}));
+	}
+	// the records of the producers that race with the stop are still written
+	core::Var::get(cfg::CoreLogAsync)->setVal(false);
+	Log::init();
+	for (std::future<void>& f : futures) {
+		f.get();
+	}
+	EXPECT_EQ(threads * messages, (int)received);
+	pool.shutdown();
+}
+
 }
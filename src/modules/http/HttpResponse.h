@@ -19,8 +19,11 @@ struct HttpResponse {
 	const char *body = nullptr;
 	size_t bodySize = 0u;
 	// if the route handler sets this to false, the memory is not freed. Can be useful for static content
-	// like error pages.
+	// like error pages. The body is not copied - the memory must stay valid until the response was sent.
 	bool freeBody = true;
+	// if this is set, the content of the file is sent as body. The server doesn't copy the file content into
+	// memory if the platform supports sendfile()
+	core::String file;
 
 	void contentLength(size_t len) {
 		bodySize = len;
@@ -43,6 +46,11 @@ struct HttpResponse {
 			headers.put(http::header::CONTENT_TYPE, http::mimetype::TEXT_PLAIN);
 		}
 	}
+
+	void setFile(const core::String& path, const char *mimeType = http::mimetype::APPLICATION_OCTET_STREAM) {
+		file = path;
+		headers.put(http::header::CONTENT_TYPE, mimeType);
+	}
 };
 
 }
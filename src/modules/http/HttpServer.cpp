@@ -6,18 +6,130 @@
 #include "RequestParser.h"
 #include "core/Assert.h"
 #include "core/ArrayLength.h"
+#include "core/Common.h"
 #include "core/Log.h"
 #include "Network.cpp.h"
 #include "app/App.h"
 #include <string.h>
 #include <SDL_stdinc.h>
+#include <SDL_rwops.h>
+#ifdef HTTP_SERVER_EPOLL
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#endif
+#ifndef __WINDOWS__
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define HTTP_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define HTTP_SEND_FLAGS 0
+#endif
 
 namespace http {
 
+static inline bool wouldBlock() {
+#ifdef __WINDOWS__
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+static inline bool interrupted() {
+#ifdef __WINDOWS__
+	return false;
+#else
+	return errno == EINTR;
+#endif
+}
+
+/**
+ * @return The size of the request header including the terminating empty line or @c 0 if the header is not yet complete
+ */
+static size_t requestHeaderSize(const uint8_t *buf, size_t len) {
+	for (size_t i = 3u; i < len; ++i) {
+		if (buf[i] == '\n' && buf[i - 1] == '\r' && buf[i - 2] == '\n' && buf[i - 3] == '\r') {
+			return i + 1u;
+		}
+	}
+	return 0u;
+}
+
+/**
+ * @return The value of the content length header of the given request header or @c 0 if there is none
+ */
+static int requestContentLength(const char *header, size_t len) {
+	static const char name[] = "\r\ncontent-length:";
+	const size_t nameLength = sizeof(name) - 1;
+	for (size_t i = 0u; i + nameLength <= len; ++i) {
+		if (SDL_strncasecmp(header + i, name, nameLength) != 0) {
+			continue;
+		}
+		const char *value = header + i + nameLength;
+		while (*value == ' ') {
+			++value;
+		}
+		return SDL_atoi(value);
+	}
+	return 0;
+}
+
+/**
+ * @brief HTTP/1.1 connections are persistent if the client doesn't ask to close them - HTTP/1.0 clients have to ask for it
+ */
+static bool requestKeepAlive(const RequestParser& request) {
+	const char *connection = request.headerValue(header::CONNECTION);
+	if (connection != nullptr) {
+		if (!SDL_strcasecmp(connection, "close")) {
+			return false;
+		}
+		if (!SDL_strcasecmp(connection, "keep-alive")) {
+			return true;
+		}
+	}
+	return request.protocolVersion != nullptr && !SDL_strcmp(request.protocolVersion, "HTTP/1.1");
+}
+
+/**
+ * @brief Sends the remaining parts of the header and the body with one call if the platform supports it
+ */
+static network_return sendBuffers(SOCKET socket, const char *header, size_t headerLength, const char *body, size_t bodySize) {
+#ifdef __WINDOWS__
+	if (headerLength > 0u) {
+		return ::send(socket, header, (int)headerLength, 0);
+	}
+	return ::send(socket, body, (int)bodySize, 0);
+#else
+	struct iovec iov[2];
+	int n = 0;
+	if (headerLength > 0u) {
+		iov[n].iov_base = (void*)header;
+		iov[n].iov_len = headerLength;
+		++n;
+	}
+	if (bodySize > 0u) {
+		iov[n].iov_base = (void*)body;
+		iov[n].iov_len = bodySize;
+		++n;
+	}
+	struct msghdr msg;
+	SDL_zero(msg);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = n;
+	return sendmsg(socket, &msg, HTTP_SEND_FLAGS);
+#endif
+}
+
 HttpServer::HttpServer(const metric::MetricPtr& metric) :
 		_socketFD(INVALID_SOCKET), _metric(metric) {
+#ifndef HTTP_SERVER_EPOLL
 	FD_ZERO(&_readFDSet);
 	FD_ZERO(&_writeFDSet);
+#endif
 }
 
 HttpServer::~HttpServer() {
@@ -53,6 +165,9 @@ bool HttpServer::unregisterRoute(HttpMethod method, const char *path) {
 }
 
 bool HttpServer::init(int16_t port) {
+	if (!networkInit()) {
+		return false;
+	}
 	_socketFD = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
 	if (_socketFD == INVALID_SOCKET) {
 		network_cleanup();
@@ -64,9 +179,6 @@ bool HttpServer::init(int16_t port) {
 	sin.sin_addr.s_addr = INADDR_ANY;
 	sin.sin_port = htons(port);
 
-	FD_ZERO(&_readFDSet);
-	FD_ZERO(&_writeFDSet);
-
 	int t = 1;
 #ifdef _WIN32
 	if (setsockopt(_socketFD, SOL_SOCKET, SO_REUSEADDR, (char*) &t, sizeof(t)) != 0) {
@@ -86,7 +198,7 @@ bool HttpServer::init(int16_t port) {
 		return false;
 	}
 
-	if (listen(_socketFD, 5) < 0) {
+	if (listen(_socketFD, SOMAXCONN) < 0) {
 		network_cleanup();
 		closesocket(_socketFD);
 		_socketFD = INVALID_SOCKET;
@@ -95,164 +207,383 @@ bool HttpServer::init(int16_t port) {
 
 	networkNonBlocking(_socketFD);
 
-	FD_SET(_socketFD, &_readFDSet);
+#ifdef HTTP_SERVER_EPOLL
+	_epollFD = epoll_create1(EPOLL_CLOEXEC);
+	struct epoll_event event;
+	SDL_zero(event);
+	// the listen socket is the only one without a client
+	event.data.ptr = nullptr;
+	event.events = EPOLLIN | EPOLLET;
+	if (_epollFD == -1 || epoll_ctl(_epollFD, EPOLL_CTL_ADD, _socketFD, &event) != 0) {
+		Log::error("Failed to set up epoll for the http server");
+		if (_epollFD != -1) {
+			close(_epollFD);
+			_epollFD = -1;
+		}
+		network_cleanup();
+		closesocket(_socketFD);
+		_socketFD = INVALID_SOCKET;
+		return false;
+	}
+#endif
+
+	_requestBuffers.reserve(RequestBufferPoolSize);
+	while (_requestBuffers.size() < RequestBufferPoolSize) {
+		_requestBuffers.push_back((uint8_t*)SDL_malloc(RequestBufferSize));
+	}
+
+	return true;
+}
+
+void HttpServer::acceptClients() {
+	for (;;) {
+		const SOCKET clientSocket = accept(_socketFD, nullptr, nullptr);
+		if (clientSocket == INVALID_SOCKET) {
+			if (interrupted()) {
+				continue;
+			}
+			break;
+		}
+#ifndef HTTP_SERVER_EPOLL
+		if (_clients.size() + 1u >= FD_SETSIZE) {
+			Log::warn("Too many http connections");
+			closesocket(clientSocket);
+			continue;
+		}
+#endif
+		networkNonBlocking(clientSocket);
+
+		Client *client;
+		if (_freeClients.empty()) {
+			client = new Client();
+		} else {
+			client = _freeClients.back();
+			_freeClients.pop();
+		}
+		client->socket = clientSocket;
+		client->index = _clients.size();
+		if (_requestBuffers.empty()) {
+			client->request = (uint8_t*)SDL_malloc(RequestBufferSize);
+		} else {
+			client->request = _requestBuffers.back();
+			_requestBuffers.pop();
+		}
+		client->requestCapacity = RequestBufferSize;
+		client->requestLength = 0u;
+		client->currentResponse = 0u;
+		client->keepAlive = true;
+		client->peerClosed = false;
+		_clients.push_back(client);
+
+#ifdef HTTP_SERVER_EPOLL
+		struct epoll_event event;
+		SDL_zero(event);
+		event.data.ptr = client;
+		event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		if (epoll_ctl(_epollFD, EPOLL_CTL_ADD, clientSocket, &event) != 0) {
+			Log::warn("Failed to watch the http connection");
+			closeClient(client);
+		}
+#endif
+	}
+}
+
+void HttpServer::releaseResponse(Response& response) {
+	SDL_free(response.header);
+	response.header = nullptr;
+	if (response.freeBody) {
+		SDL_free((char*)response.body);
+	}
+	response.body = nullptr;
+#ifdef HTTP_SERVER_EPOLL
+	if (response.file != -1) {
+		close(response.file);
+		response.file = -1;
+	}
+#endif
+}
+
+void HttpServer::releaseRequestBuffer(Client* client) {
+	if (client->requestCapacity == RequestBufferSize && _requestBuffers.size() < RequestBufferPoolSize) {
+		_requestBuffers.push_back(client->request);
+	} else {
+		SDL_free(client->request);
+	}
+	client->request = nullptr;
+	client->requestCapacity = 0u;
+	client->requestLength = 0u;
+}
 
+bool HttpServer::growRequestBuffer(Client& client) {
+	if (client.requestCapacity > _maxRequestBytes) {
+		return false;
+	}
+	const size_t capacity = client.requestCapacity * 2u;
+	client.request = (uint8_t*)SDL_realloc(client.request, capacity);
+	client.requestCapacity = capacity;
 	return true;
 }
 
-HttpServer::ClientSocketsIter HttpServer::closeClient(ClientSocketsIter& iter) {
-	Client& client = *iter;
-	const SOCKET clientSocket = client.socket;
-	FD_CLR(clientSocket, &_readFDSet);
-	FD_CLR(clientSocket, &_writeFDSet);
-	closesocket(clientSocket);
-	client.socket = INVALID_SOCKET;
-	SDL_free(client.request);
-	SDL_free(client.response);
-	return _clientSockets.erase(iter);
+void HttpServer::closeClient(Client* client) {
+	closesocket(client->socket);
+	client->socket = INVALID_SOCKET;
+	for (size_t i = client->currentResponse; i < client->responses.size(); ++i) {
+		releaseResponse(client->responses[i]);
+	}
+	client->responses.clear();
+	client->currentResponse = 0u;
+	releaseRequestBuffer(client);
+
+	const size_t index = client->index;
+	core_assert(_clients[index] == client);
+	Client *last = _clients.back();
+	_clients[index] = last;
+	last->index = index;
+	_clients.pop();
+	_freeClients.push_back(client);
 }
 
 bool HttpServer::update() {
 	core_trace_scoped(HttpServerUpdate);
-	fd_set readFDsOut;
-	fd_set writeFDsOut;
-
-	SDL_memcpy(&readFDsOut, &_readFDSet, sizeof(readFDsOut));
-	SDL_memcpy(&writeFDsOut, &_writeFDSet, sizeof(writeFDsOut));
+#ifdef HTTP_SERVER_EPOLL
+	struct epoll_event events[256];
+	const int ready = epoll_wait(_epollFD, events, lengthof(events), 0);
+	if (ready < 0) {
+		return interrupted();
+	}
+	for (int i = 0; i < ready; ++i) {
+		Client *client = (Client*)events[i].data.ptr;
+		if (client == nullptr) {
+			acceptClients();
+			continue;
+		}
+		const uint32_t flags = events[i].events;
+		if (flags & (EPOLLERR | EPOLLHUP)) {
+			closeClient(client);
+			continue;
+		}
+		process(client, (flags & (EPOLLIN | EPOLLRDHUP)) != 0);
+	}
+#else
+	FD_ZERO(&_readFDSet);
+	FD_ZERO(&_writeFDSet);
+	SOCKET maxFD = _socketFD;
+	FD_SET(_socketFD, &_readFDSet);
+	for (size_t i = 0u; i < _clients.size(); ++i) {
+		const Client *client = _clients[i];
+		if (client->keepAlive && !client->peerClosed) {
+			FD_SET(client->socket, &_readFDSet);
+		}
+		if (client->pending()) {
+			FD_SET(client->socket, &_writeFDSet);
+		}
+		maxFD = core_max(maxFD, client->socket);
+	}
 
 	struct timeval tv;
 	tv.tv_sec = 0;
 	tv.tv_usec = 0;
-	const int ready = select(FD_SETSIZE, &readFDsOut, &writeFDsOut, nullptr, &tv);
+	const int ready = select((int)maxFD + 1, &_readFDSet, &_writeFDSet, nullptr, &tv);
 	if (ready < 0) {
 		return false;
 	}
-	if (_socketFD != INVALID_SOCKET && FD_ISSET(_socketFD, &readFDsOut)) {
-		const SOCKET clientSocket = accept(_socketFD, nullptr, nullptr);
-		if (clientSocket != INVALID_SOCKET) {
-			FD_SET(clientSocket, &_readFDSet);
-			Client c;
-			c.socket = clientSocket;
-			_clientSockets.insert(c);
-			networkNonBlocking(clientSocket);
+	// the new connections are added to the end and are handled in the next update
+	const size_t n = _clients.size();
+	if (FD_ISSET(_socketFD, &_readFDSet)) {
+		acceptClients();
+	}
+	// iterate backwards - closing a client moves the last one into its slot
+	for (size_t i = n; i-- > 0u;) {
+		Client *client = _clients[i];
+		const bool readable = FD_ISSET(client->socket, &_readFDSet);
+		if (readable || FD_ISSET(client->socket, &_writeFDSet)) {
+			process(client, readable);
 		}
 	}
+#endif
+	return true;
+}
 
-	for (ClientSocketsIter i = _clientSockets.begin(); i != _clientSockets.end();) {
-		Client& client = *i;
-		const SOCKET clientSocket = client.socket;
-		if (clientSocket == INVALID_SOCKET) {
-			i = closeClient(i);
-			continue;
+void HttpServer::process(Client* client, bool readable) {
+	if (readable && client->keepAlive && !client->peerClosed) {
+		if (!receive(*client)) {
+			closeClient(client);
+			return;
 		}
+		handleRequests(*client);
+	}
+	if (client->pending() && !sendResponses(*client)) {
+		closeClient(client);
+		return;
+	}
+	if (!client->pending() && (!client->keepAlive || client->peerClosed)) {
+		closeClient(client);
+	}
+}
 
-		if (FD_ISSET(clientSocket, &writeFDsOut)) {
-			if (!sendMessage(client) || client.finished()) {
-				i = closeClient(i);
-			} else {
-				++i;
+bool HttpServer::receive(Client& client) {
+	while (client.keepAlive) {
+		if (client.requestLength == client.requestCapacity) {
+			// answer the complete requests before the buffer is grown for the rest
+			handleRequests(client);
+			if (client.requestLength == client.requestCapacity && !growRequestBuffer(client)) {
+				assembleError(client, HttpStatus::InternalServerError);
+				break;
 			}
 			continue;
 		}
-
-		if (!FD_ISSET(clientSocket, &readFDsOut)) {
-			++i;
-			continue;
-		}
-
-		constexpr const int BUFFERSIZE = 2048;
-		uint8_t recvBuf[BUFFERSIZE];
-		const network_return len = recv(clientSocket, (char*)recvBuf, BUFFERSIZE - 1, 0);
+		const size_t available = client.requestCapacity - client.requestLength;
+		const network_return len = recv(client.socket, (char*)client.request + client.requestLength, available, 0);
 		if (len < 0) {
-			i = closeClient(i);
-			continue;
+			if (interrupted()) {
+				continue;
+			}
+			return wouldBlock();
 		}
 		if (len == 0) {
-			++i;
-			continue;
+			client.peerClosed = true;
+			break;
 		}
-
-		client.request = (uint8_t*)SDL_realloc(client.request, client.requestLength + len);
-		SDL_memcpy(client.request + client.requestLength, recvBuf, len);
 		client.requestLength += len;
+	}
+	return true;
+}
 
-		if (client.requestLength == 0) {
-			++i;
-			continue;
-		}
-
-		// GET / HTTP/1.1\r\n\r\n
-		if (client.requestLength < 18) {
-			++i;
-			continue;
+void HttpServer::handleRequests(Client& client) {
+	size_t offset = 0u;
+	while (client.keepAlive && offset < client.requestLength) {
+		const uint8_t *start = client.request + offset;
+		const size_t remaining = client.requestLength - offset;
+		if (remaining < 4u) {
+			break;
 		}
-
-		if (SDL_memcmp(client.request, "GET", 3) != 0 && SDL_memcmp(client.request, "POST", 4) != 0) {
-			FD_CLR(clientSocket, &_readFDSet);
-			FD_CLR(clientSocket, &readFDsOut);
+		if (SDL_memcmp(start, "GET ", 4) != 0 && SDL_memcmp(start, "POST", 4) != 0) {
 			assembleError(client, HttpStatus::NotImplemented);
-			++i;
-			continue;
+			break;
 		}
-
-		if (client.requestLength > _maxRequestBytes) {
-			FD_CLR(clientSocket, &_readFDSet);
-			FD_CLR(clientSocket, &readFDsOut);
+		const size_t headerSize = requestHeaderSize(start, remaining);
+		if (headerSize == 0u) {
+			if (remaining > _maxRequestBytes) {
+				assembleError(client, HttpStatus::InternalServerError);
+			}
+			break;
+		}
+		const int contentLength = requestContentLength((const char*)start, headerSize);
+		if (contentLength < 0) {
+			assembleError(client, HttpStatus::BadRequest);
+			break;
+		}
+		const size_t requestSize = headerSize + (size_t)contentLength;
+		if (requestSize > _maxRequestBytes) {
 			assembleError(client, HttpStatus::InternalServerError);
-			++i;
-			continue;
+			break;
 		}
+		if (remaining < requestSize) {
+			break;
+		}
+		offset += requestSize;
 
-		uint8_t *mem = (uint8_t *)SDL_malloc(client.requestLength);
-		SDL_memcpy(mem, client.request, client.requestLength);
-		const RequestParser request(mem, client.requestLength);
+		uint8_t *mem = (uint8_t *)SDL_malloc(requestSize);
+		SDL_memcpy(mem, start, requestSize);
+		const RequestParser request(mem, requestSize);
 		if (!request.valid()) {
-			++i;
-			continue;
+			assembleError(client, HttpStatus::BadRequest);
+			break;
 		}
 
-		FD_CLR(clientSocket, &_readFDSet);
-		FD_CLR(clientSocket, &readFDsOut);
-
+		const bool keepAlive = requestKeepAlive(request);
 		HttpResponse response;
-		if (!route(request, response)) {
+		if (!route(request, response, keepAlive)) {
 			assembleError(client, HttpStatus::NotFound);
-			++i;
-			continue;
+			break;
 		}
-		assembleResponse(client, response);
-		if (response.freeBody) {
-			SDL_free((char*)response.body);
+		const char *connection = nullptr;
+		if (!keepAlive || (response.headers.get(header::CONNECTION, connection) && !SDL_strcasecmp(connection, "close"))) {
+			client.keepAlive = false;
 		}
+		assembleResponse(client, response);
+	}
+	if (offset > 0u) {
+		client.requestLength -= offset;
+		SDL_memmove(client.request, client.request + offset, client.requestLength);
 	}
-	return true;
 }
 
 void HttpServer::assembleError(Client& client, HttpStatus status) {
+	const char *errorPage = "";
+	_errorPages.get((int)status, errorPage);
+	const size_t errorPageSize = SDL_strlen(errorPage);
+
 	char buf[512];
 	SDL_snprintf(buf, sizeof(buf),
 			"HTTP/1.1 %i %s\r\n"
+			"Content-length: %u\r\n"
 			"Connection: close\r\n"
 			"Server: %s\r\n"
 			"\r\n",
 			(int)status,
 			toStatusString(status),
+			(unsigned int)errorPageSize,
 			app::App::getInstance()->appname().c_str());
 
-	const char *errorPage = "";
-	_errorPages.get((int)status, errorPage);
-
-	const size_t responseSize = SDL_strlen(errorPage) + SDL_strlen(buf);
+	const size_t responseSize = errorPageSize + SDL_strlen(buf);
 	char *responseBuf = (char*)SDL_malloc(responseSize + 1);
 	SDL_snprintf(responseBuf, responseSize + 1, "%s%s", buf, errorPage);
-	client.setResponse(responseBuf, responseSize);
+
+	Response response;
+	response.header = responseBuf;
+	response.headerLength = responseSize;
+	client.responses.push_back(response);
+	// the rest of the received data is ignored - there is no way to find the next request
+	client.keepAlive = false;
 	metric(status);
-	FD_SET(client.socket, &_writeFDSet);
 }
 
-void HttpServer::assembleResponse(Client& client, const HttpResponse& response) {
+void HttpServer::assembleResponse(Client& client, HttpResponse& response) {
+	Response r;
+	r.body = response.body;
+	r.bodySize = response.bodySize;
+	r.freeBody = response.freeBody;
+	// the server owns the body from now on
+	response.freeBody = false;
+
+	if (!response.file.empty()) {
+#ifdef HTTP_SERVER_EPOLL
+		const int fd = open(response.file.c_str(), O_RDONLY | O_CLOEXEC);
+		struct stat st;
+		if (fd == -1 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+			Log::debug("Failed to open %s", response.file.c_str());
+			if (fd != -1) {
+				close(fd);
+			}
+			releaseResponse(r);
+			assembleError(client, HttpStatus::NotFound);
+			return;
+		}
+		r.file = fd;
+		r.fileSize = (size_t)st.st_size;
+#else
+		SDL_RWops *rwops = SDL_RWFromFile(response.file.c_str(), "rb");
+		if (rwops == nullptr) {
+			Log::debug("Failed to open %s", response.file.c_str());
+			releaseResponse(r);
+			assembleError(client, HttpStatus::NotFound);
+			return;
+		}
+		const Sint64 size = SDL_RWsize(rwops);
+		char *fileBuf = (char*)SDL_malloc(size > 0 ? (size_t)size : 1u);
+		const size_t read = size > 0 ? SDL_RWread(rwops, fileBuf, 1, (size_t)size) : 0u;
+		SDL_RWclose(rwops);
+		releaseResponse(r);
+		r.body = fileBuf;
+		r.bodySize = read;
+		r.freeBody = true;
+#endif
+	}
+
 	char headers[2048];
 	if (!buildHeaderBuffer(headers, lengthof(headers), response.headers)) {
+		releaseResponse(r);
 		assembleError(client, HttpStatus::InternalServerError);
 		return;
 	}
@@ -265,21 +596,20 @@ void HttpServer::assembleResponse(Client& client, const HttpResponse& response)
 			"\r\n",
 			(int)response.status,
 			toStatusString(response.status),
-			(unsigned int)response.bodySize,
+			(unsigned int)(r.bodySize + r.fileSize),
 			headers);
 	if (headerSize >= lengthof(buf)) {
+		releaseResponse(r);
 		assembleError(client, HttpStatus::InternalServerError);
 		return;
 	}
 
-	const size_t responseSize = response.bodySize + SDL_strlen(buf);
-	char *responseBuf = (char*)SDL_malloc(responseSize);
-	SDL_memcpy(responseBuf, buf, headerSize);
-	SDL_memcpy(responseBuf + headerSize, response.body, response.bodySize);
-	client.setResponse(responseBuf, responseSize);
-	Log::trace("Response buffer of size %i", (int)responseSize);
+	r.header = (char*)SDL_malloc(headerSize);
+	SDL_memcpy(r.header, buf, headerSize);
+	r.headerLength = headerSize;
+	client.responses.push_back(r);
+	Log::trace("Response of size %i", (int)(r.headerLength + r.bodySize + r.fileSize));
 	metric(response.status);
-	FD_SET(client.socket, &_writeFDSet);
 }
 
 void HttpServer::metric(HttpStatus status) const {
@@ -288,27 +618,68 @@ void HttpServer::metric(HttpStatus status) const {
 	_metric->count("http.request", 1, {{"status", buf}});
 }
 
-bool HttpServer::sendMessage(Client& client) {
-	core_assert(client.response != nullptr);
-	int remaining = (int)client.responseLength - (int)client.alreadySent;
-	if (remaining <= 0) {
-		return false;
-	}
-	const char* p = client.response + client.alreadySent;
-	const network_return sent = ::send(client.socket, p, remaining, 0);
-	if (sent < 0) {
-		Log::debug("Failed to send to the client");
-		return false;
-	}
-	if (sent == 0) {
-		return true;
+bool HttpServer::sendResponses(Client& client) {
+	while (client.pending()) {
+		Response& response = client.responses[client.currentResponse];
+		const size_t bufferSize = response.headerLength + response.bodySize;
+		if (response.alreadySent < bufferSize) {
+			const char *header = nullptr;
+			size_t headerRemaining = 0u;
+			const char *body = response.body;
+			size_t bodyRemaining = response.bodySize;
+			if (response.alreadySent < response.headerLength) {
+				header = response.header + response.alreadySent;
+				headerRemaining = response.headerLength - response.alreadySent;
+			} else {
+				const size_t bodySent = response.alreadySent - response.headerLength;
+				body += bodySent;
+				bodyRemaining -= bodySent;
+			}
+			const network_return sent = sendBuffers(client.socket, header, headerRemaining, body, bodyRemaining);
+			if (sent < 0) {
+				if (interrupted()) {
+					continue;
+				}
+				if (wouldBlock()) {
+					return true;
+				}
+				Log::debug("Failed to send to the client");
+				return false;
+			}
+			response.alreadySent += sent;
+			continue;
+		}
+#ifdef HTTP_SERVER_EPOLL
+		if (response.fileOffset < response.fileSize) {
+			off_t offset = (off_t)response.fileOffset;
+			const ssize_t sent = sendfile(client.socket, response.file, &offset, response.fileSize - response.fileOffset);
+			if (sent < 0) {
+				if (interrupted()) {
+					continue;
+				}
+				if (wouldBlock()) {
+					return true;
+				}
+				Log::debug("Failed to send the file to the client");
+				return false;
+			}
+			if (sent == 0) {
+				// the file was truncated - the promised content length can't be delivered anymore
+				return false;
+			}
+			response.fileOffset += (size_t)sent;
+			continue;
+		}
+#endif
+		releaseResponse(response);
+		++client.currentResponse;
 	}
-	remaining -= sent;
-	client.alreadySent += sent;
-	return remaining > 0;
+	client.responses.clear();
+	client.currentResponse = 0u;
+	return true;
 }
 
-bool HttpServer::route(const RequestParser& request, HttpResponse& response) {
+bool HttpServer::route(const RequestParser& request, HttpResponse& response, bool keepAlive) {
 	Routes* routes = getRoutes(request.method);
 	Log::trace("lookup for %s", request.path);
 	auto i = routes->find(request.path);
@@ -340,7 +711,7 @@ bool HttpServer::route(const RequestParser& request, HttpResponse& response) {
 		return false;
 	}
 	response.headers.put(header::CONTENT_TYPE, http::mimetype::TEXT_PLAIN);
-	response.headers.put(header::CONNECTION, "close");
+	response.headers.put(header::CONNECTION, keepAlive ? "keep-alive" : "close");
 	response.headers.put(header::SERVER, app::App::getInstance()->appname().c_str());
 	// TODO urldecode of request data
 	//core::string::urlDecode(request.query);
@@ -353,38 +724,41 @@ void HttpServer::shutdown() {
 	for (size_t i = 0; i < l; ++i) {
 		_routes[i].clear();
 	}
-	for (ClientSocketsIter i = _clientSockets.begin(); i != _clientSockets.end();) {
-		i = closeClient(i);
+	while (!_clients.empty()) {
+		closeClient(_clients.back());
+	}
+	for (Client *client : _freeClients) {
+		delete client;
+	}
+	_freeClients.release();
+	for (uint8_t *buf : _requestBuffers) {
+		SDL_free(buf);
 	}
+	_requestBuffers.release();
 
 	for (auto i : _errorPages) {
 		SDL_free((char*)i->second);
 	}
 	_errorPages.clear();
 
+#ifdef HTTP_SERVER_EPOLL
+	if (_epollFD != -1) {
+		close(_epollFD);
+		_epollFD = -1;
+	}
+#else
 	FD_ZERO(&_readFDSet);
 	FD_ZERO(&_writeFDSet);
-	closesocket(_socketFD);
-	_socketFD = INVALID_SOCKET;
+#endif
+	if (_socketFD != INVALID_SOCKET) {
+		closesocket(_socketFD);
+		_socketFD = INVALID_SOCKET;
+	}
 	network_cleanup();
 }
 
-HttpServer::Client::Client() :
-		socket(INVALID_SOCKET) {
-}
-
-void HttpServer::Client::setResponse(char* responseBuf, size_t responseBufLength) {
-	core_assert(response == nullptr);
-	response = responseBuf;
-	responseLength = responseBufLength;
-	alreadySent = 0u;
-}
-
-bool HttpServer::Client::finished() const {
-	if (response == nullptr) {
-		return false;
-	}
-	return responseLength == alreadySent;
+bool HttpServer::Client::pending() const {
+	return currentResponse < responses.size();
 }
 
 }
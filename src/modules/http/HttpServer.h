@@ -12,56 +12,125 @@
 #include "HttpHeader.h"
 #include "HttpQuery.h"
 #include "core/collection/Map.h"
-#include "core/collection/List.h"
+#include "core/collection/DynamicArray.h"
 #include "metric/Metric.h"
 #include <stdint.h>
 #include <functional>
 #include <memory>
 
+#if defined(__linux__)
+#define HTTP_SERVER_EPOLL 1
+#endif
+
 namespace http {
 
 class RequestParser;
 
+/**
+ * @brief Non blocking http server that is ticked by calling @c update()
+ *
+ * On linux the sockets are watched by an edge triggered epoll instance - other platforms
+ * fall back to @c select() and are thus limited to @c FD_SETSIZE connections.
+ *
+ * The connections are kept alive for HTTP/1.1 clients (and HTTP/1.0 clients that ask for it)
+ * and pipelined requests are answered in the order they were received. The request buffers
+ * are taken from a preallocated pool and the responses are sent without copying the body into
+ * the header buffer. File responses (see @c HttpResponse::setFile()) are sent with @c sendfile()
+ * where available.
+ */
 class HttpServer {
 public:
 	using RouteCallback = std::function<void(const RequestParser& query, HttpResponse* response)>;
+	/**
+	 * @brief The initial size of the pooled per connection request buffers
+	 */
+	static constexpr size_t RequestBufferSize = 8 * 1024;
+	/**
+	 * @brief The amount of request buffers that are preallocated in @c init()
+	 */
+	static constexpr size_t RequestBufferPoolSize = 64;
 private:
 	SOCKET _socketFD;
+#ifdef HTTP_SERVER_EPOLL
+	int _epollFD = -1;
+#else
 	fd_set _readFDSet;
 	fd_set _writeFDSet;
+#endif
 	using Routes = core::Map<const char*, RouteCallback, 8, core::hashCharPtr, core::hashCharCompare>;
 	core::Map<int, const char*, 8, std::hash<int>> _errorPages;
 	Routes _routes[2];
 	size_t _maxRequestBytes = 1 * 1024 * 1024;
 	metric::MetricPtr _metric;
 
+	struct Response {
+		// status line and headers - for errors this also includes the error page
+		char *header = nullptr;
+		size_t headerLength = 0u;
+		const char *body = nullptr;
+		size_t bodySize = 0u;
+		bool freeBody = false;
+		// file descriptor that is sent with sendfile() after the header
+		int file = -1;
+		size_t fileSize = 0u;
+		size_t fileOffset = 0u;
+		// the bytes of header and body that were already sent
+		size_t alreadySent = 0u;
+	};
+
 	struct Client {
-		Client();
 		SOCKET socket;
+		// the slot in the client list
+		size_t index = 0u;
 
 		uint8_t *request = nullptr;
+		size_t requestCapacity = 0u;
 		size_t requestLength = 0u;
 
-		char* response = nullptr;
-		size_t responseLength = 0u;
-		size_t alreadySent = 0u;
+		core::DynamicArray<Response, 4> responses;
+		size_t currentResponse = 0u;
+		// no further requests are read if this is false - the connection is closed after the responses were sent
+		bool keepAlive = true;
+		bool peerClosed = false;
 
-		void setResponse(char* responseBuf, size_t responseBufLength);
-		bool finished() const;
+		bool pending() const;
 	};
 
-	using ClientSockets = core::List<Client>;
-	using ClientSocketsIter = ClientSockets::iterator;
-	ClientSockets _clientSockets { 1024 };
+	core::DynamicArray<Client*> _clients;
+	core::DynamicArray<Client*> _freeClients;
+	core::DynamicArray<uint8_t*> _requestBuffers;
 
-	ClientSocketsIter closeClient (ClientSocketsIter& i);
+	void acceptClients();
+	void closeClient(Client* client);
+	void releaseResponse(Response& response);
+	void releaseRequestBuffer(Client* client);
+	bool growRequestBuffer(Client& client);
+
+	/**
+	 * @brief Reads until the socket would block
+	 * @return @c false if the connection failed
+	 */
+	bool receive(Client& client);
+	/**
+	 * @brief Splits the received data into the single requests and queues the responses
+	 */
+	void handleRequests(Client& client);
+	/**
+	 * @brief Sends the queued responses until the socket would block
+	 * @return @c false if the connection failed
+	 */
+	bool sendResponses(Client& client);
+	/**
+	 * @brief Reads the pending requests, sends the queued responses and closes the connection if it's done
+	 * @note This might release the given client
+	 */
+	void process(Client* client, bool readable);
 
 	void metric(HttpStatus status) const;
 
-	bool route(const RequestParser& request, HttpResponse& response);
-	void assembleResponse(Client& client, const HttpResponse& response);
+	bool route(const RequestParser& request, HttpResponse& response, bool keepAlive);
+	void assembleResponse(Client& client, HttpResponse& response);
 	void assembleError(Client& client, HttpStatus status);
-	bool sendMessage(Client& client);
 
 	Routes* getRoutes(HttpMethod method);
 
@@ -82,8 +151,17 @@ public:
 
 	void registerRoute(HttpMethod method, const char *path, const RouteCallback& callback);
 	bool unregisterRoute(HttpMethod method, const char *path);
+
+	/**
+	 * @return The amount of open client connections
+	 */
+	size_t connections() const;
 };
 
+inline size_t HttpServer::connections() const {
+	return _clients.size();
+}
+
 inline void HttpServer::setMaxRequestSize(size_t maxBytes) {
 	_maxRequestBytes = maxBytes;
 }
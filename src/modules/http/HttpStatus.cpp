@@ -15,6 +15,8 @@ const char* toStatusString(HttpStatus status) {
 		return "Not Found";
 	} else if (status == HttpStatus::NotImplemented) {
 		return "Not Implemented";
+	} else if (status == HttpStatus::BadRequest) {
+		return "Bad Request";
 	}
 	return "Unknown";
 }
@@ -0,0 +1,183 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "http/HttpServer.h"
+#include "http/Network.cpp.h"
+#include <vector>
+
+namespace {
+
+const int16_t Port = 10110;
+
+const char *KeepAliveRequest = "GET /health HTTP/1.1\r\nHost: localhost\r\n\r\n";
+const char *CloseRequest = "GET /health HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+SOCKET connectClient() {
+	const SOCKET s = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (s == INVALID_SOCKET) {
+		return s;
+	}
+	struct sockaddr_in sin;
+	SDL_memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	sin.sin_port = htons(Port);
+	if (connect(s, (struct sockaddr *) &sin, sizeof(sin)) != 0) {
+		closesocket(s);
+		return INVALID_SOCKET;
+	}
+	networkNonBlocking(s);
+	return s;
+}
+
+struct Connection {
+	SOCKET socket = INVALID_SOCKET;
+	// the amount of responses that are still expected
+	int pending = 0;
+	bool closed = false;
+	// the last received character - a response might be split over several reads
+	char last = '\0';
+};
+
+/**
+ * @brief Ticks the server until all clients received their responses - the end of a response is detected
+ * by its body "!" that directly follows the empty line after the header
+ */
+bool receiveAll(http::HttpServer& server, std::vector<Connection>& connections) {
+	int pending = 0;
+	for (const Connection& c : connections) {
+		pending += c.pending;
+	}
+	for (int loops = 0; pending > 0; ++loops) {
+		if (loops > 1000000) {
+			return false;
+		}
+		server.update();
+		for (Connection& c : connections) {
+			if (c.pending == 0 || c.closed) {
+				continue;
+			}
+			char buf[4096];
+			const network_return len = recv(c.socket, buf, sizeof(buf), 0);
+			if (len == 0) {
+				c.closed = true;
+				pending -= c.pending;
+				c.pending = 0;
+				continue;
+			}
+			for (network_return i = 0; i < len; ++i) {
+				if (c.last == '\n' && buf[i] == '!' && c.pending > 0) {
+					--c.pending;
+					--pending;
+				}
+				c.last = buf[i];
+			}
+		}
+	}
+	return true;
+}
+
+}
+
+class HttpServerBenchmark : public app::AbstractBenchmark {
+protected:
+	http::HttpServer *_server = nullptr;
+	std::vector<Connection> _connections;
+
+public:
+	void SetUp(benchmark::State& state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_server = new http::HttpServer(_benchmarkApp->metric());
+		if (!_server->init(Port)) {
+			state.SkipWithError("Failed to initialize the http server");
+			return;
+		}
+		_server->registerRoute(http::HttpMethod::GET, "/health", [] (const http::RequestParser& request, http::HttpResponse* response) {
+			response->setText("!");
+		});
+	}
+
+	void TearDown(benchmark::State& state) override {
+		for (Connection& c : _connections) {
+			closesocket(c.socket);
+		}
+		_connections.clear();
+		_server->shutdown();
+		delete _server;
+		_server = nullptr;
+		app::AbstractBenchmark::TearDown(state);
+	}
+
+	bool connectAll(int amount) {
+		_connections.resize(amount);
+		for (Connection& c : _connections) {
+			c.socket = connectClient();
+			c.pending = 0;
+			c.closed = false;
+			c.last = '\0';
+			if (c.socket == INVALID_SOCKET) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool sendAll(const char *request, int pipelined) {
+		std::vector<char> buf;
+		const size_t len = SDL_strlen(request);
+		for (int i = 0; i < pipelined; ++i) {
+			buf.insert(buf.end(), request, request + len);
+		}
+		for (Connection& c : _connections) {
+			if (::send(c.socket, buf.data(), buf.size(), 0) != (network_return)buf.size()) {
+				return false;
+			}
+			c.pending += pipelined;
+		}
+		return true;
+	}
+};
+
+/**
+ * @brief Persistent connections - every client sends state.range(1) pipelined requests per iteration
+ */
+BENCHMARK_DEFINE_F(HttpServerBenchmark, KeepAlive)(benchmark::State& state) {
+	const int clients = (int)state.range(0);
+	const int pipelined = (int)state.range(1);
+	if (!connectAll(clients)) {
+		state.SkipWithError("Failed to connect");
+		return;
+	}
+	for (auto _ : state) {
+		if (!sendAll(KeepAliveRequest, pipelined) || !receiveAll(*_server, _connections)) {
+			state.SkipWithError("Failed to execute the requests");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * clients * pipelined);
+}
+
+/**
+ * @brief One connection per request - the behaviour of the clients that don't support keep-alive
+ */
+BENCHMARK_DEFINE_F(HttpServerBenchmark, Close)(benchmark::State& state) {
+	const int clients = (int)state.range(0);
+	for (auto _ : state) {
+		if (!connectAll(clients) || !sendAll(CloseRequest, 1) || !receiveAll(*_server, _connections)) {
+			state.SkipWithError("Failed to execute the requests");
+			break;
+		}
+		for (Connection& c : _connections) {
+			closesocket(c.socket);
+		}
+		_connections.clear();
+	}
+	state.SetItemsProcessed(state.iterations() * clients);
+}
+
+BENCHMARK_REGISTER_F(HttpServerBenchmark, KeepAlive)->Args({1, 1})->Args({64, 1})->Args({256, 1})->Args({256, 8});
+BENCHMARK_REGISTER_F(HttpServerBenchmark, Close)->Arg(1)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
@@ -4,10 +4,70 @@
 
 #include "app/tests/AbstractTest.h"
 #include "http/HttpServer.h"
+#include "http/Network.cpp.h"
+#include "core/StringUtil.h"
+#include <SDL_rwops.h>
+#include <SDL_timer.h>
+#include <stdio.h>
 
 namespace http {
 
 class HttpServerTest : public app::AbstractTest {
+protected:
+	SOCKET connectClient(int16_t port) {
+		const SOCKET s = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (s == INVALID_SOCKET) {
+			return s;
+		}
+		struct sockaddr_in sin;
+		SDL_memset(&sin, 0, sizeof(sin));
+		sin.sin_family = AF_INET;
+		sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		sin.sin_port = htons(port);
+		if (connect(s, (struct sockaddr *) &sin, sizeof(sin)) != 0) {
+			closesocket(s);
+			return INVALID_SOCKET;
+		}
+		networkNonBlocking(s);
+		return s;
+	}
+
+	int count(const core::String& str, const char *needle) const {
+		int n = 0;
+		const char *p = str.c_str();
+		while ((p = SDL_strstr(p, needle)) != nullptr) {
+			++n;
+			p += SDL_strlen(needle);
+		}
+		return n;
+	}
+
+	/**
+	 * @brief Ticks the server until the given needle was received @c expected times or the connection was closed
+	 */
+	core::String receive(HttpServer& server, SOCKET s, const char *needle, int expected, bool &closed) {
+		core::String received;
+		closed = false;
+		for (int i = 0; i < 5000; ++i) {
+			server.update();
+			char buf[1024];
+			const network_return len = recv(s, buf, sizeof(buf) - 1, 0);
+			if (len == 0) {
+				closed = true;
+				break;
+			}
+			if (len < 0) {
+				if (count(received, needle) >= expected) {
+					break;
+				}
+				SDL_Delay(1);
+				continue;
+			}
+			buf[len] = '\0';
+			received += buf;
+		}
+		return received;
+	}
 };
 
 TEST_F(HttpServerTest, testSimple) {
@@ -19,4 +79,110 @@ TEST_F(HttpServerTest, testSimple) {
 	server.shutdown();
 }
 
+TEST_F(HttpServerTest, testKeepAlivePipelining) {
+	HttpServer server(_testApp->metric());
+	ASSERT_TRUE(server.init(10102));
+	server.registerRoute(HttpMethod::GET, "/", [] (const http::RequestParser& request, HttpResponse* response) {
+		response->setText("Success");
+	});
+	const SOCKET s = connectClient(10102);
+	ASSERT_NE(INVALID_SOCKET, s);
+
+	// three pipelined requests in one packet
+	const char *requests =
+		"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+	ASSERT_EQ((network_return)SDL_strlen(requests), ::send(s, requests, SDL_strlen(requests), 0));
+	bool closed = false;
+	core::String received = receive(server, s, "Success", 3, closed);
+	EXPECT_FALSE(closed);
+	EXPECT_EQ(3, count(received, "HTTP/1.1 200")) << received.c_str();
+	EXPECT_EQ(3, count(received, "Connection: keep-alive")) << received.c_str();
+	EXPECT_EQ(1u, server.connections());
+
+	// the connection is closed once the response to the last request was sent
+	const char *last = "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+	ASSERT_EQ((network_return)SDL_strlen(last), ::send(s, last, SDL_strlen(last), 0));
+	received = receive(server, s, "Success", 2, closed);
+	EXPECT_TRUE(closed);
+	EXPECT_EQ(1, count(received, "HTTP/1.1 200")) << received.c_str();
+	EXPECT_EQ(1, count(received, "Connection: close")) << received.c_str();
+	EXPECT_EQ(0u, server.connections());
+
+	closesocket(s);
+	server.shutdown();
+}
+
+TEST_F(HttpServerTest, testSplitRequest) {
+	HttpServer server(_testApp->metric());
+	ASSERT_TRUE(server.init(10103));
+	server.registerRoute(HttpMethod::POST, "/", [] (const http::RequestParser& request, HttpResponse* response) {
+		response->setText(core::String(request.content, request.contentLength));
+	});
+	const SOCKET s = connectClient(10103);
+	ASSERT_NE(INVALID_SOCKET, s);
+
+	const char *header = "POST / HTTP/1.1\r\nContent-length: 7\r\n\r\nSuc";
+	ASSERT_EQ((network_return)SDL_strlen(header), ::send(s, header, SDL_strlen(header), 0));
+	bool closed = false;
+	core::String received = receive(server, s, "Success", 0, closed);
+	EXPECT_TRUE(received.empty()) << received.c_str();
+
+	const char *body = "cess";
+	ASSERT_EQ((network_return)SDL_strlen(body), ::send(s, body, SDL_strlen(body), 0));
+	received = receive(server, s, "Success", 1, closed);
+	EXPECT_FALSE(closed);
+	EXPECT_EQ(1, count(received, "Success")) << received.c_str();
+
+	closesocket(s);
+	server.shutdown();
+}
+
+TEST_F(HttpServerTest, testFileResponse) {
+	const char *content = "Content of the file";
+	const char *filename = "httpservertest.txt";
+	SDL_RWops *rwops = SDL_RWFromFile(filename, "wb");
+	ASSERT_NE(nullptr, rwops);
+	SDL_RWwrite(rwops, content, 1, SDL_strlen(content));
+	SDL_RWclose(rwops);
+
+	HttpServer server(_testApp->metric());
+	ASSERT_TRUE(server.init(10104));
+	server.registerRoute(HttpMethod::GET, "/file", [filename] (const http::RequestParser& request, HttpResponse* response) {
+		response->setFile(filename, http::mimetype::TEXT_PLAIN);
+	});
+	const SOCKET s = connectClient(10104);
+	ASSERT_NE(INVALID_SOCKET, s);
+
+	const char *request = "GET /file HTTP/1.0\r\nHost: localhost\r\n\r\n";
+	ASSERT_EQ((network_return)SDL_strlen(request), ::send(s, request, SDL_strlen(request), 0));
+	bool closed = false;
+	const core::String& received = receive(server, s, content, 1, closed);
+	EXPECT_TRUE(closed) << "HTTP/1.0 connections should be closed";
+	EXPECT_TRUE(core::string::endsWith(received, content)) << received.c_str();
+	EXPECT_EQ(1, count(received, "Content-length: 19")) << received.c_str();
+
+	closesocket(s);
+	server.shutdown();
+	remove(filename);
+}
+
+TEST_F(HttpServerTest, testNotFound) {
+	HttpServer server(_testApp->metric());
+	ASSERT_TRUE(server.init(10105));
+	const SOCKET s = connectClient(10105);
+	ASSERT_NE(INVALID_SOCKET, s);
+
+	const char *request = "GET /missing HTTP/1.1\r\nHost: localhost\r\n\r\nGET /missing HTTP/1.1\r\nHost: localhost\r\n\r\n";
+	ASSERT_EQ((network_return)SDL_strlen(request), ::send(s, request, SDL_strlen(request), 0));
+	bool closed = false;
+	const core::String& received = receive(server, s, "HTTP/1.1 404", 2, closed);
+	EXPECT_TRUE(closed);
+	EXPECT_EQ(1, count(received, "HTTP/1.1 404")) << received.c_str();
+
+	closesocket(s);
+	server.shutdown();
+}
+
 }
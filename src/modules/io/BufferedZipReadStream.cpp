@@ -17,9 +17,7 @@ BufferedZipReadStream::BufferedZipReadStream(SeekableReadStream &stream, size_t
 
 	uint8_t *srcBuf = (uint8_t *)core_malloc(zipSize);
 	if (stream.read(srcBuf, zipSize) == -1) {
-		// failed - make sure that the next read from this stream fails, too
-		_size = 0;
-		_pos = 0;
+		// failed - the stream stays empty, so the next read from this stream fails, too
 		Log::debug("Failed to read %i bytes from parent stream", (int)zipSize);
 		core_free(srcBuf);
 		return;
@@ -28,14 +26,11 @@ BufferedZipReadStream::BufferedZipReadStream(SeekableReadStream &stream, size_t
 	uint8_t *buf = (uint8_t *)core_malloc(maxUncompressedSize);
 	size_t finalSize = 0;
 	if (!core::zip::uncompress(srcBuf, zipSize, buf, maxUncompressedSize, &finalSize)) {
-		// failed - make sure that the next read from this stream fails, too
-		_size = 0;
-		_pos = 0;
+		// failed - the stream stays empty, so the next read from this stream fails, too
 		core_free(buf);
 		Log::error("Failed to uncompress stream data");
 	} else {
-		_buf = buf;
-		_size = (int64_t)finalSize;
+		setBuffer(buf, (int64_t)finalSize);
 	}
 
 	core_free(srcBuf);
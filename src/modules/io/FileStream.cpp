@@ -18,6 +18,7 @@ FileStream::FileStream(const FilePtr &file) : _file(file) {
 		_rwops = _file->_file;
 		if (_rwops) {
 			_size = SDL_RWsize(_rwops);
+			_pos = SDL_RWtell(_rwops);
 		} else {
 			_size = 0;
 		}
@@ -72,7 +73,7 @@ int FileStream::read(void *dataPtr, size_t dataSize) {
 		b += bytesRead;
 		completeBytesRead += bytesRead;
 	}
-	_pos = SDL_RWtell(_rwops);
+	_pos += (int64_t)completeBytesRead;
 	if (completeBytesRead != dataSize) {
 		Log::debug("File read error: %s", SDL_GetError());
 		return -1;
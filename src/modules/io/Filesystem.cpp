@@ -93,6 +93,14 @@ bool Filesystem::removeFile(const core::String &file) const {
 	return uv_fs_unlink(_loop, &req, file.c_str(), nullptr) == 0;
 }
 
+bool Filesystem::rename(const core::String &from, const core::String &to) const {
+	if (from.empty() || to.empty()) {
+		return false;
+	}
+	uv_fs_t req;
+	return uv_fs_rename(_loop, &req, from.c_str(), to.c_str(), nullptr) == 0;
+}
+
 bool Filesystem::removeDir(const core::String &dir, bool recursive) const {
 	if (dir.empty()) {
 		return false;
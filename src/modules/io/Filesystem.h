@@ -187,6 +187,13 @@ public:
 	 * @param file The full path to the file or relative to the current working dir of your app.
 	 */
 	bool removeFile(const core::String& file) const;
+	/**
+	 * @brief Renames the given file without taking the write path into account. An existing target file is replaced.
+	 * @note This can be used to atomically replace a file with a fully written temporary file.
+	 * @param from The full path to the file or relative to the current working dir of your app.
+	 * @param to The full path to the file or relative to the current working dir of your app.
+	 */
+	bool rename(const core::String& from, const core::String& to) const;
 private:
 	static bool _list(const core::String& directory, core::DynamicArray<FilesystemEntry>& entities, const core::String& filter = "");
 };
@@ -9,16 +9,30 @@
 
 namespace io {
 
-MemoryReadStream::MemoryReadStream(const void *buf, uint32_t size) : _buf((const uint8_t*)buf), _size(size) {
+MemoryReadStream::MemoryReadStream(const void *buf, uint32_t size) {
+	setBuffer((const uint8_t *)buf, size);
 }
 
-MemoryReadStream::MemoryReadStream(ReadStream &stream, uint32_t size) : _ownBuf((uint8_t*)core_malloc(size)), _size(size) {
+MemoryReadStream::MemoryReadStream(ReadStream &stream, uint32_t size) : _ownBuf((uint8_t *)core_malloc(size)) {
+	if (stream.read(_ownBuf, size) != (int)size) {
+		Log::debug("Failed to read %u bytes from parent stream", size);
+		setBuffer(_ownBuf, 0);
+	} else {
+		setBuffer(_ownBuf, size);
+	}
 }
 
 MemoryReadStream::~MemoryReadStream() {
 	core_free(_ownBuf);
 }
 
+void MemoryReadStream::setBuffer(const uint8_t *buf, int64_t size) {
+	_buf = buf;
+	_size = buf == nullptr ? 0 : size;
+	_readPtr = _buf;
+	_readEnd = _buf + _size;
+}
+
 int MemoryReadStream::read(void *dataPtr, size_t dataSize) {
 	const int64_t rem = remaining();
 	if (rem == 0) {
@@ -27,38 +41,33 @@ int MemoryReadStream::read(void *dataPtr, size_t dataSize) {
 	if (dataSize > (size_t)rem) {
 		dataSize = rem;
 	}
-	if (_pos + (int64_t)dataSize > _size) {
-		return -1;
-	}
-	if (_ownBuf) {
-		core_memcpy(dataPtr, &_ownBuf[_pos], dataSize);
-	} else {
-		core_memcpy(dataPtr, &_buf[_pos], dataSize);
-	}
-	_pos += (int64_t)dataSize;
+	core_memcpy(dataPtr, _readPtr, dataSize);
+	_readPtr += dataSize;
 	return (int)dataSize;
 }
 
 int64_t MemoryReadStream::seek(int64_t position, int whence) {
+	int64_t newPos;
 	switch (whence) {
 	case SEEK_SET:
-		_pos = position;
+		newPos = position;
 		break;
 	case SEEK_CUR:
-		_pos += position;
+		newPos = pos() + position;
 		break;
 	case SEEK_END:
-		_pos = _size + position;
+		newPos = _size + position;
 		break;
 	default:
 		return -1;
 	}
-	if (_pos < 0) {
-		_pos = 0;
-	} else if (_pos > _size) {
-		_pos = _size;
+	if (newPos < 0) {
+		newPos = 0;
+	} else if (newPos > _size) {
+		newPos = _size;
 	}
-	return _pos;
+	_readPtr = _buf + newPos;
+	return newPos;
 }
 
 } // namespace io
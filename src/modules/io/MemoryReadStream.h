@@ -9,6 +9,8 @@
 namespace io {
 
 /**
+ * @brief Seekable stream over a memory buffer. The typed readers of the base class take their values directly
+ * from the buffer without going through read().
  * @ingroup IO
  * @see SeekableReadStream
  * @see BufferedReadWriteStream
@@ -18,10 +20,15 @@ protected:
 	const uint8_t *_buf = nullptr;
 	uint8_t *_ownBuf = nullptr;
 	int64_t _size;
-	int64_t _pos = 0;
+
+	void setBuffer(const uint8_t *buf, int64_t size);
 
 public:
 	MemoryReadStream(const void *buf, uint32_t size);
+	/**
+	 * @brief Reads @c size bytes from the given stream into an owned buffer
+	 * @note If the given stream doesn't provide the requested amount of bytes, this stream is empty
+	 */
 	MemoryReadStream(ReadStream &stream, uint32_t size);
 	virtual ~MemoryReadStream();
 
@@ -29,6 +36,7 @@ public:
 	int64_t pos() const override;
 	int read(void *dataPtr, size_t dataSize) override;
 	int64_t seek(int64_t position, int whence = SEEK_SET) override;
+	bool eos() const override;
 };
 
 inline int64_t MemoryReadStream::size() const {
@@ -36,7 +44,11 @@ inline int64_t MemoryReadStream::size() const {
 }
 
 inline int64_t MemoryReadStream::pos() const {
-	return _pos;
+	return (int64_t)(_readPtr - _buf);
+}
+
+inline bool MemoryReadStream::eos() const {
+	return _readPtr >= _readEnd;
 }
 
 } // namespace io
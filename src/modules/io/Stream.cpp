@@ -352,20 +352,6 @@ bool ReadStream::readPascalStringUInt32BE(core::String &str) {
 	return readString((int)length, str, false);
 }
 
-int ReadStream::readUInt8(uint8_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt8(int8_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		return 0;
-	}
-	return -1;
-}
-
 bool ReadStream::readBool() {
 	uint8_t boolean;
 	if (readUInt8(boolean) != 0) {
@@ -374,138 +360,6 @@ bool ReadStream::readBool() {
 	return boolean != 0;
 }
 
-int ReadStream::readUInt16(uint16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const uint16_t swapped = SDL_SwapLE16(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt16(int16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int16_t swapped = SDL_SwapLE16(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt16BE(int16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int16_t swapped = SDL_SwapBE16(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readUInt16BE(uint16_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int16_t swapped = SDL_SwapBE16(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readFloat(float &val) {
-	union toint {
-		float f;
-		uint32_t i;
-	} tmp;
-	const int retVal = readUInt32(tmp.i);
-	if (retVal == 0) {
-		val = tmp.f;
-	}
-	return retVal;
-}
-
-int ReadStream::readFloatBE(float &val) {
-	union toint {
-		float f;
-		uint32_t i;
-	} tmp;
-	const int retVal = readUInt32BE(tmp.i);
-	if (retVal == 0) {
-		val = tmp.f;
-	}
-	return retVal;
-}
-
-int ReadStream::readUInt32(uint32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const uint32_t swapped = SDL_SwapLE32(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt32(int32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int32_t swapped = (int32_t)SDL_SwapLE32(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readUInt32BE(uint32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const uint32_t swapped = SDL_SwapBE32(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt32BE(int32_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int32_t swapped = SDL_SwapBE32(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readUInt64(uint64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const uint64_t swapped = SDL_SwapLE64(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt64(int64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int64_t swapped = SDL_SwapLE64(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readUInt64BE(uint64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const uint64_t swapped = SDL_SwapBE64(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
-int ReadStream::readInt64BE(int64_t &val) {
-	if (read(&val, sizeof(val)) == sizeof(val)) {
-		const int64_t swapped = SDL_SwapBE64(val);
-		val = swapped;
-		return 0;
-	}
-	return -1;
-}
-
 bool SeekableReadStream::readLine(int length, char *strbuff) {
 	for (int i = 0; i < length; ++i) {
 		uint8_t chr;
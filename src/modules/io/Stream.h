@@ -22,8 +22,29 @@ namespace io {
  * @ingroup IO
  */
 class ReadStream : public core::NonCopyable {
+protected:
+	/**
+	 * @brief The not yet consumed bytes of streams that are backed by memory. The typed readers take their values
+	 * from this window inline and only fall back to the virtual read() call if it doesn't hold enough bytes.
+	 * @note Streams that set up a window must use @c _readPtr as their read position.
+	 */
+	const uint8_t *_readPtr = nullptr;
+	const uint8_t *_readEnd = nullptr;
+
+	/**
+	 * @return Pointer to the next @c size bytes - either directly in the read window or copied into @c buf
+	 * by read(). @c nullptr if there are not enough bytes left in the stream.
+	 */
+	const uint8_t *readBytes(uint8_t *buf, size_t size);
+
 public:
 	virtual ~ReadStream() {}
+	/**
+	 * @return @c true if the typed readers are served from memory without calling read()
+	 */
+	bool hasReadWindow() const {
+		return _readEnd != nullptr;
+	}
 	/**
 	 * @return -1 on error - read bytes on success
 	 */
@@ -190,6 +211,206 @@ public:
 	bool empty() const;
 };
 
+namespace priv {
+
+inline uint16_t toUInt16LE(const uint8_t *p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t toUInt32LE(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint64_t toUInt64LE(const uint8_t *p) {
+	return (uint64_t)toUInt32LE(p) | ((uint64_t)toUInt32LE(p + 4) << 32);
+}
+
+inline uint16_t toUInt16BE(const uint8_t *p) {
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+inline uint32_t toUInt32BE(const uint8_t *p) {
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+inline uint64_t toUInt64BE(const uint8_t *p) {
+	return ((uint64_t)toUInt32BE(p) << 32) | (uint64_t)toUInt32BE(p + 4);
+}
+
+} // namespace priv
+
+inline const uint8_t *ReadStream::readBytes(uint8_t *buf, size_t size) {
+	if ((size_t)(_readEnd - _readPtr) >= size) {
+		const uint8_t *p = _readPtr;
+		_readPtr += size;
+		return p;
+	}
+	if (read(buf, size) != (int)size) {
+		return nullptr;
+	}
+	return buf;
+}
+
+inline int ReadStream::readUInt8(uint8_t &val) {
+	const uint8_t *p = readBytes(&val, sizeof(val));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = *p;
+	return 0;
+}
+
+inline int ReadStream::readInt8(int8_t &val) {
+	uint8_t v;
+	const int retVal = readUInt8(v);
+	if (retVal == 0) {
+		val = (int8_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readUInt16(uint16_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt16LE(p);
+	return 0;
+}
+
+inline int ReadStream::readUInt32(uint32_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt32LE(p);
+	return 0;
+}
+
+inline int ReadStream::readUInt64(uint64_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt64LE(p);
+	return 0;
+}
+
+inline int ReadStream::readUInt16BE(uint16_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt16BE(p);
+	return 0;
+}
+
+inline int ReadStream::readUInt32BE(uint32_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt32BE(p);
+	return 0;
+}
+
+inline int ReadStream::readUInt64BE(uint64_t &val) {
+	uint8_t buf[sizeof(val)];
+	const uint8_t *p = readBytes(buf, sizeof(buf));
+	if (p == nullptr) {
+		return -1;
+	}
+	val = priv::toUInt64BE(p);
+	return 0;
+}
+
+inline int ReadStream::readInt16(int16_t &val) {
+	uint16_t v;
+	const int retVal = readUInt16(v);
+	if (retVal == 0) {
+		val = (int16_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readInt32(int32_t &val) {
+	uint32_t v;
+	const int retVal = readUInt32(v);
+	if (retVal == 0) {
+		val = (int32_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readInt64(int64_t &val) {
+	uint64_t v;
+	const int retVal = readUInt64(v);
+	if (retVal == 0) {
+		val = (int64_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readInt8BE(int8_t &val) {
+	return readInt8(val);
+}
+
+inline int ReadStream::readInt16BE(int16_t &val) {
+	uint16_t v;
+	const int retVal = readUInt16BE(v);
+	if (retVal == 0) {
+		val = (int16_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readInt32BE(int32_t &val) {
+	uint32_t v;
+	const int retVal = readUInt32BE(v);
+	if (retVal == 0) {
+		val = (int32_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readInt64BE(int64_t &val) {
+	uint64_t v;
+	const int retVal = readUInt64BE(v);
+	if (retVal == 0) {
+		val = (int64_t)v;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readFloat(float &val) {
+	union toint {
+		float f;
+		uint32_t i;
+	} tmp;
+	const int retVal = readUInt32(tmp.i);
+	if (retVal == 0) {
+		val = tmp.f;
+	}
+	return retVal;
+}
+
+inline int ReadStream::readFloatBE(float &val) {
+	union toint {
+		float f;
+		uint32_t i;
+	} tmp;
+	const int retVal = readUInt32BE(tmp.i);
+	if (retVal == 0) {
+		val = tmp.f;
+	}
+	return retVal;
+}
+
 inline int64_t SeekableReadStream::remaining() const {
 	return size() - pos();
 }
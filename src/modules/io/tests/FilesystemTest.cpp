@@ -171,6 +171,21 @@ TEST_F(FilesystemTest, testWriteNewDir) {
 	fs.shutdown();
 }
 
+TEST_F(FilesystemTest, testRename) {
+	io::Filesystem fs;
+	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
+	EXPECT_TRUE(fs.createDir("renametest"));
+	EXPECT_TRUE(fs.syswrite("renametest/source", "new"));
+	EXPECT_TRUE(fs.syswrite("renametest/target", "old"));
+	EXPECT_TRUE(fs.rename("renametest/source", "renametest/target"));
+	EXPECT_FALSE(fs.exists("renametest/source"));
+	EXPECT_EQ("new", fs.load("renametest/target"));
+	EXPECT_FALSE(fs.rename("renametest/source", "renametest/target"));
+	fs.removeFile("renametest/target");
+	fs.removeDir("renametest");
+	fs.shutdown();
+}
+
 TEST_F(FilesystemTest, testCreateDirRecursive) {
 	io::Filesystem fs;
 	EXPECT_TRUE(fs.init("test", "test")) << "Failed to initialize the filesystem";
@@ -86,6 +86,83 @@ public:
 	static bool isVisible(const glm::vec3& eye, float orientation, const glm::vec3& target, float fieldOfView);
 };
 
+/**
+ * @brief The planes of a @c Frustum in a structure of arrays layout. The aabb tests evaluate all
+ * planes without branches - this allows the compiler to vectorize the loops.
+ * @note Use this for testing a lot of aabbs against the same frustum - e.g. for culling.
+ */
+class PackedFrustum {
+private:
+	// FRUSTUM_PLANES_MAX padded to a multiple of the simd width
+	static constexpr int Lanes = 8;
+	alignas(16) float _normX[Lanes];
+	alignas(16) float _normY[Lanes];
+	alignas(16) float _normZ[Lanes];
+	alignas(16) float _dist[Lanes];
+public:
+	PackedFrustum(const Frustum& frustum);
+
+	/**
+	 * @brief Same result as @c Frustum::test()
+	 */
+	FrustumResult test(const glm::vec3& mins, const glm::vec3& maxs) const;
+	/**
+	 * @brief Same result as @c Frustum::isVisible()
+	 */
+	bool isVisible(const glm::vec3& mins, const glm::vec3& maxs) const;
+};
+
+inline PackedFrustum::PackedFrustum(const Frustum& frustum) {
+	for (int i = 0; i < Lanes; ++i) {
+		if (i >= FRUSTUM_PLANES_MAX) {
+			// the padding planes have every point on their front side
+			_normX[i] = _normY[i] = _normZ[i] = 0.0f;
+			_dist[i] = 1.0f;
+			continue;
+		}
+		const Plane& p = frustum[i];
+		_normX[i] = p.norm().x;
+		_normY[i] = p.norm().y;
+		_normZ[i] = p.norm().z;
+		_dist[i] = p.dist();
+	}
+}
+
+inline FrustumResult PackedFrustum::test(const glm::vec3& mins, const glm::vec3& maxs) const {
+	// the vertex in the direction of the plane normal is the max of the products - the vertex
+	// in the opposite direction is the min of the products
+	float positive[Lanes];
+	float negative[Lanes];
+	for (int i = 0; i < Lanes; ++i) {
+		const float x1 = _normX[i] * mins.x, x2 = _normX[i] * maxs.x;
+		const float y1 = _normY[i] * mins.y, y2 = _normY[i] * maxs.y;
+		const float z1 = _normZ[i] * mins.z, z2 = _normZ[i] * maxs.z;
+		positive[i] = (x1 > x2 ? x1 : x2) + (y1 > y2 ? y1 : y2) + (z1 > z2 ? z1 : z2) + _dist[i];
+		negative[i] = (x1 < x2 ? x1 : x2) + (y1 < y2 ? y1 : y2) + (z1 < z2 ? z1 : z2) + _dist[i];
+	}
+	int outside = 0;
+	int intersect = 0;
+	for (int i = 0; i < Lanes; ++i) {
+		outside |= positive[i] < 0.0f;
+		intersect |= negative[i] < 0.0f;
+	}
+	if (outside) {
+		return FrustumResult::Outside;
+	}
+	return intersect ? FrustumResult::Intersect : FrustumResult::Inside;
+}
+
+inline bool PackedFrustum::isVisible(const glm::vec3& mins, const glm::vec3& maxs) const {
+	int outside = 0;
+	for (int i = 0; i < Lanes; ++i) {
+		const float x1 = _normX[i] * mins.x, x2 = _normX[i] * maxs.x;
+		const float y1 = _normY[i] * mins.y, y2 = _normY[i] * maxs.y;
+		const float z1 = _normZ[i] * mins.z, z2 = _normZ[i] * maxs.z;
+		outside |= (x1 > x2 ? x1 : x2) + (y1 > y2 ? y1 : y2) + (z1 > z2 ? z1 : z2) + _dist[i] < 0.0f;
+	}
+	return outside == 0;
+}
+
 inline Plane& Frustum::plane(FrustumPlanes frustumPlane) {
 	return _planes[(int)frustumPlane];
 }
@@ -0,0 +1,412 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "AABB.h"
+#include "Frustum.h"
+#include "core/Trace.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+#include <stdint.h>
+
+namespace math {
+
+/**
+ * @brief Loose octree with the nodes and the contents in flat pools
+ *
+ * Every node has a loose bounding box that is twice the size of its cell. An item is stored in the
+ * deepest node whose cell contains the center of the item and whose loose bounds contain the whole
+ * item. Because of this an item is never split across nodes and the node is found without
+ * redistributing any content on insert.
+ *
+ * Items that don't fit into the bounds of the tree are kept in the root node - they are always
+ * tested against the query areas.
+ *
+ * The queries don't allocate memory. They either call a visitor for each matching item or fill
+ * a reusable @c Results array.
+ *
+ * @note Given NODE type must implement @c aabb() and return math::AABB<TYPE>. The bounds are
+ * copied on insert - the bounds must not change until the item was removed again.
+ * @sa Octree
+ */
+template<class NODE, typename TYPE = int>
+class LooseOctree {
+public:
+	typedef core::DynamicArray<NODE> Results;
+	static constexpr int MaxDepth = 20;
+
+private:
+	struct Entry {
+		NODE item;
+		AABB<TYPE> aabb;
+		// next entry in the same node or the next free entry
+		int32_t next;
+	};
+
+	struct Node {
+		AABB<TYPE> cell;
+		AABB<TYPE> loose;
+		int32_t parent = -1;
+		// index of the first of the eight consecutive children
+		int32_t children = -1;
+		// head of the entry list
+		int32_t entries = -1;
+		// amount of entries in this node and all of its children
+		int32_t count = 0;
+		int depth = 0;
+	};
+
+	struct StackEntry {
+		int32_t node;
+		// the loose bounds are completely inside the query area
+		bool inside;
+	};
+	static constexpr int StackSize = 8 * (MaxDepth + 1);
+
+	core::DynamicArray<Node> _nodes;
+	core::DynamicArray<Entry> _entries;
+	// index of the first node of released groups of eight children
+	core::DynamicArray<int32_t> _freeChildren;
+	int32_t _freeEntries = -1;
+	const AABB<TYPE> _aabb;
+	const int _maxDepth;
+	// dirty flag can be used for query caches
+	bool _dirty = false;
+
+	static inline AABB<TYPE> itemAABB(const typename core::remove_pointer<NODE>::type* item) {
+		return item->aabb();
+	}
+
+	static inline AABB<TYPE> itemAABB(const typename core::remove_pointer<NODE>::type& item) {
+		return item.aabb();
+	}
+
+	/**
+	 * @brief The pools grow geometrically - the array itself only grows linearly
+	 */
+	template<class ARRAY>
+	static inline void ensureCapacity(ARRAY& array, size_t size) {
+		if (array.capacity() < size) {
+			array.reserve(core_max(size, array.capacity() * 2));
+		}
+	}
+
+	static inline int childIndex(const AABB<TYPE>& cell, const glm::tvec3<TYPE>& pos) {
+		const glm::tvec3<TYPE>& center = cell.getCenter();
+		return (pos.x >= center.x ? 4 : 0) | (pos.y >= center.y ? 2 : 0) | (pos.z >= center.z ? 1 : 0);
+	}
+
+	static Node createNode(const AABB<TYPE>& cell, int32_t parent, int depth) {
+		Node node;
+		node.cell = cell;
+		const glm::tvec3<TYPE>& halfWidth = cell.getWidth() / (TYPE)2;
+		node.loose = AABB<TYPE>(cell.mins() - halfWidth, cell.maxs() + halfWidth);
+		node.parent = parent;
+		node.depth = depth;
+		return node;
+	}
+
+	void createChildren(int32_t nodeIndex) {
+		core_trace_scoped(LooseOctreeCreateChildren);
+		const AABB<TYPE> cell = _nodes[nodeIndex].cell;
+		const int depth = _nodes[nodeIndex].depth + 1;
+		const glm::tvec3<TYPE>& mins = cell.mins();
+		const glm::tvec3<TYPE>& center = cell.getCenter();
+		const glm::tvec3<TYPE>& maxs = cell.maxs();
+		int32_t first;
+		if (_freeChildren.empty()) {
+			first = (int32_t)_nodes.size();
+			ensureCapacity(_nodes, _nodes.size() + 8);
+			_nodes.resize(_nodes.size() + 8);
+		} else {
+			first = _freeChildren.back();
+			_freeChildren.pop();
+		}
+		for (int i = 0; i < 8; ++i) {
+			const glm::tvec3<TYPE> childMins((i & 4) ? center.x : mins.x, (i & 2) ? center.y : mins.y, (i & 1) ? center.z : mins.z);
+			const glm::tvec3<TYPE> childMaxs((i & 4) ? maxs.x : center.x, (i & 2) ? maxs.y : center.y, (i & 1) ? maxs.z : center.z);
+			_nodes[first + i] = createNode(AABB<TYPE>(childMins, childMaxs), nodeIndex, depth);
+		}
+		_nodes[nodeIndex].children = first;
+	}
+
+	/**
+	 * @brief Puts the children of the given empty node and all their children back into the pool
+	 */
+	void releaseChildren(int32_t nodeIndex) {
+		const int32_t first = _nodes[nodeIndex].children;
+		if (first == -1) {
+			return;
+		}
+		core_assert(_nodes[nodeIndex].count == 0);
+		for (int i = 0; i < 8; ++i) {
+			releaseChildren(first + i);
+		}
+		_freeChildren.push_back(first);
+		_nodes[nodeIndex].children = -1;
+	}
+
+	/**
+	 * @return The child node of the given node the item must be put into - or @c -1 if the item
+	 * belongs to the given node
+	 */
+	int32_t childForItem(int32_t nodeIndex, const AABB<TYPE>& area, bool create) {
+		const Node& node = _nodes[nodeIndex];
+		if (node.depth >= _maxDepth) {
+			return -1;
+		}
+		const glm::tvec3<TYPE>& cellSize = node.cell.getWidth();
+		const glm::tvec3<TYPE>& size = area.getWidth();
+		// the children can't be split any further or the item is bigger than the child cells
+		if (cellSize.x < (TYPE)2 || cellSize.y < (TYPE)2 || cellSize.z < (TYPE)2) {
+			return -1;
+		}
+		if (size.x * (TYPE)2 > cellSize.x || size.y * (TYPE)2 > cellSize.y || size.z * (TYPE)2 > cellSize.z) {
+			return -1;
+		}
+		const glm::tvec3<TYPE>& center = area.getCenter();
+		if (!node.cell.containsPoint(center)) {
+			return -1;
+		}
+		if (node.children == -1) {
+			if (!create) {
+				return -1;
+			}
+			createChildren(nodeIndex);
+		}
+		const int32_t child = _nodes[nodeIndex].children + childIndex(_nodes[nodeIndex].cell, center);
+		if (!_nodes[child].loose.containsAABB(area)) {
+			return -1;
+		}
+		return child;
+	}
+
+	void updateCount(int32_t nodeIndex, int32_t delta) {
+		for (int32_t i = nodeIndex; i != -1; i = _nodes[i].parent) {
+			_nodes[i].count += delta;
+		}
+	}
+
+	void reset() {
+		_nodes.clear();
+		_entries.clear();
+		_freeChildren.clear();
+		_freeEntries = -1;
+		_nodes.push_back(createNode(_aabb, -1, 0));
+	}
+
+public:
+	LooseOctree(const AABB<TYPE>& aabb, int maxDepth = 10) :
+			_aabb(aabb), _maxDepth(core_min(maxDepth, (int)MaxDepth)) {
+		reset();
+	}
+
+	inline int count() const {
+		return _nodes[0].count;
+	}
+
+	inline const AABB<TYPE>& aabb() const {
+		return _aabb;
+	}
+
+	/**
+	 * @return The amount of nodes in use
+	 */
+	inline size_t nodes() const {
+		return _nodes.size() - _freeChildren.size() * 8;
+	}
+
+	bool insert(const NODE& item) {
+		core_trace_scoped(LooseOctreeInsert);
+		const AABB<TYPE>& area = itemAABB(item);
+		int32_t nodeIndex = 0;
+		for (;;) {
+			const int32_t child = childForItem(nodeIndex, area, true);
+			if (child == -1) {
+				break;
+			}
+			nodeIndex = child;
+		}
+		int32_t entryIndex = _freeEntries;
+		if (entryIndex == -1) {
+			ensureCapacity(_entries, _entries.size() + 1);
+			_entries.push_back(Entry{item, area, -1});
+			entryIndex = (int32_t)_entries.size() - 1;
+		} else {
+			_freeEntries = _entries[entryIndex].next;
+			_entries[entryIndex].item = item;
+			_entries[entryIndex].aabb = area;
+		}
+		Node& node = _nodes[nodeIndex];
+		_entries[entryIndex].next = node.entries;
+		node.entries = entryIndex;
+		updateCount(nodeIndex, 1);
+		_dirty = true;
+		return true;
+	}
+
+	bool remove(const NODE& item) {
+		core_trace_scoped(LooseOctreeRemove);
+		const AABB<TYPE>& area = itemAABB(item);
+		// the item is located somewhere on the path that the insert took
+		for (int32_t nodeIndex = 0; nodeIndex != -1; nodeIndex = childForItem(nodeIndex, area, false)) {
+			Node& node = _nodes[nodeIndex];
+			int32_t prev = -1;
+			for (int32_t e = node.entries; e != -1; prev = e, e = _entries[e].next) {
+				if (!(_entries[e].item == item)) {
+					continue;
+				}
+				if (prev == -1) {
+					node.entries = _entries[e].next;
+				} else {
+					_entries[prev].next = _entries[e].next;
+				}
+				_entries[e].next = _freeEntries;
+				_freeEntries = e;
+				updateCount(nodeIndex, -1);
+				// release the nodes of the subtree that just got empty - this keeps the pool
+				// small if the items are moving around
+				int32_t empty = nodeIndex;
+				while (_nodes[empty].parent != -1 && _nodes[_nodes[empty].parent].count == 0) {
+					empty = _nodes[empty].parent;
+				}
+				if (_nodes[empty].count == 0) {
+					releaseChildren(empty);
+				}
+				_dirty = true;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Calls the given function for every item that intersects the given area
+	 */
+	template<class FUNC>
+	void visit(const AABB<TYPE>& area, FUNC&& func) const {
+		core_trace_scoped(LooseOctreeVisitAABB);
+		StackEntry stack[StackSize];
+		int n = 0;
+		stack[n++] = StackEntry{0, false};
+		while (n > 0) {
+			const StackEntry current = stack[--n];
+			const Node& node = _nodes[current.node];
+			for (int32_t e = node.entries; e != -1; e = _entries[e].next) {
+				const Entry& entry = _entries[e];
+				if (current.inside || intersects(area, entry.aabb)) {
+					func(entry.item);
+				}
+			}
+			if (node.children == -1) {
+				continue;
+			}
+			for (int i = 0; i < 8; ++i) {
+				const int32_t childIndex = node.children + i;
+				const Node& child = _nodes[childIndex];
+				if (child.count == 0) {
+					continue;
+				}
+				if (current.inside || area.containsAABB(child.loose)) {
+					stack[n++] = StackEntry{childIndex, true};
+				} else if (intersects(area, child.loose)) {
+					stack[n++] = StackEntry{childIndex, false};
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Calls the given function for every item that is visible in the given frustum
+	 * @sa PackedFrustum
+	 */
+	template<class FUNC>
+	void visit(const Frustum& frustum, FUNC&& func) const {
+		core_trace_scoped(LooseOctreeVisitFrustum);
+		const PackedFrustum packed(frustum);
+		StackEntry stack[StackSize];
+		int n = 0;
+		stack[n++] = StackEntry{0, false};
+		while (n > 0) {
+			const StackEntry current = stack[--n];
+			const Node& node = _nodes[current.node];
+			for (int32_t e = node.entries; e != -1; e = _entries[e].next) {
+				const Entry& entry = _entries[e];
+				if (current.inside || packed.isVisible(glm::vec3(entry.aabb.mins()), glm::vec3(entry.aabb.maxs()))) {
+					func(entry.item);
+				}
+			}
+			if (node.children == -1) {
+				continue;
+			}
+			for (int i = 0; i < 8; ++i) {
+				const int32_t childIndex = node.children + i;
+				const Node& child = _nodes[childIndex];
+				if (child.count == 0) {
+					continue;
+				}
+				if (current.inside) {
+					stack[n++] = StackEntry{childIndex, true};
+					continue;
+				}
+				const FrustumResult result = packed.test(glm::vec3(child.loose.mins()), glm::vec3(child.loose.maxs()));
+				if (result != FrustumResult::Outside) {
+					stack[n++] = StackEntry{childIndex, result == FrustumResult::Inside};
+				}
+			}
+		}
+	}
+
+	/**
+	 * @param[out] results Cleared and filled with the items that intersect the given area. Reuse the
+	 * instance to avoid memory allocations.
+	 */
+	inline void query(const AABB<TYPE>& area, Results& results) const {
+		results.clear();
+		visit(area, [&results] (const NODE& item) {
+			results.push_back(item);
+		});
+	}
+
+	/**
+	 * @param[out] results Cleared and filled with the items that are visible in the given frustum. Reuse
+	 * the instance to avoid memory allocations.
+	 */
+	inline void query(const Frustum& frustum, Results& results) const {
+		results.clear();
+		visit(frustum, [&results] (const NODE& item) {
+			results.push_back(item);
+		});
+	}
+
+	inline void getContents(Results& results) const {
+		results.clear();
+		for (const Node& node : _nodes) {
+			for (int32_t e = node.entries; e != -1; e = _entries[e].next) {
+				results.push_back(_entries[e].item);
+			}
+		}
+	}
+
+	/**
+	 * @brief Removes all items - the memory of the pools is kept
+	 */
+	void clear() {
+		reset();
+		_dirty = true;
+	}
+
+	inline void markAsClean() {
+		_dirty = false;
+	}
+
+	inline bool isDirty() const {
+		return _dirty;
+	}
+};
+
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ */
+
+#include <benchmark/benchmark.h>
+#include "math/Octree.h"
+#include "math/LooseOctree.h"
+#include "math/Frustum.h"
+#include "math/Random.h"
+#include <vector>
+
+namespace {
+
+const int WorldSize = 4096;
+const int MaxItemSize = 64;
+
+struct Item {
+	math::AABB<int> bounds;
+	int id;
+
+	const math::AABB<int>& aabb() const {
+		return bounds;
+	}
+
+	bool operator==(const Item& rhs) const {
+		return id == rhs.id;
+	}
+};
+
+math::AABB<int> randomAABB(math::Random& random) {
+	const glm::ivec3 mins(random.random(0, WorldSize - MaxItemSize), random.random(0, WorldSize - MaxItemSize), random.random(0, WorldSize - MaxItemSize));
+	const glm::ivec3 size(random.random(1, MaxItemSize), random.random(1, MaxItemSize), random.random(1, MaxItemSize));
+	return math::AABB<int>(mins, mins + size);
+}
+
+std::vector<Item> createItems(int amount) {
+	math::Random random(1);
+	std::vector<Item> items(amount);
+	for (int i = 0; i < amount; ++i) {
+		items[i].bounds = randomAABB(random);
+		items[i].id = i;
+	}
+	return items;
+}
+
+const math::AABB<int> WorldAABB(0, 0, 0, WorldSize, WorldSize, WorldSize);
+const math::AABB<int> QueryAABB(1024, 1024, 1024, 2048, 2048, 2048);
+
+/**
+ * @brief Moves every 16th item to a new random position and runs one query per iteration
+ */
+template<class TREE, class QUERY>
+void churn(benchmark::State& state, TREE& tree, QUERY&& query) {
+	std::vector<Item> items = createItems((int)state.range(0));
+	for (const Item& item : items) {
+		tree.insert(item);
+	}
+	math::Random random(2);
+	size_t found = 0u;
+	for (auto _ : state) {
+		for (size_t i = random.random(0, 15); i < items.size(); i += 16) {
+			tree.remove(items[i]);
+			items[i].bounds = randomAABB(random);
+			tree.insert(items[i]);
+		}
+		found += query(tree);
+	}
+	benchmark::DoNotOptimize(found);
+	state.SetItemsProcessed(state.iterations() * (int64_t)items.size());
+}
+
+}
+
+static void BM_OctreeChurnAABB(benchmark::State& state) {
+	math::Octree<Item> tree(WorldAABB, 10);
+	math::Octree<Item>::Contents contents;
+	churn(state, tree, [&] (const math::Octree<Item>& t) {
+		contents.clear();
+		t.query(QueryAABB, contents);
+		return contents.size();
+	});
+}
+
+static void BM_LooseOctreeChurnAABB(benchmark::State& state) {
+	math::LooseOctree<Item> tree(WorldAABB, 10);
+	math::LooseOctree<Item>::Results results;
+	churn(state, tree, [&] (const math::LooseOctree<Item>& t) {
+		t.query(QueryAABB, results);
+		return results.size();
+	});
+}
+
+static void BM_OctreeChurnFrustum(benchmark::State& state) {
+	math::Octree<Item> tree(WorldAABB, 10);
+	math::Octree<Item>::Contents contents;
+	const math::Frustum frustum(glm::vec3(QueryAABB.mins()), glm::vec3(QueryAABB.maxs()));
+	churn(state, tree, [&] (const math::Octree<Item>& t) {
+		contents.clear();
+		t.query(frustum, contents);
+		return contents.size();
+	});
+}
+
+static void BM_LooseOctreeChurnFrustum(benchmark::State& state) {
+	math::LooseOctree<Item> tree(WorldAABB, 10);
+	math::LooseOctree<Item>::Results results;
+	const math::Frustum frustum(glm::vec3(QueryAABB.mins()), glm::vec3(QueryAABB.maxs()));
+	churn(state, tree, [&] (const math::LooseOctree<Item>& t) {
+		t.query(frustum, results);
+		return results.size();
+	});
+}
+
+static void BM_FrustumTest(benchmark::State& state) {
+	const math::Frustum frustum(glm::vec3(QueryAABB.mins()), glm::vec3(QueryAABB.maxs()));
+	const std::vector<Item>& items = createItems(1024);
+	int visible = 0;
+	for (auto _ : state) {
+		for (const Item& item : items) {
+			visible += frustum.test(glm::vec3(item.bounds.mins()), glm::vec3(item.bounds.maxs())) != math::FrustumResult::Outside;
+		}
+	}
+	benchmark::DoNotOptimize(visible);
+	state.SetItemsProcessed(state.iterations() * (int64_t)items.size());
+}
+
+static void BM_PackedFrustumTest(benchmark::State& state) {
+	const math::Frustum frustum(glm::vec3(QueryAABB.mins()), glm::vec3(QueryAABB.maxs()));
+	const math::PackedFrustum packed(frustum);
+	const std::vector<Item>& items = createItems(1024);
+	int visible = 0;
+	for (auto _ : state) {
+		for (const Item& item : items) {
+			visible += packed.test(glm::vec3(item.bounds.mins()), glm::vec3(item.bounds.maxs())) != math::FrustumResult::Outside;
+		}
+	}
+	benchmark::DoNotOptimize(visible);
+	state.SetItemsProcessed(state.iterations() * (int64_t)items.size());
+}
+
+BENCHMARK(BM_OctreeChurnAABB)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_LooseOctreeChurnAABB)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_OctreeChurnFrustum)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_LooseOctreeChurnFrustum)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_FrustumTest);
+BENCHMARK(BM_PackedFrustumTest);
+
+BENCHMARK_MAIN();
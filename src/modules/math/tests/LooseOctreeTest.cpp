@@ -0,0 +1,155 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "math/LooseOctree.h"
+#include "math/AABB.h"
+#include "math/Frustum.h"
+#include "math/Random.h"
+
+namespace math {
+
+namespace loc {
+class Item {
+private:
+	AABB<int> _bounds;
+	int _id;
+public:
+	Item(const AABB<int>& bounds, int id) :
+			_bounds(bounds), _id(id) {
+	}
+
+	const AABB<int>& aabb() const {
+		return _bounds;
+	}
+
+	int id() const {
+		return _id;
+	}
+
+	bool operator==(const Item& rhs) const {
+		return rhs._id == _id;
+	}
+};
+}
+
+class LooseOctreeTest : public app::AbstractTest {
+protected:
+	std::vector<loc::Item> randomItems(int amount, int worldSize, int maxItemSize) const {
+		math::Random random(1);
+		std::vector<loc::Item> items;
+		items.reserve(amount);
+		for (int i = 0; i < amount; ++i) {
+			const glm::ivec3 mins(random.random(0, worldSize), random.random(0, worldSize), random.random(0, worldSize));
+			const glm::ivec3 size(random.random(1, maxItemSize), random.random(1, maxItemSize), random.random(1, maxItemSize));
+			items.emplace_back(AABB<int>(mins, mins + size), i);
+		}
+		return items;
+	}
+};
+
+TEST_F(LooseOctreeTest, testInsertRemove) {
+	LooseOctree<loc::Item> octree({0, 0, 0, 100, 100, 100});
+	EXPECT_EQ(0, octree.count());
+	const loc::Item item({51, 51, 51, 53, 53, 53}, 1);
+	EXPECT_TRUE(octree.insert(item));
+	const loc::Item item2({52, 52, 52, 54, 55, 55}, 2);
+	EXPECT_TRUE(octree.insert(item2));
+	EXPECT_EQ(2, octree.count());
+	EXPECT_TRUE(octree.remove(item));
+	EXPECT_FALSE(octree.remove(item));
+	EXPECT_EQ(1, octree.count());
+	EXPECT_TRUE(octree.remove(item2));
+	EXPECT_EQ(0, octree.count());
+}
+
+TEST_F(LooseOctreeTest, testOutsideBounds) {
+	LooseOctree<loc::Item> octree({0, 0, 0, 100, 100, 100});
+	const loc::Item item({200, 200, 200, 210, 210, 210}, 1);
+	EXPECT_TRUE(octree.insert(item));
+	LooseOctree<loc::Item>::Results results;
+	octree.query(AABB<int>(195, 195, 195, 205, 205, 205), results);
+	ASSERT_EQ(1u, results.size());
+	EXPECT_EQ(1, results[0].id());
+	EXPECT_TRUE(octree.remove(item));
+	EXPECT_EQ(0, octree.count());
+}
+
+TEST_F(LooseOctreeTest, testQueryMatchesBruteForce) {
+	const int worldSize = 1000;
+	LooseOctree<loc::Item> octree({0, 0, 0, worldSize, worldSize, worldSize});
+	const std::vector<loc::Item>& items = randomItems(2000, worldSize, 40);
+	for (const loc::Item& item : items) {
+		ASSERT_TRUE(octree.insert(item));
+	}
+	// remove every third item to have free entries in the pool
+	for (size_t i = 0; i < items.size(); i += 3) {
+		ASSERT_TRUE(octree.remove(items[i]));
+	}
+	const AABB<int> queries[] = {
+		{0, 0, 0, 100, 100, 100},
+		{450, 450, 450, 550, 550, 550},
+		{-100, -100, -100, 2000, 2000, 2000},
+		{500, 0, 0, 501, worldSize, worldSize}
+	};
+	LooseOctree<loc::Item>::Results results;
+	for (const AABB<int>& query : queries) {
+		octree.query(query, results);
+		size_t expected = 0u;
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (i % 3 != 0 && intersects(query, items[i].aabb())) {
+				++expected;
+			}
+		}
+		EXPECT_EQ(expected, results.size());
+	}
+}
+
+TEST_F(LooseOctreeTest, testFrustumMatchesBruteForce) {
+	const int worldSize = 1000;
+	LooseOctree<loc::Item> octree({0, 0, 0, worldSize, worldSize, worldSize});
+	const std::vector<loc::Item>& items = randomItems(2000, worldSize, 40);
+	for (const loc::Item& item : items) {
+		ASSERT_TRUE(octree.insert(item));
+	}
+	const Frustum frustum(glm::vec3(100.0f), glm::vec3(600.0f, 700.0f, 400.0f));
+	LooseOctree<loc::Item>::Results results;
+	octree.query(frustum, results);
+	size_t expected = 0u;
+	for (const loc::Item& item : items) {
+		if (frustum.isVisible(glm::vec3(item.aabb().mins()), glm::vec3(item.aabb().maxs()))) {
+			++expected;
+		}
+	}
+	EXPECT_GT(expected, 0u);
+	EXPECT_EQ(expected, results.size());
+}
+
+TEST_F(LooseOctreeTest, testPackedFrustum) {
+	const Frustum frustum(glm::vec3(0.0f), glm::vec3(100.0f));
+	const PackedFrustum packed(frustum);
+	const glm::vec3 boxes[][2] = {
+		{glm::vec3(10.0f), glm::vec3(20.0f)},
+		{glm::vec3(-10.0f), glm::vec3(20.0f)},
+		{glm::vec3(-20.0f), glm::vec3(-10.0f)},
+		{glm::vec3(90.0f), glm::vec3(120.0f)}
+	};
+	for (const auto& box : boxes) {
+		EXPECT_EQ(frustum.test(box[0], box[1]), packed.test(box[0], box[1]));
+		EXPECT_EQ(frustum.isVisible(box[0], box[1]), packed.isVisible(box[0], box[1]));
+	}
+}
+
+TEST_F(LooseOctreeTest, testClearKeepsWorking) {
+	LooseOctree<loc::Item> octree({0, 0, 0, 100, 100, 100});
+	const loc::Item item({51, 51, 51, 53, 53, 53}, 1);
+	EXPECT_TRUE(octree.insert(item));
+	octree.clear();
+	EXPECT_EQ(0, octree.count());
+	EXPECT_EQ(1u, octree.nodes());
+	EXPECT_TRUE(octree.insert(item));
+	EXPECT_EQ(1, octree.count());
+}
+
+}
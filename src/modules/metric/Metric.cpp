@@ -6,12 +6,25 @@
 #include "core/Log.h"
 #include "core/Var.h"
 #include "core/Assert.h"
+#include "core/Common.h"
+#include "core/GameConfig.h"
+#include "core/TimeProvider.h"
+#include "core/concurrent/Atomic.h"
 #include <stdio.h>
 #include <string.h>
 #include <SDL_stdinc.h>
 
 namespace metric {
 
+static core::AtomicInt metricIds { 1 };
+static core::AtomicInt handleIds { 0 };
+
+thread_local Metric::ThreadShard Metric::_threadShard;
+
+Metric::Metric() :
+		_id(metricIds.increment(1)) {
+}
+
 Metric::~Metric() {
 	shutdown();
 }
@@ -34,14 +47,213 @@ bool Metric::init(const char *prefix, const IMetricSenderPtr& messageSender) {
 	} else {
 		Log::warn("Invalid %s given - using telegraf", cfg::MetricFlavor);
 	}
+	_flushMillis = core::Var::get(cfg::MetricFlushMillis, "0")->intVal();
+	if (_flushMillis > 0) {
+		Log::debug("Aggregate metrics for %i millis", _flushMillis);
+	}
 	_messageSender = messageSender;
 	return true;
 }
 
 void Metric::shutdown() {
+	if (_messageSender) {
+		flush();
+	}
 	_messageSender = IMetricSenderPtr();
 }
 
+Metric::Shard* Metric::threadShard() const {
+	if (_threadShard.metric == _id) {
+		return _threadShard.shard;
+	}
+	const std::thread::id threadId = std::this_thread::get_id();
+	core::ScopedLock lock(_shardLock);
+	auto i = _shards.find(threadId);
+	if (i == _shards.end()) {
+		i = _shards.emplace(threadId, std::make_shared<Shard>()).first;
+	}
+	_threadShard.metric = _id;
+	_threadShard.shard = i->second.get();
+	return _threadShard.shard;
+}
+
+int Metric::entry(Shard* shard, const char* key, const char* type, const TagMap& tags) const {
+	core::String& id = shard->id;
+	id = key;
+	id += '|';
+	id += type;
+	for (const auto& e : tags) {
+		id += '|';
+		id += e->key;
+		id += '=';
+		id += e->value;
+	}
+	int idx;
+	if (!shard->index.get(id, idx)) {
+		idx = (int)shard->entries.size();
+		shard->entries.emplace_back();
+		Entry& entry = shard->entries.back();
+		entry.key = key;
+		entry.tags = tags;
+		entry.type = type;
+		shard->index.put(id, idx);
+	}
+	return idx;
+}
+
+void Metric::aggregate(Shard* shard, int idx, int value) const {
+	Entry& entry = shard->entries[idx];
+	const char* type = entry.type;
+	if (!SDL_strcmp(type, "c") || !SDL_strcmp(type, "m")) {
+		// counters and meters
+		entry.value += value;
+	} else if (!SDL_strcmp(type, "g")) {
+		entry.value = value;
+	} else {
+		// timings and histograms - every value ends up in the sample with the same probability
+		const int n = entry.count++;
+		if (n < MaxSamples) {
+			entry.samples[n] = value;
+		} else {
+			uint32_t& seed = shard->seed;
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			const uint32_t slot = seed % (uint32_t)entry.count;
+			if (slot < (uint32_t)MaxSamples) {
+				entry.samples[slot] = value;
+			}
+		}
+	}
+}
+
+bool Metric::aggregate(const char* key, int value, const char* type, const TagMap& tags) const {
+	Shard* shard = threadShard();
+	core::ScopedLock lock(shard->lock);
+	aggregate(shard, entry(shard, key, type, tags), value);
+	return true;
+}
+
+Metric::Handle Metric::handle(const char* key, const char* type, const TagMap& tags) {
+	Handle handle;
+	handle.key = key;
+	handle.type = type;
+	handle.tags = tags;
+	handle.index = handleIds.increment(1);
+	return handle;
+}
+
+bool Metric::record(const Handle& handle, int value) const {
+	if (!_messageSender) {
+		return false;
+	}
+	if (_flushMillis <= 0 || handle.index < 0) {
+		return assemble(handle.key.c_str(), value, handle.type, handle.tags);
+	}
+	Shard* shard = threadShard();
+	core::ScopedLock lock(shard->lock);
+	if ((int)shard->handles.size() <= handle.index) {
+		shard->handles.resize(handle.index + 1, -1);
+	}
+	int& idx = shard->handles[handle.index];
+	if (idx < 0) {
+		idx = entry(shard, handle.key.c_str(), handle.type, handle.tags);
+	}
+	aggregate(shard, idx, value);
+	return true;
+}
+
+bool Metric::sendDatagram() {
+	if (_datagramSize == 0) {
+		return true;
+	}
+	_datagram[_datagramSize] = '\0';
+	_datagramSize = 0;
+	return _messageSender->send(_datagram);
+}
+
+bool Metric::append(const char* line, int len) {
+	bool state = true;
+	if (_datagramSize > 0 && _datagramSize + 1 + len > MaxDatagramSize) {
+		state = sendDatagram();
+	}
+	if (_datagramSize > 0) {
+		_datagram[_datagramSize++] = '\n';
+	}
+	SDL_memcpy(&_datagram[_datagramSize], line, len);
+	_datagramSize += len;
+	return state;
+}
+
+bool Metric::send(const Entry& entry) {
+	char line[MaxDatagramSize];
+	if (entry.count == 0) {
+		const int len = createLine(line, sizeof(line), entry.key.c_str(), entry.value, entry.type, entry.tags);
+		if (len <= 0) {
+			return true;
+		}
+		return append(line, len);
+	}
+	bool state = true;
+	const int samples = core_min(entry.count, MaxSamples);
+	const float sampleRate = (float)samples / (float)entry.count;
+	for (int i = 0; i < samples; ++i) {
+		const int len = createLine(line, sizeof(line), entry.key.c_str(), entry.samples[i], entry.type, entry.tags, sampleRate);
+		if (len > 0) {
+			state &= append(line, len);
+		}
+	}
+	return state;
+}
+
+void Metric::update() {
+	if (_flushMillis <= 0) {
+		return;
+	}
+	const uint64_t now = core::TimeProvider::systemMillis();
+	{
+		core::ScopedLock lock(_flushLock);
+		if (now - _lastFlush < (uint64_t)_flushMillis) {
+			return;
+		}
+	}
+	flush();
+}
+
+bool Metric::flush() {
+	core_trace_scoped(MetricFlush);
+	std::vector<Shard*> shards;
+	{
+		core::ScopedLock lock(_shardLock);
+		shards.reserve(_shards.size());
+		for (const auto& e : _shards) {
+			shards.push_back(e.second.get());
+		}
+	}
+	core::ScopedLock lock(_flushLock);
+	_lastFlush = core::TimeProvider::systemMillis();
+	if (!_messageSender) {
+		return false;
+	}
+	bool state = true;
+	std::vector<Entry> entries;
+	for (Shard* shard : shards) {
+		{
+			// swap the entries out to not block the thread of this shard while the datagrams are sent
+			core::ScopedLock shardLock(shard->lock);
+			entries.swap(shard->entries);
+			shard->index.clear();
+			shard->handles.clear();
+		}
+		for (const Entry& entry : entries) {
+			state &= send(entry);
+		}
+		entries.clear();
+	}
+	state &= sendDatagram();
+	return state;
+}
+
 bool Metric::createTags(char* buffer, size_t len, const TagMap& tags, const char* sep, const char* preamble, const char *split) {
 	if (tags.empty()) {
 		return true;
@@ -84,39 +296,54 @@ bool Metric::assemble(const char* key, int value, const char* type, const TagMap
 	if (!_messageSender) {
 		return false;
 	}
+	if (_flushMillis > 0) {
+		return aggregate(key, value, type, tags);
+	}
 	constexpr int metricSize = 256;
 	char buffer[metricSize];
+	if (createLine(buffer, sizeof(buffer), key, value, type, tags) < 0) {
+		return false;
+	}
+	return _messageSender->send(buffer);
+}
+
+int Metric::createLine(char *buffer, size_t len, const char* key, int value, const char* type, const TagMap& tags, float sampleRate) const {
 	constexpr int tagsSize = 256;
 	char tagsBuffer[tagsSize] = "";
+	// the influx line protocol doesn't know about sample rates
+	char sampleRateBuffer[32] = "";
+	if (sampleRate < 1.0f) {
+		SDL_snprintf(sampleRateBuffer, sizeof(sampleRateBuffer), "|@%f", sampleRate);
+	}
 	int written;
 	switch (_flavor) {
 	case Flavor::Etsy:
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s", _prefix.c_str(), key, value, type);
+		written = SDL_snprintf(buffer, len, "%s.%s:%i|%s%s", _prefix.c_str(), key, value, type, sampleRateBuffer);
 		break;
 	case Flavor::Datadog:
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, ":", "|#", ",")) {
-			return false;
+			return -1;
 		}
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s:%i|%s%s", _prefix.c_str(), key, value, type, tagsBuffer);
+		written = SDL_snprintf(buffer, len, "%s.%s:%i|%s%s%s", _prefix.c_str(), key, value, type, sampleRateBuffer, tagsBuffer);
 		break;
 	case Flavor::Influx:
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, "=", ",", ",")) {
-			return false;
+			return -1;
 		}
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s_%s,type=%s%s value=%i", _prefix.c_str(), key, type, tagsBuffer, value);
+		written = SDL_snprintf(buffer, len, "%s_%s,type=%s%s value=%i", _prefix.c_str(), key, type, tagsBuffer, value);
 		break;
 	case Flavor::Telegraf:
 	default:
 		if (!createTags(tagsBuffer, sizeof(tagsBuffer), tags, "=", ",", ",")) {
-			return false;
+			return -1;
 		}
-		written = SDL_snprintf(buffer, sizeof(buffer), "%s.%s%s:%i|%s", _prefix.c_str(), key, tagsBuffer, value, type);
+		written = SDL_snprintf(buffer, len, "%s.%s%s:%i|%s%s", _prefix.c_str(), key, tagsBuffer, value, type, sampleRateBuffer);
 		break;
 	}
-	if (written >= metricSize) {
-		return false;
+	if (written < 0 || written >= (int)len) {
+		return -1;
 	}
-	return _messageSender->send(buffer);
+	return written;
 }
 
 }
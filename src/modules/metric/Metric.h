@@ -12,8 +12,13 @@
 
 #include "IMetricSender.h"
 #include "core/NonCopyable.h"
+#include "core/Trace.h"
 #include "core/collection/StringMap.h"
+#include "core/concurrent/Lock.h"
+#include <map>
 #include <memory>
+#include <thread>
+#include <vector>
 #include <stdint.h>
 
 namespace metric {
@@ -35,13 +40,90 @@ using TagMap = core::StringMap<core::String, 4>;
 
 /**
  * @brief The Metric class generates and publishes metrics
+ *
+ * If the @c metric_flushmillis cvar is greater than @c 0, the metrics are not sent immediately. They are aggregated
+ * per thread and key (including the tags) instead: counters and meters are summed up, gauges keep the last value and
+ * timings and histograms keep a uniform sample of at most @c MaxSamples values that is sent with the sample rate.
+ * @c update() sends the aggregated metrics every @c metric_flushmillis milliseconds with as many lines per datagram
+ * as fit into @c MaxDatagramSize bytes.
  */
 class Metric : public core::NonCopyable {
+public:
+	/**
+	 * @brief The max size of a datagram with several metric lines - this is what statsd recommends for the internet
+	 */
+	static constexpr int MaxDatagramSize = 1432;
+	/**
+	 * @brief The max amount of values of a timing or histogram that are kept between two flushes
+	 */
+	static constexpr int MaxSamples = 64;
 private:
 	core::String _prefix;
 	Flavor _flavor = Flavor::Telegraf;
 	IMetricSenderPtr _messageSender;
 
+	/**
+	 * @brief An aggregated metric
+	 */
+	struct Entry {
+		core::String key;
+		TagMap tags;
+		/** the statsd type - this is a string literal */
+		const char *type;
+		/** the sum for counters and meters, the last value for gauges */
+		int value = 0;
+		/** the amount of recorded values for timings and histograms */
+		int count = 0;
+		/** reservoir sample of the values for timings and histograms - the first @c min(count, MaxSamples) are used */
+		int samples[MaxSamples];
+	};
+
+	/**
+	 * @brief The metrics of one thread - the lock is only shared with @c flush()
+	 */
+	struct Shard {
+		core_trace_mutex(core::Lock, lock, "MetricShard");
+		/** index into @c entries for the interned key, type and tags */
+		core::StringMap<int, 64> index;
+		/** index into @c entries for the @c Handle::index or @c -1 if it's not yet resolved for this thread */
+		std::vector<int> handles;
+		std::vector<Entry> entries;
+		/** reused to build the lookup key */
+		core::String id;
+		/** random state to pick the reservoir samples */
+		uint32_t seed = 0x9E3779B9u;
+	};
+	typedef std::shared_ptr<Shard> ShardPtr;
+
+	struct ThreadShard {
+		int metric = 0;
+		Shard* shard = nullptr;
+	};
+	/**
+	 * @brief Avoids the lookup in @c _shards for the metric instance that was used last by this thread
+	 */
+	static thread_local ThreadShard _threadShard;
+
+	int _flushMillis = 0;
+	/**
+	 * @brief Unique id of this instance to validate the @c _threadShard cache
+	 */
+	const int _id;
+	mutable core_trace_mutex(core::Lock, _shardLock, "MetricShards");
+	mutable std::map<std::thread::id, ShardPtr> _shards core_thread_guarded_by(_shardLock);
+	core_trace_mutex(core::Lock, _flushLock, "MetricFlush");
+	uint64_t _lastFlush core_thread_guarded_by(_flushLock) = 0u;
+	char _datagram[MaxDatagramSize + 1] core_thread_guarded_by(_flushLock);
+	int _datagramSize core_thread_guarded_by(_flushLock) = 0;
+
+	Shard* threadShard() const;
+	int entry(Shard* shard, const char* key, const char* type, const TagMap& tags) const;
+	void aggregate(Shard* shard, int idx, int value) const;
+	bool aggregate(const char* key, int value, const char* type, const TagMap& tags) const;
+	bool append(const char* line, int len) core_thread_requires(_flushLock);
+	bool send(const Entry& entry) core_thread_requires(_flushLock);
+	bool sendDatagram() core_thread_requires(_flushLock);
+
 	/**
 	 * @brief Create the needed tag list if it is supported by the specified flavor
 	 * @param[out] buffer The buffer to write the tag list into
@@ -52,17 +134,51 @@ private:
 	 * @return @c false if not all tags could get written into the specified target buffer, @c true otherwise
 	 */
 	static bool createTags(char *buffer, size_t len, const TagMap& tags, const char* sep, const char* preamble, const char *split = ",");
+	/**
+	 * @return The length of the metric line or @c -1 if it doesn't fit into the given buffer
+	 */
+	int createLine(char *buffer, size_t len, const char* key, int value, const char* type, const TagMap& tags, float sampleRate = 1.0f) const;
 	bool assemble(const char* key, int value, const char* type, const TagMap& tags = {}) const;
 public:
+	/**
+	 * @brief A metric with a fixed key, type and tags
+	 *
+	 * The tags are only interned once per thread and flush interval - use this for metrics that are recorded
+	 * very often with the same tags.
+	 * @see handle()
+	 */
+	struct Handle {
+		core::String key;
+		/** the statsd type - this is a string literal */
+		const char *type = "";
+		TagMap tags;
+		/** unique id to look up the aggregated entry in the thread shards */
+		int index = -1;
+	};
+
+	Metric();
 	~Metric();
 
 	/**
 	 * @param[in] messageSender @c IMessageSender - must already be initialized
-	 * @note Reads the @c metric_flavor cvar to configure the flavor.
+	 * @note Reads the @c metric_flavor cvar to configure the flavor and @c metric_flushmillis to configure the aggregation.
 	 */
 	bool init(const char *prefix, const IMetricSenderPtr& messageSender);
+	/**
+	 * @note Sends the aggregated metrics before the message sender is released
+	 */
 	void shutdown();
 
+	/**
+	 * @brief Sends the aggregated metrics if @c metric_flushmillis have passed since the last flush
+	 */
+	void update();
+	/**
+	 * @brief Sends the aggregated metrics of all threads
+	 * @return @c false if one of the datagrams could not get sent
+	 */
+	bool flush();
+
 	/**
 	 * @brief Increments the key
 	 */
@@ -131,6 +247,16 @@ public:
 	 * @note Record execution rates
 	 */
 	bool meter(const char* key, int value, const TagMap& tags = {}) const;
+
+	/**
+	 * @param[in] type The statsd type - one of @c "c", @c "g", @c "ms", @c "h" or @c "m"
+	 */
+	static Handle handle(const char* key, const char* type, const TagMap& tags = {});
+	/**
+	 * @brief Records the value for the key, type and tags of the handle
+	 * @see count(), gauge(), timing(), histogram(), meter()
+	 */
+	bool record(const Handle& handle, int value) const;
 };
 
 inline bool Metric::increment(const char* key, const TagMap& tags) const {
@@ -5,20 +5,41 @@
 #include <gtest/gtest.h>
 #include "metric/Metric.h"
 #include "metric/IMetricSender.h"
+#include "metric/UDPMetricSender.h"
 #include "core/Var.h"
+#include "core/StringUtil.h"
+#ifndef __WINDOWS__
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
 
 namespace metric {
 
 class BufferSender : public IMetricSender {
 private:
 	mutable core::String _lastBuffer;
+	mutable int _sent = 0;
+	mutable int _lines = 0;
 public:
 
 	bool send(const char* buffer) const override {
 		_lastBuffer = buffer;
+		++_sent;
+		_lines += core::string::count(buffer, '\n') + 1;
 		return true;
 	}
 
+	inline int sent() const {
+		return _sent;
+	}
+
+	inline int lines() const {
+		return _lines;
+	}
+
 	inline const core::String& metricLine() const {
 		return _lastBuffer;
 	}
@@ -36,6 +57,7 @@ protected:
 
 	void TearDown() override {
 		sender->shutdown();
+		core::Var::get("metric_flushmillis", "")->setVal("0");
 	}
 
 	inline core::String count(const char *id, int value, Flavor flavor, const TagMap& tags = {}) const {
@@ -122,4 +144,120 @@ TEST_F(MetricTest, DISABLED_testTimingMultipleTags) {
 		<< "Expected to get tags after type in datadog flavor";
 }
 
+TEST_F(MetricTest, testAggregation) {
+	setFlavor(Flavor::Etsy);
+	core::Var::get("metric_flushmillis", "")->setVal("1000");
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, sender));
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_TRUE(m.count("count", 2));
+		EXPECT_TRUE(m.gauge("gauge", i));
+	}
+	EXPECT_TRUE(m.timing("timing", 1));
+	EXPECT_TRUE(m.timing("timing", 2));
+	EXPECT_EQ(0, sender->sent()) << "Metrics should be aggregated until the next flush";
+	EXPECT_TRUE(m.flush());
+	EXPECT_EQ(1, sender->sent()) << "All metrics should fit into one datagram";
+	EXPECT_EQ(sender->metricLine(), PREFIX ".count:20|c\n" PREFIX ".gauge:9|g\n" PREFIX ".timing:1|ms\n" PREFIX ".timing:2|ms");
+	EXPECT_TRUE(m.flush());
+	EXPECT_EQ(1, sender->sent()) << "Nothing should be sent without new metrics";
+}
+
+TEST_F(MetricTest, testAggregationHandle) {
+	setFlavor(Flavor::Etsy);
+	core::Var::get("metric_flushmillis", "")->setVal("1000");
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, sender));
+	const Metric::Handle& handle = Metric::handle("count", "c");
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_TRUE(m.record(handle, 2));
+	}
+	EXPECT_TRUE(m.count("count", 1)) << "The handle and the key should share the aggregated entry";
+	EXPECT_TRUE(m.flush());
+	EXPECT_EQ(sender->metricLine(), PREFIX ".count:21|c");
+	EXPECT_TRUE(m.record(handle, 3)) << "The handle must be resolved again after a flush";
+	EXPECT_TRUE(m.flush());
+	EXPECT_EQ(2, sender->sent());
+	EXPECT_EQ(sender->metricLine(), PREFIX ".count:3|c");
+}
+
+TEST_F(MetricTest, testHandle) {
+	const Metric::Handle& handle = Metric::handle("count", "c", {{"tag", "value"}});
+	setFlavor(Flavor::Telegraf);
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, sender));
+	EXPECT_TRUE(m.record(handle, 1));
+	EXPECT_EQ(sender->metricLine(), PREFIX ".count,tag=value:1|c");
+}
+
+TEST_F(MetricTest, testAggregationDatagramSize) {
+	setFlavor(Flavor::Etsy);
+	core::Var::get("metric_flushmillis", "")->setVal("1000");
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, sender));
+	for (int i = 0; i < 1000; ++i) {
+		const core::String& key = core::string::format("histogram%i", i);
+		EXPECT_TRUE(m.histogram(key.c_str(), i));
+	}
+	EXPECT_TRUE(m.flush());
+	EXPECT_GT(sender->sent(), 1);
+	EXPECT_LT(sender->sent(), 100) << "Expected to get several lines per datagram";
+	EXPECT_LE((int)sender->metricLine().size(), Metric::MaxDatagramSize);
+	EXPECT_TRUE(core::string::endsWith(sender->metricLine(), PREFIX ".histogram999:999|h"));
+}
+
+TEST_F(MetricTest, testAggregationSampleRate) {
+	setFlavor(Flavor::Etsy);
+	core::Var::get("metric_flushmillis", "")->setVal("1000");
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, sender));
+	for (int i = 0; i < Metric::MaxSamples * 4; ++i) {
+		EXPECT_TRUE(m.timing("timing", 1));
+	}
+	EXPECT_TRUE(m.flush());
+	EXPECT_TRUE(core::string::endsWith(sender->metricLine(), PREFIX ".timing:1|ms|@0.250000"));
+	EXPECT_EQ(Metric::MaxSamples, sender->lines()) << "Only the sampled values should be sent";
+}
+
+#ifndef __WINDOWS__
+TEST_F(MetricTest, testAggregationUDP) {
+	const int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	ASSERT_GE(fd, 0);
+	struct sockaddr_in addr;
+	SDL_zero(addr);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+	addr.sin_port = 0;
+	ASSERT_EQ(0, bind(fd, (struct sockaddr*)&addr, sizeof(addr)));
+	socklen_t addrLen = sizeof(addr);
+	ASSERT_EQ(0, getsockname(fd, (struct sockaddr*)&addr, &addrLen));
+	struct timeval timeout;
+	timeout.tv_sec = 1;
+	timeout.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	setFlavor(Flavor::Telegraf);
+	core::Var::get("metric_flushmillis", "")->setVal("1000");
+	const std::shared_ptr<UDPMetricSender>& udpSender = std::make_shared<UDPMetricSender>("127.0.0.1", ntohs(addr.sin_port));
+	ASSERT_TRUE(udpSender->init());
+	Metric m;
+	ASSERT_TRUE(m.init(PREFIX, udpSender));
+	const TagMap tags {{"direction", "in"}};
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_TRUE(m.count("network_packet_count", 1, tags));
+		EXPECT_TRUE(m.count("network_packet_size", 10, tags));
+	}
+	EXPECT_TRUE(m.flush());
+
+	char buf[Metric::MaxDatagramSize + 1];
+	const ssize_t received = recv(fd, buf, sizeof(buf) - 1, 0);
+	close(fd);
+	m.shutdown();
+	udpSender->shutdown();
+	ASSERT_GT(received, 0);
+	buf[received] = '\0';
+	EXPECT_STREQ(PREFIX ".network_packet_count,direction=in:100|c\n" PREFIX ".network_packet_size,direction=in:1000|c", buf);
+}
+#endif
+
 }
@@ -5,6 +5,9 @@
 #include "AbstractServerNetwork.h"
 #include "core/Trace.h"
 #include "core/Log.h"
+#include "core/Assert.h"
+#include "core/TimeProvider.h"
+#include "core/concurrent/ThreadPool.h"
 
 namespace network {
 
@@ -62,7 +65,232 @@ bool AbstractServerNetwork::broadcast(ENetPacket* packet, int channel) {
 	return true;
 }
 
+void AbstractServerNetwork::initIngress(int workers) {
+	if (workers <= 0 || _workers) {
+		return;
+	}
+	_workers = std::make_shared<core::ThreadPool>(workers, "Ingress");
+	_workers->init();
+	Log::info("Use %i threads to handle the received packets", workers);
+}
+
+const AbstractServerNetwork::MessageMetrics& AbstractServerNetwork::messageMetrics(const char* msgType) {
+	{
+		core::ScopedReadLock lock(_messageMetricsLock);
+		auto i = _messageMetrics.find(msgType);
+		if (i != _messageMetrics.end()) {
+			return i->second;
+		}
+	}
+	core::ScopedWriteLock lock(_messageMetricsLock);
+	auto i = _messageMetrics.find(msgType);
+	if (i == _messageMetrics.end()) {
+		const metric::TagMap tags {{"direction", "in"}, {"type", msgType}};
+		MessageMetrics metrics;
+		metrics.count = metric::Metric::handle("network_packet_count", "c", tags);
+		metrics.size = metric::Metric::handle("network_packet_size", "c", tags);
+		metrics.micros = metric::Metric::handle("network_handler_micros", "h", tags);
+		i = _messageMetrics.emplace(msgType, std::move(metrics)).first;
+	}
+	// the entries are never removed - and the references of an unordered_map survive a rehash
+	return i->second;
+}
+
+void AbstractServerNetwork::execute(ENetPeer* peer, ENetPacket* packet, const ProtocolHandlerPtr& handler, const void* message, const char* msgType) {
+	const MessageMetrics& metrics = messageMetrics(msgType);
+	_metric->record(metrics.count, 1);
+	_metric->record(metrics.size, (int)packet->dataLength);
+
+	Log::debug("Received %s", msgType);
+	const uint64_t start = core::TimeProvider::highResTime();
+	handler->executeWithRaw(peer, message, (const uint8_t*)packet->data, packet->dataLength);
+	const uint64_t micros = (core::TimeProvider::highResTime() - start) * 1000000u / core::TimeProvider::highResTimeResolution();
+	_metric->record(metrics.micros, (int)micros);
+}
+
+bool AbstractServerNetwork::packetReceived(ENetEvent& event) {
+	const void* message = nullptr;
+	const char* msgType = "";
+	const ProtocolHandlerPtr& handler = route(event.packet, &message, &msgType);
+	if (!handler) {
+		return false;
+	}
+	execute(event.peer, event.packet, handler, message, msgType);
+	return true;
+}
+
+bool AbstractServerNetwork::isIdle(ENetPeer* peer) {
+	core::ScopedLock lock(_ingressLock);
+	return _peers.find(peer) == _peers.end();
+}
+
+void AbstractServerNetwork::onConnect(ENetPeer* peer) {
+	if (!_workers || isIdle(peer)) {
+		Super::onConnect(peer);
+		return;
+	}
+	Job job;
+	job.type = Job::Type::Connect;
+	enqueue(peer, std::move(job));
+}
+
+void AbstractServerNetwork::onDisconnect(ENetPeer* peer, DisconnectReason reason) {
+	if (!_workers || isIdle(peer)) {
+		Super::onDisconnect(peer, reason);
+		return;
+	}
+	Job job;
+	job.type = Job::Type::Disconnect;
+	job.reason = reason;
+	enqueue(peer, std::move(job));
+}
+
+void AbstractServerNetwork::onPacket(ENetEvent& event) {
+	if (!_workers) {
+		Super::onPacket(event);
+		return;
+	}
+	Job job;
+	job.type = Job::Type::Packet;
+	job.packet = event.packet;
+	if (isIdle(event.peer)) {
+		// nothing of this peer is pending - handlers that must run on the main thread are executed immediately
+		verify(job);
+		if (job.invalid || !job.handler->concurrent()) {
+			execute(event.peer, job);
+			return;
+		}
+	}
+	enqueue(event.peer, std::move(job));
+}
+
+void AbstractServerNetwork::enqueue(ENetPeer* peer, Job&& job) {
+	bool scheduleWorker = false;
+	{
+		core::ScopedLock lock(_ingressLock);
+		PeerQueue& queue = _peers[peer];
+		queue.jobs.emplace_back(std::move(job));
+		if (!queue.scheduled) {
+			queue.scheduled = true;
+			scheduleWorker = true;
+		}
+	}
+	if (scheduleWorker) {
+		schedule(peer);
+	}
+}
+
+void AbstractServerNetwork::schedule(ENetPeer* peer) {
+	_workers->enqueue([this, peer] () {
+		drain(peer);
+	});
+}
+
+AbstractServerNetwork::Job* AbstractServerNetwork::front(ENetPeer* peer) {
+	core::ScopedLock lock(_ingressLock);
+	auto i = _peers.find(peer);
+	core_assert(i != _peers.end());
+	if (i->second.jobs.empty()) {
+		_peers.erase(i);
+		return nullptr;
+	}
+	return &i->second.jobs.front();
+}
+
+void AbstractServerNetwork::pop(ENetPeer* peer) {
+	core::ScopedLock lock(_ingressLock);
+	auto i = _peers.find(peer);
+	core_assert(i != _peers.end());
+	i->second.jobs.pop_front();
+}
+
+bool AbstractServerNetwork::verify(Job& job) {
+	job.handler = route(job.packet, &job.message, &job.msgType);
+	job.invalid = !job.handler;
+	job.routed = true;
+	return !job.invalid;
+}
+
+void AbstractServerNetwork::execute(ENetPeer* peer, Job& job) {
+	switch (job.type) {
+	case Job::Type::Connect:
+		Super::onConnect(peer);
+		break;
+	case Job::Type::Disconnect:
+		Super::onDisconnect(peer, job.reason);
+		break;
+	case Job::Type::Packet:
+		if (job.invalid) {
+			Log::error("Failure while receiving a package - disconnecting now...");
+			disconnectPeer(peer, DisconnectReason::ProtocolError);
+		} else {
+			execute(peer, job.packet, job.handler, job.message, job.msgType);
+		}
+		enet_packet_destroy(job.packet);
+		job.packet = nullptr;
+		break;
+	}
+}
+
+void AbstractServerNetwork::drain(ENetPeer* peer) {
+	core_trace_scoped(IngressDrain);
+	while (Job* job = front(peer)) {
+		if (job->type == Job::Type::Packet && !job->routed) {
+			verify(*job);
+		}
+		if (job->type != Job::Type::Packet || job->invalid || !job->handler->concurrent()) {
+			// the queue of the peer stays scheduled until the main thread handled this job
+			core::ScopedLock lock(_ingressLock);
+			_mainThreadPeers.push_back(peer);
+			return;
+		}
+		execute(peer, *job);
+		pop(peer);
+	}
+}
+
+void AbstractServerNetwork::handleMainThreadJobs() {
+	core_trace_scoped(IngressMainThreadJobs);
+	std::vector<ENetPeer*> peers;
+	{
+		core::ScopedLock lock(_ingressLock);
+		if (_mainThreadPeers.empty()) {
+			return;
+		}
+		peers.swap(_mainThreadPeers);
+	}
+	for (ENetPeer* peer : peers) {
+		while (Job* job = front(peer)) {
+			if (job->type == Job::Type::Packet && !job->routed) {
+				verify(*job);
+			}
+			if (job->type == Job::Type::Packet && !job->invalid && job->handler->concurrent()) {
+				schedule(peer);
+				break;
+			}
+			execute(peer, *job);
+			pop(peer);
+		}
+	}
+}
+
 void AbstractServerNetwork::shutdown() {
+	if (_workers) {
+		_workers->shutdown(true);
+		_workers.reset();
+	}
+	{
+		core::ScopedLock lock(_ingressLock);
+		for (auto& e : _peers) {
+			for (Job& job : e.second.jobs) {
+				if (job.packet != nullptr) {
+					enet_packet_destroy(job.packet);
+				}
+			}
+		}
+		_peers.clear();
+		_mainThreadPeers.clear();
+	}
 	if (_server != nullptr) {
 		enet_host_flush(_server);
 		enet_host_destroy(_server);
@@ -73,6 +301,9 @@ void AbstractServerNetwork::shutdown() {
 
 void AbstractServerNetwork::update() {
 	core_trace_scoped(Network);
+	if (_workers) {
+		handleMainThreadJobs();
+	}
 	updateHost(_server);
 }
 
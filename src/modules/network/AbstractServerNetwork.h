@@ -6,15 +6,116 @@
 
 #include "network/Network.h"
 #include "metric/Metric.h"
+#include "core/Trace.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ReadWriteLock.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace core {
+class ThreadPool;
+}
 
 namespace network {
 
+/**
+ * @brief Base class for the server networks
+ *
+ * If ingress workers are configured (see @c initIngress()), the received packets are verified and executed in a
+ * thread pool. Every peer has a serial queue: the events of one peer are always handled in the order they were
+ * received, while the events of different peers are handled in parallel. Handlers that are not
+ * @c IProtocolHandler::concurrent() as well as the connect and disconnect events are executed on the thread that
+ * calls @c update(). If the queue of a peer is empty, these are handled immediately without passing the workers.
+ */
 class AbstractServerNetwork : public Network {
 private:
 	using Super = Network;
+
+	struct Job {
+		enum class Type {
+			Connect, Packet, Disconnect
+		};
+		Type type = Type::Packet;
+		ENetPacket* packet = nullptr;
+		DisconnectReason reason = DisconnectReason::Unknown;
+		ProtocolHandlerPtr handler;
+		const void* message = nullptr;
+		const char* msgType = "";
+		/** the packet was verified by a worker but it is invalid */
+		bool invalid = false;
+		bool routed = false;
+	};
+
+	struct PeerQueue {
+		std::deque<Job> jobs;
+		/** a worker is handling the jobs or the first job is waiting for the main thread */
+		bool scheduled = false;
+	};
+
+	/**
+	 * @brief The metrics of the received packets of one message type
+	 */
+	struct MessageMetrics {
+		metric::Metric::Handle count;
+		metric::Metric::Handle size;
+		metric::Metric::Handle micros;
+	};
+	core::ReadWriteLock _messageMetricsLock{"MessageMetrics"};
+	/** the message type names are string literals - so the pointer is used as key */
+	std::unordered_map<const char*, MessageMetrics> _messageMetrics core_thread_guarded_by(_messageMetricsLock);
+
+	std::shared_ptr<core::ThreadPool> _workers;
+	core_trace_mutex(core::Lock, _ingressLock, "Ingress");
+	std::unordered_map<ENetPeer*, PeerQueue> _peers core_thread_guarded_by(_ingressLock);
+	/** the peers with a job at the front of their queue that must be handled by the main thread */
+	std::vector<ENetPeer*> _mainThreadPeers core_thread_guarded_by(_ingressLock);
+
+	void enqueue(ENetPeer* peer, Job&& job);
+	void schedule(ENetPeer* peer);
+	/**
+	 * @brief Executed by the workers - handles the jobs of the peer until a job must be handled by the main thread
+	 */
+	void drain(ENetPeer* peer);
+	/**
+	 * @brief Handles the jobs that are waiting for the main thread
+	 */
+	void handleMainThreadJobs();
+	/**
+	 * @return The first job of the peer or @c nullptr if the queue is empty - the empty queue is removed then
+	 * @note Only the thread that handles the jobs of the peer may access the first job - new jobs are only appended
+	 */
+	Job* front(ENetPeer* peer);
+	void pop(ENetPeer* peer);
+	bool verify(Job& job);
+	void execute(ENetPeer* peer, Job& job);
+	void execute(ENetPeer* peer, ENetPacket* packet, const ProtocolHandlerPtr& handler, const void* message, const char* msgType);
+	bool isIdle(ENetPeer* peer);
+	const MessageMetrics& messageMetrics(const char* msgType);
+
 protected:
 	ENetHost* _server = nullptr;
 	metric::MetricPtr _metric;
+
+	/**
+	 * @brief Verifies the packet and looks up the handler for the contained message
+	 * @note This is called from the ingress workers
+	 * @param[out] message The root message that is given to the handler
+	 * @param[out] msgType The name of the message type
+	 * @return The handler or an empty pointer if the packet is invalid or no handler is registered for the message
+	 */
+	virtual ProtocolHandlerPtr route(const ENetPacket* packet, const void** message, const char** msgType) = 0;
+
+	bool packetReceived(ENetEvent& event) override;
+	void onConnect(ENetPeer* peer) override;
+	void onPacket(ENetEvent& event) override;
+	void onDisconnect(ENetPeer* peer, DisconnectReason reason) override;
+
+	/**
+	 * @param[in] workers The amount of threads that verify and execute the packets. If this is @c 0 every packet
+	 * is handled in @c update().
+	 */
+	void initIngress(int workers);
 public:
 	AbstractServerNetwork(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry,
 			const core::EventBusPtr& eventBus, const metric::MetricPtr& metric);
@@ -36,6 +36,15 @@ public:
 	}
 
 	virtual void executeWithRaw(ENetPeer* peer, const void* message, const uint8_t* /*rawData*/, size_t /*rawDataSize*/) = 0;
+
+	/**
+	 * @return @c true if the handler may be executed by the ingress workers of a server network. Such a handler
+	 * must not send messages or modify state that is owned by the main thread - the messages of one peer are still
+	 * handled in order. @c false (the default) executes the handler on the main thread.
+	 */
+	virtual bool concurrent() const {
+		return false;
+	}
 };
 
 class NopHandler : public IProtocolHandler {
@@ -49,6 +49,22 @@ bool Network::disconnectPeer(ENetPeer *peer, DisconnectReason reason) {
 	return true;
 }
 
+void Network::onConnect(ENetPeer* peer) {
+	_eventBus->publish(NewConnectionEvent(peer));
+}
+
+void Network::onPacket(ENetEvent& event) {
+	if (!packetReceived(event)) {
+		Log::error("Failure while receiving a package - disconnecting now...");
+		disconnectPeer(event.peer, DisconnectReason::ProtocolError);
+	}
+	enet_packet_destroy(event.packet);
+}
+
+void Network::onDisconnect(ENetPeer* peer, DisconnectReason reason) {
+	_eventBus->publish(DisconnectEvent(peer, reason));
+}
+
 void Network::updateHost(ENetHost* host) {
 	if (host == nullptr) {
 		return;
@@ -61,24 +77,20 @@ void Network::updateHost(ENetHost* host) {
 		case ENET_EVENT_TYPE_CONNECT: {
 			core_trace_scoped(NetworkConnect);
 			Log::info("New connection event received");
-			_eventBus->publish(NewConnectionEvent(event.peer));
+			onConnect(event.peer);
 			break;
 		}
 		case ENET_EVENT_TYPE_RECEIVE: {
 			core_trace_scoped(NetworkPacket);
 			Log::trace("Package received");
-			if (!packetReceived(event)) {
-				Log::error("Failure while receiving a package - disconnecting now...");
-				disconnectPeer(event.peer, DisconnectReason::ProtocolError);
-			}
-			enet_packet_destroy(event.packet);
+			onPacket(event);
 			break;
 		}
 		case ENET_EVENT_TYPE_DISCONNECT: {
 			core_trace_scoped(NetworkDisconnect);
 			const DisconnectReason reason = (DisconnectReason)event.data;
 			Log::info("New disconnect event received with reason: %i", (int)reason);
-			_eventBus->publish(DisconnectEvent(event.peer, reason));
+			onDisconnect(event.peer, reason);
 			break;
 		}
 		case ENET_EVENT_TYPE_NONE: {
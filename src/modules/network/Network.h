@@ -42,6 +42,20 @@ protected:
 	virtual bool packetReceived(ENetEvent& event) = 0;
 	bool disconnectPeer(ENetPeer *peer, DisconnectReason reason);
 	void updateHost(ENetHost* host);
+
+	/**
+	 * @brief Called from @c updateHost() for every connect event
+	 */
+	virtual void onConnect(ENetPeer* peer);
+	/**
+	 * @brief Called from @c updateHost() for every received packet
+	 * @note The implementation takes the ownership of the packet
+	 */
+	virtual void onPacket(ENetEvent& event);
+	/**
+	 * @brief Called from @c updateHost() for every disconnect event
+	 */
+	virtual void onDisconnect(ENetPeer* peer, DisconnectReason reason);
 public:
 	Network(const ProtocolHandlerRegistryPtr& protocolHandlerRegistry, const core::EventBusPtr& eventBus);
 	virtual ~Network();
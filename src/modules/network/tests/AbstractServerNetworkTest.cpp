@@ -0,0 +1,205 @@
+/**
+ * @file
+ */
+
+#include <gtest/gtest.h>
+#include "network/AbstractServerNetwork.h"
+#include "core/EventBus.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include <SDL_timer.h>
+#include <thread>
+#include <vector>
+
+namespace network {
+
+namespace {
+
+enum HandlerType : uint8_t {
+	Concurrent, MainThread, Max
+};
+
+struct TestPayload {
+	HandlerType type;
+	int peer;
+	int seq;
+};
+
+struct Execution {
+	int peer;
+	int seq;
+	HandlerType type;
+	std::thread::id thread;
+	bool inUpdate;
+};
+
+class ExecutionLog {
+private:
+	core_trace_mutex(core::Lock, _lock, "ExecutionLog");
+	std::vector<Execution> _executions;
+public:
+	core::AtomicBool inUpdate { false };
+
+	void add(const TestPayload& payload) {
+		core::ScopedLock lock(_lock);
+		_executions.push_back({payload.peer, payload.seq, payload.type, std::this_thread::get_id(), inUpdate});
+	}
+
+	int size() {
+		core::ScopedLock lock(_lock);
+		return (int)_executions.size();
+	}
+
+	std::vector<Execution> executions() {
+		core::ScopedLock lock(_lock);
+		return _executions;
+	}
+};
+
+class TestHandler : public IProtocolHandler {
+private:
+	ExecutionLog& _log;
+	const bool _concurrent;
+public:
+	/** blocks the concurrent handler until the test releases it */
+	core::AtomicBool blocked { false };
+
+	TestHandler(ExecutionLog& log, bool concurrent) :
+			_log(log), _concurrent(concurrent) {
+	}
+
+	void executeWithRaw(ENetPeer*, const void* message, const uint8_t*, size_t) override {
+		while (blocked) {
+			SDL_Delay(1);
+		}
+		_log.add(*(const TestPayload*)message);
+	}
+
+	bool concurrent() const override {
+		return _concurrent;
+	}
+};
+
+class TestServerNetwork : public AbstractServerNetwork {
+private:
+	ProtocolHandlerPtr _handlers[HandlerType::Max];
+protected:
+	ProtocolHandlerPtr route(const ENetPacket* packet, const void** message, const char** msgType) override {
+		if (packet->dataLength != sizeof(TestPayload)) {
+			return ProtocolHandlerPtr();
+		}
+		const TestPayload* payload = (const TestPayload*)packet->data;
+		*message = payload;
+		*msgType = payload->type == HandlerType::Concurrent ? "Concurrent" : "MainThread";
+		return _handlers[payload->type];
+	}
+public:
+	TestServerNetwork(const ProtocolHandlerPtr& concurrent, const ProtocolHandlerPtr& mainThread) :
+			AbstractServerNetwork(core::make_shared<ProtocolHandlerRegistry>(), std::make_shared<core::EventBus>(),
+					std::make_shared<metric::Metric>()) {
+		_handlers[HandlerType::Concurrent] = concurrent;
+		_handlers[HandlerType::MainThread] = mainThread;
+	}
+
+	using AbstractServerNetwork::initIngress;
+
+	void receive(ENetPeer* peer, HandlerType type, int peerId, int seq) {
+		const TestPayload payload { type, peerId, seq };
+		ENetEvent event;
+		SDL_zero(event);
+		event.type = ENET_EVENT_TYPE_RECEIVE;
+		event.peer = peer;
+		event.packet = enet_packet_create(&payload, sizeof(payload), ENET_PACKET_FLAG_RELIABLE);
+		onPacket(event);
+	}
+};
+
+}
+
+class AbstractServerNetworkTest : public testing::Test {
+protected:
+	ExecutionLog _log;
+	std::shared_ptr<TestHandler> _concurrent;
+	std::shared_ptr<TestHandler> _mainThread;
+	std::shared_ptr<TestServerNetwork> _network;
+
+	void SetUp() override {
+		_concurrent = std::make_shared<TestHandler>(_log, true);
+		_mainThread = std::make_shared<TestHandler>(_log, false);
+		_network = std::make_shared<TestServerNetwork>(_concurrent, _mainThread);
+		ASSERT_TRUE(_network->init());
+		_network->initIngress(4);
+	}
+
+	void TearDown() override {
+		_concurrent->blocked = false;
+		_network->shutdown();
+		_network.reset();
+	}
+
+	/**
+	 * @brief Ticks the network until the expected amount of handlers were executed
+	 */
+	bool update(int expected) {
+		for (int i = 0; i < 5000; ++i) {
+			_log.inUpdate = true;
+			_network->update();
+			_log.inUpdate = false;
+			if (_log.size() >= expected) {
+				return _log.size() == expected;
+			}
+			SDL_Delay(1);
+		}
+		return false;
+	}
+};
+
+TEST_F(AbstractServerNetworkTest, testPerPeerOrder) {
+	constexpr int peers = 8;
+	constexpr int packets = 200;
+	ENetPeer peer[peers];
+	SDL_zero(peer);
+	for (int seq = 0; seq < packets; ++seq) {
+		for (int p = 0; p < peers; ++p) {
+			// every few packets a handler of the main thread is queued in between the worker handlers
+			const HandlerType type = (seq + p) % 7 == 0 ? HandlerType::MainThread : HandlerType::Concurrent;
+			_network->receive(&peer[p], type, p, seq);
+		}
+	}
+	ASSERT_TRUE(update(peers * packets));
+	int next[peers] = {};
+	for (const Execution& e : _log.executions()) {
+		EXPECT_EQ(next[e.peer], e.seq) << "Packet of peer " << e.peer << " was handled out of order";
+		next[e.peer] = e.seq + 1;
+	}
+	for (int p = 0; p < peers; ++p) {
+		EXPECT_EQ(packets, next[p]);
+	}
+}
+
+TEST_F(AbstractServerNetworkTest, testMainThreadHandlersOnlyInUpdate) {
+	const std::thread::id mainThread = std::this_thread::get_id();
+	ENetPeer peer;
+	SDL_zero(peer);
+	_concurrent->blocked = true;
+	_network->receive(&peer, HandlerType::Concurrent, 0, 0);
+	// the queue of the peer isn't idle - so this must wait for the worker and is then handed to update()
+	_network->receive(&peer, HandlerType::MainThread, 0, 1);
+	_network->receive(&peer, HandlerType::Concurrent, 0, 2);
+	_network->receive(&peer, HandlerType::MainThread, 0, 3);
+	_concurrent->blocked = false;
+	ASSERT_TRUE(update(4));
+	const std::vector<Execution>& executions = _log.executions();
+	for (int i = 0; i < (int)executions.size(); ++i) {
+		const Execution& e = executions[i];
+		EXPECT_EQ(i, e.seq);
+		if (e.type == HandlerType::MainThread) {
+			EXPECT_EQ(mainThread, e.thread) << "Handler " << i << " was not executed on the main thread";
+			EXPECT_TRUE(e.inUpdate) << "Handler " << i << " was not executed in update()";
+		} else {
+			EXPECT_NE(mainThread, e.thread) << "Handler " << i << " was not executed by a worker";
+		}
+	}
+}
+
+}
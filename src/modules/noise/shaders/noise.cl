@@ -2022,14 +2022,13 @@ __kernel void ridgedMF2(
 	const int x = get_global_id(0);
 	const int y = get_global_id(1);
 	const int w = get_global_size(0);
-	const int h = get_global_size(1);
 	const int index = (x + y * w) * components;
 	for (int channel = 0; channel < components; ++channel) {
 		const float2 v = (float2)(x + channel, y + channel);
 		const float noise = _norm(_ridgedMF2(v, ridgeOffset, octaves, lacunarity, gain));
 		const uchar color = (uchar) (noise * 255.0f);
 		const int channelIndex = index + channel;
-		output[channelIndex] = color;
+		output[channelIndex] = (uchar4)(color);
 	}
 }
 
@@ -56,8 +56,10 @@ void BindParam::push(const Model& model, const Field& field) {
 	}
 	case FieldType::BLOB: {
 		const Blob& value = notNull ? model.getValue<Blob>(field) : *model.getValuePointer<Blob>(field);
-		values[index] = (const char*)value.data;
-		lengths[index] = value.length;
+		// copy the data - the parameters must stay valid if the model is modified or destroyed
+		valueBuffers.emplace_back((const char*)value.data, value.length);
+		values[index] = valueBuffers.back().c_str();
+		lengths[index] = (int)value.length;
 		formats[index] = 1; // binary format
 		Log::debug("Parameter %i: length: %i", index + 1, (int)value.length);
 		break;
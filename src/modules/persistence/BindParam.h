@@ -36,6 +36,9 @@ struct BindParam {
 	int add();
 	/**
 	 * @brief Pushes a new value for the given field of the given model to the parameter
+	 * @note The value is copied - the model is not referenced by the parameters. Make sure to
+	 * construct the instance with the expected amount of fields, as the copied values must not
+	 * be reallocated.
 	 */
 	void push(const Model& model, const Field& field);
 };
@@ -25,6 +25,22 @@ bool Connection::status() const {
 #endif
 }
 
+const core::String& Connection::preparedStatement(const core::String& statement) const {
+	auto i = _preparedStatements.find(statement);
+	if (i == _preparedStatements.end()) {
+		static const core::String empty;
+		return empty;
+	}
+	return i->second;
+}
+
+core::String Connection::registerPreparedStatement(const core::String& statement) {
+	// the counter is not reset on unregistering - the old name might still be in use on the server
+	const core::String& name = core::string::format("vengi_stmt_%i", _preparedStatementCounter++);
+	_preparedStatements[statement] = name;
+	return name;
+}
+
 void Connection::changeDb(const core::String& dbname) {
 	_dbname = dbname;
 }
@@ -6,7 +6,7 @@
 
 #include "ForwardDecl.h"
 #include "core/String.h"
-#include <unordered_set>
+#include <unordered_map>
 
 namespace persistence {
 
@@ -18,10 +18,24 @@ private:
 	core::String _user;
 	core::String _password;
 	uint16_t _port = 0u;
-	std::unordered_set<core::String, core::StringHash> _preparedStatements;
+	/**
+	 * @brief Maps the statement text to the name of the server side prepared statement. The text
+	 * is unique for each combination of model, operation and condition shape.
+	 */
+	std::unordered_map<core::String, core::String, core::StringHash> _preparedStatements;
+	int _preparedStatementCounter = 0;
 public:
-	bool hasPreparedStatement(const core::String& name) const;
-	void registerPreparedStatement(const core::String& name);
+	/**
+	 * @return The name of the prepared statement for the given statement text or an empty string if the
+	 * statement wasn't prepared on this connection yet.
+	 */
+	const core::String& preparedStatement(const core::String& statement) const;
+	/**
+	 * @return The name the statement should get prepared with on this connection
+	 */
+	core::String registerPreparedStatement(const core::String& statement);
+	void unregisterPreparedStatement(const core::String& statement);
+	size_t preparedStatements() const;
 
 	bool status() const;
 
@@ -45,12 +59,12 @@ inline ConnectionType* Connection::connection() const {
 	return _connection;
 }
 
-inline bool Connection::hasPreparedStatement(const core::String& name) const {
-	return _preparedStatements.find(name) != _preparedStatements.end();
+inline size_t Connection::preparedStatements() const {
+	return _preparedStatements.size();
 }
 
-inline void Connection::registerPreparedStatement(const core::String& name) {
-	_preparedStatements.insert(name);
+inline void Connection::unregisterPreparedStatement(const core::String& statement) {
+	_preparedStatements.erase(statement);
 }
 
 }
@@ -42,9 +42,11 @@ bool ConnectionPool::init() {
 			_dbName->strVal().c_str());
 
 	for (int i = _connectionAmount; i < _min; ++i) {
-		if (addConnection() == nullptr) {
+		Connection* c = addConnection();
+		if (c == nullptr) {
 			break;
 		}
+		_connections.push(c);
 	}
 
 	if (_connectionAmount < _min) {
@@ -92,7 +94,6 @@ Connection* ConnectionPool::addConnection() {
 		return nullptr;
 	}
 
-	_connections.push(c);
 	++_connectionAmount;
 	return c;
 }
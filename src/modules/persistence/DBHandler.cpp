@@ -248,9 +248,9 @@ State DBHandler::execInternalWithParameters(const core::String& query, Model& mo
 		Log::error(logid, "Could not execute query '%s' - could not acquire connection", query.c_str());
 		return State();
 	}
-	State s(scoped.connection());
+	State s(scoped.connection(), binaryResults(model));
 	Log::debug(logid, "Execute query '%s' with %i parameters", query.c_str(), param.position);
-	if (!s.exec(query.c_str(), param.position, &param.values[0], &param.lengths[0], &param.formats[0])) {
+	if (!execInternalPrepared(s, scoped.connection(), query, param.position, &param.values[0], &param.lengths[0], &param.formats[0])) {
 		Log::warn(logid, "Failed to execute query: '%s'", query.c_str());
 	}
 	if (s.affectedRows <= 0) {
@@ -276,6 +276,49 @@ State DBHandler::execInternalWithParameters(const core::String& query, const Bin
 	return s;
 }
 
+bool DBHandler::execInternalPrepared(State& s, Connection* connection, const core::String& query, int parameterCount,
+		const char *const *paramValues, const int *paramLengths, const int *paramFormats) const {
+	if (!_preparedStatements) {
+		return s.exec(query.c_str(), parameterCount, paramValues, paramLengths, paramFormats);
+	}
+	core::String name = connection->preparedStatement(query);
+	if (name.empty()) {
+		if (connection->preparedStatements() >= MaxPreparedStatements) {
+			return s.exec(query.c_str(), parameterCount, paramValues, paramLengths, paramFormats);
+		}
+		name = connection->registerPreparedStatement(query);
+		if (!s.prepare(name.c_str(), query.c_str(), parameterCount)) {
+			Log::warn(logid, "Failed to prepare query: '%s'", query.c_str());
+			connection->unregisterPreparedStatement(query);
+			return false;
+		}
+		Log::debug(logid, "Prepared query '%s' as '%s'", query.c_str(), name.c_str());
+	}
+	if (!s.execPrepared(name.c_str(), parameterCount, paramValues, paramLengths, paramFormats)) {
+		const char *code = s.errorCode();
+		// invalid_sql_statement_name or a cached plan that doesn't match the altered table anymore
+		if (!SDL_strcmp(code, "26000") || !SDL_strcmp(code, "0A000")) {
+			// the statement is prepared again under a new name with the next call
+			connection->unregisterPreparedStatement(query);
+		}
+		return false;
+	}
+	return true;
+}
+
+bool DBHandler::binaryResults(const Model& model) const {
+	if (!_preparedStatements) {
+		return false;
+	}
+	// blobs are unescaped by libpq in the text format - see State::getResult()
+	for (const Field& f : model.fields()) {
+		if (f.type == FieldType::BLOB) {
+			return false;
+		}
+	}
+	return true;
+}
+
 bool DBHandler::begin() {
 	return exec(createTransactionBegin());
 }
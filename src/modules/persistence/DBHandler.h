@@ -41,6 +41,24 @@ private:
 	State execInternalWithParameters(const core::String& query, Model& model, const BindParam& param) const;
 	State execInternalWithCondition(const core::String& query, BindParam& params, int conditionOffset, const DBCondition& condition) const;
 	State execInternalWithParameters(const core::String& query, const BindParam& param) const;
+	/**
+	 * @brief Executes the statement as a server side prepared statement of the given connection. The
+	 * statement is only parsed and planned by the server the first time it is seen on a connection.
+	 * @note Falls back to @c State::exec() if prepared statements are disabled or too many different
+	 * statements were already prepared on the connection.
+	 */
+	bool execInternalPrepared(State& s, Connection* connection, const core::String& query, int parameterCount,
+			const char *const *paramValues, const int *paramLengths, const int *paramFormats) const;
+	/**
+	 * @return @c true if the results for the given model can be requested in the binary format.
+	 */
+	bool binaryResults(const Model& model) const;
+
+	/**
+	 * @brief Upper limit for the prepared statements per connection - statements with e.g. different
+	 * limit and offset values are no candidates for re-use and would let the cache grow forever.
+	 */
+	static constexpr size_t MaxPreparedStatements = 256u;
 
 	mutable ConnectionPool _connectionPool;
 
@@ -57,10 +75,10 @@ private:
 			Log::error(logid, "Could not execute query '%s' - could not acquire connection", query.c_str());
 			return false;
 		}
-		State s(scoped.connection());
+		State s(scoped.connection(), binaryResults(model));
 		if (conditionAmount > 0) {
 			if (keyParams.position == conditionAmount) {
-				if (!s.exec(query.c_str(), conditionAmount, &keyParams.values[0], &keyParams.lengths[0], &keyParams.formats[0])) {
+				if (!execInternalPrepared(s, scoped.connection(), query, conditionAmount, &keyParams.values[0], &keyParams.lengths[0], &keyParams.formats[0])) {
 					Log::error(logid, "Failed to execute query '%s' with %i parameters", query.c_str(), conditionAmount);
 				}
 			} else {
@@ -71,11 +89,11 @@ private:
 					Log::debug(logid, "Parameter %i: '%s'", index + 1, value);
 					params.values[index] = value;
 				}
-				if (!s.exec(query.c_str(), conditionAmount, &params.values[0], &params.lengths[0], &params.formats[0])) {
+				if (!execInternalPrepared(s, scoped.connection(), query, conditionAmount, &params.values[0], &params.lengths[0], &params.formats[0])) {
 					Log::error(logid, "Failed to execute query '%s' with %i parameters", query.c_str(), conditionAmount);
 				}
 			}
-		} else if (!s.exec(query.c_str())) {
+		} else if (!execInternalPrepared(s, scoped.connection(), query, 0, nullptr, nullptr, nullptr)) {
 			Log::error(logid, "Failed to execute query '%s'", query.c_str());
 		}
 		for (int i = 0; i < s.affectedRows; ++i) {
@@ -87,6 +105,7 @@ private:
 	}
 
 	bool _initialized = false;
+	bool _preparedStatements = true;
 	const bool _useForeignKeys;
 
 public:
@@ -190,6 +209,12 @@ public:
 
 	void freeBlob(Blob& blob) const;
 
+	/**
+	 * @brief Selects, inserts and updates are executed as cached prepared statements with binary results
+	 * by default. Disabling this executes them as plain text statements with text results.
+	 */
+	void setPreparedStatements(bool enabled);
+
 	/**
 	 * @brief Updates the database entry for the give model. The primary keys must be set in the
 	 * @c persistence::Model instance that is given to this method
@@ -287,6 +312,10 @@ public:
 	bool rollback();
 };
 
+inline void DBHandler::setPreparedStatements(bool enabled) {
+	_preparedStatements = enabled;
+}
+
 typedef std::shared_ptr<DBHandler> DBHandlerPtr;
 
 }
@@ -6,7 +6,12 @@
 #include "ISavable.h"
 #include "DBHandler.h"
 #include "SQLGenerator.h"
+#include "ScopedConnection.h"
+#include "State.h"
 #include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "core/Trace.h"
 
 namespace persistence {
 
@@ -20,33 +25,78 @@ MassQuery::~MassQuery() {
 	commit();
 }
 
-void MassQuery::commit() {
-	// TODO: how to handle the error state here?
+void MassQuery::bind(const std::vector<const Model*>& models, bool insert, std::list<Statement>& statements) {
+	size_t parameters = 0u;
+	for (const Model* m : models) {
+		parameters += m->fields().size();
+	}
+	statements.emplace_back(core_max(1, (int)parameters));
+	Statement& statement = statements.back();
+	if (insert) {
+		statement.query = createInsertStatement(models, &statement.params);
+	} else {
+		statement.query = createDeleteStatement(models, &statement.params);
+	}
+	if (statement.query.empty()) {
+		statements.pop_back();
+	}
+}
+
+void MassQuery::bind() {
 	if (!_insertOrUpdate.empty()) {
-		_dbHandler->insert(_insertOrUpdate);
+		bind(_insertOrUpdate, true, _statements);
 		_insertOrUpdate.clear();
 	}
 	if (!_delete.empty()) {
-		_dbHandler->deleteModels(_delete);
+		bind(_delete, false, _statements);
 		_delete.clear();
 	}
 }
 
+bool MassQuery::commit() {
+	bind();
+	if (_statements.empty()) {
+		_size = 0u;
+		return true;
+	}
+	core_trace_scoped(MassQueryCommit);
+	bool state = true;
+	ScopedConnection scoped(_dbHandler->_connectionPool, _dbHandler->connection());
+	if (!scoped) {
+		Log::error(DBHandler::logid, "Could not execute %i statements - could not acquire connection", (int)_statements.size());
+		state = false;
+	} else {
+		for (const Statement& statement : _statements) {
+			const BindParam& param = statement.params;
+			State s(scoped.connection());
+			Log::debug(DBHandler::logid, "Execute query '%s' with %i parameters", statement.query.c_str(), param.position);
+			if (!s.exec(statement.query.c_str(), param.position, &param.values[0], &param.lengths[0], &param.formats[0])) {
+				Log::warn(DBHandler::logid, "Failed to execute query: '%s'", statement.query.c_str());
+				state = false;
+			}
+		}
+	}
+	_statements.clear();
+	_size = 0u;
+	return state;
+}
+
 void MassQuery::add(ISavable* savable) {
 	core_assert(savable != nullptr);
-	std::vector<const Model*> models;
-	if (!savable->getDirtyModels(models)) {
+	_models.clear();
+	if (!savable->getDirtyModels(_models)) {
 		return;
 	}
-	for (const Model* m : models) {
+	for (const Model* m : _models) {
 		if (m->shouldBeDeleted()) {
 			_delete.push_back(m);
 		} else {
 			_insertOrUpdate.push_back(m);
 		}
 	}
+	_size += _models.size();
 	if (_insertOrUpdate.size() + _delete.size() >= _commitSize) {
-		commit();
+		bind();
 	}
 }
 
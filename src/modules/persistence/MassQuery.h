@@ -5,6 +5,8 @@
 #pragma once
 
 #include "BindParam.h"
+#include "core/String.h"
+#include <list>
 #include <memory>
 #include <vector>
 
@@ -12,24 +14,69 @@ namespace persistence {
 
 class ISavable;
 class DBHandler;
+class Model;
 
 /**
  * @brief Implements mass updates for @c ISavable instances.
+ *
+ * The dirty models are collected with @c add() and converted into multi row upserts and deletes
+ * in @c bind(). The values of the models are copied into the bound parameters - the models are
+ * not referenced anymore after @c bind() was called. This allows to collect the dirty states
+ * while the savables are locked and to execute the statements after the lock was released.
+ *
+ * @note All models that are added to one instance must belong to the same table.
  */
 class MassQuery {
 private:
+	struct Statement {
+		core::String query;
+		BindParam params;
+		Statement(int parameters) : params(parameters) {}
+	};
 	const DBHandler * const _dbHandler;
 	const size_t _commitSize;
+	std::vector<const Model*> _models;
 	std::vector<const Model*> _insertOrUpdate;
 	std::vector<const Model*> _delete;
+	// the bound parameters are referencing the value buffers - the elements must not be moved
+	std::list<Statement> _statements;
+	size_t _size = 0u;
 	friend class DBHandler;
 	MassQuery(const DBHandler* dbHandler, size_t amount = 1000);
 
+	static void bind(const std::vector<const Model*>& models, bool insert, std::list<Statement>& statements);
+
 public:
+	MassQuery(MassQuery&& other) = default;
 	~MassQuery();
 
 	void add(ISavable* savable);
-	void commit();
+	/**
+	 * @brief Converts the collected models into statements with copies of the current values
+	 */
+	void bind();
+	/**
+	 * @brief Executes the pending statements on one pooled connection
+	 * @return @c false if one of the statements failed
+	 */
+	bool commit();
+
+	/**
+	 * @return The amount of models that were added since the last @c commit()
+	 */
+	size_t size() const;
+	/**
+	 * @return The amount of statements that are waiting for the next @c commit()
+	 */
+	size_t statements() const;
 };
 
+inline size_t MassQuery::size() const {
+	return _size;
+}
+
+inline size_t MassQuery::statements() const {
+	return _statements.size();
+}
+
 }
@@ -46,19 +46,29 @@ const Field& Model::getField(const char* name) const {
 bool Model::fillModelValues(State& state) {
 	const int cols = state.cols;
 	Log::debug("Query has values for %i cols", cols);
-	for (int i = 0; i < cols; ++i) {
-		const char* name = state.columnName(i);
-		const Field& f = getField(name);
-		if (f.name != name) {
-			Log::error("Unknown field name for '%s'", name);
-			state.result = false;
-			return false;
+	if ((int)state.columnFields.size() != cols) {
+		// the column layout is the same for every row - only resolve the field names once
+		state.columnFields.resize(cols);
+		for (int i = 0; i < cols; ++i) {
+			const char* name = state.columnName(i);
+			const Field& f = getField(name);
+			if (f.name != name) {
+				Log::error("Unknown field name for '%s'", name);
+				state.columnFields.clear();
+				state.result = false;
+				return false;
+			}
+			state.columnFields[i] = &f;
 		}
+	}
+	const bool binary = state.isBinary();
+	for (int i = 0; i < cols; ++i) {
+		const Field& f = *state.columnFields[i];
 		const char *value;
 		int length;
 		bool isNull;
 		state.getResult(i, f.type, &value, &length, &isNull);
-		Log::debug("Try to set '%s' to '%s' (length: %i)", name, value, length);
+		Log::debug("Try to set '%s' (length: %i)", f.name.c_str(), length);
 		switch (f.type) {
 		case FieldType::PASSWORD:
 		case FieldType::TEXT:
@@ -74,28 +84,30 @@ bool Model::fillModelValues(State& state) {
 			break;
 		}
 		case FieldType::BOOLEAN:
-			setValue(f, state.isBool(value));
+			setValue(f, binary ? value[0] != '\0' : state.isBool(value));
 			break;
 		case FieldType::BLOB:
 			setValue(f, Blob((uint8_t*)value, length));
 			break;
 		case FieldType::INT:
-			setValue(f, (int32_t)core::string::toInt(value));
+			setValue(f, (int32_t)(binary ? state.binaryToInt(value, length) : core::string::toInt(value)));
 			break;
 		case FieldType::SHORT:
-			setValue(f, (int16_t)core::string::toInt(value));
+			setValue(f, (int16_t)(binary ? state.binaryToInt(value, length) : core::string::toInt(value)));
 			break;
 		case FieldType::BYTE:
-			setValue(f, (uint8_t)core::string::toInt(value));
+			setValue(f, (uint8_t)(binary ? state.binaryToInt(value, length) : core::string::toInt(value)));
 			break;
 		case FieldType::LONG:
-			setValue(f, core::string::toLong(value));
+			setValue(f, binary ? state.binaryToInt(value, length) : core::string::toLong(value));
 			break;
 		case FieldType::DOUBLE:
-			setValue(f, core::string::toDouble(value));
+			setValue(f, binary ? state.binaryToDouble(value, length) : core::string::toDouble(value));
 			break;
 		case FieldType::TIMESTAMP: {
-			setValue(f, Timestamp(core::string::toLong(value)));
+			// selected as epoch seconds - see createSelect()
+			const int64_t seconds = binary ? state.binaryToInt(value, length) : core::string::toLong(value);
+			setValue(f, Timestamp(seconds));
 			break;
 		}
 		case FieldType::MAX:
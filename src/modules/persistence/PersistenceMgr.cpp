@@ -6,7 +6,12 @@
 #include "DBHandler.h"
 #include "MassQuery.h"
 #include "core/Common.h"
+#include "core/GameConfig.h"
+#include "core/TimeProvider.h"
 #include "core/Trace.h"
+#include "core/Var.h"
+#include "core/concurrent/ThreadPool.h"
+#include <future>
 
 namespace persistence {
 
@@ -14,6 +19,9 @@ PersistenceMgr::PersistenceMgr(const DBHandlerPtr& dbHandler) :
 		_lock("persistencemgr"), _dbHandler(dbHandler) {
 }
 
+PersistenceMgr::~PersistenceMgr() {
+}
+
 bool PersistenceMgr::registerSavable(uint32_t fourcc, ISavable *savable) {
 	Log::trace(logid, "Register savable (fourcc: %u, savable: %p)", fourcc, savable);
 	core::ScopedWriteLock lock(_lock);
@@ -24,51 +32,161 @@ bool PersistenceMgr::registerSavable(uint32_t fourcc, ISavable *savable) {
 bool PersistenceMgr::unregisterSavable(uint32_t fourcc, ISavable *savable) {
 	core_trace_scoped(PersistenceMgrUnregisterSavable);
 	Log::trace(logid, "Unregister savable (fourcc: %u, savable: %p)", fourcc, savable);
-	core::ScopedWriteLock lock(_lock);
-	auto i = _savables.find(fourcc);
-	if (i == _savables.end()) {
-		Log::trace(logid, "Could not find fourcc (fourcc: %u, savable: %p)", fourcc, savable);
-		return false;
-	}
-	auto s = i->second.find(savable);
-	if (s != i->second.end()) {
+	MassQuery stmt = _dbHandler->massQuery();
+	{
+		core::ScopedWriteLock lock(_lock);
+		auto i = _savables.find(fourcc);
+		if (i == _savables.end()) {
+			Log::trace(logid, "Could not find fourcc (fourcc: %u, savable: %p)", fourcc, savable);
+			return false;
+		}
+		auto s = i->second.find(savable);
+		if (s == i->second.end()) {
+			Log::trace(logid, "Could not find savable (fourcc: %u, savable: %p)", fourcc, savable);
+			return false;
+		}
 		i->second.erase(s);
-		// make sure to persist the dirty state
-		MassQuery stmt = _dbHandler->massQuery();
+		// make sure to persist the dirty state - the values are copied, the savable might be gone after this call
 		stmt.add(savable);
+		stmt.bind();
+	}
+	{
+		// an update that collected an older state of this savable might still be writing - wait for it, as
+		// the last commit wins
+		core::ScopedLock lock(_updateLock);
 		stmt.commit();
-		Log::trace(logid, "Removed savable (fourcc: %u, savable: %p)", fourcc, savable);
-		return true;
 	}
-	Log::trace(logid, "Could not find savable (fourcc: %u, savable: %p)", fourcc, savable);
-	return false;
+	Log::trace(logid, "Removed savable (fourcc: %u, savable: %p)", fourcc, savable);
+	return true;
 }
 
 bool PersistenceMgr::init() {
+	int writers = core::Var::get(cfg::DatabaseWriters, "2")->intVal();
+	const core::VarPtr& maxConnections = core::Var::get(cfg::DatabaseMaxConnections);
+	if (maxConnections) {
+		// leave one connection for the other queries
+		writers = core_min(writers, maxConnections->intVal() - 1);
+	}
+	if (writers > 1) {
+		_writers = std::make_shared<core::ThreadPool>(writers, "PersistenceMgr");
+		_writers->init();
+	}
+	Log::debug(logid, "Use %i connections to write the dirty states", core_max(1, writers));
 	return true;
 }
 
 void PersistenceMgr::shutdown() {
 	core_trace_scoped(PersistenceMgrShutdown);
-	update(0l);
+	{
+		core::ScopedLock lock(_updateLock);
+		persist();
+		_queries.clear();
+	}
+	if (_writers) {
+		_writers->shutdown(true);
+		_writers.reset();
+	}
 	core::ScopedWriteLock lock(_lock);
 	_savables.clear();
 }
 
-void PersistenceMgr::update(long dt) {
-	core_trace_scoped(PersistenceMgrUpdate);
+size_t PersistenceMgr::collect() {
+	core_trace_scoped(PersistenceMgrCollect);
 	core::ScopedReadLock lock(_lock);
+	size_t n = 0u;
 	for (auto& collection : _savables) {
 		if (collection.second.empty()) {
 			continue;
 		}
-		MassQuery stmt = _dbHandler->massQuery();
+		// each mass query only contains models of one collection, as they are batched into one statement
+		bool newQuery = true;
 		for (ISavable *savable : collection.second) {
-			stmt.add(savable);
+			if (newQuery) {
+				if (n >= _queries.size()) {
+					_queries.emplace_back(_dbHandler->massQuery());
+				}
+				++n;
+				newQuery = false;
+			}
+			MassQuery& query = _queries[n - 1];
+			query.add(savable);
+			if (query.size() >= _batchSize) {
+				// split large collections to write them in parallel
+				newQuery = true;
+			}
 		}
-		stmt.commit();
 	}
-	Log::debug(logid, "Persisted dirty states of %i savables", (int)_savables.size());
+	for (size_t i = 0u; i < n; ++i) {
+		// copy the values before the savables are unlocked
+		_queries[i].bind();
+	}
+	return n;
+}
+
+bool PersistenceMgr::commit(MassQuery& query) {
+	const int size = (int)query.size();
+	const bool state = query.commit();
+	_pending.increment(-size);
+	_written.increment(size);
+	return state;
+}
+
+void PersistenceMgr::persist() {
+	core_trace_scoped(PersistenceMgrPersist);
+	const uint64_t start = core::TimeProvider::highResTime();
+	const size_t n = collect();
+	int models = 0;
+	for (size_t i = 0u; i < n; ++i) {
+		models += (int)_queries[i].size();
+	}
+	_pending = models;
+	_written = 0;
+
+	int failed = 0;
+	if (_writers && n > 1u) {
+		std::vector<std::future<bool>> futures;
+		futures.reserve(n);
+		for (size_t i = 0u; i < n; ++i) {
+			MassQuery* query = &_queries[i];
+			futures.emplace_back(_writers->enqueue([this, query] () {
+				return commit(*query);
+			}));
+		}
+		for (std::future<bool>& f : futures) {
+			if (!f.valid() || !f.get()) {
+				++failed;
+			}
+		}
+	} else {
+		for (size_t i = 0u; i < n; ++i) {
+			if (!commit(_queries[i])) {
+				++failed;
+			}
+		}
+	}
+	_failed = failed;
+	const uint64_t micros = (core::TimeProvider::highResTime() - start) * 1000000u / core::TimeProvider::highResTimeResolution();
+	_micros = (int)micros;
+	Log::debug(logid, "Persisted dirty states of %i models in %i queries", models, (int)n);
+}
+
+void PersistenceMgr::update(long dt) {
+	core_trace_scoped(PersistenceMgrUpdate);
+	if (!_updateLock.try_lock()) {
+		Log::debug(logid, "Skip update - the previous update is still running");
+		return;
+	}
+	persist();
+	_updateLock.unlock();
+}
+
+PersistenceMgr::Stats PersistenceMgr::stats() const {
+	Stats stats;
+	stats.pending = _pending;
+	stats.written = _written;
+	stats.failed = _failed;
+	stats.micros = _micros;
+	return stats;
 }
 
 }
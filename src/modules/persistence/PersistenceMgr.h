@@ -7,11 +7,20 @@
 #include <memory>
 #include <map>
 #include <unordered_set>
+#include <vector>
 #include "ISavable.h"
 #include "DBHandler.h"
+#include "MassQuery.h"
 #include "core/IComponent.h"
+#include "core/Trace.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
 #include "core/concurrent/ReadWriteLock.h"
 
+namespace core {
+class ThreadPool;
+}
+
 /**
  * Persistence layer
  */
@@ -20,9 +29,27 @@ namespace persistence {
 /**
  * @brief This class is responsible for calling the update mechanisms for the single components of each player.
  * It will collect all database actions in prepared statements to write delta values into the database.
+ *
+ * Each @c update() is executed in two stages: The dirty models of all savables are collected and their values
+ * are copied into multi row statements while the savables are locked. The statements are executed after the
+ * lock was released - distributed over several pooled connections. Registering savables doesn't have to wait
+ * for the database this way. Unregistering writes the final dirty state after a running update was written, to
+ * not get overwritten by an older state.
+ *
  * @note Your @c ISavable instances must be registered and unregistered.
  */
 class PersistenceMgr : public core::IComponent {
+public:
+	struct Stats {
+		/** the amount of models that were collected but are not yet written to the database */
+		int pending = 0;
+		/** the amount of models that were written in the last update */
+		int written = 0;
+		/** the amount of statements that failed in the last update */
+		int failed = 0;
+		/** the microseconds the last update took */
+		int micros = 0;
+	};
 private:
 	static constexpr uint32_t logid = Log::logid("PersistenceMgr");
 	using Savables = std::unordered_set<ISavable*>;
@@ -30,9 +57,32 @@ private:
 	Map _savables core_thread_guarded_by(_lock);
 	core::ReadWriteLock _lock;
 	const DBHandlerPtr _dbHandler;
+
+	/**
+	 * @brief Only one update may run at a time to keep the order of the writes
+	 */
+	core_trace_mutex(core::Lock, _updateLock, "PersistenceMgrUpdate");
+	/**
+	 * @brief The mass queries are reused for every update to keep their buffers
+	 */
+	std::vector<MassQuery> _queries core_thread_guarded_by(_updateLock);
+	std::shared_ptr<core::ThreadPool> _writers;
+	size_t _batchSize = 1000u;
+
+	core::AtomicInt _pending { 0 };
+	core::AtomicInt _written { 0 };
+	core::AtomicInt _failed { 0 };
+	core::AtomicInt _micros { 0 };
+
+	void persist() core_thread_requires(_updateLock);
+	/**
+	 * @return The amount of mass queries that were filled with the dirty states
+	 */
+	size_t collect() core_thread_requires(_updateLock);
+	bool commit(MassQuery& query);
 public:
 	PersistenceMgr(const DBHandlerPtr& dbHandler);
-	virtual ~PersistenceMgr() {}
+	virtual ~PersistenceMgr();
 
 	virtual bool registerSavable(uint32_t fourcc, ISavable *savable);
 	virtual bool unregisterSavable(uint32_t fourcc, ISavable *savable);
@@ -43,7 +93,13 @@ public:
 	 */
 	void shutdown() override;
 
+	/**
+	 * @note If the previous update is still writing to the database, this call is skipped. The dirty
+	 * states are collected with the next update.
+	 */
 	void update(long dt);
+
+	Stats stats() const;
 };
 
 typedef std::shared_ptr<PersistenceMgr> PersistenceMgrPtr;
@@ -620,7 +620,7 @@ core::String createDropTableStatement(const Model& model) {
 	return stmt;
 }
 
-static void createWhereStatementsForKeys(core::String& stmt, int& index, const Model& model, BindParam* params) {
+static int createKeyConditions(core::String& stmt, int& index, const Model& model, BindParam* params) {
 	int where = 0;
 	const Fields& fields = model.fields();
 	for (auto i = fields.begin(); i != fields.end(); ++i) {
@@ -633,8 +633,6 @@ static void createWhereStatementsForKeys(core::String& stmt, int& index, const M
 		}
 		if (where > 0) {
 			stmt += " AND ";
-		} else {
-			stmt += " WHERE ";
 		}
 		++where;
 		stmt += "\"";
@@ -652,6 +650,15 @@ static void createWhereStatementsForKeys(core::String& stmt, int& index, const M
 			}
 		}
 	}
+	return where;
+}
+
+static void createWhereStatementsForKeys(core::String& stmt, int& index, const Model& model, BindParam* params) {
+	core::String conditions;
+	if (createKeyConditions(conditions, index, model, params) > 0) {
+		stmt += " WHERE ";
+		stmt += conditions;
+	}
 }
 
 core::String createCountStatement(const Model& model, BindParam* params) {
@@ -711,6 +718,30 @@ core::String createDeleteStatement(const Model& model, BindParam* params) {
 	return stmt;
 }
 
+core::String createDeleteStatement(const std::vector<const Model*>& models, BindParam* params) {
+	const Model& table = *models.front();
+	core::String stmt;
+	stmt += "DELETE FROM ";
+	createTableIdentifier(stmt, table);
+	int index = 1;
+	int where = 0;
+	for (const Model* model : models) {
+		core::String conditions;
+		if (createKeyConditions(conditions, index, *model, params) <= 0) {
+			// never delete the whole table because of a model without keys
+			continue;
+		}
+		stmt += where > 0 ? " OR (" : " WHERE (";
+		stmt += conditions;
+		stmt += ")";
+		++where;
+	}
+	if (where == 0) {
+		return core::String();
+	}
+	return stmt;
+}
+
 core::String createInsertBaseStatement(const Model& table, bool& primaryKeyIncluded) {
 	core::String stmt;
 	stmt += "INSERT INTO ";
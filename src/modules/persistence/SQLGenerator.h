@@ -24,6 +24,12 @@ extern core::String createTruncateTableStatement(const Model& model);
 extern core::String createDropTableStatement(const Model& model);
 extern core::String createUpdateStatement(const Model& model, BindParam* params = nullptr, int* parameterCount = nullptr);
 extern core::String createDeleteStatement(const Model& model, BindParam* params = nullptr);
+/**
+ * @brief Deletes all the given models (of the same table) with one statement. The models are identified by
+ * their primary keys - models without valid primary keys are skipped.
+ * @return An empty string if none of the models could be identified
+ */
+extern core::String createDeleteStatement(const std::vector<const Model*>& models, BindParam* params = nullptr);
 extern core::String createInsertBaseStatement(const Model& table, bool& primaryKeyIncluded);
 extern core::String createInsertValuesStatement(const Model& table, BindParam* params, int& insertValueIndex);
 extern core::String createInsertStatement(const Model& model, BindParam* params = nullptr, int* parameterCount = nullptr);
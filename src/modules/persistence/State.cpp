@@ -8,36 +8,45 @@
 #include "core/StringUtil.h"
 #include "Connection.h"
 #include "postgres/PQSymbol.h"
+#include <SDL_endian.h>
+#include <SDL_stdinc.h>
 
 namespace persistence {
 
-State::State(Connection* connection) :
-		_connection(connection) {
+State::State(Connection* connection, bool binary) :
+		_connection(connection), _resultFormat(binary ? 1 : 0) {
 }
 
 State::State(State&& other) noexcept :
-		res(other.res), lastErrorMsg(other.lastErrorMsg), affectedRows(other.affectedRows),
-		cols(other.cols), currentRow(other.currentRow), result(other.result) {
+		_connection(other._connection), _resultFormat(other._resultFormat), res(other.res),
+		columnFields(std::move(other.columnFields)), lastErrorMsg(other.lastErrorMsg),
+		affectedRows(other.affectedRows), cols(other.cols), currentRow(other.currentRow), result(other.result) {
 	other.res = nullptr;
 	other._connection = nullptr;
 	other.lastErrorMsg = nullptr;
 }
 
 State::~State() {
+	clearResult();
+	lastErrorMsg = nullptr;
+}
+
+void State::clearResult() {
 	if (res != nullptr) {
 #ifdef HAVE_POSTGRES
 		PQclear(res);
 #endif
 		res = nullptr;
 	}
-	lastErrorMsg = nullptr;
+	columnFields.clear();
 }
 
 bool State::exec(const char *statement, int parameterCount, const char *const *paramValues, const int *paramLengths, const int *paramFormats) {
 	core_assert_msg(parameterCount <= 0 || paramValues != nullptr, "Parameters don't match");
 	ConnectionType* c = _connection->connection();
+	clearResult();
 #ifdef HAVE_POSTGRES
-	if (parameterCount <= 0) {
+	if (parameterCount <= 0 && _resultFormat == 0) {
 		res = PQexec(c, statement);
 	} else {
 		res = PQexecParams(c, statement, parameterCount, nullptr, paramValues, paramLengths, paramFormats, _resultFormat);
@@ -49,21 +58,19 @@ bool State::exec(const char *statement, int parameterCount, const char *const *p
 
 bool State::prepare(const char *name, const char* statement, int parameterCount) {
 	ConnectionType* c = _connection->connection();
+	clearResult();
 #ifdef HAVE_POSTGRES
 	res = PQprepare(c, name, statement, parameterCount, nullptr);
 #endif
 	checkLastResult(c);
-	if (!result) {
-		return false;
-	}
-	if (name != nullptr && name[0] != '\0') {
-		_connection->registerPreparedStatement(core::String(name));
-	}
-	return true;
+	// the result of the prepare call doesn't contain any rows
+	clearResult();
+	return result;
 }
 
 bool State::execPrepared(const char *name, int parameterCount, const char *const *paramValues, const int *paramLengths, const int *paramFormats) {
 	ConnectionType* c = _connection->connection();
+	clearResult();
 #ifdef HAVE_POSTGRES
 	res = PQexecPrepared(c, name, parameterCount, paramValues, paramLengths, paramFormats, _resultFormat);
 #endif
@@ -83,6 +90,9 @@ bool State::asBool(int colIndex) const {
 	if (length == 0) {
 		return false;
 	}
+	if (isBinary()) {
+		return value[0] != '\0';
+	}
 	return isBool(value);
 }
 
@@ -94,9 +104,69 @@ int State::asInt(int colIndex) const {
 	if (length == 0) {
 		return 0;
 	}
+	if (isBinary()) {
+		return (int)binaryToInt(value, length);
+	}
 	return core::string::toInt(value);
 }
 
+int64_t State::binaryToInt(const char *value, int length) {
+	switch (length) {
+	case 1:
+		return (int8_t)value[0];
+	case 2: {
+		uint16_t v;
+		SDL_memcpy(&v, value, sizeof(v));
+		return (int16_t)SDL_SwapBE16(v);
+	}
+	case 4: {
+		uint32_t v;
+		SDL_memcpy(&v, value, sizeof(v));
+		return (int32_t)SDL_SwapBE32(v);
+	}
+	case 8: {
+		uint64_t v;
+		SDL_memcpy(&v, value, sizeof(v));
+		return (int64_t)SDL_SwapBE64(v);
+	}
+	default:
+		break;
+	}
+	return 0;
+}
+
+double State::binaryToDouble(const char *value, int length) {
+	if (length == 4) {
+		uint32_t v;
+		SDL_memcpy(&v, value, sizeof(v));
+		v = SDL_SwapBE32(v);
+		float f;
+		SDL_memcpy(&f, &v, sizeof(f));
+		return f;
+	}
+	if (length == 8) {
+		uint64_t v;
+		SDL_memcpy(&v, value, sizeof(v));
+		v = SDL_SwapBE64(v);
+		double d;
+		SDL_memcpy(&d, &v, sizeof(d));
+		return d;
+	}
+	return 0.0;
+}
+
+const char *State::errorCode() const {
+#ifdef HAVE_POSTGRES
+	if (res != nullptr) {
+		const char *code = PQresultErrorField(res, PG_DIAG_SQLSTATE);
+		if (code != nullptr) {
+			return code;
+		}
+	}
+#endif
+	return "";
+}
+
 const char *State::columnName(int colIndex) const {
 #ifdef HAVE_POSTGRES
 	return PQfname(res, colIndex);
@@ -8,9 +8,12 @@
 #include "core/NonCopyable.h"
 #include "FieldType.h"
 #include "core/String.h"
+#include <vector>
 
 namespace persistence {
 
+struct Field;
+
 /**
  * @brief Wraps the postgres api
  */
@@ -18,14 +21,19 @@ class State : public core::NonCopyable {
 private:
 	Connection* _connection = nullptr;
 	void checkLastResult(ConnectionType* connection);
+	void clearResult();
 
 	// 1 = binary, 0 = text
-	const int _resultFormat = 0;
+	int _resultFormat = 0;
 public:
-	constexpr State() {
+	State() {
 	}
 
-	State(Connection* connection);
+	/**
+	 * @param[in] binary Request the results in the binary format. The values are not parsed from strings
+	 * then, but @c FieldType::BLOB columns are not supported in this mode.
+	 */
+	State(Connection* connection, bool binary = false);
 	State(State&& other) noexcept;
 	~State();
 
@@ -35,6 +43,11 @@ public:
 	bool prepare(const char *name, const char* statement, int parameterCount);
 	bool execPrepared(const char *name, int parameterCount, const char *const *paramValues = nullptr, const int *paramLengths = nullptr, const int *paramFormats = nullptr);
 
+	/**
+	 * @return The SQLSTATE code of the failed statement or an empty string
+	 */
+	const char *errorCode() const;
+
 	/**
 	 * @param[in] colIndex The column index of the current row. Starting at index 0 for the first column
 	 */
@@ -63,8 +76,22 @@ public:
 
 	int asInt(int colIndex) const;
 
+	/**
+	 * @brief Converts a big endian integer value of a binary result with 1, 2, 4 or 8 bytes
+	 */
+	static int64_t binaryToInt(const char *value, int length);
+	/**
+	 * @brief Converts a big endian floating point value of a binary result with 4 or 8 bytes
+	 */
+	static double binaryToDouble(const char *value, int length);
+
 	ResultType* res = nullptr;
 
+	/**
+	 * @brief The model fields of the result columns - resolved once for the first row
+	 */
+	std::vector<const Field*> columnFields;
+
 	char* lastErrorMsg = nullptr;
 	int affectedRows = -1;
 	int cols = -1;
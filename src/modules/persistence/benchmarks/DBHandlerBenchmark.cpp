@@ -0,0 +1,132 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "persistence/DBHandler.h"
+#include "persistence/DBCondition.h"
+#include "core/Var.h"
+#include "core/GameConfig.h"
+#include "core/StringUtil.h"
+#include "core/Common.h"
+#include "TestModel.h"
+#include <vector>
+
+namespace persistence {
+
+/**
+ * @brief Compares the cached prepared statements with binary results against plain text statements
+ * with text results. Needs a running postgres server - see @c AbstractDatabaseTest for the settings.
+ */
+class DBHandlerBenchmark : public app::AbstractBenchmark {
+protected:
+	DBHandler _dbHandler;
+	bool _supported = false;
+
+	bool onInitApp() override {
+		core::Var::get(cfg::DatabaseMinConnections, "1");
+		core::Var::get(cfg::DatabaseMaxConnections, "2");
+		core::Var::get(cfg::DatabaseName, "enginetest");
+		core::Var::get(cfg::DatabaseHost, "localhost");
+		core::Var::get(cfg::DatabasePort, "5432");
+		core::Var::get(cfg::DatabaseUser, "vengi");
+		core::Var::get(cfg::DatabasePassword, "engine");
+		return true;
+	}
+
+public:
+	void SetUp(benchmark::State& state) override {
+		app::AbstractBenchmark::SetUp(state);
+		_supported = _dbHandler.init();
+		if (!_supported) {
+			state.SkipWithError("No database connection");
+			return;
+		}
+		_dbHandler.dropTable(db::TestModel());
+		_dbHandler.createTable(db::TestModel());
+		const int rows = (int)state.range(0);
+		// insert in batches - postgres limits the amount of parameters per statement
+		const int batchSize = 1000;
+		for (int start = 0; start < rows; start += batchSize) {
+			std::vector<db::TestModel> models(core_min(batchSize, rows - start));
+			for (size_t i = 0; i < models.size(); ++i) {
+				db::TestModel& mdl = models[i];
+				const core::String& email = core::string::format("benchmark%i@b.c.d", start + (int)i);
+				mdl.setName(email);
+				mdl.setEmail(email);
+				mdl.setPassword("secret");
+				mdl.setPoints(start + (int)i);
+				mdl.setSomedouble(1.0);
+				mdl.setSomeshort(1);
+				mdl.setRegistrationdate(Timestamp::now());
+			}
+			_dbHandler.insert(models);
+		}
+	}
+
+	void TearDown(benchmark::State& state) override {
+		if (_supported) {
+			_dbHandler.dropTable(db::TestModel());
+		}
+		_dbHandler.shutdown();
+		app::AbstractBenchmark::TearDown(state);
+	}
+
+	void selectAll(benchmark::State& state, bool prepared) {
+		if (!_supported) {
+			return;
+		}
+		_dbHandler.setPreparedStatements(prepared);
+		int64_t rows = 0;
+		for (auto _ : state) {
+			_dbHandler.select(db::TestModel(), DBConditionOne(), [&] (db::TestModel&& model) {
+				benchmark::DoNotOptimize(model.points());
+				++rows;
+			});
+		}
+		state.SetItemsProcessed(rows);
+	}
+
+	void selectById(benchmark::State& state, bool prepared) {
+		if (!_supported) {
+			return;
+		}
+		_dbHandler.setPreparedStatements(prepared);
+		const int amount = (int)state.range(0);
+		int64_t rows = 0;
+		int64_t id = 1;
+		for (auto _ : state) {
+			db::TestModel model;
+			if (_dbHandler.select(model, db::DBConditionTestModelId(id))) {
+				++rows;
+			}
+			id = id % amount + 1;
+		}
+		state.SetItemsProcessed(rows);
+	}
+};
+
+BENCHMARK_DEFINE_F(DBHandlerBenchmark, SelectAllText)(benchmark::State& state) {
+	selectAll(state, false);
+}
+
+BENCHMARK_DEFINE_F(DBHandlerBenchmark, SelectAllPrepared)(benchmark::State& state) {
+	selectAll(state, true);
+}
+
+BENCHMARK_DEFINE_F(DBHandlerBenchmark, SelectByIdText)(benchmark::State& state) {
+	selectById(state, false);
+}
+
+BENCHMARK_DEFINE_F(DBHandlerBenchmark, SelectByIdPrepared)(benchmark::State& state) {
+	selectById(state, true);
+}
+
+BENCHMARK_REGISTER_F(DBHandlerBenchmark, SelectAllText)->Arg(100)->Arg(10000);
+BENCHMARK_REGISTER_F(DBHandlerBenchmark, SelectAllPrepared)->Arg(100)->Arg(10000);
+BENCHMARK_REGISTER_F(DBHandlerBenchmark, SelectByIdText)->Arg(1000);
+BENCHMARK_REGISTER_F(DBHandlerBenchmark, SelectByIdPrepared)->Arg(1000);
+
+}
+
+BENCHMARK_MAIN();
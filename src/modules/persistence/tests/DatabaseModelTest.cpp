@@ -150,6 +150,32 @@ TEST_F(DatabaseModelTest, testCreateModels) {
 	}
 }
 
+TEST_F(DatabaseModelTest, testCreateModelsTextResults) {
+	if (!_supported) {
+		return;
+	}
+	_dbHandler.setPreparedStatements(false);
+	int64_t id = -1L;
+	for (int i = 0; i < 5; ++i) {
+		createModel(core::string::format("testCreateModelsTextResults%i@b.c.d", i), "secret", id);
+	}
+}
+
+TEST_F(DatabaseModelTest, testBinaryResultConversion) {
+	const uint8_t int2[] = {0xFF, 0xFE};
+	EXPECT_EQ(-2, State::binaryToInt((const char*)int2, sizeof(int2)));
+	const uint8_t int4[] = {0x00, 0x01, 0x00, 0x02};
+	EXPECT_EQ(65538, State::binaryToInt((const char*)int4, sizeof(int4)));
+	const uint8_t int8[] = {0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00};
+	EXPECT_EQ(INT64_C(4294967296), State::binaryToInt((const char*)int8, sizeof(int8)));
+	// 1.5 as big endian float8
+	const uint8_t float8[] = {0x3F, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+	EXPECT_DOUBLE_EQ(1.5, State::binaryToDouble((const char*)float8, sizeof(float8)));
+	// -2.0 as big endian float4
+	const uint8_t float4[] = {0xC0, 0x00, 0x00, 0x00};
+	EXPECT_DOUBLE_EQ(-2.0, State::binaryToDouble((const char*)float4, sizeof(float4)));
+}
+
 TEST_F(DatabaseModelTest, testSelectAll) {
 	if (!_supported) {
 		return;
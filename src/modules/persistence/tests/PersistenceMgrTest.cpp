@@ -124,6 +124,37 @@ TEST_F(PersistenceMgrTest, testSavableDelete) {
 	update(mgr, mdl);
 }
 
+TEST_F(PersistenceMgrTest, testSavableMultipleModels) {
+	if (!_supported) {
+		return;
+	}
+	PersistenceMgr mgr(_dbHandler);
+	EXPECT_TRUE(mgr.init());
+	EXPECT_TRUE(mgr.registerSavable(FourCC('F','O','O','O'), this));
+	const db::TestModel mdl1 = create(1, "1");
+	const db::TestModel mdl2 = create(2, "2");
+	const db::TestModel mdl3 = create(3, "3");
+	_dirtyModels.push_back(&mdl1);
+	_dirtyModels.push_back(&mdl2);
+	_dirtyModels.push_back(&mdl3);
+	mgr.update(0l);
+	EXPECT_EQ(3, mgr.stats().written);
+	EXPECT_EQ(0, mgr.stats().pending);
+	EXPECT_EQ(0, mgr.stats().failed);
+	EXPECT_EQ(3, _dbHandler->count(db::TestModel(), DBConditionOne()));
+
+	db::TestModel del1 = mdl1;
+	del1.flagForDelete();
+	db::TestModel del3 = mdl3;
+	del3.flagForDelete();
+	_dirtyModels.push_back(&del1);
+	_dirtyModels.push_back(&del3);
+	mgr.update(0l);
+	EXPECT_EQ(1, _dbHandler->count(db::TestModel(), DBConditionOne()));
+	EXPECT_TRUE(mgr.unregisterSavable(FourCC('F','O','O','O'), this));
+	mgr.shutdown();
+}
+
 TEST_F(PersistenceMgrTest, testSavableRelativeUpdate) {
 	if (!_supported) {
 		return;
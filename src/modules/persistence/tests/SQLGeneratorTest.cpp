@@ -22,6 +22,26 @@ TEST_F(SQLGeneratorTest, testDeleteWithPk) {
 	ASSERT_EQ(R"(DELETE FROM "public"."test" WHERE "id" = $1)", createDeleteStatement(model));
 }
 
+TEST_F(SQLGeneratorTest, testDeleteMultipleWithPk) {
+	db::TestModel model1;
+	model1.setId(1L);
+	db::TestModel model2;
+	model2.setId(2L);
+	db::TestModel withoutPk;
+	const std::vector<const Model*> models {&model1, &withoutPk, &model2};
+	BindParam params(3);
+	ASSERT_EQ(R"(DELETE FROM "public"."test" WHERE ("id" = $1) OR ("id" = $2))", createDeleteStatement(models, &params));
+	ASSERT_EQ(2, params.position);
+	ASSERT_STREQ("1", params.values[0]);
+	ASSERT_STREQ("2", params.values[1]);
+}
+
+TEST_F(SQLGeneratorTest, testDeleteMultipleWithoutPk) {
+	db::TestModel model;
+	const std::vector<const Model*> models {&model};
+	ASSERT_EQ("", createDeleteStatement(models));
+}
+
 TEST_F(SQLGeneratorTest, testDrop) {
 	ASSERT_EQ(R"(DROP TABLE IF EXISTS "public"."test";DROP SEQUENCE IF EXISTS "public"."test_id_seq";)",
 			createDropTableStatement(db::TestModel()));
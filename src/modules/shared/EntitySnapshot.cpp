@@ -0,0 +1,138 @@
+/**
+ * @file
+ */
+
+#include "EntitySnapshot.h"
+#include "core/Assert.h"
+#include "core/Trace.h"
+#include <glm/common.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+
+namespace shared {
+
+static inline int32_t quantizePosition(float v) {
+	return (int32_t)glm::round(v * SnapshotPositionScale);
+}
+
+QuantizedEntityState QuantizedEntityState::quantize(const glm::vec3& pos, float orientation, network::Animation animation) {
+	QuantizedEntityState state;
+	state.x = quantizePosition(pos.x);
+	state.y = quantizePosition(pos.y);
+	state.z = quantizePosition(pos.z);
+	const float normalized = glm::mod(orientation, glm::two_pi<float>()) / glm::two_pi<float>();
+	state.rotation = (uint16_t)((uint32_t)glm::round(normalized * 65536.0f) & 0xFFFFu);
+	state.animation = (uint8_t)animation;
+	return state;
+}
+
+glm::vec3 QuantizedEntityState::pos() const {
+	return glm::vec3((float)x, (float)y, (float)z) / SnapshotPositionScale;
+}
+
+float QuantizedEntityState::orientation() const {
+	return (float)rotation / 65536.0f * glm::two_pi<float>();
+}
+
+static inline bool entryLess(const EntitySnapshotState::Entry& entry, int64_t id) {
+	return entry.first < id;
+}
+
+const QuantizedEntityState* EntitySnapshotState::find(int64_t id) const {
+	auto i = std::lower_bound(entities.begin(), entities.end(), id, entryLess);
+	if (i == entities.end() || i->first != id) {
+		return nullptr;
+	}
+	return &i->second;
+}
+
+void EntitySnapshotState::add(int64_t id, const QuantizedEntityState& state) {
+	core_assert(entities.empty() || entities.back().first < id);
+	entities.emplace_back(id, state);
+}
+
+void EntitySnapshotState::clear(uint32_t newSequence) {
+	sequence = newSequence;
+	entities.clear();
+}
+
+const EntitySnapshotState* EntitySnapshotHistory::get(uint32_t sequence) const {
+	if (sequence == 0u) {
+		return nullptr;
+	}
+	const EntitySnapshotState& state = _states[sequence % SnapshotHistorySize];
+	if (state.sequence != sequence) {
+		return nullptr;
+	}
+	return &state;
+}
+
+EntitySnapshotState& EntitySnapshotHistory::next(uint32_t sequence) {
+	core_assert(sequence > _lastSequence);
+	_lastSequence = sequence;
+	EntitySnapshotState& state = _states[sequence % SnapshotHistorySize];
+	state.clear(sequence);
+	return state;
+}
+
+void EntitySnapshotHistory::reset() {
+	for (EntitySnapshotState& state : _states) {
+		state.clear(0u);
+	}
+	_lastSequence = 0u;
+}
+
+bool EntitySnapshotHistory::apply(const network::EntitySnapshot* snapshot, const Visitor& visitor) {
+	core_trace_scoped(EntitySnapshotApply);
+	const uint32_t sequence = snapshot->sequence();
+	if (sequence <= _lastSequence) {
+		return false;
+	}
+	const uint32_t baseSequence = snapshot->base();
+	const EntitySnapshotState* base = nullptr;
+	if (baseSequence != 0u) {
+		base = get(baseSequence);
+		if (base == nullptr) {
+			return false;
+		}
+	}
+
+	// the base slot might get reused by the new snapshot - so build the new state before storing it
+	EntitySnapshotState current;
+	current.sequence = sequence;
+	if (base != nullptr) {
+		current.entities = base->entities;
+	}
+	_decoded.clear();
+	for (const network::EntityDelta* delta : *snapshot->entities()) {
+		const int64_t id = delta->id();
+		QuantizedEntityState state;
+		auto i = std::lower_bound(current.entities.begin(), current.entities.end(), id, entryLess);
+		const bool known = i != current.entities.end() && i->first == id;
+		if (!delta->absolute()) {
+			if (!known) {
+				return false;
+			}
+			state = i->second;
+		}
+		state.x += delta->x();
+		state.y += delta->y();
+		state.z += delta->z();
+		state.rotation = (uint16_t)(state.rotation + delta->rotation());
+		state.animation = (uint8_t)(state.animation + delta->animation());
+		if (known) {
+			i->second = state;
+		} else {
+			current.entities.insert(i, EntitySnapshotState::Entry(id, state));
+		}
+		_decoded.emplace_back(id, state);
+	}
+	EntitySnapshotState& target = next(sequence);
+	target.entities = std::move(current.entities);
+	for (const EntitySnapshotState::Entry& entry : _decoded) {
+		visitor(entry.first, entry.second);
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "ServerMessages_generated.h"
+#include <glm/vec3.hpp>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+/**
+ * Shared between client and server
+ */
+namespace shared {
+
+/**
+ * @brief The enet channel that is used for the unreliable sequenced @c network::EntitySnapshot messages
+ */
+constexpr int SnapshotChannel = 1;
+/**
+ * @brief Positions are transferred in fixed point with this amount of steps per voxel
+ */
+constexpr float SnapshotPositionScale = 64.0f;
+/**
+ * @brief The amount of snapshots that are kept on both sides to delta encode against
+ */
+constexpr uint32_t SnapshotHistorySize = 32u;
+
+/**
+ * @brief The quantized state of an entity as it is transferred in the @c network::EntitySnapshot
+ */
+struct QuantizedEntityState {
+	int32_t x = 0;
+	int32_t y = 0;
+	int32_t z = 0;
+	uint16_t rotation = 0u;
+	uint8_t animation = 0u;
+
+	inline bool operator==(const QuantizedEntityState& rhs) const {
+		return x == rhs.x && y == rhs.y && z == rhs.z && rotation == rhs.rotation && animation == rhs.animation;
+	}
+
+	inline bool operator!=(const QuantizedEntityState& rhs) const {
+		return !(*this == rhs);
+	}
+
+	glm::vec3 pos() const;
+	float orientation() const;
+
+	static QuantizedEntityState quantize(const glm::vec3& pos, float orientation, network::Animation animation);
+};
+
+/**
+ * @brief The full (absolute) quantized entity states of one snapshot - sorted by entity id
+ */
+struct EntitySnapshotState {
+	using Entry = std::pair<int64_t, QuantizedEntityState>;
+	uint32_t sequence = 0u;
+	std::vector<Entry> entities;
+
+	const QuantizedEntityState* find(int64_t id) const;
+	/**
+	 * @note The entities must be added in ascending id order
+	 */
+	void add(int64_t id, const QuantizedEntityState& state);
+	void clear(uint32_t newSequence);
+};
+
+/**
+ * @brief Ring buffer of the last @c SnapshotHistorySize snapshots
+ */
+class EntitySnapshotHistory {
+private:
+	EntitySnapshotState _states[SnapshotHistorySize];
+	std::vector<EntitySnapshotState::Entry> _decoded;
+	uint32_t _lastSequence = 0u;
+public:
+	/**
+	 * @return @c nullptr if the given sequence is no longer (or not yet) part of the history
+	 */
+	const EntitySnapshotState* get(uint32_t sequence) const;
+	EntitySnapshotState& next(uint32_t sequence);
+
+	uint32_t lastSequence() const;
+
+	using Visitor = std::function<void(int64_t id, const QuantizedEntityState& state)>;
+	/**
+	 * @brief Reconstructs the absolute entity states of the given snapshot message and stores them in the history
+	 * @param[in] visitor Called for every entity that is part of the snapshot message
+	 * @return @c false if the snapshot is outdated or the base snapshot is not known. The snapshot
+	 * must not be acknowledged in this case.
+	 */
+	bool apply(const network::EntitySnapshot* snapshot, const Visitor& visitor);
+
+	void reset();
+};
+
+inline uint32_t EntitySnapshotHistory::lastSequence() const {
+	return _lastSequence;
+}
+
+}
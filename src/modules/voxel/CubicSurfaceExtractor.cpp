@@ -4,6 +4,8 @@
 
 #include "CubicSurfaceExtractor.h"
 #include "core/Common.h"
+#include "core/ScopedPtr.h"
+#include <glm/vector_relational.hpp>
 
 namespace voxel {
 
@@ -118,6 +120,25 @@ SDL_FORCE_INLINE bool isQuadFlipped(const VoxelVertex& v00, const VoxelVertex& v
 	return v00.ambientOcclusion + v11.ambientOcclusion > v01.ambientOcclusion + v10.ambientOcclusion;
 }
 
+static void addQuad(Mesh* result, const Quad& quad) {
+	const IndexType i0 = quad.vertices[0];
+	const IndexType i1 = quad.vertices[1];
+	const IndexType i2 = quad.vertices[2];
+	const IndexType i3 = quad.vertices[3];
+	const VoxelVertex& v00 = result->getVertex(i3);
+	const VoxelVertex& v01 = result->getVertex(i0);
+	const VoxelVertex& v10 = result->getVertex(i2);
+	const VoxelVertex& v11 = result->getVertex(i1);
+
+	if (isQuadFlipped(v00, v01, v10, v11)) {
+		result->addTriangle(i1, i2, i3);
+		result->addTriangle(i1, i3, i0);
+	} else {
+		result->addTriangle(i0, i1, i2);
+		result->addTriangle(i0, i2, i3);
+	}
+}
+
 void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVector& vecListQuads) {
 	core_trace_scoped(GenerateMeshify);
 	for (QuadList& listQuads : vecListQuads) {
@@ -130,22 +151,7 @@ void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVecto
 		}
 
 		for (const Quad& quad : listQuads) {
-			const IndexType i0 = quad.vertices[0];
-			const IndexType i1 = quad.vertices[1];
-			const IndexType i2 = quad.vertices[2];
-			const IndexType i3 = quad.vertices[3];
-			const VoxelVertex& v00 = result->getVertex(i3);
-			const VoxelVertex& v01 = result->getVertex(i0);
-			const VoxelVertex& v10 = result->getVertex(i2);
-			const VoxelVertex& v11 = result->getVertex(i1);
-
-			if (isQuadFlipped(v00, v01, v10, v11)) {
-				result->addTriangle(i1, i2, i3);
-				result->addTriangle(i1, i3, i0);
-			} else {
-				result->addTriangle(i0, i1, i2);
-				result->addTriangle(i0, i2, i3);
-			}
+			addQuad(result, quad);
 		}
 	}
 }
@@ -189,4 +195,259 @@ IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t z, cons
 	return 0; //Should never happen.
 }
 
+static inline int lowestBit(uint64_t mask) {
+	core_assert(mask != 0u);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(mask);
+#else
+	int idx = 0;
+	while ((mask & 1u) == 0u) {
+		mask >>= 1;
+		++idx;
+	}
+	return idx;
+#endif
+}
+
+static inline bool isOpaque(const Voxel& voxel) {
+	const VoxelType material = voxel.getMaterial();
+	return !isAir(material) && !isTransparent(material);
+}
+
+namespace {
+
+/**
+ * @brief The bitmasks of one tile of @c extractBinaryGreedyMesh()
+ *
+ * The columns are stored for each axis and indexed by the padded coordinates of the other two axes - the bit
+ * index is the padded coordinate on the column axis.
+ */
+class BinaryTile {
+private:
+	static constexpr int Size = BinaryMeshTilePaddedSize;
+	// the axes that are spanned by the faces that are perpendicular to the given axis
+	static constexpr int UAxis[] = {1, 0, 0};
+	static constexpr int VAxis[] = {2, 2, 1};
+
+	const Voxel* _voxels;
+	const glm::ivec3 _size;
+	const glm::ivec3 _padded;
+	const glm::ivec3 _tileOffset;
+	const glm::ivec3 _translate;
+	const bool _ambientOcclusion;
+	Mesh* _result;
+
+	uint64_t _columns[3][Size * Size];
+	// the faces of all planes of one axis for both directions - indexed by the plane and u, the bit index is v
+	uint64_t _planes[2][Size][Size];
+	// the visible faces of one plane - indexed by u, the bit index is v
+	uint64_t _faces[Size];
+	// color, flags and the ambient occlusion of the four corners for each face of the plane
+	uint32_t _keys[Size * Size];
+
+	inline uint64_t column(int axis, int u, int v) const {
+		return _columns[axis][u * Size + v];
+	}
+
+	inline const Voxel& voxel(int x, int y, int z) const {
+		return _voxels[(z * _padded.x + x) * _padded.y + y];
+	}
+
+	inline bool occluded(int axis, int layer, int u, int v) const {
+		return (column(axis, u, v) >> layer) & 1u;
+	}
+
+	uint32_t key(int axis, int solidLayer, int airLayer, int u, int v) const {
+		glm::ivec3 pos;
+		pos[axis] = solidLayer;
+		pos[UAxis[axis]] = u;
+		pos[VAxis[axis]] = v;
+		const Voxel& material = voxel(pos.x, pos.y, pos.z);
+		uint32_t k = material.getColor() | (material.getFlags() << 8);
+		if (!_ambientOcclusion) {
+			return k | (0xffu << 11);
+		}
+		const bool uMinus = occluded(axis, airLayer, u - 1, v);
+		const bool uPlus = occluded(axis, airLayer, u + 1, v);
+		const bool vMinus = occluded(axis, airLayer, u, v - 1);
+		const bool vPlus = occluded(axis, airLayer, u, v + 1);
+		k |= vertexAmbientOcclusion(uMinus, vMinus, occluded(axis, airLayer, u - 1, v - 1)) << 11;
+		k |= vertexAmbientOcclusion(uMinus, vPlus, occluded(axis, airLayer, u - 1, v + 1)) << 13;
+		k |= vertexAmbientOcclusion(uPlus, vMinus, occluded(axis, airLayer, u + 1, v - 1)) << 15;
+		k |= vertexAmbientOcclusion(uPlus, vPlus, occluded(axis, airLayer, u + 1, v + 1)) << 17;
+		return k;
+	}
+
+	/**
+	 * @param cu @c 0 for the lower and @c 1 for the upper u corner
+	 * @param cv @c 0 for the lower and @c 1 for the upper v corner
+	 */
+	IndexType addCorner(int axis, int plane, int u, int v, int cu, int cv, uint32_t k) {
+		glm::ivec3 pos;
+		pos[axis] = _tileOffset[axis] + plane - 1;
+		pos[UAxis[axis]] = _tileOffset[UAxis[axis]] + u - 1;
+		pos[VAxis[axis]] = _tileOffset[VAxis[axis]] + v - 1;
+		VoxelVertex vertex;
+		vertex.position = pos + _translate;
+		vertex.colorIndex = k & 0xffu;
+		vertex.ambientOcclusion = (k >> (11 + (cu * 2 + cv) * 2)) & 3u;
+		vertex.flags = (k >> 8) & 7u;
+		vertex.padding = 0u;
+		return _result->addVertex(vertex);
+	}
+
+	/**
+	 * @brief Emits the quad for the faces u to u + h and v to v + w of the given plane. The winding matches
+	 * the quads of @c extractCubicMesh()
+	 */
+	void addQuad(int axis, bool negative, int plane, int u, int v, int h, int w, uint32_t k) {
+		const IndexType v00 = addCorner(axis, plane, u, v, 0, 0, k);
+		const IndexType v01 = addCorner(axis, plane, u, v + w, 0, 1, k);
+		const IndexType v11 = addCorner(axis, plane, u + h, v + w, 1, 1, k);
+		const IndexType v10 = addCorner(axis, plane, u + h, v, 1, 0, k);
+		if (negative != (axis == 1)) {
+			voxel::addQuad(_result, Quad(v00, v01, v11, v10));
+		} else {
+			voxel::addQuad(_result, Quad(v00, v10, v11, v01));
+		}
+	}
+
+	/**
+	 * @brief Greedy merges the faces of one plane - runs along v are extended along u as long as the
+	 * faces and their keys match
+	 */
+	void mergePlane(int axis, bool negative, int plane) {
+		const int su = _size[UAxis[axis]];
+		const int solidLayer = negative ? plane : plane - 1;
+		const int airLayer = negative ? plane - 1 : plane;
+		for (int u = 1; u <= su; ++u) {
+			uint64_t row = _faces[u];
+			while (row != 0u) {
+				const int v = lowestBit(row);
+				row &= row - 1u;
+				_keys[u * Size + v] = key(axis, solidLayer, airLayer, u, v);
+			}
+		}
+		for (int u = 1; u <= su; ++u) {
+			while (_faces[u] != 0u) {
+				const int v = lowestBit(_faces[u]);
+				const uint32_t k = _keys[u * Size + v];
+				int w = 1;
+				while (((_faces[u] >> (v + w)) & 1u) && _keys[u * Size + v + w] == k) {
+					++w;
+				}
+				const uint64_t run = ((uint64_t(1) << w) - 1u) << v;
+				int h = 1;
+				for (; u + h <= su; ++h) {
+					if ((_faces[u + h] & run) != run) {
+						break;
+					}
+					const uint32_t *keys = &_keys[(u + h) * Size + v];
+					int i = 0;
+					while (i < w && keys[i] == k) {
+						++i;
+					}
+					if (i != w) {
+						break;
+					}
+				}
+				for (int i = 0; i < h; ++i) {
+					_faces[u + i] &= ~run;
+				}
+				addQuad(axis, negative, plane, u, v, h, w, k);
+			}
+		}
+	}
+
+public:
+	BinaryTile(const Voxel* voxels, const glm::ivec3& size, const glm::ivec3& tileOffset, Mesh* result, const glm::ivec3& translate,
+			bool ambientOcclusion) :
+			_voxels(voxels), _size(size), _padded(size + 2), _tileOffset(tileOffset), _translate(translate),
+			_ambientOcclusion(ambientOcclusion), _result(result) {
+	}
+
+	/**
+	 * @return @c false if the tile doesn't contain any opaque voxel
+	 */
+	bool fill() {
+		core_trace_scoped(FillBinaryTile);
+		core_memset(_columns, 0, sizeof(_columns));
+		const Voxel* voxel = _voxels;
+		uint64_t any = 0u;
+		for (int z = 0; z < _padded.z; ++z) {
+			for (int x = 0; x < _padded.x; ++x) {
+				uint64_t yColumn = 0u;
+				for (int y = 0; y < _padded.y; ++y, ++voxel) {
+					if (!isOpaque(*voxel)) {
+						continue;
+					}
+					yColumn |= uint64_t(1) << y;
+					_columns[0][y * Size + z] |= uint64_t(1) << x;
+					_columns[2][x * Size + y] |= uint64_t(1) << z;
+				}
+				_columns[1][x * Size + z] = yColumn;
+				any |= yColumn;
+			}
+		}
+		return any != 0u;
+	}
+
+	void meshify() {
+		core_trace_scoped(MeshifyBinaryTile);
+		for (int axis = 0; axis < 3; ++axis) {
+			const int sa = _size[axis];
+			const int su = _size[UAxis[axis]];
+			const int sv = _size[VAxis[axis]];
+			// only the planes between the lower border and the last cell belong to this tile
+			const uint64_t planeMask = ((uint64_t(1) << sa) - 1u) << 1;
+			core_memset(_planes, 0, sizeof(_planes));
+			for (int u = 1; u <= su; ++u) {
+				for (int v = 1; v <= sv; ++v) {
+					const uint64_t c = column(axis, u, v);
+					// the voxel is opaque and the one in front of it (lower coordinate) isn't
+					uint64_t negativeFaces = c & ~(c << 1) & planeMask;
+					// the voxel with the lower coordinate is opaque and this one isn't
+					uint64_t positiveFaces = (c << 1) & ~c & planeMask;
+					while (negativeFaces != 0u) {
+						_planes[0][lowestBit(negativeFaces)][u] |= uint64_t(1) << v;
+						negativeFaces &= negativeFaces - 1u;
+					}
+					while (positiveFaces != 0u) {
+						_planes[1][lowestBit(positiveFaces)][u] |= uint64_t(1) << v;
+						positiveFaces &= positiveFaces - 1u;
+					}
+				}
+			}
+			for (int direction = 0; direction < 2; ++direction) {
+				for (int plane = 1; plane <= sa; ++plane) {
+					bool empty = true;
+					for (int u = 1; u <= su; ++u) {
+						_faces[u] = _planes[direction][plane][u];
+						empty &= _faces[u] == 0u;
+					}
+					if (!empty) {
+						mergePlane(axis, direction == 0, plane);
+					}
+				}
+			}
+		}
+	}
+};
+
+constexpr int BinaryTile::UAxis[];
+constexpr int BinaryTile::VAxis[];
+
+}
+
+void meshifyBinaryTile(const Voxel* voxels, const glm::ivec3& size, const glm::ivec3& tileOffset, Mesh* result,
+		const glm::ivec3& translate, bool ambientOcclusion) {
+	core_assert(glm::all(glm::lessThanEqual(size, glm::ivec3(BinaryMeshTileSize))));
+	// the masks are too big for the stack
+	core::ScopedPtr<BinaryTile> tile(new BinaryTile(voxels, size, tileOffset, result, translate, ambientOcclusion));
+	if (!tile->fill()) {
+		return;
+	}
+	tile->meshify();
+}
+
 }
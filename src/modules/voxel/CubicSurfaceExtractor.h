@@ -17,6 +17,7 @@
 #include "Face.h"
 #include <glm/fwd.hpp>
 #include <glm/vec3.hpp>
+#include <glm/common.hpp>
 #include <list>
 #include <vector>
 
@@ -100,6 +101,23 @@ extern IndexType addVertex(bool reuseVertices, uint32_t x, uint32_t y, uint32_t
 
 extern void meshify(Mesh* result, bool mergeQuads, bool ambientOcclusion, QuadListVector& vecListQuads);
 
+/**
+ * @brief The max amount of cells per axis that @c extractBinaryGreedyMesh() processes at once. Together with the
+ * one voxel border that is needed for the neighbour and ambient occlusion lookups a column fits into 64 bits.
+ */
+constexpr int BinaryMeshTileSize = 62;
+constexpr int BinaryMeshTilePaddedSize = BinaryMeshTileSize + 2;
+
+/**
+ * @brief Meshes one tile of @c extractBinaryGreedyMesh()
+ * @param[in] voxels The voxels of the tile including the one voxel border on each side. They are stored
+ * in columns along the y axis - the index is @code ((z * (size.x + 2)) + x) * (size.y + 2) + y @endcode
+ * @param[in] size The amount of cells of the tile without the border - at most @c BinaryMeshTileSize per axis
+ * @param[in] tileOffset The lower corner of the tile relative to the lower corner of the extracted region
+ */
+extern void meshifyBinaryTile(const Voxel* voxels, const glm::ivec3& size, const glm::ivec3& tileOffset, Mesh* result,
+		const glm::ivec3& translate, bool ambientOcclusion);
+
 /**
  * The CubicSurfaceExtractor creates a mesh in which each voxel appears to be rendered as a cube
  *
@@ -378,7 +396,7 @@ void extractCubicMesh(VolumeType* volData, const Region& region, Mesh* result, I
 
 				// Z [F] BEHIND
 				if (isQuadNeeded(voxelBeforeMaterial, voxelCurrentMaterial, FaceNames::PositiveZ)) {
-					const VoxelType _voxelRightBehind      = volumeSampler.peekVoxel1px0py1pz().getMaterial();
+					const VoxelType _voxelRightBehind      = volumeSampler.peekVoxel1px0py0pz().getMaterial();
 					const VoxelType _voxelAboveBehind      = volumeSampler.peekVoxel0px1py0pz().getMaterial();
 					const VoxelType _voxelAboveRightBehind = volumeSampler.peekVoxel1px1py0pz().getMaterial();
 					const VoxelType _voxelBelowRightBehind = volumeSampler.peekVoxel1px1ny0pz().getMaterial();
@@ -416,6 +434,58 @@ void extractCubicMesh(VolumeType* volData, const Region& region, Mesh* result, I
 	result->compressIndices();
 }
 
+/**
+ * @brief Alternative to @c extractCubicMesh() that works on occupancy bitmasks instead of sampling the neighbours of each voxel.
+ *
+ * Each voxel of the region (and the one voxel border around it) is only fetched once. The opaque voxels are stored as 64 bit
+ * columns along each axis, the visible faces of a whole column are computed with a shift and a mask and the quads are greedy
+ * merged directly from the per plane face masks. The ambient occlusion values are looked up in the same masks.
+ *
+ * The faces are placed by the same rules as in @c extractCubicMesh() with @c IsQuadNeeded - and the vertices have the same format.
+ * Faces are only merged if the color, the flags and the ambient occlusion values of all four corners match. The vertices are not
+ * shared between quads. Regions that are bigger than @c BinaryMeshTileSize are processed in tiles and the quads are not merged
+ * across tile borders.
+ */
+template<typename VolumeType>
+void extractBinaryGreedyMesh(VolumeType* volData, const Region& region, Mesh* result, const glm::ivec3& translate, bool ambientOcclusion = true) {
+	core_trace_scoped(ExtractBinaryGreedyMesh);
+
+	result->clear();
+	const glm::ivec3& offset = region.getLowerCorner();
+	const glm::ivec3& upper = region.getUpperCorner();
+	result->setOffset(offset);
+
+	std::vector<Voxel> voxels(BinaryMeshTilePaddedSize * BinaryMeshTilePaddedSize * BinaryMeshTilePaddedSize);
+	typename VolumeType::Sampler volumeSampler(volData);
+
+	for (int32_t tileZ = offset.z; tileZ <= upper.z; tileZ += BinaryMeshTileSize) {
+		for (int32_t tileX = offset.x; tileX <= upper.x; tileX += BinaryMeshTileSize) {
+			for (int32_t tileY = offset.y; tileY <= upper.y; tileY += BinaryMeshTileSize) {
+				const glm::ivec3 tileLower(tileX, tileY, tileZ);
+				const glm::ivec3 size = glm::min(upper - tileLower + 1, glm::ivec3(BinaryMeshTileSize));
+				{
+					core_trace_scoped(FillTile);
+					Voxel* voxel = voxels.data();
+					for (int32_t z = tileLower.z - 1; z <= tileLower.z + size.z; ++z) {
+						for (int32_t x = tileLower.x - 1; x <= tileLower.x + size.x; ++x) {
+							volumeSampler.setPosition(x, tileLower.y - 1, z);
+							for (int32_t y = tileLower.y - 1; y <= tileLower.y + size.y; ++y) {
+								*voxel++ = volumeSampler.voxel();
+								if (core_likely(y != tileLower.y + size.y)) {
+									volumeSampler.movePositiveY();
+								}
+							}
+						}
+					}
+				}
+				meshifyBinaryTile(voxels.data(), size, tileLower - offset, result, translate, ambientOcclusion);
+			}
+		}
+	}
+
+	result->compressIndices();
+}
+
 }
 
 #undef BUFFERED_SAMPLER
@@ -29,6 +29,8 @@ Mesh::Mesh(Mesh&& other) noexcept {
 	other._compressedIndices = nullptr;
 	_compressedIndexSize = other._compressedIndexSize;
 	other._compressedIndexSize = 0u;
+	_compressedIndicesCapacity = other._compressedIndicesCapacity;
+	other._compressedIndicesCapacity = 0u;
 	_offset = other._offset;
 	_mayGetResized = other._mayGetResized;
 }
@@ -38,10 +40,12 @@ Mesh::Mesh(const Mesh& other) {
 	_vecVertices = other._vecVertices;
 	_compressedIndexSize = other._compressedIndexSize;
 	if (other._compressedIndices != nullptr) {
-		_compressedIndices = (uint8_t*)core_malloc(_vecIndices.size() * _compressedIndexSize);
-		core_memcpy(_compressedIndices, other._compressedIndices, _vecIndices.size() * _compressedIndexSize);
+		_compressedIndicesCapacity = _vecIndices.size() * _compressedIndexSize;
+		_compressedIndices = (uint8_t*)core_malloc(_compressedIndicesCapacity);
+		core_memcpy(_compressedIndices, other._compressedIndices, _compressedIndicesCapacity);
 	} else {
 		_compressedIndices = nullptr;
+		_compressedIndicesCapacity = 0u;
 	}
 	_offset = other._offset;
 	_mayGetResized = other._mayGetResized;
@@ -56,10 +60,12 @@ Mesh& Mesh::operator=(const Mesh& other) {
 	_compressedIndexSize = other._compressedIndexSize;
 	core_free(_compressedIndices);
 	if (other._compressedIndices != nullptr) {
-		_compressedIndices = (uint8_t*)core_malloc(_vecIndices.size() * _compressedIndexSize);
-		core_memcpy(_compressedIndices, other._compressedIndices, _vecIndices.size() * _compressedIndexSize);
+		_compressedIndicesCapacity = _vecIndices.size() * _compressedIndexSize;
+		_compressedIndices = (uint8_t*)core_malloc(_compressedIndicesCapacity);
+		core_memcpy(_compressedIndices, other._compressedIndices, _compressedIndicesCapacity);
 	} else {
 		_compressedIndices = nullptr;
+		_compressedIndicesCapacity = 0u;
 	}
 	_offset = other._offset;
 	_mayGetResized = other._mayGetResized;
@@ -74,6 +80,8 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
 	other._compressedIndices = nullptr;
 	_compressedIndexSize = other._compressedIndexSize;
 	other._compressedIndexSize = 4u;
+	_compressedIndicesCapacity = other._compressedIndicesCapacity;
+	other._compressedIndicesCapacity = 0u;
 	_offset = other._offset;
 	_mayGetResized = other._mayGetResized;
 	return *this;
@@ -199,17 +207,23 @@ void Mesh::removeUnusedVertices() {
 
 void Mesh::compressIndices() {
 	if (_vecIndices.empty()) {
-		core_free(_compressedIndices);
-		_compressedIndices = nullptr;
 		_compressedIndexSize = 0;
 		return;
 	}
 	const size_t maxSize = _vecIndices.size() * sizeof(voxel::IndexType);
-	core_free(_compressedIndices);
-	_compressedIndices = (uint8_t*)core_malloc(maxSize);
+	if (maxSize > _compressedIndicesCapacity) {
+		core_free(_compressedIndices);
+		_compressedIndices = (uint8_t*)core_malloc(maxSize);
+		_compressedIndicesCapacity = maxSize;
+	}
 	util::indexCompress(&_vecIndices.front(), maxSize, _compressedIndexSize, _compressedIndices, maxSize);
 }
 
+size_t Mesh::allocatedBytes() const {
+	return _vecVertices.capacity() * sizeof(VertexArray::value_type) + _vecIndices.capacity() * sizeof(IndexArray::value_type)
+			+ _compressedIndicesCapacity;
+}
+
 bool Mesh::operator<(const Mesh& rhs) const {
 	return glm::all(glm::lessThan(getOffset(), rhs.getOffset()));
 }
@@ -48,10 +48,17 @@ public:
 	void clear();
 	bool isEmpty() const;
 	void removeUnusedVertices();
+	/**
+	 * @note The buffer of the compressed indices is kept and reused for the next call if it is big enough
+	 */
 	void compressIndices();
 
 	const uint8_t* compressedIndices() const;
 	size_t compressedIndexSize() const;
+	/**
+	 * @return The bytes of the allocated vertex, index and compressed index buffers - not just the used part of them
+	 */
+	size_t allocatedBytes() const;
 
 	bool operator<(const Mesh& rhs) const;
 private:
@@ -59,6 +66,7 @@ private:
 	alignas(16) VertexArray _vecVertices;
 	uint8_t *_compressedIndices = nullptr;
 	size_t _compressedIndexSize = 0u;
+	size_t _compressedIndicesCapacity = 0u;
 	glm::ivec3 _offset { 0 };
 	bool _mayGetResized;
 };
@@ -0,0 +1,74 @@
+/**
+ * @file
+ */
+
+#include "MeshPool.h"
+#include "core/Common.h"
+
+namespace voxel {
+
+MeshPool::MeshPool(size_t maxPooledBytes) : _maxPooledBytes(maxPooledBytes) {
+}
+
+Mesh MeshPool::acquire(int vertices, int indices) {
+	const int elements = core_max(vertices, indices);
+	int sizeClass = 0;
+	while (sizeClass < SizeClasses && classSize(sizeClass) < elements) {
+		++sizeClass;
+	}
+	core::ScopedLock lock(_lock);
+	++_stats.acquired;
+	for (int i = sizeClass; i < SizeClasses; ++i) {
+		core::DynamicArray<Mesh>& meshes = _meshes[i];
+		if (meshes.empty()) {
+			continue;
+		}
+		Mesh mesh(core::move(meshes.back()));
+		meshes.pop();
+		++_stats.reused;
+		_stats.pooledBytes -= mesh.allocatedBytes();
+		return mesh;
+	}
+	if (sizeClass == SizeClasses) {
+		// too big to get pooled in a size class - the mesh is pooled in the biggest class on release
+		return Mesh(vertices, indices, true);
+	}
+	return Mesh(classSize(sizeClass), classSize(sizeClass), true);
+}
+
+void MeshPool::release(Mesh&& mesh) {
+	mesh.clear();
+	const size_t elements = core_min(mesh.getVertexVector().capacity(), mesh.getIndexVector().capacity());
+	const size_t bytes = mesh.allocatedBytes();
+	{
+		core::ScopedLock lock(_lock);
+		if (elements >= (size_t)MinClassSize && _stats.pooledBytes + bytes <= _maxPooledBytes) {
+			int sizeClass = 0;
+			while (sizeClass + 1 < SizeClasses && (size_t)classSize(sizeClass + 1) <= elements) {
+				++sizeClass;
+			}
+			_meshes[sizeClass].emplace_back(core::move(mesh));
+			_stats.pooledBytes += bytes;
+			_stats.peakPooledBytes = core_max(_stats.peakPooledBytes, _stats.pooledBytes);
+			return;
+		}
+		++_stats.dropped;
+	}
+	// free the buffers outside of the lock
+	Mesh dropped(core::move(mesh));
+}
+
+void MeshPool::clear() {
+	core::ScopedLock lock(_lock);
+	for (core::DynamicArray<Mesh>& meshes : _meshes) {
+		meshes.release();
+	}
+	_stats.pooledBytes = 0u;
+}
+
+MeshPool::Stats MeshPool::stats() const {
+	core::ScopedLock lock(_lock);
+	return _stats;
+}
+
+}
@@ -0,0 +1,84 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Mesh.h"
+#include "core/Trace.h"
+#include "core/concurrent/Lock.h"
+#include "core/collection/DynamicArray.h"
+
+namespace voxel {
+
+/**
+ * @brief Keeps the buffers of meshes that are no longer needed to hand them out to the next extraction.
+ *
+ * The pooled meshes are sorted into size classes by the amount of vertices and indices they can hold without
+ * a reallocation. @c acquire() returns a pooled mesh of the smallest class that is big enough - or a new mesh
+ * with the size of that class if there is none. Meshes that are given back with @c release() are cleared but
+ * keep their buffers - meshes that grew during the extraction are pooled in the bigger class.
+ *
+ * @note All methods are thread safe.
+ */
+class MeshPool {
+public:
+	struct Stats {
+		/** the amount of @c acquire() calls */
+		int acquired = 0;
+		/** the amount of @c acquire() calls that were served with a pooled mesh */
+		int reused = 0;
+		/** the amount of released meshes that were not pooled because they were too small or the pool was full */
+		int dropped = 0;
+		/** the allocated bytes of the currently pooled meshes */
+		size_t pooledBytes = 0u;
+		/** the max allocated bytes that were pooled at once */
+		size_t peakPooledBytes = 0u;
+
+		inline float reuseRate() const {
+			if (acquired <= 0) {
+				return 0.0f;
+			}
+			return (float)reused / (float)acquired;
+		}
+	};
+
+	/**
+	 * @brief The amount of vertices and indices of the smallest size class - each further class doubles this
+	 */
+	static constexpr int MinClassSize = 1024;
+	static constexpr int SizeClasses = 10;
+
+private:
+	core_trace_mutex(core::Lock, _lock, "MeshPool");
+	core::DynamicArray<Mesh> _meshes[SizeClasses] core_thread_guarded_by(_lock);
+	Stats _stats core_thread_guarded_by(_lock);
+	const size_t _maxPooledBytes;
+
+	static constexpr int classSize(int sizeClass) {
+		return MinClassSize << sizeClass;
+	}
+
+public:
+	/**
+	 * @param maxPooledBytes Released meshes are freed instead of pooled if the pool would hold more than this
+	 */
+	MeshPool(size_t maxPooledBytes = 64u * 1024u * 1024u);
+
+	/**
+	 * @return A cleared mesh that can hold at least the given amount of vertices and indices without a reallocation
+	 */
+	Mesh acquire(int vertices, int indices);
+	/**
+	 * @brief Hand the mesh back after it was uploaded or serialized. Its buffers are freed if it is not pooled.
+	 */
+	void release(Mesh&& mesh);
+	/**
+	 * @brief Frees all pooled meshes
+	 */
+	void clear();
+
+	Stats stats() const;
+};
+
+}
@@ -13,6 +13,9 @@
 
 namespace voxel {
 
+// the writes of the pager while it fills a chunk are no modifications of the volume
+static thread_local int pagingIn = 0;
+
 /**
  * This constructor creates a volume with a fixed size which is specified as a parameter. By default this constructor will not enable paging
  * but you can override this if desired. If you do wish to enable
@@ -112,6 +115,7 @@ void PagedVolume::setVoxel(int32_t uXPos, int32_t uYPos, int32_t uZPos, const Vo
 	const uint32_t yOffset = static_cast<uint32_t>(uYPos & _chunkMask);
 	const uint32_t zOffset = static_cast<uint32_t>(uZPos & _chunkMask);
 	chunk(chunkX, chunkY, chunkZ)->setVoxel(xOffset, yOffset, zOffset, tValue);
+	addModifiedRegion(Region(uXPos, uYPos, uZPos, uXPos, uYPos, uZPos));
 }
 
 /**
@@ -154,7 +158,7 @@ void PagedVolume::setVoxels(int32_t uXPos, int32_t uYPos, int32_t uZPos, int nx,
 				const uint16_t yOffset = static_cast<uint16_t>(y & _chunkMask);
 
 				ChunkPtr chunkPtr = chunk(chunkX, chunkY, chunkZ);
-				const int32_t n = core_min(left, int32_t(chunkPtr->_sideLength));
+				const int32_t n = core_min(left, int32_t(chunkPtr->_sideLength) - yOffset);
 
 				chunkPtr->setVoxels(xOffset, yOffset, zOffset, array, n);
 				left -= n;
@@ -163,14 +167,62 @@ void PagedVolume::setVoxels(int32_t uXPos, int32_t uYPos, int32_t uZPos, int nx,
 			}
 		}
 	}
+	if (amount > 0) {
+		addModifiedRegion(Region(uXPos, uYPos, uZPos, uXPos + nx - 1, uYPos + amount - 1, uZPos + nz - 1));
+	}
+}
+
+void PagedVolume::setTrackModifications(bool track) {
+	_trackModifications = track;
+	if (!track) {
+		core::ScopedLock lock(_modifiedLock);
+		_modifiedRegions.clear();
+	}
+}
+
+static inline int64_t regionVoxels(const Region& region) {
+	return (int64_t)region.getWidthInVoxels() * (int64_t)region.getHeightInVoxels() * (int64_t)region.getDepthInVoxels();
+}
+
+void PagedVolume::addModifiedRegion(const Region& region) {
+	if (pagingIn > 0 || !_trackModifications) {
+		return;
+	}
+	core::ScopedLock lock(_modifiedLock);
+	if (!_modifiedRegions.empty()) {
+		// bulk edits usually write neighbouring voxels one after another - the regions are merged as long as the
+		// union doesn't cover voxels that are part of neither region (which is only the case if they are adjacent)
+		Region& last = _modifiedRegions.back();
+		Region merged = last;
+		merged.accumulate(region);
+		if (regionVoxels(merged) <= regionVoxels(last) + regionVoxels(region)) {
+			last = merged;
+			return;
+		}
+	}
+	_modifiedRegions.push_back(region);
+}
+
+bool PagedVolume::popModifiedRegions(core::DynamicArray<Region>& regions) {
+	core::ScopedLock lock(_modifiedLock);
+	if (_modifiedRegions.empty()) {
+		return false;
+	}
+	regions.append(_modifiedRegions.data(), _modifiedRegions.size());
+	_modifiedRegions.clear();
+	return true;
 }
 
 /**
  * Removes all voxels from memory by removing all chunks. The application has the chance to persist the data via @c Pager::pageOut
  */
 void PagedVolume::flushAll() {
-	core::ScopedWriteLock writeLock(_volumeLock);
-	_chunks.clear();
+	{
+		core::ScopedWriteLock writeLock(_volumeLock);
+		_chunks.clear();
+	}
+	core::ScopedLock lock(_modifiedLock);
+	_modifiedRegions.clear();
 }
 
 /**
@@ -185,7 +237,7 @@ void PagedVolume::deleteOldestChunkIfNeeded() const {
 	ChunkMap::iterator oldestChunk = _chunks.end();
 	uint32_t oldestChunkTimestamp = _timestamper;
 	for (ChunkMap::iterator i = _chunks.begin(); i != _chunks.end(); ++i) {
-		const ChunkPtr& chunk = i->second;
+		const ChunkPtr& chunk = i->value;
 		if (chunk->_chunkLastAccessed < oldestChunkTimestamp) {
 			oldestChunkTimestamp = chunk->_chunkLastAccessed;
 			oldestChunk = i;
@@ -215,7 +267,9 @@ PagedVolume::ChunkPtr PagedVolume::createNewChunk(int32_t chunkX, int32_t chunkY
 
 	// Page the data in
 	// We'll use this later to decide if data needs to be paged out again.
+	++pagingIn;
 	chunk->_dataModified = _pager->pageIn(pctx);
+	--pagingIn;
 	Log::debug("finished creating new chunk at %i:%i:%i", chunkX, chunkY, chunkZ);
 
 	return chunk;
@@ -235,7 +289,7 @@ PagedVolume::ChunkPtr PagedVolume::chunk(int32_t chunkX, int32_t chunkY, int32_t
 		}
 		return chunk;
 	}
-	const ChunkPtr& chunk = i->second;
+	const ChunkPtr& chunk = i->value;
 	chunk->_chunkLastAccessed = ++_timestamper;
 	return chunk;
 }
@@ -11,7 +11,9 @@
 #include "core/Assert.h"
 #include "core/concurrent/ReadWriteLock.h"
 #include "core/concurrent/Atomic.h"
-#include "core/collection/Map.h"
+#include "core/concurrent/Lock.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/HashMap.h"
 #include "core/SharedPtr.h"
 
 namespace voxel {
@@ -237,6 +239,19 @@ public:
 	/** @brief Removes all voxels from memory */
 	void flushAll();
 
+	/**
+	 * @brief Remember the regions of the voxel writes that are done via @c setVoxel() and @c setVoxels()
+	 * @note Writes that happen while the Pager is paging in a chunk (e.g. the world generation) are not
+	 * tracked. Neither are writes via a Sampler.
+	 * @sa popModifiedRegions()
+	 */
+	void setTrackModifications(bool track);
+	/**
+	 * @brief Hands out the regions that were modified since the last call
+	 * @return @c false if nothing was modified
+	 */
+	bool popModifiedRegions(core::DynamicArray<Region>& regions);
+
 	ChunkPtr chunk(const glm::ivec3& pos) const;
 
 	glm::ivec3 chunkPos(int x, int y, int z) const;
@@ -249,6 +264,13 @@ public:
 		return _chunkSideLength;
 	}
 
+	/**
+	 * @return The maximum amount of chunks that are kept in memory
+	 */
+	inline uint32_t chunkCountLimit() const {
+		return _chunkCountLimit;
+	}
+
 protected:
 	/// Copy constructor
 	PagedVolume(const PagedVolume& rhs);
@@ -260,12 +282,13 @@ private:
 	ChunkPtr chunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
 	ChunkPtr createNewChunk(int32_t uChunkX, int32_t uChunkY, int32_t uChunkZ) const;
 	void deleteOldestChunkIfNeeded() const;
+	void addModifiedRegion(const Region& region);
 
 	mutable int32_t _timestamper = 0;
 
 	uint32_t _chunkCountLimit = 0u;
 
-	typedef core::Map<glm::ivec3, ChunkPtr, 64, glm::hash<glm::ivec3>> ChunkMap;
+	typedef core::HashMap<glm::ivec3, ChunkPtr, glm::hash<glm::ivec3>> ChunkMap;
 	mutable ChunkMap _chunks core_thread_guarded_by(_volumeLock);
 
 	// The size of the chunks
@@ -278,6 +301,10 @@ private:
 	Region _region;
 
 	mutable core::ReadWriteLock _volumeLock{"pagedvolume"};
+
+	core::AtomicBool _trackModifications{false};
+	core_trace_mutex(core::Lock, _modifiedLock, "PagedVolumeModified");
+	core::DynamicArray<Region> _modifiedRegions core_thread_guarded_by(_modifiedLock);
 };
 
 inline const Voxel& PagedVolume::Sampler::voxel() const {
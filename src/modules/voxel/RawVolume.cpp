@@ -3,13 +3,22 @@
  */
 
 #include "RawVolume.h"
+#include "RawVolumeSnapshot.h"
 #include "core/Assert.h"
 #include "core/StandardLib.h"
+#include "core/Trace.h"
 #include <glm/common.hpp>
 #include <limits>
 
 namespace voxel {
 
+struct RawVolumeBrickCache {
+	/** The amount of bricks in each direction */
+	glm::ivec3 dimensions;
+	RawVolumeBricks bricks;
+	core::DynamicArray<uint8_t> dirty;
+};
+
 static const uint8_t SAMPLER_INVALIDX = 1 << 0;
 static const uint8_t SAMPLER_INVALIDY = 1 << 1;
 static const uint8_t SAMPLER_INVALIDZ = 1 << 2;
@@ -100,6 +109,8 @@ RawVolume::RawVolume(const RawVolume& src, const Region& region, bool *onlyAir)
 RawVolume::RawVolume(RawVolume&& move) noexcept {
 	_data = move._data;
 	move._data = nullptr;
+	_brickCache = move._brickCache;
+	move._brickCache = nullptr;
 	_mins = move._mins;
 	_maxs = move._maxs;
 	_region = move._region;
@@ -124,6 +135,8 @@ RawVolume::RawVolume(Voxel* data, const voxel::Region& region) :
 RawVolume::~RawVolume() {
 	core_free(_data);
 	_data = nullptr;
+	delete _brickCache;
+	_brickCache = nullptr;
 }
 
 Voxel* RawVolume::copyVoxels() const {
@@ -196,9 +209,79 @@ bool RawVolume::setVoxel(const glm::ivec3& pos, const Voxel& voxel) {
 	_maxs = (glm::max)(_maxs, pos);
 	_boundsValid = true;
 	_data[index] = voxel;
+	if (_brickCache != nullptr) {
+		markBrickDirty(glm::ivec3(localXPos, localYPos, iLocalZPos));
+	}
 	return true;
 }
 
+void RawVolume::markBrickDirty(const glm::ivec3& localPos) {
+	const glm::ivec3 brick = localPos >> RawVolumeBrick::Bits;
+	const glm::ivec3& dim = _brickCache->dimensions;
+	_brickCache->dirty[brick.x + brick.y * dim.x + brick.z * dim.x * dim.y] = 1u;
+}
+
+core::SharedPtr<RawVolumeSnapshot> RawVolume::snapshot() const {
+	core_trace_scoped(RawVolumeSnapshot);
+	if (_brickCache == nullptr) {
+		_brickCache = new RawVolumeBrickCache();
+		const glm::ivec3 size(width(), height(), depth());
+		_brickCache->dimensions = (size + RawVolumeBrick::Mask) >> RawVolumeBrick::Bits;
+		const glm::ivec3& dim = _brickCache->dimensions;
+		const size_t n = (size_t)dim.x * dim.y * dim.z;
+		_brickCache->bricks.resize(n);
+		_brickCache->dirty.resize(n);
+		core_memset(_brickCache->dirty.data(), 1, n);
+	}
+	const glm::ivec3& dim = _brickCache->dimensions;
+	const int w = width();
+	const int stride = w * height();
+	int brickIdx = 0;
+	for (int bz = 0; bz < dim.z; ++bz) {
+		const int z0 = bz << RawVolumeBrick::Bits;
+		const int nz = core_min(RawVolumeBrick::Size, depth() - z0);
+		for (int by = 0; by < dim.y; ++by) {
+			const int y0 = by << RawVolumeBrick::Bits;
+			const int ny = core_min(RawVolumeBrick::Size, height() - y0);
+			for (int bx = 0; bx < dim.x; ++bx, ++brickIdx) {
+				if (!_brickCache->dirty[brickIdx]) {
+					continue;
+				}
+				_brickCache->dirty[brickIdx] = 0u;
+				const int x0 = bx << RawVolumeBrick::Bits;
+				const int nx = core_min(RawVolumeBrick::Size, w - x0);
+				const Voxel* src = _data + x0 + y0 * w + z0 * stride;
+				bool air = true;
+				for (int z = 0; z < nz && air; ++z) {
+					for (int y = 0; y < ny && air; ++y) {
+						const Voxel* row = src + y * w + z * stride;
+						for (int x = 0; x < nx; ++x) {
+							if (!isAir(row[x].getMaterial())) {
+								air = false;
+								break;
+							}
+						}
+					}
+				}
+				if (air) {
+					// air bricks are not stored
+					_brickCache->bricks[brickIdx] = RawVolumeBrickPtr();
+					continue;
+				}
+				// never modify a brick in place - older snapshots might still reference it
+				RawVolumeBrickPtr brick = RawVolumeBrickPtr::create();
+				for (int z = 0; z < nz; ++z) {
+					for (int y = 0; y < ny; ++y) {
+						core_memcpy((void*)&brick->voxels[RawVolumeBrick::index(0, y, z)], (const void*)(src + y * w + z * stride), nx * sizeof(Voxel));
+					}
+				}
+				_brickCache->bricks[brickIdx] = core::move(brick);
+			}
+		}
+	}
+	return core::SharedPtr<RawVolumeSnapshot>::create(_region, _borderVoxel, dim, _brickCache->bricks);
+}
+
 /**
  * This function should probably be made internal...
  */
@@ -220,6 +303,9 @@ void RawVolume::initialise(const Region& regValidRegion) {
 void RawVolume::clear() {
 	const size_t size = width() * height() * depth() * sizeof(Voxel);
 	core_memset(_data, 0, size);
+	if (_brickCache != nullptr) {
+		core_memset(_brickCache->dirty.data(), 1, _brickCache->dirty.size());
+	}
 	_mins = glm::ivec3((std::numeric_limits<int>::max)() / 2);
 	_maxs = glm::ivec3((std::numeric_limits<int>::min)() / 2);
 	_boundsValid = false;
@@ -241,6 +327,9 @@ bool RawVolume::Sampler::setVoxel(const Voxel& voxel) {
 		return false;
 	}
 	*_currentVoxel = voxel;
+	if (_volume->_brickCache != nullptr) {
+		_volume->markBrickDirty(_posInVolume - _volume->_region.getLowerCorner());
+	}
 	_volume->_mins = (glm::min)(_volume->_mins, _posInVolume);
 	_volume->_maxs = (glm::max)(_volume->_maxs, _posInVolume);
 	_volume->_boundsValid = true;
@@ -6,10 +6,14 @@
 
 #include "Voxel.h"
 #include "Region.h"
+#include "core/SharedPtr.h"
 #include <glm/vec3.hpp>
 
 namespace voxel {
 
+class RawVolumeSnapshot;
+struct RawVolumeBrickCache;
+
 /**
  * Simple volume implementation which stores data in a single large 3D array.
  *
@@ -182,6 +186,17 @@ public:
 		return (const uint8_t*)_data;
 	}
 
+	/**
+	 * @brief Creates an immutable copy of the voxels that can be handed over to other threads.
+	 *
+	 * The copy is stored in refcounted bricks that are shared with the previous snapshot of this volume - only the
+	 * bricks that were modified since then are copied.
+	 * @note The first call enables the tracking of the modified bricks. From then on the volume keeps the bricks of
+	 * the last snapshot alive, which costs up to the memory of the volume itself.
+	 * @note Must be called from the thread that modifies the volume.
+	 */
+	core::SharedPtr<RawVolumeSnapshot> snapshot() const;
+
 	/**
 	 * @brief Shift the region of the volume by the given coordinates
 	 */
@@ -193,6 +208,7 @@ public:
 
 private:
 	void initialise(const Region& region);
+	void markBrickDirty(const glm::ivec3& localPos);
 
 	/** The size of the volume */
 	Region _region;
@@ -206,6 +222,9 @@ private:
 	glm::ivec3 _mins;
 	glm::ivec3 _maxs;
 	bool _boundsValid;
+
+	/** The bricks of the last snapshot and the bricks that were modified since then */
+	mutable RawVolumeBrickCache* _brickCache = nullptr;
 };
 
 inline const Region& RawVolume::region() const {
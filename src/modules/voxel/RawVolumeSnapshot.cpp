@@ -0,0 +1,92 @@
+/**
+ * @file
+ */
+
+#include "RawVolumeSnapshot.h"
+#include "RawVolume.h"
+#include "core/StandardLib.h"
+#include "core/Trace.h"
+
+namespace voxel {
+
+RawVolumeSnapshot::RawVolumeSnapshot(const Region &region, const Voxel &borderVoxel, const glm::ivec3 &dimensions,
+									 const RawVolumeBricks &bricks)
+	: _region(region), _borderVoxel(borderVoxel), _dimensions(dimensions), _bricks(bricks) {
+}
+
+const Voxel &RawVolumeSnapshot::voxel(int32_t x, int32_t y, int32_t z) const {
+	if (!_region.containsPoint(x, y, z)) {
+		return _borderVoxel;
+	}
+	const int32_t localX = x - _region.getLowerX();
+	const int32_t localY = y - _region.getLowerY();
+	const int32_t localZ = z - _region.getLowerZ();
+	const RawVolumeBrickPtr &b = _bricks[brickIndex(localX, localY, localZ)];
+	if (!b) {
+		return _airVoxel;
+	}
+	return b->voxels[RawVolumeBrick::index(localX & RawVolumeBrick::Mask, localY & RawVolumeBrick::Mask,
+										   localZ & RawVolumeBrick::Mask)];
+}
+
+const RawVolumeBrickPtr &RawVolumeSnapshot::brick(const glm::ivec3 &pos) const {
+	static const RawVolumeBrickPtr empty;
+	if (!_region.containsPoint(pos)) {
+		return empty;
+	}
+	const glm::ivec3 local = pos - _region.getLowerCorner();
+	return _bricks[brickIndex(local.x, local.y, local.z)];
+}
+
+RawVolume *RawVolumeSnapshot::toVolume(const Region &region, bool *onlyAir) const {
+	core_trace_scoped(RawVolumeSnapshotToVolume);
+	Region target = region;
+	target.cropTo(_region);
+	if (!target.isValid()) {
+		return nullptr;
+	}
+	if (onlyAir) {
+		*onlyAir = true;
+	}
+	const int width = target.getWidthInVoxels();
+	const int height = target.getHeightInVoxels();
+	const size_t size = (size_t)width * height * target.getDepthInVoxels() * sizeof(Voxel);
+	Voxel *data = (Voxel *)core_malloc(size);
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	Voxel *tgt = data;
+	for (int z = target.getLowerZ(); z <= target.getUpperZ(); ++z) {
+		const int32_t localZ = z - mins.z;
+		for (int y = target.getLowerY(); y <= target.getUpperY(); ++y) {
+			const int32_t localY = y - mins.y;
+			// copy the row in runs that don't cross brick borders
+			for (int x = target.getLowerX(); x <= target.getUpperX();) {
+				const int32_t localX = x - mins.x;
+				const int inBrickX = localX & RawVolumeBrick::Mask;
+				const int run = core_min(RawVolumeBrick::Size - inBrickX, target.getUpperX() - x + 1);
+				const RawVolumeBrickPtr &b = _bricks[brickIndex(localX, localY, localZ)];
+				if (!b) {
+					core_memset((void *)tgt, 0, run * sizeof(Voxel));
+				} else {
+					const Voxel *src = &b->voxels[RawVolumeBrick::index(inBrickX, localY & RawVolumeBrick::Mask,
+																		 localZ & RawVolumeBrick::Mask)];
+					core_memcpy((void *)tgt, (const void *)src, run * sizeof(Voxel));
+					if (onlyAir && *onlyAir) {
+						for (int i = 0; i < run; ++i) {
+							if (!isAir(src[i].getMaterial())) {
+								*onlyAir = false;
+								break;
+							}
+						}
+					}
+				}
+				tgt += run;
+				x += run;
+			}
+		}
+	}
+	RawVolume *v = RawVolume::createRaw(data, target);
+	v->setBorderValue(_borderVoxel);
+	return v;
+}
+
+} // namespace voxel
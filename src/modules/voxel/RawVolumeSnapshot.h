@@ -0,0 +1,104 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Region.h"
+#include "Voxel.h"
+#include "core/SharedPtr.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+
+class RawVolume;
+
+/**
+ * @brief Fixed size block of voxels that is shared between the snapshots of a RawVolume
+ */
+struct RawVolumeBrick {
+	static constexpr int Bits = 4;
+	static constexpr int Size = 1 << Bits;
+	static constexpr int Mask = Size - 1;
+	Voxel voxels[Size * Size * Size];
+
+	static inline constexpr int index(int x, int y, int z) {
+		return x + y * Size + z * Size * Size;
+	}
+};
+
+using RawVolumeBrickPtr = core::SharedPtr<RawVolumeBrick>;
+using RawVolumeBricks = core::DynamicArray<RawVolumeBrickPtr>;
+
+/**
+ * @brief Immutable copy of the voxels of a RawVolume at the time RawVolume::snapshot() was called.
+ *
+ * The voxels are stored in refcounted bricks. Bricks that were not modified between two snapshots of the same
+ * volume are shared, bricks that only contain air are not stored at all. Because nothing is modified after the
+ * construction, a snapshot can be read from any thread.
+ *
+ * @sa RawVolume::snapshot()
+ */
+class RawVolumeSnapshot {
+private:
+	Region _region;
+	Voxel _borderVoxel;
+	Voxel _airVoxel;
+	glm::ivec3 _dimensions;
+	RawVolumeBricks _bricks;
+
+	int brickIndex(int32_t localX, int32_t localY, int32_t localZ) const;
+
+public:
+	/**
+	 * @param dimensions The amount of bricks in each direction
+	 */
+	RawVolumeSnapshot(const Region &region, const Voxel &borderVoxel, const glm::ivec3 &dimensions,
+					  const RawVolumeBricks &bricks);
+
+	const Region &region() const;
+	const Voxel &borderValue() const;
+	const Voxel &voxel(int32_t x, int32_t y, int32_t z) const;
+	const Voxel &voxel(const glm::ivec3 &pos) const;
+
+	/**
+	 * @return The brick that holds the given position or an empty pointer if the brick only contains air or the
+	 * position is outside the snapshot region
+	 */
+	const RawVolumeBrickPtr &brick(const glm::ivec3 &pos) const;
+
+	/**
+	 * @brief Copies the voxels of the given region into a new volume. The region is cropped to the snapshot region.
+	 * @param[out] onlyAir Set to @c true if the copied voxels are all air
+	 * @return @c nullptr if the region doesn't intersect the snapshot region - the caller takes the ownership
+	 * of the returned volume otherwise
+	 */
+	RawVolume *toVolume(const Region &region, bool *onlyAir = nullptr) const;
+	RawVolume *toVolume() const;
+};
+
+using RawVolumeSnapshotPtr = core::SharedPtr<RawVolumeSnapshot>;
+
+inline const Region &RawVolumeSnapshot::region() const {
+	return _region;
+}
+
+inline const Voxel &RawVolumeSnapshot::borderValue() const {
+	return _borderVoxel;
+}
+
+inline int RawVolumeSnapshot::brickIndex(int32_t localX, int32_t localY, int32_t localZ) const {
+	return (localX >> RawVolumeBrick::Bits) + (localY >> RawVolumeBrick::Bits) * _dimensions.x +
+		   (localZ >> RawVolumeBrick::Bits) * _dimensions.x * _dimensions.y;
+}
+
+inline const Voxel &RawVolumeSnapshot::voxel(const glm::ivec3 &pos) const {
+	return voxel(pos.x, pos.y, pos.z);
+}
+
+inline RawVolume *RawVolumeSnapshot::toVolume() const {
+	return toVolume(_region);
+}
+
+} // namespace voxel
@@ -0,0 +1,147 @@
+/**
+ * @file
+ */
+
+#include "AbstractVoxelTest.h"
+#include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/IsQuadNeeded.h"
+#include "voxel/RawVolume.h"
+#include <glm/geometric.hpp>
+#include <map>
+
+namespace voxel {
+
+class CubicSurfaceExtractorTest: public AbstractVoxelTest {
+protected:
+	/**
+	 * @brief The color, the flags and the ambient occlusion values of the four corners of a unit face
+	 */
+	struct UnitFace {
+		uint8_t colorIndex;
+		uint8_t flags;
+		uint8_t ambientOcclusion[2][2];
+
+		bool operator==(const UnitFace& other) const {
+			return colorIndex == other.colorIndex && flags == other.flags
+				&& ambientOcclusion[0][0] == other.ambientOcclusion[0][0] && ambientOcclusion[0][1] == other.ambientOcclusion[0][1]
+				&& ambientOcclusion[1][0] == other.ambientOcclusion[1][0] && ambientOcclusion[1][1] == other.ambientOcclusion[1][1];
+		}
+	};
+	typedef std::map<std::tuple<int, int, int, int, int>, UnitFace> UnitFaces;
+
+	/**
+	 * @brief Splits the quads of the mesh into unit faces. Both extractors emit two consecutive triangles per quad
+	 * and only merge faces with the same values in the matching corners - so the corner values of a quad are the
+	 * values of each unit face it covers.
+	 */
+	void rasterize(const Mesh& mesh, UnitFaces& faces) const {
+		const size_t indices = mesh.getNoOfIndices();
+		ASSERT_EQ(0u, indices % 6u);
+		for (size_t i = 0u; i < indices; i += 6u) {
+			glm::ivec3 mins(INT32_MAX);
+			glm::ivec3 maxs(INT32_MIN);
+			for (size_t j = 0u; j < 6u; ++j) {
+				const glm::ivec3 pos(mesh.getVertex(mesh.getIndex(i + j)).position);
+				mins = glm::min(mins, pos);
+				maxs = glm::max(maxs, pos);
+			}
+			const glm::ivec3 extent = maxs - mins;
+			const int axis = extent.x == 0 ? 0 : (extent.y == 0 ? 1 : 2);
+			const int uAxis = axis == 0 ? 1 : 0;
+			const int vAxis = axis == 2 ? 1 : 2;
+			const glm::ivec3 p0(mesh.getVertex(mesh.getIndex(i + 0)).position);
+			const glm::ivec3 p1(mesh.getVertex(mesh.getIndex(i + 1)).position);
+			const glm::ivec3 p2(mesh.getVertex(mesh.getIndex(i + 2)).position);
+			const int normal = glm::cross(glm::vec3(p1 - p0), glm::vec3(p2 - p0))[axis] > 0.0f ? 1 : -1;
+
+			UnitFace face;
+			for (size_t j = 0u; j < 6u; ++j) {
+				const VoxelVertex& vertex = mesh.getVertex(mesh.getIndex(i + j));
+				const glm::ivec3 pos(vertex.position);
+				face.colorIndex = vertex.colorIndex;
+				face.flags = vertex.flags;
+				face.ambientOcclusion[pos[uAxis] == maxs[uAxis]][pos[vAxis] == maxs[vAxis]] = vertex.ambientOcclusion;
+			}
+			for (int u = mins[uAxis]; u < maxs[uAxis]; ++u) {
+				for (int v = mins[vAxis]; v < maxs[vAxis]; ++v) {
+					const bool inserted = faces.emplace(std::make_tuple(axis, normal, mins[axis], u, v), face).second;
+					EXPECT_TRUE(inserted) << "Overlapping faces at " << u << ":" << v << " on plane " << mins[axis] << " of axis " << axis;
+				}
+			}
+		}
+	}
+
+	template<class Volume>
+	void compare(Volume* volume, const Region& region) const {
+		Mesh cubic(1024, 1024, true);
+		extractCubicMesh(volume, region, &cubic, IsQuadNeeded(), region.getLowerCorner(), false, true);
+		Mesh binary(1024, 1024, true);
+		extractBinaryGreedyMesh(volume, region, &binary, region.getLowerCorner());
+		EXPECT_EQ(cubic.getOffset(), binary.getOffset());
+		EXPECT_LE(binary.getNoOfIndices(), cubic.getNoOfIndices());
+
+		UnitFaces cubicFaces;
+		rasterize(cubic, cubicFaces);
+		UnitFaces binaryFaces;
+		rasterize(binary, binaryFaces);
+		ASSERT_FALSE(cubicFaces.empty());
+		ASSERT_EQ(cubicFaces.size(), binaryFaces.size());
+		for (const auto& e : cubicFaces) {
+			auto i = binaryFaces.find(e.first);
+			ASSERT_NE(binaryFaces.end(), i) << "Missing face on axis " << std::get<0>(e.first) << " plane " << std::get<2>(e.first)
+					<< " at " << std::get<3>(e.first) << ":" << std::get<4>(e.first);
+			EXPECT_TRUE(e.second == i->second) << "Face on axis " << std::get<0>(e.first) << " plane " << std::get<2>(e.first)
+					<< " at " << std::get<3>(e.first) << ":" << std::get<4>(e.first) << " differs";
+		}
+	}
+};
+
+TEST_F(CubicSurfaceExtractorTest, testBinaryGreedyMeshSphere) {
+	compare(&_volData, _region);
+}
+
+TEST_F(CubicSurfaceExtractorTest, testBinaryGreedyMeshRandom) {
+	// bigger than one tile on the x axis and starting at an odd position to check the tile borders
+	const Region region(glm::ivec3(-3, 2, 5), glm::ivec3(70, 20, 14));
+	RawVolume volume(Region(glm::ivec3(-10), glm::ivec3(80)));
+	for (int z = -4; z <= 15; ++z) {
+		for (int y = 1; y <= 21; ++y) {
+			for (int x = -4; x <= 71; ++x) {
+				const int r = _random.random(0, 9);
+				if (r < 4) {
+					continue;
+				}
+				const VoxelType type = r == 4 ? VoxelType::Transparent : VoxelType::Generic;
+				volume.setVoxel(x, y, z, Voxel(type, r % 3, r == 9 ? 1u : 0u));
+			}
+		}
+	}
+	compare(&volume, region);
+}
+
+TEST_F(CubicSurfaceExtractorTest, testBinaryGreedyMeshMerge) {
+	const Region region(0, 15);
+	RawVolume volume(region);
+	for (int z = 0; z <= 15; ++z) {
+		for (int x = 0; x <= 15; ++x) {
+			volume.setVoxel(x, 0, z, createVoxel(VoxelType::Generic, 1));
+		}
+	}
+	Mesh mesh(1024, 1024, true);
+	extractBinaryGreedyMesh(&volume, region, &mesh, region.getLowerCorner());
+	// one quad for the upper and the lower side and one for the sides on the lower x and z borders - the
+	// faces on the upper borders belong to the neighbour regions
+	EXPECT_EQ(16u, mesh.getNoOfVertices());
+	EXPECT_EQ(24u, mesh.getNoOfIndices());
+}
+
+TEST_F(CubicSurfaceExtractorTest, testBinaryGreedyMeshEmpty) {
+	const Region region(0, 15);
+	RawVolume volume(region);
+	Mesh mesh(1024, 1024, true);
+	extractBinaryGreedyMesh(&volume, region, &mesh, region.getLowerCorner());
+	EXPECT_TRUE(mesh.isEmpty());
+	EXPECT_EQ(region.getLowerCorner(), mesh.getOffset());
+}
+
+}
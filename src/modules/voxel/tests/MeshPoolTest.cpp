@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "voxel/MeshPool.h"
+
+namespace voxel {
+
+class MeshPoolTest: public app::AbstractTest {
+};
+
+TEST_F(MeshPoolTest, testReuse) {
+	MeshPool pool;
+	Mesh mesh = pool.acquire(100, 200);
+	EXPECT_GE(mesh.getVertexVector().capacity(), (size_t)MeshPool::MinClassSize);
+	EXPECT_GE(mesh.getIndexVector().capacity(), (size_t)MeshPool::MinClassSize);
+	mesh.addVertex(VoxelVertex());
+	mesh.addTriangle(0, 0, 0);
+	mesh.compressIndices();
+	const VoxelVertex* vertices = mesh.getRawVertexData();
+	const uint8_t* compressedIndices = mesh.compressedIndices();
+	pool.release(core::move(mesh));
+
+	MeshPool::Stats stats = pool.stats();
+	EXPECT_EQ(1, stats.acquired);
+	EXPECT_EQ(0, stats.reused);
+	EXPECT_GT(stats.pooledBytes, 0u);
+	EXPECT_EQ(stats.pooledBytes, stats.peakPooledBytes);
+
+	Mesh reused = pool.acquire(MeshPool::MinClassSize, MeshPool::MinClassSize);
+	EXPECT_TRUE(reused.isEmpty());
+	EXPECT_EQ(vertices, reused.getRawVertexData());
+	reused.addVertex(VoxelVertex());
+	reused.addTriangle(0, 0, 0);
+	reused.compressIndices();
+	EXPECT_EQ(compressedIndices, reused.compressedIndices()) << "The compressed index buffer should be reused";
+
+	stats = pool.stats();
+	EXPECT_EQ(2, stats.acquired);
+	EXPECT_EQ(1, stats.reused);
+	EXPECT_FLOAT_EQ(0.5f, stats.reuseRate());
+	EXPECT_EQ(0u, stats.pooledBytes);
+	EXPECT_GT(stats.peakPooledBytes, 0u);
+}
+
+TEST_F(MeshPoolTest, testSizeClasses) {
+	MeshPool pool;
+	pool.release(pool.acquire(MeshPool::MinClassSize, MeshPool::MinClassSize));
+	// the pooled mesh is too small
+	Mesh big = pool.acquire(MeshPool::MinClassSize * 4, MeshPool::MinClassSize);
+	EXPECT_GE(big.getVertexVector().capacity(), (size_t)MeshPool::MinClassSize * 4);
+	EXPECT_GE(big.getIndexVector().capacity(), (size_t)MeshPool::MinClassSize * 4);
+	EXPECT_EQ(0, pool.stats().reused);
+	pool.release(core::move(big));
+	// a big mesh is handed out for small requests if there is no small one left
+	Mesh small1 = pool.acquire(10, 10);
+	Mesh small2 = pool.acquire(10, 10);
+	EXPECT_EQ(2, pool.stats().reused);
+	EXPECT_GE(small1.getVertexVector().capacity(), (size_t)MeshPool::MinClassSize);
+	EXPECT_GE(small2.getVertexVector().capacity(), (size_t)MeshPool::MinClassSize * 4);
+}
+
+TEST_F(MeshPoolTest, testMaxPooledBytes) {
+	MeshPool pool(1024u);
+	pool.release(pool.acquire(MeshPool::MinClassSize, MeshPool::MinClassSize));
+	const MeshPool::Stats& stats = pool.stats();
+	EXPECT_EQ(1, stats.dropped);
+	EXPECT_EQ(0u, stats.pooledBytes);
+	Mesh tooSmall(16, 16);
+	pool.release(core::move(tooSmall));
+	EXPECT_EQ(2, pool.stats().dropped);
+}
+
+}
@@ -0,0 +1,125 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "core/ScopedPtr.h"
+#include "voxel/RawVolume.h"
+#include "voxel/RawVolumeSnapshot.h"
+
+namespace voxel {
+
+class RawVolumeSnapshotTest : public app::AbstractTest {
+protected:
+	void fill(RawVolume &v) const {
+		const Region &region = v.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					if ((x + y + z) % 3 == 0) {
+						v.setVoxel(x, y, z, createVoxel(VoxelType::Generic, (x * 7 + y * 3 + z) % 255));
+					}
+				}
+			}
+		}
+	}
+
+	void compare(const RawVolume &v, const RawVolumeSnapshot &s) const {
+		ASSERT_EQ(v.region(), s.region());
+		const Region &region = v.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					ASSERT_TRUE(v.voxel(x, y, z).isSame(s.voxel(x, y, z))) << "Mismatch at " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+};
+
+TEST_F(RawVolumeSnapshotTest, testSnapshot) {
+	// the size is no multiple of the brick size
+	RawVolume v(Region(glm::ivec3(-5, 2, -20), glm::ivec3(30, 20, 3)));
+	fill(v);
+	const RawVolumeSnapshotPtr &snapshot = v.snapshot();
+	compare(v, *snapshot.get());
+	EXPECT_EQ(v.borderValue(), snapshot->voxel(-6, 2, -20));
+}
+
+TEST_F(RawVolumeSnapshotTest, testCopyOnWrite) {
+	RawVolume v(Region(0, 47));
+	fill(v);
+	const RawVolumeSnapshotPtr &first = v.snapshot();
+	const Voxel old = v.voxel(1, 1, 1);
+	const Voxel voxel = createVoxel(VoxelType::Generic, 42);
+	ASSERT_FALSE(old.isSame(voxel));
+	v.setVoxel(1, 1, 1, voxel);
+	const RawVolumeSnapshotPtr &second = v.snapshot();
+
+	EXPECT_TRUE(old.isSame(first->voxel(1, 1, 1)));
+	EXPECT_TRUE(voxel.isSame(second->voxel(1, 1, 1)));
+	compare(v, *second.get());
+
+	// only the modified brick was copied
+	EXPECT_NE(first->brick(glm::ivec3(1)).get(), second->brick(glm::ivec3(1)).get());
+	EXPECT_EQ(first->brick(glm::ivec3(20)).get(), second->brick(glm::ivec3(20)).get());
+	EXPECT_EQ(first->brick(glm::ivec3(47)).get(), second->brick(glm::ivec3(47)).get());
+}
+
+TEST_F(RawVolumeSnapshotTest, testSamplerSetVoxel) {
+	RawVolume v(Region(0, 31));
+	const RawVolumeSnapshotPtr &first = v.snapshot();
+	RawVolume::Sampler sampler(v);
+	ASSERT_TRUE(sampler.setPosition(20, 20, 20));
+	const Voxel voxel = createVoxel(VoxelType::Generic, 1);
+	ASSERT_TRUE(sampler.setVoxel(voxel));
+	const RawVolumeSnapshotPtr &second = v.snapshot();
+	EXPECT_EQ(Voxel(), first->voxel(20, 20, 20));
+	EXPECT_EQ(voxel, second->voxel(20, 20, 20));
+}
+
+TEST_F(RawVolumeSnapshotTest, testAirBricks) {
+	RawVolume v(Region(0, 31));
+	v.setVoxel(0, 0, 0, createVoxel(VoxelType::Generic, 1));
+	const RawVolumeSnapshotPtr &snapshot = v.snapshot();
+	EXPECT_TRUE(snapshot->brick(glm::ivec3(0)));
+	EXPECT_FALSE(snapshot->brick(glm::ivec3(31)));
+	EXPECT_EQ(Voxel(), snapshot->voxel(31, 31, 31));
+}
+
+TEST_F(RawVolumeSnapshotTest, testClear) {
+	RawVolume v(Region(0, 15));
+	fill(v);
+	const RawVolumeSnapshotPtr &first = v.snapshot();
+	v.clear();
+	const RawVolumeSnapshotPtr &second = v.snapshot();
+	EXPECT_TRUE(first->brick(glm::ivec3(0)));
+	EXPECT_FALSE(second->brick(glm::ivec3(0)));
+}
+
+TEST_F(RawVolumeSnapshotTest, testToVolume) {
+	RawVolume v(Region(0, 40));
+	v.setVoxel(20, 20, 20, createVoxel(VoxelType::Generic, 1));
+	const RawVolumeSnapshotPtr &snapshot = v.snapshot();
+
+	bool onlyAir = false;
+	core::ScopedPtr<RawVolume> air(snapshot->toVolume(Region(0, 10), &onlyAir));
+	ASSERT_TRUE(air);
+	EXPECT_TRUE(onlyAir);
+	EXPECT_EQ(Region(0, 10), air->region());
+
+	core::ScopedPtr<RawVolume> cropped(snapshot->toVolume(Region(14, 50), &onlyAir));
+	ASSERT_TRUE(cropped);
+	EXPECT_FALSE(onlyAir);
+	EXPECT_EQ(Region(14, 40), cropped->region());
+	EXPECT_EQ(v.voxel(20, 20, 20), cropped->voxel(20, 20, 20));
+	EXPECT_EQ(v.voxel(19, 20, 20), cropped->voxel(19, 20, 20));
+
+	core::ScopedPtr<RawVolume> full(snapshot->toVolume());
+	ASSERT_TRUE(full);
+	EXPECT_EQ(0, memcmp(full->data(), v.data(), v.width() * v.height() * v.depth() * sizeof(Voxel)));
+
+	EXPECT_EQ(nullptr, snapshot->toVolume(Region(50, 60)));
+}
+
+} // namespace voxel
@@ -837,12 +837,12 @@ bool GLTFFormat::subdivideShape(SceneGraphNode &node,
 			}
 
 			for (const auto &entry : posMap) {
-				const PosSampling &pos = entry->second;
+				const PosSampling &pos = entry->value;
 				const glm::vec4 &color = pos.avgColor();
 				uint8_t addedPaletteIndex = 0;
 				palette.addColorToPalette(core::Color::getRGBA(color), false, &addedPaletteIndex);
 				const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, addedPaletteIndex);
-				volume->setVoxel(entry->first, voxel);
+				volume->setVoxel(entry->key, voxel);
 			}
 		}
 		++n;
@@ -236,12 +236,12 @@ void MeshFormat::voxelizeTris(voxelformat::SceneGraphNode &node, const PosMap &p
 		if (stopExecution()) {
 			return;
 		}
-		const PosSampling &pos = entry->second;
+		const PosSampling &pos = entry->value;
 		const glm::vec4 &color = pos.avgColor();
 		uint8_t addedPaletteIndex = 0;
 		palette.addColorToPalette(core::Color::getRGBA(color), false, &addedPaletteIndex);
 		const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, addedPaletteIndex);
-		wrapper.setVoxel(entry->first, voxel);
+		wrapper.setVoxel(entry->key, voxel);
 	}
 	node.setPalette(palette);
 	if (fillHollow) {
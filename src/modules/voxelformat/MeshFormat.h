@@ -7,7 +7,7 @@
 #include "Format.h"
 #include "private/Tri.h"
 #include "core/collection/DynamicArray.h"
-#include "core/collection/Map.h"
+#include "core/collection/HashMap.h"
 
 namespace voxelformat {
 
@@ -94,7 +94,7 @@ protected:
 		}
 	};
 
-	typedef core::Map<glm::ivec3, PosSampling, 64, glm::hash<glm::ivec3>> PosMap;
+	typedef core::HashMap<glm::ivec3, PosSampling, glm::hash<glm::ivec3>> PosMap;
 
 	static void voxelizeTris(voxelformat::SceneGraphNode &node, const PosMap &posMap, bool hillHollow);
 	static void transformTris(const TriCollection &subdivided, PosMap &posMap);
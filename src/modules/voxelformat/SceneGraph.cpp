@@ -3,15 +3,24 @@
  */
 
 #include "SceneGraph.h"
+#include "app/App.h"
 #include "core/Common.h"
 #include "core/Log.h"
 #include "core/Pair.h"
+#include "core/collection/Array.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/Set.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ConditionVariable.h"
+#include "core/concurrent/Lock.h"
+#include "core/concurrent/ThreadPool.h"
 #include "voxel/MaterialColor.h"
 #include "voxel/Palette.h"
 #include "voxel/RawVolume.h"
 #include "voxelformat/SceneGraphNode.h"
-#include "voxelutil/VolumeMerger.h"
 #include "voxelutil/VolumeVisitor.h"
+#include <glm/common.hpp>
+#include <glm/vector_relational.hpp>
 
 namespace voxelformat {
 
@@ -342,24 +351,92 @@ SceneGraphNode *SceneGraph::operator[](int modelIdx) {
 	return nullptr;
 }
 
+/**
+ * @brief Executes the given function for each index in [0, n) on the app thread pool.
+ *
+ * The calling thread takes part in the work and only waits for the indices that were claimed by other threads.
+ * This keeps the function usable from within tasks that are already executed by the thread pool - pool tasks that
+ * start after all indices were claimed return without touching the function. The thread that finishes the last
+ * index wakes up the caller.
+ */
+template<class FUNC>
+static void parallelFor(int n, const FUNC &func) {
+	if (n <= 0) {
+		return;
+	}
+	core::ThreadPool &threadPool = app::App::getInstance()->threadPool();
+	const int tasks = core_min(n, (int)threadPool.size()) - 1;
+	if (tasks <= 0) {
+		for (int i = 0; i < n; ++i) {
+			func(i);
+		}
+		return;
+	}
+	struct State {
+		core::AtomicInt next{0};
+		core::AtomicInt done{0};
+		core_trace_mutex(core::Lock, lock, "SceneGraphParallelFor");
+		core::ConditionVariable finished;
+	};
+	const core::SharedPtr<State> &state = core::make_shared<State>();
+	const FUNC *funcPtr = &func;
+	auto work = [state, funcPtr, n] () {
+		for (;;) {
+			const int i = state->next.increment();
+			if (i >= n) {
+				break;
+			}
+			(*funcPtr)(i);
+			if (state->done.increment() == n - 1) {
+				// the caller checks the counter while holding the lock - so the notification can't get lost
+				core::ScopedLock lock(state->lock);
+				state->finished.notify_all();
+			}
+		}
+	};
+	for (int i = 0; i < tasks; ++i) {
+		threadPool.enqueue(work);
+	}
+	work();
+	core::ScopedLock lock(state->lock);
+	state->finished.wait(state->lock, [&state, n] () {
+		return state->done >= n;
+	});
+}
+
 voxel::Palette SceneGraph::mergePalettes(bool removeUnused, int emptyIndex) const {
 	voxel::Palette palette;
+	// mirrors the colors of the palette to avoid a linear search for each color of each node
+	core::Set<uint32_t, 521> paletteColors;
 	bool tooManyColors = false;
 	for (const SceneGraphNode &node : *this) {
 		const voxel::Palette &nodePalette = node.palette();
 		for (int i = 0; i < nodePalette.colorCount; ++i) {
 			const core::RGBA rgba = nodePalette.colors[i];
-			if (palette.hasColor(rgba)) {
+			if (paletteColors.has(rgba.rgba)) {
 				continue;
 			}
 			uint8_t index = 0;
 			int skipIndex = rgba.a == 0 ? -1 : emptyIndex;
+			const int colorCount = palette.colorCount;
 			if (!palette.addColorToPalette(rgba, false, &index, false, skipIndex)) {
 				if (index < palette.colorCount - 1) {
 					tooManyColors = true;
 					break;
 				}
 			}
+			if (index < colorCount) {
+				// an existing (transparent) slot was replaced
+				paletteColors.clear();
+				for (int j = 0; j < palette.colorCount; ++j) {
+					paletteColors.insert(palette.colors[j].rgba);
+				}
+			} else {
+				// the skipped slot is part of the palette, too
+				for (int j = colorCount; j < palette.colorCount; ++j) {
+					paletteColors.insert(palette.colors[j].rgba);
+				}
+			}
 			if (nodePalette.hasGlow(i)) {
 				palette.setGlow(index, 1.0f);
 			}
@@ -374,19 +451,28 @@ voxel::Palette SceneGraph::mergePalettes(bool removeUnused, int emptyIndex) cons
 		for (int i = 0; i < voxel::PaletteMaxColors; ++i) {
 			palette.removeGlow(i);
 		}
+		core::DynamicArray<const SceneGraphNode *> nodes;
+		nodes.reserve(size());
 		for (const SceneGraphNode &node : *this) {
-			core::Array<bool, voxel::PaletteMaxColors> used;
-			if (removeUnused) {
-				used.fill(false);
-				voxelutil::visitVolume(*node.volume(), [&used] (int, int, int, const voxel::Voxel &voxel) {
-					used[voxel.getColor()] = true;
-				});
-			} else {
-				used.fill(true);
+			nodes.push_back(&node);
+		}
+		core::DynamicArray<core::Array<bool, voxel::PaletteMaxColors>> used;
+		used.resize(nodes.size());
+		parallelFor((int)nodes.size(), [&nodes, &used, removeUnused] (int n) {
+			core::Array<bool, voxel::PaletteMaxColors> &nodeUsed = used[n];
+			if (!removeUnused) {
+				nodeUsed.fill(true);
+				return;
 			}
-			const voxel::Palette &nodePalette = node.palette();
+			nodeUsed.fill(false);
+			voxelutil::visitVolume(*nodes[n]->volume(), [&nodeUsed] (int, int, int, const voxel::Voxel &voxel) {
+				nodeUsed[voxel.getColor()] = true;
+			});
+		});
+		for (size_t n = 0; n < nodes.size(); ++n) {
+			const voxel::Palette &nodePalette = nodes[n]->palette();
 			for (int i = 0; i < nodePalette.colorCount; ++i) {
-				if (!used[i]) {
+				if (!used[n][i]) {
 					Log::trace("color %i not used, skip it for this node", i);
 					continue;
 				}
@@ -417,6 +503,8 @@ SceneGraph::MergedVolumePalette SceneGraph::merge(bool transform) const {
 
 	core::DynamicArray<const SceneGraphNode *> nodes;
 	nodes.reserve(n);
+	core::DynamicArray<voxel::Region> destRegions;
+	destRegions.reserve(n);
 
 	voxel::Region mergedRegion = voxel::Region::InvalidRegion;
 	const voxel::Palette &palette = mergePalettes(true);
@@ -432,31 +520,72 @@ SceneGraph::MergedVolumePalette SceneGraph::merge(bool transform) const {
 		} else {
 			mergedRegion = region;
 		}
-	}
 
-	voxel::RawVolume* merged = new voxel::RawVolume(mergedRegion);
-	for (size_t i = 0; i < nodes.size(); ++i) {
-		const SceneGraphNode* node = nodes[i];
-		const voxel::Region& sourceRegion = node->region();
-		voxel::Region destRegion = sourceRegion;
+		voxel::Region destRegion = node.region();
 		if (transform) {
-			const KeyFrameIndex keyFrameIdx = 0;
-			const SceneGraphTransform &transform = node->transform(keyFrameIdx);
-			const glm::vec3 &translation = transform.worldTranslation();
-			destRegion.shift(translation);
+			destRegion = region;
 			// TODO: rotation
 		}
+		destRegions.push_back(destRegion);
+	}
 
-		voxelutil::mergeVolumes(merged, node->volume(), destRegion, sourceRegion, [node, &palette] (voxel::Voxel& voxel) {
-			if (isAir(voxel.getMaterial())) {
-				return false;
+	// the closest match in the merged palette for each color of each node
+	core::DynamicArray<core::Array<uint8_t, voxel::PaletteMaxColors>> remaps;
+	remaps.resize(nodes.size());
+	parallelFor((int)nodes.size(), [&nodes, &remaps, &palette] (int i) {
+		const voxel::Palette &nodePalette = nodes[i]->palette();
+		for (int c = 0; c < voxel::PaletteMaxColors; ++c) {
+			remaps[i][c] = (uint8_t)palette.getClosestMatch(nodePalette.colors[c]);
+		}
+	});
+
+	const int width = mergedRegion.getWidthInVoxels();
+	const int height = mergedRegion.getHeightInVoxels();
+	const int depth = mergedRegion.getDepthInVoxels();
+	const size_t bytes = (size_t)width * (size_t)height * (size_t)depth * sizeof(voxel::Voxel);
+	voxel::Voxel *data = (voxel::Voxel *)core_malloc(bytes);
+	core_memset((void *)data, 0, bytes);
+
+	// each task owns a range of z slices of the merged volume and copies the nodes in order into it - this way
+	// the later nodes still overwrite the earlier ones without any locking
+	const int slabs = core_min(depth, (int)app::App::getInstance()->threadPool().size() * 4);
+	parallelFor(slabs, [&] (int slab) {
+		const int lowerZ = mergedRegion.getLowerZ() + (int)((int64_t)depth * slab / slabs);
+		const int upperZ = mergedRegion.getLowerZ() + (int)((int64_t)depth * (slab + 1) / slabs) - 1;
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			const voxel::RawVolume *volume = nodes[i]->volume();
+			const voxel::Region &sourceRegion = volume->region();
+			const voxel::Region &destRegion = destRegions[i];
+			const glm::ivec3 &mins = glm::max(destRegion.getLowerCorner(), glm::ivec3(mergedRegion.getLowerX(), mergedRegion.getLowerY(), lowerZ));
+			const glm::ivec3 &maxs = glm::min(destRegion.getUpperCorner(), glm::ivec3(mergedRegion.getUpperX(), mergedRegion.getUpperY(), upperZ));
+			if (glm::any(glm::greaterThan(mins, maxs))) {
+				continue;
 			}
-			const core::RGBA color = node->palette().colors[voxel.getColor()];
-			const uint8_t index = palette.getClosestMatch(color);
-			voxel.setColor(index);
-			return true;
-		});
-	}
+			const core::Array<uint8_t, voxel::PaletteMaxColors> &remap = remaps[i];
+			const glm::ivec3 &offset = sourceRegion.getLowerCorner() - destRegion.getLowerCorner();
+			const int sourceWidth = sourceRegion.getWidthInVoxels();
+			const int sourceHeight = sourceRegion.getHeightInVoxels();
+			const voxel::Voxel *sourceData = (const voxel::Voxel *)volume->data();
+			for (int z = mins.z; z <= maxs.z; ++z) {
+				for (int y = mins.y; y <= maxs.y; ++y) {
+					const glm::ivec3 source = glm::ivec3(mins.x, y, z) + offset - sourceRegion.getLowerCorner();
+					const voxel::Voxel *sourceRow = sourceData + source.x + source.y * sourceWidth + (size_t)source.z * sourceWidth * sourceHeight;
+					voxel::Voxel *destRow = data + (mins.x - mergedRegion.getLowerX()) + (y - mergedRegion.getLowerY()) * width
+							+ (size_t)(z - mergedRegion.getLowerZ()) * width * height;
+					for (int x = 0; x <= maxs.x - mins.x; ++x) {
+						voxel::Voxel voxel = sourceRow[x];
+						if (isAir(voxel.getMaterial())) {
+							continue;
+						}
+						voxel.setColor(remap[voxel.getColor()]);
+						destRow[x] = voxel;
+					}
+				}
+			}
+		}
+	});
+
+	voxel::RawVolume* merged = voxel::RawVolume::createRaw(data, mergedRegion);
 	merged->translate(-mergedRegion.getLowerCorner());
 	return MergedVolumePalette{merged, palette};
 }
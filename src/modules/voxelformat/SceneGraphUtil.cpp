@@ -17,7 +17,7 @@ static int addToGraph(SceneGraph &sceneGraph, SceneGraphNode &&node, int parent)
 	return newNodeId;
 }
 
-static void copy(const SceneGraphNode &node, SceneGraphNode &target) {
+void copy(const SceneGraphNode &node, SceneGraphNode &target) {
 	target.setName(node.name());
 	target.setKeyFrames(node.keyFrames());
 	target.setVisible(node.visible());
@@ -8,6 +8,9 @@
 
 namespace voxelformat {
 
+// copies everything but the volume and the children
+void copy(const SceneGraphNode &node, SceneGraphNode &target);
+
 void copyNode(const SceneGraphNode &src, SceneGraphNode &target, bool copyVolume);
 
 // this makes a copy of the volumes affected
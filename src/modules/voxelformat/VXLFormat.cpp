@@ -350,7 +350,7 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 			continue;
 		}
 
-		wrap(stream.seek(dataStart + colStart[i]))
+		wrapBool(stream.seek(dataStart + colStart[i]) != -1)
 		uint32_t z = 0;
 		do {
 			uint8_t v;
@@ -393,7 +393,7 @@ bool VXLFormat::readNode(io::SeekableReadStream& stream, VXLModel& mdl, uint32_t
 			continue;
 		}
 
-		wrap(stream.seek(dataStart + colStart[i]))
+		wrapBool(stream.seek(dataStart + colStart[i]) != -1)
 
 		const uint8_t x = (uint8_t)(i % footer.xsize);
 		const uint8_t y = (uint8_t)(i / footer.xsize);
@@ -495,7 +495,7 @@ bool VXLFormat::readNodeFooter(io::SeekableReadStream& stream, VXLModel& mdl, ui
 
 bool VXLFormat::readNodeFooters(io::SeekableReadStream& stream, VXLModel& mdl) const {
 	const VXLHeader& hdr = mdl.header;
-	wrap(stream.seek(HeaderSize + NodeHeaderSize * hdr.nodeCount + hdr.bodysize))
+	wrapBool(stream.seek(HeaderSize + NodeHeaderSize * hdr.nodeCount + hdr.bodysize) != -1)
 	for (uint32_t i = 0; i < hdr.tailerCount; ++i) {
 		wrapBool(readNodeFooter(stream, mdl, i))
 	}
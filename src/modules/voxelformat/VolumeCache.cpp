@@ -72,6 +72,7 @@ bool VolumeCache::deleteVolume(const char* fullPath) {
 	if (i != _volumes.end()) {
 		delete i->value;
 		_volumes.erase(i);
+		_generation.increment(1);
 		return true;
 	}
 	return false;
@@ -91,6 +92,7 @@ void VolumeCache::construct() {
 			delete e->value;
 		}
 		_volumes.clear();
+		_generation.increment(1);
 	});
 }
 
@@ -104,6 +106,7 @@ void VolumeCache::shutdown() {
 		delete e->value;
 	}
 	_volumes.clear();
+	_generation.increment(1);
 }
 
 }
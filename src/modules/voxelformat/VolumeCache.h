@@ -8,6 +8,7 @@
 #include "voxel/RawVolume.h"
 #include "core/collection/StringMap.h"
 #include <memory>
+#include "core/concurrent/Atomic.h"
 #include "core/concurrent/Lock.h"
 #include "core/Trace.h"
 
@@ -22,6 +23,7 @@ class VolumeCache : public core::IComponent {
 private:
 	core::StringMap<voxel::RawVolume*> _volumes core_thread_guarded_by(_mutex);
 	core_trace_mutex(core::Lock, _mutex, "VolumeCache");
+	core::AtomicInt _generation { 0 };
 public:
 	~VolumeCache();
 	/**
@@ -42,11 +44,21 @@ public:
 	 */
 	bool removeVolume(const char* fullPath);
 
+	/**
+	 * The generation is increased whenever volumes of the cache are freed. Anything that is keyed on the
+	 * volume pointers of an older generation is invalid - the memory might be reused by new volumes.
+	 */
+	int generation() const;
+
 	bool init() override;
 	void shutdown() override;
 	void construct() override;
 };
 
+inline int VolumeCache::generation() const {
+	return _generation;
+}
+
 using VolumeCachePtr = std::shared_ptr<VolumeCache>;
 
 }
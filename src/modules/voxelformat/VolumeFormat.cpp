@@ -13,6 +13,7 @@
 #include "io/FileStream.h"
 #include "io/Filesystem.h"
 #include "io/FormatDescription.h"
+#include "io/MemoryReadStream.h"
 #include "io/Stream.h"
 #include "video/Texture.h"
 #include "voxelformat/AoSVXLFormat.h"
@@ -311,6 +312,17 @@ size_t loadPalette(const core::String &filename, io::SeekableReadStream &stream,
 
 bool loadFormat(const core::String &filename, io::SeekableReadStream &stream, SceneGraph &newSceneGraph) {
 	core_trace_scoped(LoadVolumeFormat);
+	const int64_t size = stream.size();
+	if (!stream.hasReadWindow() && size > 0 && size <= (int64_t)UINT32_MAX) {
+		// the loaders are doing a lot of small reads - serve them from memory instead of the file
+		stream.seek(0);
+		io::MemoryReadStream memStream(stream, (uint32_t)size);
+		if (memStream.size() == size) {
+			return loadFormat(filename, memStream, newSceneGraph);
+		}
+		Log::warn("Failed to buffer model file %s", filename.c_str());
+		stream.seek(0);
+	}
 	const uint32_t magic = loadMagic(stream);
 	const core::String &fileext = core::string::extractExtension(filename);
 	const io::FormatDescription *desc = getDescription(fileext, magic);
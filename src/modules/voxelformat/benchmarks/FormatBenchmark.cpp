@@ -0,0 +1,89 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/ArrayLength.h"
+#include "io/FileStream.h"
+#include "io/Filesystem.h"
+#include "io/MemoryReadStream.h"
+#include "voxel/MaterialColor.h"
+#include "voxelformat/SceneGraph.h"
+#include "voxelformat/VolumeFormat.h"
+
+static const char *corpus[] = {"r.0.-2.qb",	 "aceofspades.vxl",	 "cc.vxl",		"rgb.cub",
+								"test.kv6",	 "qubicle.qbcl",	 "test.binvox", "vox_character.vox",
+								"qubicle.qbt",	 "chr_knight.gox"};
+
+class FormatBenchmark : public app::AbstractBenchmark {
+protected:
+	io::FilePtr open(benchmark::State &state) const {
+		const char *filename = corpus[state.range(0)];
+		state.SetLabel(filename);
+		return io::filesystem()->open(filename);
+	}
+
+public:
+	bool onInitApp() override {
+		return voxel::initDefaultPalette();
+	}
+};
+
+BENCHMARK_DEFINE_F(FormatBenchmark, loadFormat)(benchmark::State &state) {
+	const io::FilePtr &file = open(state);
+	io::FileStream stream(file);
+	for (auto _ : state) {
+		voxelformat::SceneGraph sceneGraph;
+		stream.seek(0);
+		if (!voxelformat::loadFormat(file->name(), stream, sceneGraph)) {
+			state.SkipWithError("Failed to load the model");
+			break;
+		}
+		benchmark::DoNotOptimize(sceneGraph.size());
+	}
+	state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+/**
+ * @brief Reads the whole file byte by byte from the file
+ */
+BENCHMARK_DEFINE_F(FormatBenchmark, readUInt8File)(benchmark::State &state) {
+	const io::FilePtr &file = open(state);
+	io::FileStream stream(file);
+	uint32_t sum = 0u;
+	for (auto _ : state) {
+		stream.seek(0);
+		uint8_t val;
+		while (stream.readUInt8(val) == 0) {
+			sum += val;
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+/**
+ * @brief Reads the whole file byte by byte from memory - this is what the format loaders get from
+ * voxelformat::loadFormat()
+ */
+BENCHMARK_DEFINE_F(FormatBenchmark, readUInt8Memory)(benchmark::State &state) {
+	const io::FilePtr &file = open(state);
+	io::FileStream fileStream(file);
+	io::MemoryReadStream stream(fileStream, (uint32_t)fileStream.size());
+	uint32_t sum = 0u;
+	for (auto _ : state) {
+		stream.seek(0);
+		uint8_t val;
+		while (stream.readUInt8(val) == 0) {
+			sum += val;
+		}
+	}
+	benchmark::DoNotOptimize(sum);
+	state.SetBytesProcessed(state.iterations() * stream.size());
+}
+
+BENCHMARK_REGISTER_F(FormatBenchmark, loadFormat)->DenseRange(0, lengthof(corpus) - 1)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(FormatBenchmark, readUInt8File)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(FormatBenchmark, readUInt8Memory)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+
+#include "app/benchmark/AbstractBenchmark.h"
+#include "core/Color.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/Palette.h"
+#include "voxel/RawVolume.h"
+#include "voxelformat/SceneGraph.h"
+#include "voxelformat/SceneGraphNode.h"
+
+/**
+ * @brief A scene with 100 model nodes of 32x32x32 voxels each, every node with its own palette
+ */
+class SceneGraphBenchmark : public app::AbstractBenchmark {
+protected:
+	voxelformat::SceneGraph _sceneGraph;
+
+public:
+	void onCleanupApp() override {
+		_sceneGraph.clear();
+	}
+
+	bool onInitApp() override {
+		if (!voxel::initDefaultPalette()) {
+			return false;
+		}
+		const int nodes = 100;
+		for (int i = 0; i < nodes; ++i) {
+			voxelformat::SceneGraphNode node(voxelformat::SceneGraphNodeType::Model);
+			const voxel::Region region(0, 31);
+			voxel::RawVolume *v = new voxel::RawVolume(region);
+			for (int z = 0; z <= 31; ++z) {
+				for (int y = 0; y <= 31; ++y) {
+					for (int x = 0; x <= 31; ++x) {
+						if ((x ^ y ^ z ^ i) & 1) {
+							v->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + y + z + i) % 16));
+						}
+					}
+				}
+			}
+			node.setVolume(v, true);
+			voxel::Palette palette;
+			palette.colorCount = 16;
+			for (int c = 0; c < palette.colorCount; ++c) {
+				palette.colors[c] = core::RGBA(i * 2, c * 16, 255 - i, 255);
+			}
+			node.setPalette(palette);
+			voxelformat::SceneGraphTransform transform;
+			transform.setWorldTranslation(glm::vec3((i % 10) * 24, 0, (i / 10) * 24));
+			node.setTransform(0, transform);
+			_sceneGraph.emplace(core::move(node));
+		}
+		return true;
+	}
+};
+
+BENCHMARK_DEFINE_F(SceneGraphBenchmark, mergePalettes)(benchmark::State &state) {
+	for (auto _ : state) {
+		const voxel::Palette &palette = _sceneGraph.mergePalettes(true);
+		benchmark::DoNotOptimize(palette.colorCount);
+	}
+}
+
+BENCHMARK_DEFINE_F(SceneGraphBenchmark, merge)(benchmark::State &state) {
+	for (auto _ : state) {
+		voxelformat::SceneGraph::MergedVolumePalette merged = _sceneGraph.merge();
+		benchmark::DoNotOptimize(merged.first);
+		delete merged.first;
+	}
+}
+
+BENCHMARK_REGISTER_F(SceneGraphBenchmark, mergePalettes)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SceneGraphBenchmark, merge)->Unit(benchmark::kMillisecond);
@@ -10,6 +10,7 @@
 #include "voxel/tests/TestHelper.h"
 #include "voxelformat/SceneGraph.h"
 #include "voxelformat/SceneGraphNode.h"
+#include "voxelutil/VolumeVisitor.h"
 
 namespace voxelformat {
 
@@ -197,6 +198,63 @@ TEST_F(SceneGraphTest, testMerge) {
 	delete merged.first;
 }
 
+TEST_F(SceneGraphTest, testMergeOverlapping) {
+	// more nodes and colors than fit into one palette - with overlapping regions where the later nodes win
+	SceneGraph sceneGraph;
+	const int nodes = 40;
+	for (int i = 0; i < nodes; ++i) {
+		SceneGraphNode node(SceneGraphNodeType::Model);
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 7));
+		for (int z = 0; z <= 7; ++z) {
+			for (int y = 0; y <= 7; ++y) {
+				for (int x = 0; x <= 7; ++x) {
+					if ((x + y + z + i) % 3 != 0) {
+						v->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x + y + z + i) % 8));
+					}
+				}
+			}
+		}
+		node.setVolume(v, true);
+		voxel::Palette pal;
+		pal.colorCount = 8;
+		for (int c = 0; c < pal.colorCount; ++c) {
+			pal.colors[c] = core::RGBA(i * 6, c * 30, 255 - i, 255);
+		}
+		node.setPalette(pal);
+		SceneGraphTransform transform;
+		transform.setWorldTranslation(glm::vec3(i * 3, 0, (i % 5) * 2));
+		node.setTransform(0, transform);
+		sceneGraph.emplace(core::move(node));
+	}
+	const voxel::Palette &palette = sceneGraph.mergePalettes(true);
+	SceneGraph::MergedVolumePalette merged = sceneGraph.merge(true);
+	ASSERT_NE(nullptr, merged.first);
+	ASSERT_EQ(palette.colorCount, merged.second.colorCount);
+	const voxel::Region &region = merged.first->region();
+	EXPECT_EQ(glm::ivec3(0), region.getLowerCorner());
+	EXPECT_EQ(glm::ivec3((nodes - 1) * 3 + 7, 7, 4 * 2 + 7), region.getUpperCorner());
+
+	voxel::RawVolume expected(region);
+	for (const SceneGraphNode &node : sceneGraph) {
+		const glm::ivec3 translation(node.transform(0).worldTranslation());
+		voxelutil::visitVolume(*node.volume(), [&] (int x, int y, int z, const voxel::Voxel &voxel) {
+			const uint8_t color = palette.getClosestMatch(node.palette().colors[voxel.getColor()]);
+			expected.setVoxel(glm::ivec3(x, y, z) + translation, voxel::createVoxel(voxel::VoxelType::Generic, color));
+		});
+	}
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				const voxel::Voxel &voxel = merged.first->voxel(x, y, z);
+				const voxel::Voxel &expectedVoxel = expected.voxel(x, y, z);
+				ASSERT_EQ(expectedVoxel.getMaterial(), voxel.getMaterial()) << "Unexpected voxel at " << x << ":" << y << ":" << z;
+				ASSERT_EQ(expectedVoxel.getColor(), voxel.getColor()) << "Unexpected color at " << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	delete merged.first;
+}
+
 TEST_F(SceneGraphTest, testKeyframes) {
 	SceneGraphNode node(SceneGraphNodeType::Group);
 	EXPECT_EQ(InvalidKeyFrame, node.addKeyFrame(0));
@@ -12,6 +12,7 @@
 #include "video/Texture.h"
 #include "video/TextureConfig.h"
 #include "voxel/CubicSurfaceExtractor.h"
+#include "voxel/RawVolumeSnapshot.h"
 #include "voxelformat/SceneGraphNode.h"
 #include "voxelutil/VolumeMerger.h"
 #include "voxel/MaterialColor.h"
@@ -163,6 +164,10 @@ bool RawVolumeRenderer::scheduleExtractions(size_t maxExtraction) {
 	if (maxExtraction == 0) {
 		return true;
 	}
+	// the snapshots only copy the bricks that were modified since the last extraction - the copy of the
+	// extraction region is done by the worker threads
+	int snapshotIdx = -1;
+	voxel::RawVolumeSnapshotPtr snapshot;
 	size_t i;
 	for (i = 0; i < n; ++i) {
 		const int idx = _extractRegions[i].idx;
@@ -170,22 +175,27 @@ bool RawVolumeRenderer::scheduleExtractions(size_t maxExtraction) {
 		if (v == nullptr) {
 			continue;
 		}
+		if (snapshotIdx != idx) {
+			snapshot = v->snapshot();
+			snapshotIdx = idx;
+		}
 		const voxel::Region& finalRegion = _extractRegions[i].region;
-		bool onlyAir = true;
-		voxel::RawVolume copy(v, voxel::Region(finalRegion.getLowerCorner() - 2, finalRegion.getUpperCorner() + 2), &onlyAir);
 		const glm::ivec3& mins = finalRegion.getLowerCorner();
-		if (!onlyAir) {
-			_threadPool.enqueue([movedCopy = core::move(copy), mins, idx, finalRegion, this] () {
-				++_runningExtractorTasks;
+		_threadPool.enqueue([snapshot, mins, idx, finalRegion, this] () {
+			++_runningExtractorTasks;
+			bool onlyAir = true;
+			voxel::RawVolume *copy = snapshot->toVolume(voxel::Region(finalRegion.getLowerCorner() - 2, finalRegion.getUpperCorner() + 2), &onlyAir);
+			if (copy == nullptr || onlyAir) {
+				_pendingQueue.emplace(mins, idx, core::move(voxel::Mesh()));
+			} else {
 				voxel::Mesh mesh(65536, 65536, true);
-				voxel::extractCubicMesh(&movedCopy, finalRegion, &mesh, voxel::IsQuadNeeded(), mins);
+				voxel::extractCubicMesh(copy, finalRegion, &mesh, voxel::IsQuadNeeded(), mins);
 				_pendingQueue.emplace(mins, idx, core::move(mesh));
-				Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
-				--_runningExtractorTasks;
-			});
-		} else {
-			_pendingQueue.emplace(mins, idx, core::move(voxel::Mesh()));
-		}
+			}
+			delete copy;
+			Log::debug("Enqueue mesh for idx: %i (%i:%i:%i)", idx, mins.x, mins.y, mins.z);
+			--_runningExtractorTasks;
+		});
 		--maxExtraction;
 		if (maxExtraction == 0) {
 			break;
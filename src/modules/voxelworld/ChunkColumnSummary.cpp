@@ -0,0 +1,266 @@
+/**
+ * @file
+ */
+
+#include "ChunkColumnSummary.h"
+#include "core/Common.h"
+#include "core/Log.h"
+#include "core/Trace.h"
+#include "io/Stream.h"
+#include "voxel/Constants.h"
+
+namespace voxelworld {
+
+#define SUMMARY_VERSION 2
+
+ChunkColumnSummary::ChunkColumnSummary(const voxel::Region &region)
+	: _region(region), _width(region.getWidthInVoxels()), _depth(region.getDepthInVoxels()) {
+}
+
+void ChunkColumnSummary::scanColumn(const voxel::PagedVolume::ChunkPtr &chunk, int localX, int localZ,
+									core::DynamicArray<Floor> &floors, Column &column) const {
+	const int height = _region.getHeightInVoxels();
+	column.topSolid = -1;
+	column.surface = voxel::Voxel();
+	column.floorCount = 0u;
+	bool lastEnterable = false;
+	voxel::Voxel last;
+	for (int y = 0; y < height; ++y) {
+		const voxel::Voxel &v = chunk->voxel(localX, y, localZ);
+		const bool enterable = voxel::isEnterable(v.getMaterial());
+		if (!enterable) {
+			column.topSolid = (int16_t)y;
+			column.surface = v;
+		} else if (!lastEnterable) {
+			Floor floor;
+			floor.start = (int16_t)y;
+			floor.end = (int16_t)y;
+			floor.voxel = v;
+			floor.ground = last;
+			floors.push_back(floor);
+			++column.floorCount;
+		} else {
+			floors.back().end = (int16_t)y;
+		}
+		lastEnterable = enterable;
+		last = v;
+	}
+}
+
+void ChunkColumnSummary::build(const voxel::PagedVolume::ChunkPtr &chunk) {
+	core_trace_scoped(ChunkColumnSummaryBuild);
+	core_assert(chunk->sideLength() == _width && chunk->sideLength() == _depth);
+	_columns.resize((size_t)_width * _depth);
+	_floors.clear();
+	for (int z = 0; z < _depth; ++z) {
+		for (int x = 0; x < _width; ++x) {
+			Column &column = _columns[columnIndex(x, z)];
+			column.floorOffset = (uint32_t)_floors.size();
+			scanColumn(chunk, x, z, _floors, column);
+		}
+	}
+}
+
+void ChunkColumnSummary::update(const voxel::PagedVolume::ChunkPtr &chunk, const core::DynamicArray<voxel::Region> &regions) {
+	core_trace_scoped(ChunkColumnSummaryUpdate);
+	if (!valid()) {
+		return;
+	}
+	core::DynamicArray<bool> dirtyColumns;
+	dirtyColumns.resize(_columns.size());
+	dirtyColumns.fill(false);
+	bool dirty = false;
+	for (const voxel::Region &region : regions) {
+		voxel::Region cropped = region;
+		cropped.cropTo(_region);
+		if (!cropped.isValid()) {
+			continue;
+		}
+		const glm::ivec3 &mins = cropped.getLowerCorner() - _region.getLowerCorner();
+		const glm::ivec3 &maxs = cropped.getUpperCorner() - _region.getLowerCorner();
+		for (int z = mins.z; z <= maxs.z; ++z) {
+			for (int x = mins.x; x <= maxs.x; ++x) {
+				dirtyColumns[columnIndex(x, z)] = true;
+			}
+		}
+		dirty = true;
+	}
+	if (!dirty) {
+		return;
+	}
+	// the floors of all columns are stored in one array - so the array has to be assembled again
+	core::DynamicArray<Floor> floors;
+	floors.reserve(_floors.size());
+	for (size_t i = 0; i < _columns.size(); ++i) {
+		Column &column = _columns[i];
+		const uint32_t floorOffset = (uint32_t)floors.size();
+		if (dirtyColumns[i]) {
+			scanColumn(chunk, (int)i % _width, (int)i / _width, floors, column);
+		} else if (column.floorCount > 0u) {
+			floors.append(&_floors[column.floorOffset], column.floorCount);
+		}
+		column.floorOffset = floorOffset;
+	}
+	_floors = core::move(floors);
+}
+
+int ChunkColumnSummary::topSolidHeight(int x, int z) const {
+	const Column &c = column(x, z);
+	if (c.topSolid < 0) {
+		return voxel::NO_FLOOR_FOUND;
+	}
+	return _region.getLowerY() + c.topSolid;
+}
+
+const ChunkColumnSummary::Floor *ChunkColumnSummary::floors(int x, int z, int &amount) const {
+	const Column &c = column(x, z);
+	amount = c.floorCount;
+	if (amount == 0) {
+		return nullptr;
+	}
+	return &_floors[c.floorOffset];
+}
+
+bool ChunkColumnSummary::findWalkableFloor(const glm::ivec3 &position, int maxDistanceUpwards,
+										   voxelutil::FloorTraceResult &result) const {
+	if (!containsColumn(position.x, position.z) || position.y < _region.getLowerY() ||
+		position.y > _region.getUpperY()) {
+		return false;
+	}
+	int amount;
+	const Floor *f = floors(position.x, position.z, amount);
+	const int localY = position.y - _region.getLowerY();
+	for (int i = 0; i < amount; ++i) {
+		const Floor &floor = f[i];
+		if (localY > floor.end) {
+			continue;
+		}
+		if (localY >= floor.start) {
+			// the position is enterable - trace down to the ground of the run
+			if (floor.start == 0) {
+				// the ground is not part of this chunk
+				return false;
+			}
+			result = voxelutil::FloorTraceResult(_region.getLowerY() + floor.start, floor.ground);
+			return true;
+		}
+		// the position is solid - trace up to the next enterable voxel
+		const int maxDistance = core_min(maxDistanceUpwards, voxel::MAX_HEIGHT - position.y);
+		if (floor.start - localY <= maxDistance) {
+			result = voxelutil::FloorTraceResult(_region.getLowerY() + floor.start, floor.voxel);
+		} else {
+			result = voxelutil::FloorTraceResult();
+		}
+		return true;
+	}
+	// solid up to the top of the chunk
+	if (_region.getUpperY() >= voxel::MAX_HEIGHT || position.y + maxDistanceUpwards <= _region.getUpperY()) {
+		result = voxelutil::FloorTraceResult();
+		return true;
+	}
+	return false;
+}
+
+static bool writeVoxel(io::WriteStream &stream, const voxel::Voxel &voxel) {
+	if (!stream.writeUInt8((uint8_t)voxel.getMaterial())) {
+		return false;
+	}
+	if (!stream.writeUInt8(voxel.getColor())) {
+		return false;
+	}
+	return stream.writeUInt8(voxel.getFlags());
+}
+
+static bool readVoxel(io::ReadStream &stream, voxel::Voxel &voxel) {
+	uint8_t material;
+	uint8_t color;
+	uint8_t flags;
+	if (stream.readUInt8(material) != 0 || stream.readUInt8(color) != 0 || stream.readUInt8(flags) != 0) {
+		return false;
+	}
+	if (material >= (uint8_t)voxel::VoxelType::Max) {
+		return false;
+	}
+	voxel = voxel::Voxel((voxel::VoxelType)material, color, flags);
+	return true;
+}
+
+bool ChunkColumnSummary::write(io::WriteStream &stream) const {
+	core_trace_scoped(ChunkColumnSummaryWrite);
+	stream.writeUInt8(SUMMARY_VERSION);
+	const glm::ivec3 &mins = _region.getLowerCorner();
+	const glm::ivec3 &maxs = _region.getUpperCorner();
+	for (int i = 0; i < 3; ++i) {
+		stream.writeInt32(mins[i]);
+		stream.writeInt32(maxs[i]);
+	}
+	stream.writeUInt32((uint32_t)_columns.size());
+	for (const Column &column : _columns) {
+		stream.writeInt16(column.topSolid);
+		writeVoxel(stream, column.surface);
+		stream.writeUInt16(column.floorCount);
+	}
+	for (const Column &column : _columns) {
+		for (uint16_t i = 0; i < column.floorCount; ++i) {
+			const Floor &floor = _floors[column.floorOffset + i];
+			stream.writeInt16(floor.start);
+			stream.writeInt16(floor.end);
+			writeVoxel(stream, floor.voxel);
+			if (!writeVoxel(stream, floor.ground)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool ChunkColumnSummary::read(io::ReadStream &stream) {
+	core_trace_scoped(ChunkColumnSummaryRead);
+	uint8_t version;
+	if (stream.readUInt8(version) != 0 || version != SUMMARY_VERSION) {
+		Log::warn("Unsupported column summary version");
+		return false;
+	}
+	glm::ivec3 mins;
+	glm::ivec3 maxs;
+	for (int i = 0; i < 3; ++i) {
+		if (stream.readInt32(mins[i]) != 0 || stream.readInt32(maxs[i]) != 0) {
+			return false;
+		}
+	}
+	const voxel::Region region(mins, maxs);
+	if (!region.isValid()) {
+		return false;
+	}
+	uint32_t columnCount;
+	if (stream.readUInt32(columnCount) != 0) {
+		return false;
+	}
+	if (columnCount != (uint32_t)region.getWidthInVoxels() * (uint32_t)region.getDepthInVoxels()) {
+		Log::warn("Invalid column count in summary: %u", columnCount);
+		return false;
+	}
+	*this = ChunkColumnSummary(region);
+	_columns.resize(columnCount);
+	uint32_t floorCount = 0u;
+	for (Column &column : _columns) {
+		if (stream.readInt16(column.topSolid) != 0 || !readVoxel(stream, column.surface) || stream.readUInt16(column.floorCount) != 0) {
+			_columns.clear();
+			return false;
+		}
+		column.floorOffset = floorCount;
+		floorCount += column.floorCount;
+	}
+	_floors.resize(floorCount);
+	for (Floor &floor : _floors) {
+		if (stream.readInt16(floor.start) != 0 || stream.readInt16(floor.end) != 0 ||
+			!readVoxel(stream, floor.voxel) || !readVoxel(stream, floor.ground)) {
+			_columns.clear();
+			_floors.clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace voxelworld
@@ -0,0 +1,147 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "voxelutil/FloorTraceResult.h"
+#include "core/Assert.h"
+#include "core/SharedPtr.h"
+#include "core/collection/DynamicArray.h"
+#include <glm/vec3.hpp>
+
+namespace io {
+class ReadStream;
+class WriteStream;
+}
+
+namespace voxelworld {
+
+/**
+ * @brief Per column information about a chunk of the world that is gathered once the chunk was generated.
+ *
+ * For each x/z column of the chunk this stores the highest solid voxel, the surface material and the list of
+ * walkable floors. This allows to answer floor and height queries without walking the voxels of the
+ * @c voxel::PagedVolume.
+ *
+ * @note The summary is not updated if the voxels of the chunk are modified.
+ */
+class ChunkColumnSummary {
+public:
+	/**
+	 * @brief A vertical run of enterable voxels
+	 */
+	struct Floor {
+		/**
+		 * The lowest enterable voxel of the run - this is the height level of the floor
+		 */
+		int16_t start;
+		/**
+		 * The highest enterable voxel of the run
+		 */
+		int16_t end;
+		/**
+		 * The voxel at @c start
+		 */
+		voxel::Voxel voxel;
+		/**
+		 * The solid voxel below @c start - only valid if @c start is not the lowest voxel of the chunk
+		 */
+		voxel::Voxel ground;
+	};
+
+	struct Column {
+		// the chunk local height of the highest solid voxel or -1 if the column is empty
+		int16_t topSolid = -1;
+		voxel::Voxel surface;
+		uint16_t floorCount = 0u;
+		uint32_t floorOffset = 0u;
+	};
+
+private:
+	voxel::Region _region;
+	int _width = 0;
+	int _depth = 0;
+	core::DynamicArray<Column> _columns;
+	core::DynamicArray<Floor> _floors;
+
+	int columnIndex(int localX, int localZ) const;
+	void scanColumn(const voxel::PagedVolume::ChunkPtr &chunk, int localX, int localZ,
+					core::DynamicArray<Floor> &floors, Column &column) const;
+
+public:
+	ChunkColumnSummary() {}
+	ChunkColumnSummary(const voxel::Region &region);
+
+	/**
+	 * @brief Collects the column information from the voxels of the given chunk
+	 */
+	void build(const voxel::PagedVolume::ChunkPtr &chunk);
+	/**
+	 * @brief Collects the column information again for all columns that intersect the given regions - e.g. after
+	 * objects were placed in the chunk
+	 */
+	void update(const voxel::PagedVolume::ChunkPtr &chunk, const core::DynamicArray<voxel::Region> &regions);
+
+	/**
+	 * @return @c false if the summary was not yet built or loaded
+	 */
+	bool valid() const;
+	const voxel::Region &region() const;
+	bool containsColumn(int x, int z) const;
+
+	const Column &column(int x, int z) const;
+	/**
+	 * @return The world height of the highest solid voxel in the column or @c voxel::NO_FLOOR_FOUND
+	 */
+	int topSolidHeight(int x, int z) const;
+	const voxel::Voxel &surface(int x, int z) const;
+	/**
+	 * @return The enterable runs of the column ordered from bottom to top. The heights are chunk local.
+	 */
+	const Floor *floors(int x, int z, int &amount) const;
+
+	/**
+	 * @brief Resolves the same floor that @c voxelutil::findWalkableFloor() would find for the given world position
+	 * @param[out] result The floor trace result
+	 * @return @c false if the query can't be answered by the data of this chunk - e.g. because the trace would leave
+	 * the chunk. The caller has to walk the voxels in this case.
+	 */
+	bool findWalkableFloor(const glm::ivec3 &position, int maxDistanceUpwards, voxelutil::FloorTraceResult &result) const;
+
+	bool write(io::WriteStream &stream) const;
+	bool read(io::ReadStream &stream);
+};
+
+typedef core::SharedPtr<ChunkColumnSummary> ChunkColumnSummaryPtr;
+
+inline int ChunkColumnSummary::columnIndex(int localX, int localZ) const {
+	return localZ * _width + localX;
+}
+
+inline bool ChunkColumnSummary::valid() const {
+	return !_columns.empty();
+}
+
+inline const voxel::Region &ChunkColumnSummary::region() const {
+	return _region;
+}
+
+inline bool ChunkColumnSummary::containsColumn(int x, int z) const {
+	return valid() && x >= _region.getLowerX() && x <= _region.getUpperX() && z >= _region.getLowerZ() &&
+		   z <= _region.getUpperZ();
+}
+
+inline const ChunkColumnSummary::Column &ChunkColumnSummary::column(int x, int z) const {
+	core_assert(containsColumn(x, z));
+	return _columns[columnIndex(x - _region.getLowerX(), z - _region.getLowerZ())];
+}
+
+inline const voxel::Voxel &ChunkColumnSummary::surface(int x, int z) const {
+	return column(x, z).surface;
+}
+
+} // namespace voxelworld
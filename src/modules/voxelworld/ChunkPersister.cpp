@@ -3,7 +3,9 @@
  */
 
 #include "ChunkPersister.h"
+#include "ChunkColumnSummary.h"
 #include "io/BufferedReadWriteStream.h"
+#include "io/MemoryReadStream.h"
 #include "core/Zip.h"
 #include "core/Assert.h"
 #include "core/Enum.h"
@@ -12,36 +14,57 @@
 
 namespace voxelworld {
 
-#define WORLD_FILE_VERSION 2
+#define WORLD_FILE_VERSION 3
 
-bool ChunkPersister::saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, io::BufferedReadWriteStream& outStream) const {
+static bool compressBuffer(const uint8_t *buf, uint32_t size, std::unique_ptr<uint8_t[]> &compressed, size_t &compressedSize) {
+	const uint32_t neededBufLen = core::zip::compressBound(size);
+	compressed.reset(new uint8_t[neededBufLen]);
+	return core::zip::compress(buf, size, compressed.get(), neededBufLen, &compressedSize);
+}
+
+bool ChunkPersister::saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, io::BufferedReadWriteStream& outStream, const ChunkColumnSummary* summary) const {
 	// save the stuff
 	const voxel::Voxel* voxelBuf = chunk->data();
 	const int voxelSize = chunk->dataSizeInBytes();
-	uint32_t neededVoxelBufLen = core::zip::compressBound(voxelSize);
-	uint8_t* compressedVoxelBuf = new uint8_t[neededVoxelBufLen];
-	std::unique_ptr<uint8_t[]> smartBuf(compressedVoxelBuf);
+	std::unique_ptr<uint8_t[]> compressedVoxelBuf;
 	size_t finalBufferSize;
+	io::BufferedReadWriteStream summaryStream;
+	std::unique_ptr<uint8_t[]> compressedSummaryBuf;
+	size_t finalSummaryBufferSize = 0;
 	{
 		core_trace_scoped(ChunkPersisterCompress);
-		const bool success = core::zip::compress((const uint8_t*)voxelBuf, voxelSize, compressedVoxelBuf, neededVoxelBufLen, &finalBufferSize);
-		if (!success) {
+		if (!compressBuffer((const uint8_t*)voxelBuf, voxelSize, compressedVoxelBuf, finalBufferSize)) {
 			Log::error("Failed to compress the voxel data");
 			return false;
 		}
+		if (summary != nullptr && summary->valid()) {
+			if (!summary->write(summaryStream)) {
+				Log::error("Failed to write the column summary");
+				return false;
+			}
+			if (!compressBuffer(summaryStream.getBuffer(), summaryStream.size(), compressedSummaryBuf, finalSummaryBufferSize)) {
+				Log::error("Failed to compress the column summary");
+				return false;
+			}
+		}
 	}
 	{
 		core_trace_scoped(ChunkPersisterSaveCompressed);
 		outStream.writeUInt32(voxelSize);
 		outStream.writeUInt8(WORLD_FILE_VERSION);
-		outStream.write(compressedVoxelBuf, finalBufferSize);
+		outStream.writeUInt32(finalSummaryBufferSize > 0 ? (uint32_t)summaryStream.size() : 0u);
+		outStream.writeUInt32((uint32_t)finalSummaryBufferSize);
+		if (finalSummaryBufferSize > 0) {
+			outStream.write(compressedSummaryBuf.get(), finalSummaryBufferSize);
+		}
+		outStream.write(compressedVoxelBuf.get(), finalBufferSize);
 	}
 	return true;
 }
 
-bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, const uint8_t *fileBuf, size_t fileLen) const {
+bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, const uint8_t *fileBuf, size_t fileLen, ChunkColumnSummary* summary) const {
 	core_trace_scoped(ChunkPersisterLoadCompressed);
-	const size_t headerSize = sizeof(int32_t) + sizeof(uint8_t);
+	const size_t headerSize = sizeof(int32_t) + sizeof(uint8_t) + 2 * sizeof(uint32_t);
 	if (!fileBuf || fileLen <= headerSize) {
 		return false;
 	}
@@ -52,6 +75,10 @@ bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 	bs.readUInt32(len);
 	uint8_t version;
 	bs.readUInt8(version);
+	uint32_t summaryLen;
+	bs.readUInt32(summaryLen);
+	uint32_t compressedSummaryLen;
+	bs.readUInt32(compressedSummaryLen);
 
 	if (version != WORLD_FILE_VERSION) {
 		Log::warn("chunk has a wrong version number %i (expected %i)",
@@ -63,8 +90,12 @@ bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 		Log::error("extracted memory would not fit the target chunk (%i bytes vs %i chunk size)", len, sizeLimit);
 		return false;
 	}
-	const uint8_t* buf = fileBuf + headerSize;
-	const size_t remaining = fileLen - headerSize;
+	if (compressedSummaryLen >= fileLen - headerSize) {
+		Log::error("Invalid column summary size %u", compressedSummaryLen);
+		return false;
+	}
+	const uint8_t* buf = fileBuf + headerSize + compressedSummaryLen;
+	const size_t remaining = fileLen - headerSize - compressedSummaryLen;
 
 	// TODO: doesn't work on big endian
 	uint8_t *targetBuf = (uint8_t*)chunk->data();
@@ -72,6 +103,17 @@ bool ChunkPersister::loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, c
 		Log::error("Failed to uncompress the world data with len %i", len);
 		return false;
 	}
+	if (summary != nullptr && summaryLen > 0u) {
+		std::unique_ptr<uint8_t[]> summaryBuf(new uint8_t[summaryLen]);
+		if (!core::zip::uncompress(fileBuf + headerSize, compressedSummaryLen, summaryBuf.get(), summaryLen)) {
+			Log::warn("Failed to uncompress the column summary with len %u", summaryLen);
+			return true;
+		}
+		io::MemoryReadStream summaryStream(summaryBuf.get(), summaryLen);
+		if (!summary->read(summaryStream)) {
+			Log::warn("Failed to read the column summary");
+		}
+	}
 	return true;
 }
 
@@ -13,6 +13,8 @@
 
 namespace voxelworld {
 
+class ChunkColumnSummary;
+
 class ChunkPersister : public core::IComponent {
 public:
 	virtual ~ChunkPersister() {}
@@ -20,12 +22,19 @@ public:
 	virtual bool init() override { return true; };
 	virtual void shutdown() override { };
 
-	virtual bool load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) { return false; }
-	virtual bool save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) { return false; }
+	/**
+	 * @param[out] summary If not @c null, this is filled with the persisted column summary of the chunk. If the
+	 * chunk was persisted without a summary, it stays untouched.
+	 */
+	virtual bool load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, ChunkColumnSummary* summary = nullptr) { return false; }
+	/**
+	 * @param[in] summary The optional column summary that is persisted together with the chunk
+	 */
+	virtual bool save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, const ChunkColumnSummary* summary = nullptr) { return false; }
 	virtual void erase(const voxel::Region& region, unsigned int seed) { }
 
-	bool loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, const uint8_t *fileBuf, size_t fileLen) const;
-	bool saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, io::BufferedReadWriteStream& outStream) const;
+	bool loadCompressed(const voxel::PagedVolume::ChunkPtr& chunk, const uint8_t *fileBuf, size_t fileLen, ChunkColumnSummary* summary = nullptr) const;
+	bool saveCompressed(const voxel::PagedVolume::ChunkPtr& chunk, io::BufferedReadWriteStream& outStream, const ChunkColumnSummary* summary = nullptr) const;
 };
 
 typedef std::shared_ptr<ChunkPersister> ChunkPersisterPtr;
@@ -31,7 +31,7 @@ void FilePersister::erase(const voxel::Region& region, unsigned int seed) {
 #endif
 }
 
-bool FilePersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) {
+bool FilePersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, ChunkColumnSummary* summary) {
 	core_trace_scoped(WorldPersisterLoad);
 	const io::FilesystemPtr& filesystem = io::filesystem();
 	const core::String& filename = getWorldName(chunk->chunkPos(), seed);
@@ -42,15 +42,15 @@ bool FilePersister::load(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int
 	Log::trace("Try to load world %s", f->name().c_str());
 	uint8_t *fileBuf;
 	const int fileLen = f->read((void **) &fileBuf);
-	const bool success = loadCompressed(chunk, fileBuf, fileLen);
+	const bool success = loadCompressed(chunk, fileBuf, fileLen, summary);
 	delete[] fileBuf;
 	return success;
 }
 
-bool FilePersister::save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed) {
+bool FilePersister::save(const voxel::PagedVolume::ChunkPtr& chunk, unsigned int seed, const ChunkColumnSummary* summary) {
 	core_trace_scoped(WorldPersisterLoad);
 	io::BufferedReadWriteStream final;
-	if (!saveCompressed(chunk, final)) {
+	if (!saveCompressed(chunk, final, summary)) {
 		return false;
 	}
 	const core::String& filename = getWorldName(chunk->chunkPos(), seed);
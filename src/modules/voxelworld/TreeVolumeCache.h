@@ -30,6 +30,14 @@ public:
 	 * @return voxel::RawVolume or @c nullptr if no tree volume was found for the given tree type.
 	 */
 	voxel::RawVolume* loadTree(const glm::ivec3& treePos, const char *treeType);
+	/**
+	 * @sa voxelformat::VolumeCache::generation()
+	 */
+	int generation() const;
 };
 
+inline int TreeVolumeCache::generation() const {
+	return _volumeCache->generation();
+}
+
 }
\ No newline at end of file
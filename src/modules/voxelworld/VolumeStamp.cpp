@@ -0,0 +1,173 @@
+/**
+ * @file
+ */
+
+#include "VolumeStamp.h"
+#include "core/Assert.h"
+#include "core/Common.h"
+#include "core/Trace.h"
+#include "voxel/RawVolume.h"
+
+namespace voxelworld {
+
+VolumeStamp::VolumeStamp(const voxel::RawVolume *volume, int orientation) {
+	core_trace_scoped(VolumeStampCreate);
+	core_assert(orientation >= 0 && orientation < Orientations);
+	const voxel::Region &region = volume->region();
+	const glm::ivec3 &mins = region.getLowerCorner();
+	const glm::ivec3 &maxs = region.getUpperCorner();
+	_region = region;
+	if (orientation == 1 || orientation == 3) {
+		_region.setUpperX(mins.x + region.getDepthInVoxels() - 1);
+		_region.setUpperZ(mins.z + region.getWidthInVoxels() - 1);
+	} else if (orientation == SwapXZ) {
+		_region = voxel::Region(mins.z, mins.y, mins.x, maxs.z, maxs.y, maxs.x);
+	}
+	for (int z = mins.z; z <= maxs.z; ++z) {
+		for (int x = mins.x; x <= maxs.x; ++x) {
+			int rx;
+			int rz;
+			switch (orientation) {
+			case 1:
+				rx = mins.x + (maxs.z - z);
+				rz = mins.z + (x - mins.x);
+				break;
+			case 2:
+				rx = mins.x + (maxs.x - x);
+				rz = mins.z + (maxs.z - z);
+				break;
+			case 3:
+				rx = mins.x + (z - mins.z);
+				rz = mins.z + (maxs.x - x);
+				break;
+			case SwapXZ:
+				rx = z;
+				rz = x;
+				break;
+			default:
+				rx = x;
+				rz = z;
+				break;
+			}
+			for (int y = mins.y; y <= maxs.y; ++y) {
+				const voxel::Voxel &voxel = volume->voxel(x, y, z);
+				if (voxel::isAir(voxel.getMaterial())) {
+					continue;
+				}
+				// extend the span of the previous voxel in this column if there is one
+				if (!_spans.empty()) {
+					Span &last = _spans.back();
+					if (last.x == rx && last.z == rz && last.y + last.length == y) {
+						++last.length;
+						_voxels.push_back(voxel);
+						continue;
+					}
+				}
+				Span span;
+				span.x = (int16_t)rx;
+				span.y = (int16_t)y;
+				span.z = (int16_t)rz;
+				span.length = 1u;
+				span.offset = (uint32_t)_voxels.size();
+				_spans.push_back(span);
+				_voxels.push_back(voxel);
+			}
+		}
+	}
+}
+
+int VolumeStamp::apply(const voxel::PagedVolume::ChunkPtr &chunk, const voxel::Region &chunkRegion,
+					   const glm::ivec3 &pos) const {
+	const glm::ivec3 &mins = chunkRegion.getLowerCorner();
+	const glm::ivec3 &maxs = chunkRegion.getUpperCorner();
+	int amount = 0;
+	for (const Span &span : _spans) {
+		const int x = pos.x + span.x;
+		if (x < mins.x || x > maxs.x) {
+			continue;
+		}
+		const int z = pos.z + span.z;
+		if (z < mins.z || z > maxs.z) {
+			continue;
+		}
+		const int lowerY = pos.y + span.y;
+		const int startY = core_max(lowerY, mins.y);
+		const int endY = core_min(lowerY + span.length - 1, maxs.y);
+		if (startY > endY) {
+			continue;
+		}
+		const int n = endY - startY + 1;
+		chunk->setVoxels(x - mins.x, startY - mins.y, z - mins.z, voxels(span) + (startY - lowerY), n);
+		amount += n;
+	}
+	return amount;
+}
+
+VolumeStampPtr VolumeStampCache::stamp(const voxel::RawVolume *volume, int orientation, int generation) {
+	core_assert(orientation >= 0 && orientation < VolumeStamp::Orientations);
+	// the volumes are heap allocated - the lower bits of the address are free for the orientation
+	static_assert(VolumeStamp::Orientations <= 8, "Not enough free bits for the orientation");
+	core_assert(((uintptr_t)volume & 7) == 0);
+	const uintptr_t key = (uintptr_t)volume | (uintptr_t)orientation;
+	core::ScopedLock lock(_lock);
+	if (_generation != generation) {
+		_stamps.clear();
+		_generation = generation;
+	}
+	auto i = _stamps.find(key);
+	if (i != _stamps.end()) {
+		return i->value;
+	}
+	const VolumeStampPtr &stamp = core::make_shared<VolumeStamp>(volume, orientation);
+	_stamps.put(key, stamp);
+	return stamp;
+}
+
+void VolumeStampCache::shutdown() {
+	core::ScopedLock lock(_lock);
+	_stamps.clear();
+}
+
+size_t VolumeStampCache::size() {
+	core::ScopedLock lock(_lock);
+	return _stamps.size();
+}
+
+VolumeStampBatch::VolumeStampBatch(const voxel::Region &region) : _region(region) {
+}
+
+bool VolumeStampBatch::touchesColumns(const VolumeStamp &stamp, const glm::ivec3 &pos) const {
+	const voxel::Region &region = stamp.region();
+	if (region.getLowerX() + pos.x > _region.getUpperX() || region.getUpperX() + pos.x < _region.getLowerX()) {
+		return false;
+	}
+	if (region.getLowerZ() + pos.z > _region.getUpperZ() || region.getUpperZ() + pos.z < _region.getLowerZ()) {
+		return false;
+	}
+	return true;
+}
+
+bool VolumeStampBatch::add(const VolumeStampPtr &stamp, const glm::ivec3 &pos) {
+	if (!voxel::intersects(_region, stamp->region(pos))) {
+		return false;
+	}
+	Entry entry;
+	entry.stamp = stamp;
+	entry.pos = pos;
+	_entries.push_back(entry);
+	return true;
+}
+
+int VolumeStampBatch::apply(const voxel::PagedVolume::ChunkPtr &chunk, core::DynamicArray<voxel::Region> *regions) const {
+	core_trace_scoped(VolumeStampBatchApply);
+	int amount = 0;
+	for (const Entry &entry : _entries) {
+		amount += entry.stamp->apply(chunk, _region, entry.pos);
+		if (regions != nullptr) {
+			regions->push_back(entry.stamp->region(entry.pos));
+		}
+	}
+	return amount;
+}
+
+} // namespace voxelworld
@@ -0,0 +1,168 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "voxel/PagedVolume.h"
+#include "voxel/Region.h"
+#include "voxel/Voxel.h"
+#include "core/SharedPtr.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/HashMap.h"
+#include "core/concurrent/Lock.h"
+#include <glm/vec3.hpp>
+
+namespace voxel {
+class RawVolume;
+}
+
+namespace voxelworld {
+
+/**
+ * @brief A template volume (e.g. a tree) that was rotated around the y axis (or had its x and z axes swapped) and
+ * converted into run-length encoded vertical spans of solid voxels. Air voxels of the template are not part of the
+ * stamp.
+ *
+ * The spans are copied into the chunk column by column - which is much cheaper than visiting each voxel of the
+ * template volume.
+ */
+class VolumeStamp {
+public:
+	/**
+	 * The amount of supported rotations around the y axis - in 90 degree steps
+	 */
+	static constexpr int Rotations = 4;
+	/**
+	 * Swaps the x and z axes of the template - this is what @c voxelutil::RawVolumeRotateWrapper does for
+	 * @c math::Axis::Y
+	 */
+	static constexpr int SwapXZ = Rotations;
+	/**
+	 * The amount of supported orientations - the rotations and @c SwapXZ
+	 */
+	static constexpr int Orientations = Rotations + 1;
+
+	struct Span {
+		// template space position of the lowest voxel of the span
+		int16_t x;
+		int16_t y;
+		int16_t z;
+		uint16_t length;
+		// index of the first voxel of the span
+		uint32_t offset;
+	};
+
+private:
+	voxel::Region _region;
+	core::DynamicArray<Span> _spans;
+	core::DynamicArray<voxel::Voxel> _voxels;
+
+public:
+	/**
+	 * @param orientation The amount of 90 degree rotations around the y axis or @c SwapXZ. The rotated template
+	 * keeps the lower corner of the template region - the swapped template swaps the corners, too.
+	 */
+	VolumeStamp(const voxel::RawVolume *volume, int orientation);
+
+	/**
+	 * @return The rotated region in template space
+	 */
+	const voxel::Region &region() const;
+	/**
+	 * @return The region the stamp covers if it is placed at the given position
+	 */
+	voxel::Region region(const glm::ivec3 &pos) const;
+	const core::DynamicArray<Span> &spans() const;
+	const voxel::Voxel *voxels(const Span &span) const;
+
+	/**
+	 * @brief Copies the spans into the given chunk - every voxel outside of the chunk region is skipped
+	 * @param chunkRegion The world region of the chunk
+	 * @param pos The world position of the template space origin
+	 * @return The amount of voxels that were set
+	 */
+	int apply(const voxel::PagedVolume::ChunkPtr &chunk, const voxel::Region &chunkRegion, const glm::ivec3 &pos) const;
+};
+
+typedef core::SharedPtr<VolumeStamp> VolumeStampPtr;
+
+/**
+ * @brief Caches the rotated stamps of template volumes
+ * @note The volume pointer is used as key - the cache is cleared if the given generation of the template volumes
+ * changes (see @c voxelformat::VolumeCache::generation())
+ */
+class VolumeStampCache {
+private:
+	core::HashMap<uintptr_t, VolumeStampPtr> _stamps core_thread_guarded_by(_lock);
+	int _generation core_thread_guarded_by(_lock) = 0;
+	core_trace_mutex(core::Lock, _lock, "VolumeStampCache");
+
+public:
+	/**
+	 * @param generation The generation of the template volumes - the cached stamps of other generations are
+	 * dropped as their volumes might have been freed and the address reused
+	 */
+	VolumeStampPtr stamp(const voxel::RawVolume *volume, int orientation, int generation = 0);
+	void shutdown();
+	size_t size();
+};
+
+/**
+ * @brief Collects all stamps for one chunk to copy them in one pass
+ *
+ * The stamps are applied in the order they were added - later stamps overwrite the voxels of earlier stamps.
+ */
+class VolumeStampBatch {
+private:
+	struct Entry {
+		VolumeStampPtr stamp;
+		glm::ivec3 pos;
+	};
+	voxel::Region _region;
+	core::DynamicArray<Entry> _entries;
+
+public:
+	/**
+	 * @param region The world region of the chunk
+	 */
+	VolumeStampBatch(const voxel::Region &region);
+
+	/**
+	 * @brief Check whether the stamp placed at the given position would touch the x and z range of the chunk - the
+	 * height is not taken into account. This allows to skip a stamp before its height is known.
+	 */
+	bool touchesColumns(const VolumeStamp &stamp, const glm::ivec3 &pos) const;
+	/**
+	 * @return @c false if the stamp doesn't intersect the chunk region and was not added
+	 */
+	bool add(const VolumeStampPtr &stamp, const glm::ivec3 &pos);
+	/**
+	 * @param[out] regions If not @c nullptr the world regions of the applied stamps are added here
+	 * @return The amount of voxels that were set
+	 */
+	int apply(const voxel::PagedVolume::ChunkPtr &chunk, core::DynamicArray<voxel::Region> *regions = nullptr) const;
+	size_t size() const;
+};
+
+inline const voxel::Region &VolumeStamp::region() const {
+	return _region;
+}
+
+inline voxel::Region VolumeStamp::region(const glm::ivec3 &pos) const {
+	return voxel::Region(_region.getLowerCorner() + pos, _region.getUpperCorner() + pos);
+}
+
+inline const core::DynamicArray<VolumeStamp::Span> &VolumeStamp::spans() const {
+	return _spans;
+}
+
+inline const voxel::Voxel *VolumeStamp::voxels(const Span &span) const {
+	return &_voxels[span.offset];
+}
+
+inline size_t VolumeStampBatch::size() const {
+	return _entries.size();
+}
+
+} // namespace voxelworld
@@ -21,6 +21,10 @@ WorldMgr::WorldMgr(const voxel::PagedVolume::PagerPtr& pager) :
 		_pager(pager), _random(_seed) {
 }
 
+WorldMgr::WorldMgr(const WorldPagerPtr& pager) :
+		_pager(pager), _worldPager(pager), _random(_seed) {
+}
+
 WorldMgr::~WorldMgr() {
 	shutdown();
 }
@@ -63,8 +67,23 @@ void WorldMgr::shutdown() {
 
 voxelutil::FloorTraceResult WorldMgr::findWalkableFloor(const glm::ivec3& position, int maxDistanceUpwards) const {
 	core_assert_msg(_volumeData != nullptr, "WorldMgr is not initialized");
+	voxelutil::FloorTraceResult result;
+	if (findSummaryFloor(position, maxDistanceUpwards, result)) {
+		return result;
+	}
 	voxel::PagedVolume::Sampler sampler(_volumeData);
 	return voxelutil::findWalkableFloor(&sampler, position, maxDistanceUpwards);
 }
 
+bool WorldMgr::findSummaryFloor(const glm::ivec3& position, int maxDistanceUpwards, voxelutil::FloorTraceResult& result) const {
+	if (!_worldPager) {
+		return false;
+	}
+	const ChunkColumnSummaryPtr& summary = _worldPager->columnSummary(_volumeData->chunkPos(position));
+	if (!summary) {
+		return false;
+	}
+	return summary->findWalkableFloor(position, maxDistanceUpwards, result);
+}
+
 }
@@ -11,6 +11,7 @@
 #include "voxelutil/Raycast.h"
 #include "voxelutil/FloorTraceResult.h"
 #include "voxelformat/VolumeCache.h"
+#include "WorldPager.h"
 #include "voxel/Constants.h"
 #include "core/GLM.h"
 #include "math/Random.h"
@@ -28,6 +29,10 @@ namespace voxelworld {
 class WorldMgr {
 public:
 	WorldMgr(const voxel::PagedVolume::PagerPtr& pager);
+	/**
+	 * @brief Floor queries are answered by the column summaries of the pager if possible
+	 */
+	WorldMgr(const WorldPagerPtr& pager);
 	~WorldMgr();
 
 	/**
@@ -47,6 +52,13 @@ public:
 	 */
 	voxelutil::FloorTraceResult findWalkableFloor(const glm::ivec3& position, int maxDistanceUpwards = voxel::MAX_HEIGHT) const;
 
+	/**
+	 * @brief Resolves the floor from the column summary of the chunk without touching the voxels
+	 * @return @c false if there is no column summary for the chunk or the summary can't answer the query
+	 * @sa ChunkColumnSummary::findWalkableFloor()
+	 */
+	bool findSummaryFloor(const glm::ivec3& position, int maxDistanceUpwards, voxelutil::FloorTraceResult& result) const;
+
 	bool init(uint32_t volumeMemoryMegaBytes = 1024, uint16_t chunkSideLength = 256);
 	void shutdown();
 	void reset();
@@ -74,6 +86,7 @@ private:
 	glm::ivec3 chunkPos(const glm::ivec3& pos) const;
 
 	voxel::PagedVolume::PagerPtr _pager;
+	WorldPagerPtr _worldPager;
 	voxel::PagedVolume *_volumeData = nullptr;
 	mutable std::mt19937 _engine;
 	long _seed = 0l;
@@ -26,7 +26,13 @@ bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
 	if (pctx.region.getLowerY() < 0) {
 		return false;
 	}
-	if (_chunkPersister->load(pctx.chunk, _seed)) {
+	const ChunkColumnSummaryPtr& summary = core::make_shared<ChunkColumnSummary>(pctx.region);
+	if (_chunkPersister->load(pctx.chunk, _seed, summary.get())) {
+		if (!summary->valid()) {
+			// persisted without a summary
+			summary->build(pctx.chunk);
+		}
+		addColumnSummary(pctx.chunk->chunkPos(), summary);
 		return false;
 	}
 	voxel::PagedVolumeWrapper wrapper(_volumeData, pctx.chunk, pctx.region);
@@ -34,8 +40,10 @@ bool WorldPager::pageIn(voxel::PagedVolume::PagerContext& pctx) {
 	core_trace_scoped(CreateWorld);
 	math::Random random(_seed);
 	createWorld(wrapper);
-	placeTrees(pctx);
-	_chunkPersister->save(pctx.chunk, _seed);
+	summary->build(pctx.chunk);
+	placeTrees(pctx, *summary.get());
+	_chunkPersister->save(pctx.chunk, _seed, summary.get());
+	addColumnSummary(pctx.chunk->chunkPos(), summary);
 	//}
 	return true;
 }
@@ -44,6 +52,40 @@ void WorldPager::pageOut(voxel::PagedVolume::Chunk* chunk) {
 	// currently chunks are not modifiable and are saved directly after creating the chunk
 }
 
+void WorldPager::addColumnSummary(const glm::ivec3& chunkPos, const ChunkColumnSummaryPtr& summary) {
+	core::ScopedLock lock(_columnSummaryLock);
+	ColumnSummaryEntry entry;
+	entry.summary = summary;
+	entry.lastAccessed = ++_columnSummaryTimestamper;
+	_columnSummaries.put(chunkPos, entry);
+	// the summaries of chunks that were removed from the volume are still valid, as the chunks are not modified
+	// after they were generated - but don't keep more of them than the volume keeps chunks
+	if (_columnSummaries.size() <= _volumeData->chunkCountLimit()) {
+		return;
+	}
+	auto oldest = _columnSummaries.end();
+	uint32_t oldestTimestamp = _columnSummaryTimestamper;
+	for (auto i = _columnSummaries.begin(); i != _columnSummaries.end(); ++i) {
+		if (i->value.lastAccessed < oldestTimestamp) {
+			oldestTimestamp = i->value.lastAccessed;
+			oldest = i;
+		}
+	}
+	if (oldest != _columnSummaries.end()) {
+		_columnSummaries.erase(oldest);
+	}
+}
+
+ChunkColumnSummaryPtr WorldPager::columnSummary(const glm::ivec3& chunkPos) const {
+	core::ScopedLock lock(_columnSummaryLock);
+	auto i = _columnSummaries.find(chunkPos);
+	if (i == _columnSummaries.end()) {
+		return ChunkColumnSummaryPtr();
+	}
+	i->value.lastAccessed = ++_columnSummaryTimestamper;
+	return i->value.summary;
+}
+
 void WorldPager::setSeed(unsigned int seed) {
 	_seed = seed;
 }
@@ -76,7 +118,12 @@ void WorldPager::shutdown() {
 	}
 	_noise.shutdown();
 	_volumeCache.shutdown();
+	_stampCache.shutdown();
 	_volumeData = nullptr;
+	{
+		core::ScopedLock lock(_columnSummaryLock);
+		_columnSummaries.clear();
+	}
 	_biomeManager.shutdown();
 	_worldCtx = WorldContext();
 }
@@ -136,19 +183,39 @@ int WorldPager::terrainHeight(int x, int y, int z) const {
 	return terrainHeight(x, y, z, n);
 }
 
-int WorldPager::terrainHeight(int x, int minsY, int z, float n) const {
-	core_trace_scoped(TerrainHeight);
+int WorldPager::surfaceHeight(int x, int z, float n) const {
 	const int maxHeight = voxel::MAX_TERRAIN_HEIGHT - 1;
 	int centerHeight;
 	// the center of a city should make the terrain more even
 	const float cityMultiplier = _biomeManager.getCityMultiplier(glm::ivec2(x, z), &centerHeight);
-	int ni;
 	if (cityMultiplier < 1.0f) {
 		const float revn = (1.0f - cityMultiplier);
-		ni = revn * centerHeight + (cityMultiplier * n * maxHeight);
-	} else {
-		ni = n * maxHeight;
+		return revn * centerHeight + (cityMultiplier * n * maxHeight);
+	}
+	return n * maxHeight;
+}
+
+bool WorldPager::aboveWater(int x, int minsY, int z) const {
+	core_trace_scoped(AboveWater);
+	const float n = getNoiseValue(x, z);
+	const int ni = surfaceHeight(x, z, n);
+	if (ni <= minsY + 1) {
+		return ni > voxel::MAX_WATER_HEIGHT;
+	}
+	// terrainHeight() ends one voxel above the first solid density from the top - so the densities
+	// below the water level don't matter
+	const int minY = core_max(minsY + 1, voxel::MAX_WATER_HEIGHT);
+	for (int y = ni - 1; y >= minY; --y) {
+		if (getDensity(x, y, z, n) > _worldCtx.caveDensityThreshold) {
+			return true;
+		}
 	}
+	return minsY + 1 > voxel::MAX_WATER_HEIGHT;
+}
+
+int WorldPager::terrainHeight(int x, int minsY, int z, float n) const {
+	core_trace_scoped(TerrainHeight);
+	int ni = surfaceHeight(x, z, n);
 	for (int y = ni - 1; y >= minsY + 1; --y) {
 		const float density = getDensity(x, y, z, n);
 		if (density > _worldCtx.caveDensityThreshold) {
@@ -196,7 +263,7 @@ int WorldPager::fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const
 	return core_max(ni - minsY, voxel::MAX_WATER_HEIGHT - minsY);
 }
 
-void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
+void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx, ChunkColumnSummary& summary) {
 	// expand region to all surrounding regions by half of the region size.
 	// we do this to be able to limit the generation on the current chunk. Otherwise
 	// we would endlessly generate new chunks just because the trees overlap to
@@ -226,30 +293,36 @@ void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
 	// would have to loop over more regions.
 	core_assert(pagerCtx.region.getLowerY() == 0);
 	core_assert(pagerCtx.region.getUpperY() == voxel::MAX_HEIGHT);
-	voxel::PagedVolumeWrapper chunkWrapper(_volumeData, pagerCtx.chunk, pagerCtx.region);
+	VolumeStampBatch batch(pagerCtx.region);
 
 	const size_t regionsSize = lengthof(regions);
-
 	for (size_t i = 0; i < regionsSize; ++i) {
 		const voxel::Region& region = regions[i];
 		const std::vector<const char*>& treeTypes = _biomeManager.getTreeTypes(region);
 		if (treeTypes.empty()) {
 			Log::debug("No tree types given for region %s", region.toString().c_str());
-			return;
+			break;
 		}
 		std::vector<glm::vec2> positions;
 		math::Random random(_seed);
 		_biomeManager.getTreePositions(region, positions, random, 0);
 		int treeTypeIndex = random.random(0, treeTypes.size() - 1);
 		const int treeTypeSize = (int)treeTypes.size();
-		const math::Axis axes[] = {math::Axis::None, math::Axis::Y, math::Axis::Y, math::Axis::None, math::Axis::Y};
-		constexpr size_t axesSize = lengthof(axes);
+		const int orientations[] = {0, VolumeStamp::SwapXZ, VolumeStamp::SwapXZ, 0, VolumeStamp::SwapXZ};
+		constexpr size_t orientationsSize = lengthof(orientations);
 		int positionIndex = 0;
 		for (const glm::vec2& position : positions) {
 			++positionIndex;
 			glm::ivec3 treePos(position.x, 0, position.y);
-			treePos.y = terrainHeight(position.x, pagerCtx.region.getLowerY(), position.y);
-			if (treePos.y <= voxel::MAX_WATER_HEIGHT) {
+			// the tree type index only advances for trees above the water level - every chunk
+			// that a tree reaches into must pick the same type for it
+			const bool ownColumn = summary.containsColumn(treePos.x, treePos.z);
+			if (ownColumn) {
+				treePos.y = summary.topSolidHeight(treePos.x, treePos.z) + 1;
+				if (treePos.y <= voxel::MAX_WATER_HEIGHT) {
+					continue;
+				}
+			} else if (!aboveWater(treePos.x, pagerCtx.region.getLowerY(), treePos.z)) {
 				continue;
 			}
 			const char *treeType = treeTypes[treeTypeIndex++];
@@ -258,34 +331,23 @@ void WorldPager::placeTrees(voxel::PagedVolume::PagerContext& pagerCtx) {
 			if (v == nullptr) {
 				continue;
 			}
-			const voxelutil::RawVolumeRotateWrapper rotateWrapper(v, axes[positionIndex % axesSize]);
-			addVolumeToPosition(chunkWrapper, rotateWrapper, treePos);
-		}
-	}
-}
-
-void WorldPager::addVolumeToPosition(voxel::PagedVolumeWrapper& target, const voxelutil::RawVolumeRotateWrapper& source, const glm::ivec3& pos) {
-	const voxel::Region& region = source.region();
-	const glm::ivec3& mins = region.getLowerCorner();
-	const glm::ivec3& maxs = region.getUpperCorner();
-	const voxel::Region& targetRegion = target.region();
-	for (int x = mins.x; x <= maxs.x; ++x) {
-		const int nx = pos.x + x;
-		for (int y = mins.y; y <= maxs.y; ++y) {
-			const int ny = pos.y + y;
-			for (int z = mins.z; z <= maxs.z; ++z) {
-				const int nz = pos.z + z;
-				if (!targetRegion.containsPoint(nx, ny, nz)) {
-					continue;
-				}
-				const voxel::Voxel& voxel = source.voxel(x, y, z);
-				if (voxel::isAir(voxel.getMaterial())) {
-					continue;
-				}
-				target.setVoxel(nx, ny, nz, voxel);
+			// the generation is queried after the volume was loaded - a cleared volume cache drops the stamps of the freed volumes
+			const VolumeStampPtr& stamp = _stampCache.stamp(v, orientations[positionIndex % orientationsSize], _volumeCache.generation());
+			if (!batch.touchesColumns(*stamp.get(), treePos)) {
+				continue;
+			}
+			if (!ownColumn) {
+				// only the trees that reach into this chunk need the exact height
+				treePos.y = terrainHeight(position.x, pagerCtx.region.getLowerY(), position.y);
 			}
+			batch.add(stamp, treePos);
 		}
 	}
+	// the tree heights are taken from the terrain - so the summary is updated after all trees were placed
+	core::DynamicArray<voxel::Region> treeRegions;
+	treeRegions.reserve(batch.size());
+	batch.apply(pagerCtx.chunk, &treeRegions);
+	summary.update(pagerCtx.chunk, treeRegions);
 }
 
 }
@@ -13,8 +13,11 @@
 #include "BiomeManager.h"
 #include "core/SharedPtr.h"
 #include "ChunkPersister.h"
+#include "ChunkColumnSummary.h"
 #include "TreeVolumeCache.h"
-#include "voxelutil/RawVolumeRotateWrapper.h"
+#include "VolumeStamp.h"
+#include "core/collection/HashMap.h"
+#include "core/concurrent/Lock.h"
 
 namespace voxel {
 class PagedVolumeWrapper;
@@ -39,12 +42,34 @@ private:
 	WorldContext _worldCtx;
 	noise::Noise _noise;
 	TreeVolumeCache _volumeCache;
+	VolumeStampCache _stampCache;
 	ChunkPersisterPtr _chunkPersister;
 
+	struct ColumnSummaryEntry {
+		ChunkColumnSummaryPtr summary;
+		uint32_t lastAccessed = 0u;
+	};
+	typedef core::HashMap<glm::ivec3, ColumnSummaryEntry, glm::hash<glm::ivec3>> ColumnSummaries;
+	mutable ColumnSummaries _columnSummaries core_thread_guarded_by(_columnSummaryLock);
+	mutable uint32_t _columnSummaryTimestamper core_thread_guarded_by(_columnSummaryLock) = 0u;
+	mutable core_trace_mutex(core::Lock, _columnSummaryLock, "WorldPagerColumnSummaries");
+
 	void createWorld(voxel::PagedVolumeWrapper& volume) const;
-	void placeTrees(voxel::PagedVolume::PagerContext& pagerCtx);
-	void addVolumeToPosition(voxel::PagedVolumeWrapper& target, const voxelutil::RawVolumeRotateWrapper& source, const glm::ivec3& pos);
+	/**
+	 * @param summary The column summary of the chunk terrain - it is updated for the columns the trees were placed in
+	 */
+	void placeTrees(voxel::PagedVolume::PagerContext& pagerCtx, ChunkColumnSummary& summary);
+	void addColumnSummary(const glm::ivec3& chunkPos, const ChunkColumnSummaryPtr& summary);
 
+	/**
+	 * @return The terrain height before the caves are carved out
+	 */
+	int surfaceHeight(int x, int z, float n) const;
+	/**
+	 * @return The same as @c terrainHeight() > @c voxel::MAX_WATER_HEIGHT - but without looking at the densities
+	 * below the water level
+	 */
+	bool aboveWater(int x, int minsY, int z) const;
 	int terrainHeight(int x, int minsY, int z) const;
 	int terrainHeight(int x, int minsY, int z, float n) const;
 	int fillVoxels(int x, int minsY, int z, voxel::Voxel* voxels) const;
@@ -86,8 +111,20 @@ public:
 	 */
 	bool pageIn(voxel::PagedVolume::PagerContext& ctx) override;
 	void pageOut(voxel::PagedVolume::Chunk* chunk) override;
+
+	/**
+	 * @param chunkPos The chunk position as returned by @c voxel::PagedVolume::chunkPos()
+	 * @return The column summary of the chunk at the given position or an empty pointer if the chunk wasn't paged
+	 * in (recently)
+	 */
+	ChunkColumnSummaryPtr columnSummary(const glm::ivec3& chunkPos) const;
+	const BiomeManager& biomeManager() const;
 };
 
+inline const BiomeManager& WorldPager::biomeManager() const {
+	return _biomeManager;
+}
+
 inline const ChunkPersisterPtr& WorldPager::chunkPersister() const {
 	return _chunkPersister;
 }
@@ -43,6 +43,36 @@ BENCHMARK_DEFINE_F(PagedVolumeBenchmark, pageIn) (benchmark::State& state) {
 	}
 }
 
+BENCHMARK_DEFINE_F(PagedVolumeBenchmark, pageInForest) (benchmark::State& state) {
+	voxelworld::WorldPager pager(_volumeCache, std::make_shared<voxelworld::ChunkPersister>());
+	pager.setSeed(0l);
+	int chunkSize = 256;
+	voxel::PagedVolume volumeData(&pager, 1024 * 1024 * 1024, chunkSize);
+	const io::FilesystemPtr& filesystem = io::filesystem();
+	const core::String& luaParameters = filesystem->load("worldparams.lua");
+	// a single grass biome with a very dense tree distribution
+	const core::String luaBiomes = R"(
+function initBiomes()
+  local biome = biomeMgr.addBiome(0, 256, 0.5, 0.5, "Grass", false, 6)
+  biome:addTree("pine")
+  biome:addTree("fir")
+  biome:addTree("deciduous")
+  biome:addTree("bush")
+  biomeMgr.setDefault(biome)
+end
+
+function initCities()
+end
+)";
+	pager.init(&volumeData, luaParameters, luaBiomes);
+	int i = 0;
+	while (state.KeepRunning()) {
+		volumeData.voxel(chunkSize * i, 0, 0);
+		++i;
+	}
+}
+
 BENCHMARK_REGISTER_F(PagedVolumeBenchmark, pageIn);
+BENCHMARK_REGISTER_F(PagedVolumeBenchmark, pageInForest);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+/**
+ * @file
+ */
+
+#include "voxelworld/ChunkColumnSummary.h"
+#include "AbstractVoxelWorldTest.h"
+#include "io/BufferedReadWriteStream.h"
+#include "voxelutil/FloorTrace.h"
+
+namespace voxelworld {
+
+class ChunkColumnSummaryTest: public AbstractVoxelWorldTest {
+};
+
+TEST_F(ChunkColumnSummaryTest, testBuild) {
+	ChunkColumnSummary summary(_region);
+	ASSERT_FALSE(summary.valid());
+	summary.build(_ctx.chunk());
+	ASSERT_TRUE(summary.valid());
+	ASSERT_TRUE(summary.containsColumn(32, 32));
+	ASSERT_FALSE(summary.containsColumn(64, 32));
+	ASSERT_EQ(voxel::VoxelType::Grass, summary.surface(32, 32).getMaterial());
+	ASSERT_EQ(_volData.voxel(32, summary.topSolidHeight(32, 32), 32).getMaterial(), voxel::VoxelType::Grass);
+	ASSERT_TRUE(voxel::isAir(_volData.voxel(32, summary.topSolidHeight(32, 32) + 1, 32).getMaterial()));
+	ASSERT_EQ(voxel::NO_FLOOR_FOUND, summary.topSolidHeight(0, 0));
+	int amount;
+	ASSERT_NE(nullptr, summary.floors(32, 32, amount));
+	ASSERT_EQ(2, amount);
+	const ChunkColumnSummary::Floor *floors = summary.floors(0, 0, amount);
+	ASSERT_NE(nullptr, floors);
+	ASSERT_EQ(1, amount);
+	ASSERT_EQ(0, floors[0].start);
+	ASSERT_EQ(_region.getUpperY(), floors[0].end);
+}
+
+TEST_F(ChunkColumnSummaryTest, testFindWalkableFloor) {
+	ChunkColumnSummary summary(_region);
+	summary.build(_ctx.chunk());
+	voxel::PagedVolume::Sampler sampler(&_volData);
+	const int maxDistances[] = {1, 10, voxel::MAX_HEIGHT};
+	int answered = 0;
+	for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); z += 3) {
+		for (int x = _region.getLowerX(); x <= _region.getUpperX(); x += 3) {
+			for (int y = _region.getLowerY(); y <= _region.getUpperY(); y += 5) {
+				for (int maxDistance : maxDistances) {
+					const glm::ivec3 pos(x, y, z);
+					voxelutil::FloorTraceResult result;
+					if (!summary.findWalkableFloor(pos, maxDistance, result)) {
+						continue;
+					}
+					++answered;
+					const voxelutil::FloorTraceResult &expected = voxelutil::findWalkableFloor(&sampler, pos, maxDistance);
+					ASSERT_EQ(expected.heightLevel, result.heightLevel)
+						<< "Unexpected floor for " << x << ":" << y << ":" << z << " (" << maxDistance << ")";
+					ASSERT_TRUE(expected.voxel.isSame(result.voxel))
+						<< "Unexpected floor voxel for " << x << ":" << y << ":" << z << " (" << maxDistance << ")";
+				}
+			}
+		}
+	}
+	ASSERT_GT(answered, 0);
+}
+
+TEST_F(ChunkColumnSummaryTest, testWriteRead) {
+	ChunkColumnSummary summary(_region);
+	summary.build(_ctx.chunk());
+	io::BufferedReadWriteStream stream;
+	ASSERT_TRUE(summary.write(stream));
+	stream.seek(0);
+	ChunkColumnSummary loaded;
+	ASSERT_TRUE(loaded.read(stream));
+	ASSERT_EQ(summary.region(), loaded.region());
+	ASSERT_TRUE(summary.surface(32, 32).isSame(loaded.surface(32, 32)));
+	for (int z = _region.getLowerZ(); z <= _region.getUpperZ(); ++z) {
+		for (int x = _region.getLowerX(); x <= _region.getUpperX(); ++x) {
+			ASSERT_EQ(summary.topSolidHeight(x, z), loaded.topSolidHeight(x, z));
+			int amount;
+			int loadedAmount;
+			const ChunkColumnSummary::Floor *floors = summary.floors(x, z, amount);
+			const ChunkColumnSummary::Floor *loadedFloors = loaded.floors(x, z, loadedAmount);
+			ASSERT_EQ(amount, loadedAmount);
+			for (int i = 0; i < amount; ++i) {
+				ASSERT_EQ(floors[i].start, loadedFloors[i].start);
+				ASSERT_EQ(floors[i].end, loadedFloors[i].end);
+				ASSERT_TRUE(floors[i].ground.isSame(loadedFloors[i].ground));
+			}
+		}
+	}
+}
+
+TEST_F(ChunkColumnSummaryTest, testUpdate) {
+	ChunkColumnSummary summary(_region);
+	summary.build(_ctx.chunk());
+	const int topSolid = summary.topSolidHeight(32, 32);
+	const int otherTopSolid = summary.topSolidHeight(20, 20);
+	_ctx.setVoxel(32, topSolid + 2, 32, voxel::createColorVoxel(voxel::VoxelType::Wood, 0));
+	core::DynamicArray<voxel::Region> regions;
+	regions.emplace_back(glm::ivec3(32, topSolid + 2, 32), glm::ivec3(32, topSolid + 2, 32));
+	summary.update(_ctx.chunk(), regions);
+	ASSERT_EQ(topSolid + 2, summary.topSolidHeight(32, 32));
+	ASSERT_EQ(voxel::VoxelType::Wood, summary.surface(32, 32).getMaterial());
+	ASSERT_EQ(otherTopSolid, summary.topSolidHeight(20, 20));
+	int amount;
+	summary.floors(32, 32, amount);
+	ASSERT_EQ(3, amount);
+}
+
+}
@@ -3,6 +3,7 @@
  */
 
 #include "voxelworld/FilePersister.h"
+#include "voxelworld/ChunkColumnSummary.h"
 #include "AbstractVoxelWorldTest.h"
 
 namespace voxelworld {
@@ -18,4 +19,17 @@ TEST_F(FilePersisterTest, testSaveLoad) {
 	ASSERT_EQ(voxel::VoxelType::Grass, _volData.voxel(32, 32, 32).getMaterial());
 }
 
+TEST_F(FilePersisterTest, testSaveLoadColumnSummary) {
+	FilePersister persister;
+	ChunkColumnSummary summary(_region);
+	summary.build(_ctx.chunk());
+	ASSERT_TRUE(persister.save(_ctx.chunk(), _seed, &summary)) << "Could not save volume chunk";
+	_volData.flushAll();
+	ChunkColumnSummary loaded(_region);
+	ASSERT_TRUE(persister.load(_ctx.chunk(), _seed, &loaded)) << "Could not load volume chunk";
+	ASSERT_TRUE(loaded.valid());
+	ASSERT_EQ(summary.topSolidHeight(32, 32), loaded.topSolidHeight(32, 32));
+	ASSERT_EQ(voxel::VoxelType::Grass, _volData.voxel(32, 32, 32).getMaterial());
+}
+
 }
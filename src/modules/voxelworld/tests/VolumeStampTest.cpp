@@ -0,0 +1,139 @@
+/**
+ * @file
+ */
+
+#include "voxelworld/VolumeStamp.h"
+#include "voxelutil/RawVolumeRotateWrapper.h"
+#include "AbstractVoxelWorldTest.h"
+
+namespace voxelworld {
+
+class VolumeStampTest: public AbstractVoxelWorldTest {
+protected:
+	// 3x4x2 volume with a trunk in the first column and a different color for each voxel of the upper layers
+	voxel::RawVolume *createTemplate() const {
+		voxel::RawVolume *v = new voxel::RawVolume(voxel::Region(0, 0, 0, 2, 3, 1));
+		v->setVoxel(0, 0, 0, voxel::createColorVoxel(voxel::VoxelType::Wood, 0));
+		v->setVoxel(0, 1, 0, voxel::createColorVoxel(voxel::VoxelType::Wood, 0));
+		for (int x = 0; x <= 2; ++x) {
+			for (int z = 0; z <= 1; ++z) {
+				v->setVoxel(x, 3, z, voxel::createColorVoxel(voxel::VoxelType::Leaf, x + z * 3));
+			}
+		}
+		return v;
+	}
+};
+
+TEST_F(VolumeStampTest, testSpans) {
+	voxel::RawVolume *v = createTemplate();
+	const VolumeStamp stamp(v, 0);
+	EXPECT_EQ(v->region(), stamp.region());
+	// the trunk span and one span per leaf column
+	ASSERT_EQ(7u, stamp.spans().size());
+	int voxels = 0;
+	for (const VolumeStamp::Span &span : stamp.spans()) {
+		voxels += span.length;
+	}
+	EXPECT_EQ(8, voxels);
+	delete v;
+}
+
+TEST_F(VolumeStampTest, testRotations) {
+	voxel::RawVolume *v = createTemplate();
+	const voxel::Region &region = v->region();
+	const glm::ivec3 pos(2, 40, 2);
+	for (int rotation = 0; rotation < VolumeStamp::Rotations; ++rotation) {
+		SCOPED_TRACE(rotation);
+		_volData.flushAll();
+		_ctx = voxel::PagedVolumeWrapper(&_volData, _volData.chunk(_region.getCenter()), _region);
+		const VolumeStamp stamp(v, rotation);
+		if (rotation % 2 == 1) {
+			EXPECT_EQ(region.getDepthInVoxels(), stamp.region().getWidthInVoxels());
+			EXPECT_EQ(region.getWidthInVoxels(), stamp.region().getDepthInVoxels());
+		} else {
+			EXPECT_EQ(region, stamp.region());
+		}
+		EXPECT_EQ(8, stamp.apply(_ctx.chunk(), _region, pos));
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				int rx = x;
+				int rz = z;
+				// rotate the template position by 90 degrees per step around the y axis
+				for (int i = 0; i < rotation; ++i) {
+					const int tmp = rx;
+					rx = (i % 2 == 0 ? region.getUpperZ() : region.getUpperX()) - rz;
+					rz = tmp;
+				}
+				for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+					const voxel::Voxel &expected = v->voxel(x, y, z);
+					const voxel::Voxel &actual = _volData.voxel(pos.x + rx, pos.y + y, pos.z + rz);
+					EXPECT_TRUE(expected.isSame(actual)) << "template position " << x << ":" << y << ":" << z;
+				}
+			}
+		}
+	}
+	delete v;
+}
+
+TEST_F(VolumeStampTest, testSwapXZ) {
+	voxel::RawVolume *v = createTemplate();
+	const voxelutil::RawVolumeRotateWrapper wrapper(v, math::Axis::Y);
+	const voxel::Region &region = wrapper.region();
+	const glm::ivec3 pos(2, 40, 2);
+	const VolumeStamp stamp(v, VolumeStamp::SwapXZ);
+	EXPECT_EQ(region, stamp.region());
+	EXPECT_EQ(8, stamp.apply(_ctx.chunk(), _region, pos));
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				const voxel::Voxel &expected = wrapper.voxel(x, y, z);
+				const voxel::Voxel &actual = _volData.voxel(pos.x + x, pos.y + y, pos.z + z);
+				EXPECT_TRUE(expected.isSame(actual)) << "position " << x << ":" << y << ":" << z;
+			}
+		}
+	}
+	delete v;
+}
+
+TEST_F(VolumeStampTest, testClipToChunk) {
+	voxel::RawVolume *v = createTemplate();
+	const VolumeStampPtr &stamp = core::make_shared<VolumeStamp>(v, 0);
+	VolumeStampBatch batch(_region);
+	// the lower two trunk voxels are below the chunk
+	const glm::ivec3 bottom(_region.getLowerX() + 4, _region.getLowerY() - 2, _region.getLowerZ() + 4);
+	// the upper layer reaches into the next chunk in x direction
+	const glm::ivec3 side(_region.getUpperX() - 1, 40, _region.getLowerZ() + 4);
+	// completely outside of the chunk
+	const glm::ivec3 outside(_region.getUpperX() + 1, 40, _region.getLowerZ() + 4);
+	EXPECT_TRUE(batch.touchesColumns(*stamp.get(), bottom));
+	EXPECT_FALSE(batch.touchesColumns(*stamp.get(), outside));
+	EXPECT_TRUE(batch.add(stamp, bottom));
+	EXPECT_TRUE(batch.add(stamp, side));
+	EXPECT_FALSE(batch.add(stamp, outside));
+	ASSERT_EQ(2u, batch.size());
+	core::DynamicArray<voxel::Region> regions;
+	// 6 leaves for the bottom stamp, the trunk and 4 leaves for the side stamp
+	EXPECT_EQ(12, batch.apply(_ctx.chunk(), &regions));
+	ASSERT_EQ(2u, regions.size());
+	EXPECT_EQ(stamp->region(bottom), regions[0]);
+	EXPECT_TRUE(voxel::isAir(_volData.voxel(side.x + 2, side.y + 3, side.z).getMaterial()));
+	EXPECT_EQ(voxel::VoxelType::Leaf, _volData.voxel(side.x + 1, side.y + 3, side.z).getMaterial());
+	EXPECT_EQ(voxel::VoxelType::Leaf, _volData.voxel(bottom.x, bottom.y + 3, bottom.z).getMaterial());
+	delete v;
+}
+
+TEST_F(VolumeStampTest, testCache) {
+	voxel::RawVolume *v = createTemplate();
+	VolumeStampCache cache;
+	const VolumeStampPtr &stamp = cache.stamp(v, 1);
+	EXPECT_EQ(stamp.get(), cache.stamp(v, 1).get());
+	EXPECT_NE(stamp.get(), cache.stamp(v, 2).get());
+	EXPECT_EQ(2u, cache.size());
+	EXPECT_NE(stamp.get(), cache.stamp(v, 1, 1).get()) << "A new generation of the volumes should drop the stamps";
+	EXPECT_EQ(1u, cache.size());
+	cache.shutdown();
+	EXPECT_EQ(0u, cache.size());
+	delete v;
+}
+
+}
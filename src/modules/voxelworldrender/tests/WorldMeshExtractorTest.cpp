@@ -0,0 +1,158 @@
+/**
+ * @file
+ */
+
+#include "app/tests/AbstractTest.h"
+#include "core/GameConfig.h"
+#include "core/Var.h"
+#include "voxel/MaterialColor.h"
+#include "voxel/PagedVolume.h"
+#include "voxelworldrender/worldrenderer/WorldMeshExtractor.h"
+
+namespace voxelworldrender {
+
+class WorldMeshExtractorTest : public app::AbstractTest {
+protected:
+	static constexpr int GroundHeight = 40;
+
+	class Pager : public voxel::PagedVolume::Pager {
+	public:
+		bool pageIn(voxel::PagedVolume::PagerContext &ctx) override {
+			const voxel::Region &region = ctx.region;
+			for (int z = 0; z < region.getDepthInVoxels(); ++z) {
+				for (int y = 0; y < region.getHeightInVoxels(); ++y) {
+					if (region.getLowerY() + y > GroundHeight) {
+						break;
+					}
+					for (int x = 0; x < region.getWidthInVoxels(); ++x) {
+						ctx.chunk->setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+					}
+				}
+			}
+			return true;
+		}
+
+		void pageOut(voxel::PagedVolume::Chunk *) override {
+		}
+	};
+
+	Pager _pager;
+	voxel::PagedVolume _volume{&_pager, 16 * 1024 * 1024, 32};
+	WorldMeshExtractor _extractor;
+
+	bool onInitApp() override {
+		core::Var::get(cfg::VoxelMeshSize, "16", core::CV_READONLY);
+		return _extractor.init(&_volume);
+	}
+
+	void onCleanupApp() override {
+		_extractor.shutdown();
+	}
+
+	/**
+	 * @brief Executes the scheduled extractions and collects the offsets of the extracted meshes
+	 * @param[out] empty The amount of empty meshes
+	 */
+	core::DynamicArray<glm::ivec3> extract(int jobs, int &empty) {
+		for (int i = 0; i < jobs; ++i) {
+			_extractor.extractScheduledMesh();
+		}
+		core::DynamicArray<glm::ivec3> offsets;
+		empty = 0;
+		voxel::Mesh mesh;
+		while (_extractor.pop(mesh)) {
+			if (mesh.isEmpty()) {
+				++empty;
+			} else {
+				offsets.push_back(mesh.getOffset());
+			}
+			_extractor.release(core::move(mesh));
+		}
+		return offsets;
+	}
+};
+
+TEST_F(WorldMeshExtractorTest, testSections) {
+	EXPECT_EQ(glm::ivec3(16, WorldMeshExtractor::SectionHeight, 16), _extractor.sectionSize());
+	ASSERT_TRUE(_extractor.scheduleMeshExtraction(glm::ivec3(3, 10, 5)));
+	EXPECT_FALSE(_extractor.scheduleMeshExtraction(glm::ivec3(0))) << "The column is already scheduled";
+	int empty = 0;
+	const core::DynamicArray<glm::ivec3> &offsets = extract(1, empty);
+	// the lowest section is solid and surrounded by solid voxels - only the section with the ground surface has faces
+	ASSERT_EQ(1u, offsets.size());
+	EXPECT_EQ(glm::ivec3(0, WorldMeshExtractor::SectionHeight, 0), offsets[0]);
+	EXPECT_EQ(WorldMeshExtractor::Sections - 1, empty);
+	EXPECT_EQ(0, _extractor.updateModifiedSections()) << "The world generation must not lead to re-extractions";
+}
+
+TEST_F(WorldMeshExtractorTest, testModifiedSections) {
+	ASSERT_TRUE(_extractor.scheduleMeshExtraction(glm::ivec3(0)));
+	int empty = 0;
+	extract(1, empty);
+
+	_volume.setVoxel(5, GroundHeight + 1, 5, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	ASSERT_EQ(1, _extractor.updateModifiedSections());
+	EXPECT_EQ(0, _extractor.updateModifiedSections()) << "The modifications should only get handled once";
+	const core::DynamicArray<glm::ivec3> &offsets = extract(1, empty);
+	ASSERT_EQ(1u, offsets.size()) << "Only the modified section should get re-extracted";
+	EXPECT_EQ(glm::ivec3(0, WorldMeshExtractor::SectionHeight, 0), offsets[0]);
+	EXPECT_EQ(0, empty);
+}
+
+TEST_F(WorldMeshExtractorTest, testModifiedSectionBorders) {
+	ASSERT_TRUE(_extractor.scheduleMeshExtraction(glm::ivec3(0)));
+	int empty = 0;
+	extract(1, empty);
+
+	// the neighbouring section is affected, too - but the neighbouring column was not yet extracted
+	_volume.setVoxel(15, WorldMeshExtractor::SectionHeight - 1, 5, voxel::Voxel());
+	ASSERT_EQ(2, _extractor.updateModifiedSections());
+	const core::DynamicArray<glm::ivec3> &offsets = extract(1, empty);
+	EXPECT_EQ(2, (int)offsets.size() + empty);
+	EXPECT_EQ(0, empty) << "The hole in the lowest section should lead to faces";
+
+	// the modification is not visible before the column is extracted the next time
+	EXPECT_TRUE(_extractor.allowReExtraction(glm::ivec3(0)));
+	_volume.setVoxel(5, 5, 5, voxel::Voxel());
+	EXPECT_EQ(0, _extractor.updateModifiedSections());
+}
+
+TEST_F(WorldMeshExtractorTest, testOutdatedMeshes) {
+	ASSERT_TRUE(_extractor.scheduleMeshExtraction(glm::ivec3(0)));
+	_extractor.extractScheduledMesh();
+	size_t vertices = 0u;
+	voxel::Mesh mesh;
+	while (_extractor.pop(mesh)) {
+		vertices += mesh.getNoOfVertices();
+		_extractor.release(core::move(mesh));
+	}
+
+	// the section is extracted twice before its meshes are popped - only the latest mesh may be handed out
+	_volume.setVoxel(5, GroundHeight + 1, 5, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	ASSERT_EQ(1, _extractor.updateModifiedSections());
+	_extractor.extractScheduledMesh();
+	_volume.setVoxel(5, GroundHeight + 1, 5, voxel::Voxel());
+	ASSERT_EQ(1, _extractor.updateModifiedSections());
+	_extractor.extractScheduledMesh();
+
+	ASSERT_TRUE(_extractor.pop(mesh));
+	EXPECT_EQ(glm::ivec3(0, WorldMeshExtractor::SectionHeight, 0), mesh.getOffset());
+	EXPECT_EQ(vertices, mesh.getNoOfVertices()) << "The mesh of the first modification was handed out";
+	_extractor.release(core::move(mesh));
+	EXPECT_FALSE(_extractor.pop(mesh)) << "The outdated mesh should have been dropped";
+}
+
+TEST_F(WorldMeshExtractorTest, testMergeModifiedRegions) {
+	for (int x = 0; x < 10; ++x) {
+		_volume.setVoxel(x, GroundHeight + 1, 5, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	}
+	// not adjacent to the previous voxels
+	_volume.setVoxel(11, GroundHeight + 2, 6, voxel::createVoxel(voxel::VoxelType::Generic, 2));
+	core::DynamicArray<voxel::Region> regions;
+	ASSERT_TRUE(_volume.popModifiedRegions(regions));
+	ASSERT_EQ(2u, regions.size()) << "The adjacent voxel writes should have been merged";
+	EXPECT_EQ(voxel::Region(0, GroundHeight + 1, 5, 9, GroundHeight + 1, 5), regions[0]);
+	EXPECT_EQ(voxel::Region(11, GroundHeight + 2, 6, 11, GroundHeight + 2, 6), regions[1]);
+}
+
+}
@@ -18,8 +18,9 @@ namespace {
 constexpr double ScaleDuration = 1.5;
 }
 
+// chunks outside of the octree bounds are still found - they are just not sorted into the nodes
 WorldChunkMgr::WorldChunkMgr(core::ThreadPool& threadPool) :
-		_octree({}, 30), _threadPool(threadPool) {
+		_octree({glm::ivec3(-4096), glm::ivec3(4096)}), _chunkBuffers(MAX_CHUNKBUFFERS), _threadPool(threadPool) {
 }
 
 void WorldChunkMgr::updateViewDistance(float viewDistance) {
@@ -51,11 +52,18 @@ void WorldChunkMgr::reset() {
 }
 
 void WorldChunkMgr::handleMeshQueue() {
-	voxel::Mesh mesh;
-	if (!_meshExtractor.pop(mesh)) {
-		return;
+	// a column is handed out in sections
+	for (int i = 0; i < WorldMeshExtractor::Sections; ++i) {
+		voxel::Mesh mesh;
+		if (!_meshExtractor.pop(mesh)) {
+			return;
+		}
+		uploadMesh(mesh);
+		_meshExtractor.release(core::move(mesh));
 	}
+}
 
+void WorldChunkMgr::uploadMesh(const voxel::Mesh& mesh) {
 	// Now add the mesh to the list of meshes to render.
 	core_trace_scoped(WorldRendererHandleMeshQueue);
 
@@ -65,17 +73,37 @@ void WorldChunkMgr::handleMeshQueue() {
 			freeChunkBuffer = &chunkBuffer;
 		}
 		// check whether we update an existing one
-		if (chunkBuffer.aabb().mins() == mesh.getOffset()) {
+		if (chunkBuffer.inuse && chunkBuffer.aabb().mins() == mesh.getOffset()) {
 			freeChunkBuffer = &chunkBuffer;
 			break;
 		}
 	}
 
+	if (mesh.isEmpty()) {
+		// a re-extracted section that became empty
+		if (freeChunkBuffer != nullptr && freeChunkBuffer->inuse) {
+			freeChunkBuffer->reset();
+			_octree.remove(freeChunkBuffer);
+		}
+		return;
+	}
+
 	if (freeChunkBuffer == nullptr) {
 		Log::warn("Could not find free chunk buffer slot");
 		return;
 	}
 
+	const voxel::VertexArray& vertices = mesh.getVertexVector();
+	const uint8_t* indices = mesh.compressedIndices();
+	if (freeChunkBuffer->inuse) {
+		// splice the re-extracted section into the existing buffers - the position and size didn't change
+		video::Buffer& buffer = freeChunkBuffer->_buffer;
+		freeChunkBuffer->_compressedIndexSize = mesh.compressedIndexSize();
+		buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
+		buffer.update(freeChunkBuffer->_ibo, indices, mesh.getNoOfIndices() * freeChunkBuffer->_compressedIndexSize);
+		return;
+	}
+
 	video::Buffer& buffer = freeChunkBuffer->_buffer;
 	freeChunkBuffer->_vbo = buffer.create();
 	if (freeChunkBuffer->_vbo == -1) {
@@ -101,12 +129,10 @@ void WorldChunkMgr::handleMeshQueue() {
 	}
 	freeChunkBuffer->_compressedIndexSize = mesh.compressedIndexSize();
 
-	const voxel::VertexArray& vertices = mesh.getVertexVector();
-	const uint8_t* indices = mesh.compressedIndices();
 	buffer.update(freeChunkBuffer->_vbo, &vertices.front(), vertices.size() * sizeof(voxel::VertexArray::value_type));
 	buffer.update(freeChunkBuffer->_ibo, indices, mesh.getNoOfIndices() * freeChunkBuffer->_compressedIndexSize);
 
-	const glm::ivec3& size = _meshExtractor.meshSize();
+	const glm::ivec3& size = _meshExtractor.sectionSize();
 	const glm::ivec3& mins = mesh.getOffset();
 	const glm::ivec3 maxs(mins.x + size.x, mins.y + size.y, mins.z + size.z);
 	freeChunkBuffer->_aabb = {mins, maxs};
@@ -118,6 +144,7 @@ void WorldChunkMgr::handleMeshQueue() {
 }
 
 void WorldChunkMgr::update(double deltaFrameSeconds, const video::Camera &camera, const glm::vec3& focusPos) {
+	_meshExtractor.updateModifiedSections();
 	handleMeshQueue();
 
 	_meshExtractor.updateExtractionOrder(focusPos);
@@ -131,7 +158,8 @@ void WorldChunkMgr::update(double deltaFrameSeconds, const video::Camera &camera
 		if (distance < _maxAllowedDistance) {
 			continue;
 		}
-		core_assert_always(_meshExtractor.allowReExtraction(pos));
+		// only the first section of a column finds it in the set of the extracted columns
+		_meshExtractor.allowReExtraction(pos);
 		chunkBuffer.reset();
 		_octree.remove(&chunkBuffer);
 		Log::trace("Remove mesh from %i:%i", pos.x, pos.z);
@@ -153,13 +181,10 @@ void WorldChunkMgr::cull(const video::Camera& camera) {
 	// don't cull objects that might cast shadows
 	aabb.shift(camera.forward() * -10.0f);
 
-	size_t index = 0;
-	Tree::Contents contents;
-	_octree.query(math::AABB<int>(aabb.mins(), aabb.maxs()), contents);
-
-	for (ChunkBuffer* chunkBuffer : contents) {
+	int index = 0;
+	_octree.visit(math::AABB<int>(aabb.mins(), aabb.maxs()), [&] (ChunkBuffer* chunkBuffer) {
 		_visibleBuffers.visible[index++] = chunkBuffer;
-	}
+	});
 	_visibleBuffers.size = index;
 }
 
@@ -185,9 +210,17 @@ void WorldChunkMgr::extractMeshes(const video::Camera& camera) {
 	maxs.y = voxel::MAX_HEIGHT;
 	maxs.z += farplane;
 
-	_octree.visit(mins, maxs, [&] (const glm::ivec3& mins, const glm::ivec3& maxs) {
-		return !_meshExtractor.scheduleMeshExtraction(mins);
-	}, glm::vec3(_meshExtractor.meshSize()));
+	const glm::ivec3& meshSize = _meshExtractor.meshSize();
+	glm::ivec3 pos;
+	for (pos.x = (int)mins.x; pos.x < (int)maxs.x; pos.x += meshSize.x) {
+		for (pos.y = (int)mins.y; pos.y < (int)maxs.y; pos.y += meshSize.y) {
+			for (pos.z = (int)mins.z; pos.z < (int)maxs.z; pos.z += meshSize.z) {
+				if (_meshExtractor.scheduleMeshExtraction(pos)) {
+					break;
+				}
+			}
+		}
+	}
 }
 
 void WorldChunkMgr::extractMesh(const glm::ivec3& pos) {
@@ -4,12 +4,13 @@
 
 #pragma once
 
-#include "math/Octree.h"
+#include "math/LooseOctree.h"
 #include "WorldMeshExtractor.h"
 #include "video/Camera.h"
 #include "voxel/VoxelVertex.h"
 #include "voxel/Mesh.h"
 #include "video/Buffer.h"
+#include "core/collection/DynamicArray.h"
 
 namespace shader {
 class WorldShader;
@@ -50,10 +51,12 @@ protected:
 	};
 
 
-	using Tree = math::Octree<ChunkBuffer *>;
+	using Tree = math::LooseOctree<ChunkBuffer *>;
 	Tree _octree;
-	static constexpr int MAX_CHUNKBUFFERS = 2048;
-	ChunkBuffer _chunkBuffers[MAX_CHUNKBUFFERS];
+	// one buffer for each non empty section of a mesh column
+	static constexpr int MAX_CHUNKBUFFERS = 2048 * WorldMeshExtractor::Sections;
+	// heap allocated - the mgr is often part of an application instance on the stack
+	core::DynamicArray<ChunkBuffer> _chunkBuffers;
 	int _maxAllowedDistance = -1;
 
 	struct VisibleBuffers {
@@ -71,6 +74,7 @@ protected:
 
 	void cull(const video::Camera &camera);
 	void handleMeshQueue();
+	void uploadMesh(const voxel::Mesh& mesh);
 public:
 	WorldChunkMgr(core::ThreadPool& threadPool);
 
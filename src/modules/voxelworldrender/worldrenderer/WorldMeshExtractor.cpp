@@ -15,6 +15,7 @@ WorldMeshExtractor::WorldMeshExtractor() {
 
 bool WorldMeshExtractor::init(voxel::PagedVolume *volume) {
 	_volume = volume;
+	_volume->setTrackModifications(true);
 	_meshSize = core::Var::getSafe(cfg::VoxelMeshSize);
 	return true;
 }
@@ -26,7 +27,19 @@ void WorldMeshExtractor::shutdown() {
 	_extracted.abortWait();
 	_positionsExtracted.clear();
 	_extracted.clear();
+	{
+		core::ScopedLock lock(_sectionsLock);
+		_scheduledSections.clear();
+		_sectionGenerations.clear();
+	}
+	if (_volume != nullptr) {
+		_volume->setTrackModifications(false);
+	}
 	_volume = nullptr;
+	const voxel::MeshPool::Stats& stats = _meshPool.stats();
+	Log::debug("Mesh pool: %i acquired, %.1f%% reused, %i dropped, peak pooled memory %i KB",
+			stats.acquired, stats.reuseRate() * 100.0f, stats.dropped, (int)(stats.peakPooledBytes / 1024u));
+	_meshPool.clear();
 }
 
 void WorldMeshExtractor::reset() {
@@ -36,11 +49,45 @@ void WorldMeshExtractor::reset() {
 	_extracted.clear();
 	_positionsExtracted.clear();
 	_pendingExtraction.clear();
+	core::ScopedLock lock(_sectionsLock);
+	_scheduledSections.clear();
+	_sectionGenerations.clear();
+}
+
+bool WorldMeshExtractor::isLatest(const ExtractedMesh& extracted) {
+	core::ScopedLock lock(_sectionsLock);
+	auto i = _sectionGenerations.find(extracted.mesh.getOffset());
+	if (i == _sectionGenerations.end()) {
+		return true;
+	}
+	SectionGeneration& sectionGeneration = i->second;
+	const bool latest = sectionGeneration.generation == extracted.generation;
+	if (--sectionGeneration.pending <= 0) {
+		_sectionGenerations.erase(i);
+	}
+	return latest;
 }
 
 bool WorldMeshExtractor::pop(voxel::Mesh& item) {
 	core_trace_value_scoped(QueryNewMesh, _positionsExtracted.size());
-	return _extracted.pop(item);
+	ExtractedMesh extracted;
+	while (_extracted.pop(extracted)) {
+		if (isLatest(extracted)) {
+			item = core::move(extracted.mesh);
+			return true;
+		}
+		// the mesh of the newer extraction was already handed out or is still queued
+		_meshPool.release(core::move(extracted.mesh));
+	}
+	return false;
+}
+
+void WorldMeshExtractor::release(voxel::Mesh&& mesh) {
+	_meshPool.release(core::move(mesh));
+}
+
+voxel::MeshPool::Stats WorldMeshExtractor::meshPoolStats() const {
+	return _meshPool.stats();
 }
 
 glm::ivec3 WorldMeshExtractor::meshPos(const glm::ivec3& pos) const {
@@ -56,6 +103,11 @@ glm::ivec3 WorldMeshExtractor::meshSize() const {
 	return glm::ivec3(s, voxel::MAX_MESH_CHUNK_HEIGHT, s);
 }
 
+glm::ivec3 WorldMeshExtractor::sectionSize() const {
+	const int s = _meshSize->intVal();
+	return glm::ivec3(s, SectionHeight, s);
+}
+
 void WorldMeshExtractor::updateExtractionOrder(const glm::ivec3& sortPos) {
 	core_trace_value_scoped(SortExtractionOrder, _pendingExtraction.size());
 	const glm::ivec3& d = glm::abs(_pendingExtractionSortPosition - sortPos);
@@ -83,29 +135,117 @@ bool WorldMeshExtractor::scheduleMeshExtraction(const glm::ivec3& p) {
 	}
 	Log::trace("mesh extraction for %i:%i:%i (%i:%i:%i)",
 			p.x, p.y, p.z, pos.x, pos.y, pos.z);
-	_pendingExtraction.push(pos);
+	scheduleSections(pos, AllSections);
 	return true;
 }
 
+int WorldMeshExtractor::scheduleSections(const glm::ivec3& pos, uint8_t sections) {
+	uint8_t added;
+	bool pending;
+	{
+		core::ScopedLock lock(_sectionsLock);
+		uint8_t &scheduled = _scheduledSections[pos];
+		pending = scheduled != 0;
+		added = sections & ~scheduled;
+		scheduled |= sections;
+	}
+	if (!pending) {
+		_pendingExtraction.push(pos);
+	}
+	int count = 0;
+	for (int s = 0; s < Sections; ++s) {
+		if (added & (1 << s)) {
+			++count;
+		}
+	}
+	return count;
+}
+
+int WorldMeshExtractor::updateModifiedSections() {
+	if (_volume == nullptr) {
+		return 0;
+	}
+	_modifiedRegions.clear();
+	if (!_volume->popModifiedRegions(_modifiedRegions)) {
+		return 0;
+	}
+	core_trace_scoped(UpdateModifiedSections);
+	const glm::ivec3& size = meshSize();
+	int scheduled = 0;
+	for (voxel::Region region : _modifiedRegions) {
+		// the faces and the ambient occlusion of the neighbours depend on the modified voxels, too
+		region.grow(1);
+		const glm::ivec3& mins = meshPos(region.getLowerCorner());
+		const glm::ivec3& maxs = meshPos(region.getUpperCorner());
+		glm::ivec3 pos;
+		for (pos.x = mins.x; pos.x <= maxs.x; pos.x += size.x) {
+			for (pos.y = mins.y; pos.y <= maxs.y; pos.y += size.y) {
+				for (pos.z = mins.z; pos.z <= maxs.z; pos.z += size.z) {
+					// columns that were not yet extracted will see the modification anyway
+					if (_positionsExtracted.find(pos) == _positionsExtracted.end()) {
+						continue;
+					}
+					const int lowerSection = glm::clamp((region.getLowerY() - pos.y) / SectionHeight, 0, Sections - 1);
+					const int upperSection = glm::clamp((region.getUpperY() - pos.y) / SectionHeight, 0, Sections - 1);
+					uint8_t sections = 0u;
+					for (int s = lowerSection; s <= upperSection; ++s) {
+						sections |= 1 << s;
+					}
+					scheduled += scheduleSections(pos, sections);
+				}
+			}
+		}
+	}
+	return scheduled;
+}
+
 void WorldMeshExtractor::extractScheduledMesh() {
 	decltype(_pendingExtraction)::Key pos;
 	if (!_pendingExtraction.waitAndPop(pos)) {
 		return;
 	}
-	core_trace_scoped(MeshExtraction);
 	const glm::ivec3& size = meshSize();
-	const glm::ivec3 mins(pos);
-	const glm::ivec3 maxs(pos.x + size.x - 1, pos.y + size.y - 2, pos.z + size.z - 1);
-	const voxel::Region region(mins, maxs);
-	// these numbers are made up mostly by try-and-error - we need to revisit them from time to time to prevent extra mem allocs
-	// they also heavily depend on the size of the mesh region we extract
+	uint8_t sections;
+	uint32_t generations[Sections];
+	{
+		core::ScopedLock lock(_sectionsLock);
+		auto i = _scheduledSections.find(pos);
+		if (i == _scheduledSections.end()) {
+			return;
+		}
+		sections = i->second;
+		_scheduledSections.erase(i);
+		// the volume is read after this point - a higher generation never sees older voxels
+		for (int s = 0; s < Sections; ++s) {
+			if ((sections & (1 << s)) == 0) {
+				continue;
+			}
+			SectionGeneration& sectionGeneration = _sectionGenerations[glm::ivec3(pos.x, pos.y + s * SectionHeight, pos.z)];
+			sectionGeneration.generation = ++_generation;
+			++sectionGeneration.pending;
+			generations[s] = sectionGeneration.generation;
+		}
+	}
+	core_trace_scoped(MeshExtraction);
+	const int upperY = pos.y + size.y - 2;
+	// these numbers are made up mostly by try-and-error - they only select the size class of a new mesh, pooled
+	// meshes that had to grow are handed out again with their bigger buffers
 	const int factor = 64;
-	const int vertices = region.getWidthInVoxels() * region.getDepthInVoxels() * factor;
-	voxel::Mesh mesh(vertices, vertices);
-	voxel::extractCubicMesh(_volume, region, &mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
-	if (!mesh.isEmpty()) {
-		_extracted.push(std::move(mesh));
+	const int vertices = size.x * size.z * factor / Sections;
+	for (int s = 0; s < Sections; ++s) {
+		if ((sections & (1 << s)) == 0) {
+			continue;
+		}
+		const glm::ivec3 mins(pos.x, pos.y + s * SectionHeight, pos.z);
+		const glm::ivec3 maxs(pos.x + size.x - 1, core_min(mins.y + SectionHeight - 1, upperY), pos.z + size.z - 1);
+		const voxel::Region region(mins, maxs);
+		ExtractedMesh extracted;
+		extracted.mesh = _meshPool.acquire(vertices, vertices);
+		extracted.generation = generations[s];
+		voxel::extractCubicMesh(_volume, region, &extracted.mesh, voxel::IsQuadNeeded(), region.getLowerCorner());
+		// empty meshes are handed out, too - they replace the mesh of a section that became empty
+		_extracted.push(std::move(extracted));
 	}
 }
 
-}
\ No newline at end of file
+}
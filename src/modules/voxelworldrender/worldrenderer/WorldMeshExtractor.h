@@ -5,12 +5,17 @@
 #pragma once
 
 #include "voxel/Mesh.h"
+#include "voxel/MeshPool.h"
 #include "core/concurrent/ThreadPool.h"
 #include "core/Var.h"
 #include "core/collection/ConcurrentPriorityQueue.h"
 #include "voxel/PagedVolume.h"
 #include "core/concurrent/Atomic.h"
+#include "core/concurrent/Lock.h"
+#include "core/collection/DynamicArray.h"
+#include "voxel/Constants.h"
 
+#include <unordered_map>
 #include <unordered_set>
 #include <glm/vec3.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -20,9 +25,28 @@ namespace voxelworldrender {
 
 typedef std::unordered_set<glm::ivec3, std::hash<glm::ivec3> > PositionSet;
 
+/**
+ * @brief Extracts the meshes of the world columns in the background.
+ *
+ * A column of @c meshSize() is split into vertical sections of @c SectionHeight voxels. Every section gets its own
+ * mesh - with the lower corner of the section as offset. Voxel writes to the volume only lead to the re-extraction
+ * of the sections they touch - see @c updateModifiedSections().
+ */
 class WorldMeshExtractor {
+public:
+	static constexpr int SectionHeight = 32;
+	static constexpr int Sections = voxel::MAX_MESH_CHUNK_HEIGHT / SectionHeight;
+	static constexpr uint8_t AllSections = (1 << Sections) - 1;
+	static_assert(Sections <= 8, "The sections of a column must fit into the section mask");
 private:
-	core::ConcurrentPriorityQueue<voxel::Mesh> _extracted;
+	struct ExtractedMesh {
+		voxel::Mesh mesh;
+		uint32_t generation = 0u;
+		inline bool operator<(const ExtractedMesh& rhs) const {
+			return mesh < rhs.mesh;
+		}
+	};
+	core::ConcurrentPriorityQueue<ExtractedMesh> _extracted;
 	glm::ivec3 _pendingExtractionSortPosition { 0, 0, 0 };
 	struct CloseToPoint {
 		glm::ivec2 _refPoint;
@@ -40,8 +64,32 @@ private:
 	core::ConcurrentPriorityQueue<glm::ivec3, CloseToPoint> _pendingExtraction { CloseToPoint(_pendingExtractionSortPosition) };
 	// fast lookup for positions that are already extracted
 	PositionSet _positionsExtracted;
+	// the section mask of each scheduled column - a column is part of the pending extractions as long as it has an entry
+	core_trace_mutex(core::Lock, _sectionsLock, "WorldMeshExtractorSections");
+	std::unordered_map<glm::ivec3, uint8_t, std::hash<glm::ivec3> > _scheduledSections core_thread_guarded_by(_sectionsLock);
+	struct SectionGeneration {
+		uint32_t generation = 0u;
+		// the amount of started extractions whose meshes were not yet popped
+		int pending = 0;
+	};
+	// the generation of the latest extraction of the sections with queued meshes - by the section offset. A section
+	// can be extracted again before its previous mesh was popped, the outdated meshes are dropped in pop()
+	std::unordered_map<glm::ivec3, SectionGeneration, std::hash<glm::ivec3> > _sectionGenerations core_thread_guarded_by(_sectionsLock);
+	uint32_t _generation core_thread_guarded_by(_sectionsLock) = 0u;
+	core::DynamicArray<voxel::Region> _modifiedRegions;
 	core::VarPtr _meshSize;
 	voxel::PagedVolume *_volume = nullptr;
+	// the buffers of the uploaded meshes are reused by the extraction jobs
+	voxel::MeshPool _meshPool;
+
+	/**
+	 * @return The amount of the given sections that were not yet scheduled for the given column
+	 */
+	int scheduleSections(const glm::ivec3& pos, uint8_t sections);
+	/**
+	 * @return @c false if a newer extraction of the section of the given mesh was started
+	 */
+	bool isLatest(const ExtractedMesh& extracted);
 
 public:
 	WorldMeshExtractor();
@@ -50,10 +98,19 @@ public:
 
 	/**
 	 * @brief We need to pop the mesh extractor queue to find out if there are new and ready to use meshes for us
+	 * @note Only the latest mesh of a section is handed out - the meshes of outdated extractions are dropped
 	 * @return @c false if this isn't the case, @c true if the given reference was filled with valid data.
 	 */
 	bool pop(voxel::Mesh& item);
 
+	/**
+	 * @brief Hand a mesh that was received by @c pop() back after it was uploaded. The buffers are reused
+	 * for the next extractions.
+	 */
+	void release(voxel::Mesh&& mesh);
+
+	voxel::MeshPool::Stats meshPoolStats() const;
+
 	/**
 	 * @brief If you don't need an extracted mesh anymore, make sure to allow the reextraction at a later time.
 	 * @param[in] pos A world position vector that is automatically converted into a mesh tile vector
@@ -74,6 +131,15 @@ public:
 	 */
 	bool scheduleMeshExtraction(const glm::ivec3& pos);
 
+	/**
+	 * @brief Schedules the re-extraction of the sections of the already extracted columns that were touched
+	 * by the voxel writes to the volume since the last call.
+	 * @note The extracted meshes of the sections that became empty are handed out, too - they have to
+	 * replace the old meshes.
+	 * @return The amount of newly scheduled sections
+	 */
+	int updateModifiedSections();
+
 	void reset();
 
 	/**
@@ -82,6 +148,10 @@ public:
 	glm::ivec3 meshPos(const glm::ivec3& pos) const;
 
 	glm::ivec3 meshSize() const;
+	/**
+	 * @brief The size of the region a mesh that is handed out by @c pop() is covering
+	 */
+	glm::ivec3 sectionSize() const;
 
 	bool init(voxel::PagedVolume *volume);
 	void shutdown();
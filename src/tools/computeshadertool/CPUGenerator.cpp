@@ -0,0 +1,572 @@
+/**
+ * @file
+ */
+
+#include "CPUGenerator.h"
+#include "core/Log.h"
+#include "core/StringUtil.h"
+#include <SDL_stdinc.h>
+#include <simplecpp.h>
+#include <sstream>
+#include <vector>
+
+namespace computeshadertool {
+
+struct HostToken {
+	core::String str;
+	int line = 0;
+	bool name = false;
+	bool number = false;
+};
+
+struct HostKernel {
+	core::String name;
+	std::vector<std::vector<core::String>> parameters;
+};
+
+/**
+ * @brief Collects the formatted c++ code
+ */
+struct HostWriter {
+	core::String out;
+	core::String prev;
+	int line = -1;
+	int depth = 0;
+
+	static bool isIdentifierEnd(const core::String& token) {
+		if (token.empty()) {
+			return false;
+		}
+		const char c = token[token.size() - 1];
+		return SDL_isalnum(c) || c == '_';
+	}
+
+	static bool needsSpace(const core::String& prev, const core::String& token) {
+		if (prev.empty()) {
+			return false;
+		}
+		if (token == "," || token == ";" || token == ")" || token == "]" || token == "." || token == "->") {
+			return false;
+		}
+		if (prev == "(" || prev == "[" || prev == "." || prev == "->" || prev == "!" || prev == "~") {
+			return false;
+		}
+		if (token == "(" || token == "[") {
+			if (prev == "if" || prev == "for" || prev == "while" || prev == "switch" || prev == "return") {
+				return true;
+			}
+			return !(isIdentifierEnd(prev) || prev == ")" || prev == "]");
+		}
+		if (token == "++" || token == "--") {
+			return !(isIdentifierEnd(prev) || prev == ")" || prev == "]");
+		}
+		return true;
+	}
+
+	void write(const core::String& token, int tokenLine) {
+		if (line != tokenLine) {
+			if (line != -1) {
+				out += "\n";
+			}
+			for (int i = 0; i < depth; ++i) {
+				out += "\t";
+			}
+			line = tokenLine;
+		} else if (needsSpace(prev, token)) {
+			out += " ";
+		}
+		out += token;
+		prev = token;
+	}
+};
+
+static bool tokenize(const core::String& buffer, const core::String& computeFilename, std::vector<HostToken>& tokens) {
+	simplecpp::DUI dui;
+	simplecpp::OutputList outputList;
+	std::vector<std::string> files;
+	std::stringstream f(buffer.c_str());
+	simplecpp::TokenList rawtokens(f, files, computeFilename.c_str(), &outputList);
+	std::map<std::string, simplecpp::TokenList*> included = simplecpp::load(rawtokens, files, dui, &outputList);
+	simplecpp::TokenList output(files);
+	simplecpp::preprocess(output, rawtokens, files, included, dui, &outputList);
+	for (const simplecpp::Token *tok = output.cfront(); tok != nullptr; tok = tok->next) {
+		if (tok->comment) {
+			continue;
+		}
+		HostToken token;
+		token.str = tok->str().c_str();
+		token.line = tok->location.line;
+		token.name = tok->name;
+		token.number = tok->number;
+		tokens.push_back(token);
+	}
+	simplecpp::cleanup(included);
+	return !tokens.empty();
+}
+
+static bool isAddressSpace(const core::String& token) {
+	return token == "__global" || token == "global" || token == "__local" || token == "local"
+		|| token == "__private" || token == "private" || token == "__read_only" || token == "read_only"
+		|| token == "__write_only" || token == "write_only" || token == "__read_write" || token == "read_write";
+}
+
+static bool isConstantQualifier(const core::String& token) {
+	return token == "__constant" || token == "constant";
+}
+
+static bool isKernelQualifier(const core::String& token) {
+	return token == "__kernel" || token == "kernel";
+}
+
+/**
+ * @return The amount of components of the OpenCL vector type - or @c 0 if the given token is no vector type
+ */
+static int vectorWidth(const core::String& token) {
+	static const char *baseTypes[] = {"char", "uchar", "short", "ushort", "int", "uint", "long", "ulong", "float", "double", "half"};
+	for (const char *baseType : baseTypes) {
+		if (!core::string::startsWith(token, baseType)) {
+			continue;
+		}
+		const core::String width = token.substr(SDL_strlen(baseType));
+		if (width.empty() || !core::string::isInteger(width)) {
+			continue;
+		}
+		return core::string::toInt(width);
+	}
+	return 0;
+}
+
+/**
+ * @brief The OpenCL types and functions that have no host implementation
+ */
+static bool isUnsupported(const core::String& token) {
+	if (token == "half" || core::string::startsWith(token, "half")) {
+		return vectorWidth(token) > 0 || token == "half";
+	}
+	if (vectorWidth(token) > 4) {
+		return true;
+	}
+	return token == "barrier" || token == "work_group_barrier" || token == "mem_fence" || token == "read_mem_fence"
+		|| token == "write_mem_fence" || token == "async_work_group_copy" || token == "wait_group_events"
+		|| token == "prefetch" || token == "printf" || token == "union"
+		|| core::string::startsWith(token, "atomic_") || core::string::startsWith(token, "atom_")
+		|| core::string::startsWith(token, "vload") || core::string::startsWith(token, "vstore")
+		|| core::string::startsWith(token, "CLK_");
+}
+
+/**
+ * @brief Valid identifiers in OpenCL C, but keywords in c++
+ */
+static bool isCppKeyword(const core::String& token) {
+	static const char *keywords[] = {"alignas", "alignof", "and", "and_eq", "bitand", "bitor", "catch", "class", "compl",
+		"constexpr", "decltype", "delete", "explicit", "export", "friend", "mutable", "namespace", "new", "noexcept",
+		"not", "not_eq", "nullptr", "operator", "or", "or_eq", "protected", "public", "static_assert", "template",
+		"this", "thread_local", "throw", "try", "typeid", "typename", "using", "virtual", "xor", "xor_eq"};
+	for (const char *keyword : keywords) {
+		if (token == keyword) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Floating point literals without suffix are single precision on devices without @c cl_khr_fp64
+ */
+static bool isDoubleLiteral(const core::String& token) {
+	if (token.empty() || (!SDL_isdigit(token[0]) && token[0] != '.')) {
+		return false;
+	}
+	const char last = token[token.size() - 1];
+	if (last == 'f' || last == 'F' || last == 'l' || last == 'L' || last == 'h' || last == 'H') {
+		return false;
+	}
+	if (core::string::startsWith(token, "0x") || core::string::startsWith(token, "0X")) {
+		return core::string::contains(token, "p") || core::string::contains(token, "P");
+	}
+	return core::string::contains(token, ".") || core::string::contains(token, "e") || core::string::contains(token, "E");
+}
+
+/**
+ * @return The component name for the OpenCL numeric swizzle or an empty string if the swizzle is not supported
+ */
+static core::String swizzle(const core::String& member, bool& supported) {
+	supported = true;
+	if (member.size() == 2u && (member[0] == 's' || member[0] == 'S') && member[1] >= '0' && member[1] <= '3') {
+		static const char *components[] = {"x", "y", "z", "w"};
+		return components[member[1] - '0'];
+	}
+	if (member == "lo" || member == "hi" || member == "even" || member == "odd") {
+		supported = false;
+		return "";
+	}
+	if ((member[0] == 's' || member[0] == 'S') && member.size() > 1u) {
+		bool hex = true;
+		for (size_t i = 1; i < member.size(); ++i) {
+			hex &= SDL_isxdigit(member[i]) != 0;
+		}
+		if (hex) {
+			supported = false;
+			return "";
+		}
+	}
+	if (member.size() > 1u) {
+		bool components = true;
+		for (size_t i = 0; i < member.size(); ++i) {
+			components &= SDL_strchr("xyzw", member[i]) != nullptr;
+		}
+		if (components) {
+			supported = false;
+			return "";
+		}
+	}
+	return member;
+}
+
+static core::String join(const std::vector<core::String>& tokens, size_t begin, size_t end) {
+	core::String str;
+	for (size_t i = begin; i < end; ++i) {
+		if (tokens[i] == "const" && i > begin && tokens[i - 1] == "*") {
+			continue;
+		}
+		if (!str.empty()) {
+			str += " ";
+		}
+		str += tokens[i];
+	}
+	return str;
+}
+
+static bool generateEntryPoint(const core::String& computeFilename, const HostKernel& kernel, core::String& out) {
+	out += "/**\n";
+	out += " * @brief Entry point for the work groups of the kernel '";
+	out += kernel.name;
+	out += "'\n";
+	out += " */\n";
+	out += "inline void ";
+	out += kernel.name;
+	out += "CPU(const compute::cpu::WorkGroup &_workGroup) {\n";
+	out += "\tusing namespace host;\n";
+	core::String args;
+	int index = 0;
+	for (const std::vector<core::String>& parameter : kernel.parameters) {
+		if (parameter.size() == 1u && parameter[0] == "void") {
+			continue;
+		}
+		if (parameter.size() < 2u) {
+			Log::error("%s: error: Failed to parse the parameter %i of kernel %s", computeFilename.c_str(), index, kernel.name.c_str());
+			return false;
+		}
+		const core::String& name = parameter.back();
+		const size_t typeEnd = parameter.size() - 1u;
+		size_t pointer = typeEnd;
+		bool image = false;
+		bool sampler = false;
+		for (size_t i = 0; i < typeEnd; ++i) {
+			if (parameter[i] == "*") {
+				if (pointer != typeEnd) {
+					Log::error("%s: error: Pointer to pointer parameters are not supported (kernel %s)",
+							computeFilename.c_str(), kernel.name.c_str());
+					return false;
+				}
+				pointer = i;
+			} else if (parameter[i] == "image2d_t" || parameter[i] == "image3d_t") {
+				image = true;
+			} else if (parameter[i] == "sampler_t") {
+				sampler = true;
+			}
+		}
+		out += "\t";
+		out += join(parameter, 0, typeEnd);
+		out += " ";
+		out += name;
+		if (pointer != typeEnd) {
+			out += " = _workGroup.buffer<";
+			out += join(parameter, 0, pointer);
+			out += ">(";
+		} else if (image) {
+			out += " = _workGroup.image(";
+		} else if (sampler) {
+			out += " = _workGroup.sampler(";
+		} else {
+			std::vector<core::String> valueType;
+			for (size_t i = 0; i < typeEnd; ++i) {
+				if (parameter[i] != "const") {
+					valueType.push_back(parameter[i]);
+				}
+			}
+			out += " = _workGroup.value<";
+			out += join(valueType, 0, valueType.size());
+			out += ">(";
+		}
+		out += core::string::toString(index);
+		out += ");\n";
+		if (!args.empty()) {
+			args += ", ";
+		}
+		args += name;
+		++index;
+	}
+	out += "\t_workGroup.run([&] () {\n";
+	out += "\t\thost::";
+	out += kernel.name;
+	out += "(";
+	out += args;
+	out += ");\n";
+	out += "\t});\n";
+	out += "}\n\n";
+	return true;
+}
+
+static void generateAliases(const core::List<Struct>& structs, core::String& out) {
+	for (const Struct& s : structs) {
+		if (!s.name.empty()) {
+			out += "using ";
+			out += s.name;
+			out += " = $name$::";
+			out += s.name;
+			out += ";\n";
+		}
+		if (!s.isEnum) {
+			continue;
+		}
+		for (const Parameter& p : s.parameters) {
+			out += "constexpr auto ";
+			out += p.name;
+			out += " = $name$::";
+			out += p.name;
+			out += ";\n";
+		}
+	}
+}
+
+bool generateHostSrc(const core::String& buffer, const core::String& computeFilename, const core::List<Struct>& structs, HostSrc& hostSrc) {
+	std::vector<HostToken> tokens;
+	if (!tokenize(buffer, computeFilename, tokens)) {
+		return true;
+	}
+	bool doublePrecision = false;
+	for (const HostToken& tok : tokens) {
+		if (tok.str == "double" || (vectorWidth(tok.str) > 0 && core::string::startsWith(tok.str, "double"))) {
+			doublePrecision = true;
+			break;
+		}
+	}
+
+	HostWriter writer;
+	std::vector<HostKernel> kernels;
+	HostKernel kernel;
+	std::vector<core::String> parameter;
+	bool statementStart = true;
+	bool kernelSignature = false;
+	bool inParameters = false;
+	int parens = 0;
+
+	auto emit = [&] (const core::String& token, int line) {
+		if (token == "(") {
+			if (kernelSignature && writer.depth == 0 && parens == 0) {
+				kernel.name = writer.prev;
+				inParameters = true;
+				writer.write(token, line);
+				++parens;
+				return;
+			}
+			++parens;
+		} else if (token == ")") {
+			--parens;
+		}
+		if (inParameters) {
+			if ((token == "," && parens == 1) || (token == ")" && parens == 0)) {
+				if (!parameter.empty()) {
+					kernel.parameters.push_back(parameter);
+				}
+				parameter.clear();
+				inParameters = token != ")";
+			} else {
+				parameter.push_back(token);
+			}
+		}
+		if (token == "{") {
+			if (kernelSignature && writer.depth == 0) {
+				kernels.push_back(kernel);
+				kernel = HostKernel();
+				kernelSignature = false;
+			}
+			writer.write(token, line);
+			++writer.depth;
+			return;
+		}
+		if (token == "}") {
+			--writer.depth;
+			writer.write(token, line);
+			if (writer.depth == 0 && parens == 0) {
+				statementStart = true;
+			}
+			return;
+		}
+		writer.write(token, line);
+		if (token == ";" && writer.depth == 0 && parens == 0) {
+			statementStart = true;
+			// just a declaration of the kernel
+			kernelSignature = false;
+			kernel = HostKernel();
+		}
+	};
+
+	const size_t n = tokens.size();
+	for (size_t i = 0; i < n; ++i) {
+		const HostToken& tok = tokens[i];
+		const core::String& token = tok.str;
+		const core::String& next = i + 1 < n ? tokens[i + 1].str : "";
+
+		if (token == "$constant") {
+			// exported constants don't have any meaning for the kernel code
+			i += 2;
+			continue;
+		}
+		if (token == "__attribute__" || token == "__attribute") {
+			if (next != "(") {
+				continue;
+			}
+			int depth = 0;
+			for (++i; i < n; ++i) {
+				if (tokens[i].str == "(") {
+					++depth;
+				} else if (tokens[i].str == ")") {
+					if (--depth == 0) {
+						break;
+					}
+				}
+			}
+			continue;
+		}
+		if (isAddressSpace(token)) {
+			continue;
+		}
+		if (isUnsupported(token)) {
+			Log::error("%s:%i: error: '%s' is not supported by the cpu backend", computeFilename.c_str(), tok.line, token.c_str());
+			return false;
+		}
+
+		if (statementStart && writer.depth == 0 && parens == 0) {
+			if (token == ";") {
+				emit(token, tok.line);
+				continue;
+			}
+			statementStart = false;
+			if ((token == "struct" || token == "enum") && (next == "{" || (i + 2 < n && tokens[i + 2].str == "{"))) {
+				// the structs and enums are part of the generated shader class
+				int depth = 0;
+				for (; i < n; ++i) {
+					if (tokens[i].str == "{") {
+						++depth;
+					} else if (tokens[i].str == "}") {
+						if (--depth == 0) {
+							break;
+						}
+					}
+				}
+				for (++i; i < n && tokens[i].str != ";"; ++i) {
+				}
+				statementStart = true;
+				continue;
+			}
+			if (token == "typedef") {
+				if (next == "struct" || next == "enum") {
+					Log::error("%s:%i: error: typedef of structs or enums is not supported by the cpu backend",
+							computeFilename.c_str(), tok.line);
+					return false;
+				}
+				emit(token, tok.line);
+				continue;
+			}
+			emit("inline", tok.line);
+			if (token == "inline") {
+				continue;
+			}
+		}
+
+		if (isKernelQualifier(token)) {
+			kernelSignature = true;
+			continue;
+		}
+		if (isConstantQualifier(token)) {
+			emit("const", tok.line);
+			if (next == "const") {
+				++i;
+			}
+			continue;
+		}
+		if (token == "struct" || token == "enum") {
+			// the elaborated type specifier is not valid for the type aliases
+			continue;
+		}
+		if (token == "(" && vectorWidth(next) > 0 && i + 3 < n && tokens[i + 2].str == ")" && tokens[i + 3].str == "(") {
+			// vector literal (float2)(x, y)
+			emit(next, tok.line);
+			i += 2;
+			continue;
+		}
+		if (token == "." && i + 1 < n && tokens[i + 1].name) {
+			bool supported;
+			const core::String& member = swizzle(next, supported);
+			if (!supported) {
+				Log::error("%s:%i: error: swizzle '%s' is not supported by the cpu backend",
+						computeFilename.c_str(), tok.line, next.c_str());
+				return false;
+			}
+			emit(token, tok.line);
+			emit(member, tok.line);
+			++i;
+			continue;
+		}
+		if (tok.name && isCppKeyword(token)) {
+			emit(token + "_", tok.line);
+			continue;
+		}
+		if (tok.number && !doublePrecision && isDoubleLiteral(token)) {
+			emit(token + "f", tok.line);
+			continue;
+		}
+		emit(token, tok.line);
+	}
+
+	if (kernels.empty()) {
+		return true;
+	}
+
+	hostSrc.declarations += "\n";
+	for (const HostKernel& k : kernels) {
+		hostSrc.declarations += "inline void ";
+		hostSrc.declarations += k.name;
+		hostSrc.declarations += "CPU(const compute::cpu::WorkGroup &_workGroup);\n";
+
+		hostSrc.registration += "\t\tcompute::registerKernel(_program, \"";
+		hostSrc.registration += k.name;
+		hostSrc.registration += "\", &priv$name$::";
+		hostSrc.registration += k.name;
+		hostSrc.registration += "CPU);\n";
+	}
+
+	core::String& impl = hostSrc.implementation;
+	impl += "\n/**\n";
+	impl += " * @brief Host implementation of the kernels for the cpu backend - generated from @c ";
+	impl += computeFilename;
+	impl += "\n */\n";
+	impl += "namespace priv$name$ {\n\n";
+	impl += "namespace host {\n\n";
+	impl += "using namespace compute::cpu;\n";
+	generateAliases(structs, impl);
+	impl += "\n";
+	impl += writer.out;
+	impl += "\n\n}\n\n";
+	for (const HostKernel& k : kernels) {
+		if (!generateEntryPoint(computeFilename, k, impl)) {
+			return false;
+		}
+	}
+	impl += "}\n";
+	return true;
+}
+
+}
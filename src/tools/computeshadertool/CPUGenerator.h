@@ -0,0 +1,46 @@
+/**
+ * @file
+ */
+
+#pragma once
+
+#include "Types.h"
+#include "core/String.h"
+#include "core/collection/List.h"
+
+namespace computeshadertool {
+
+/**
+ * @brief The c++ code of the host implementation of the kernels for the cpu backend of the compute module
+ */
+struct HostSrc {
+	/**
+	 * @brief Forward declarations of the kernel entry points - they are needed to register the kernels in @c setup()
+	 */
+	core::String declarations;
+	/**
+	 * @brief The @c compute::registerKernel() calls
+	 */
+	core::String registration;
+	/**
+	 * @brief The translated OpenCL code and the kernel entry points that fetch the arguments from the work group
+	 */
+	core::String implementation;
+};
+
+/**
+ * @brief Translates the OpenCL C kernels into c++ code that runs on the host.
+ *
+ * The translation works on the preprocessed tokens. Address space qualifiers are removed, vector literals like
+ * @c (float2)(x,y) are converted into glm constructors and the OpenCL built-ins are provided by
+ * @c compute/cpu/CLBuiltins.h. Constructs that have no host equivalent (e.g. barriers, atomics,
+ * multi-component swizzles or half types) are reported as errors.
+ *
+ * @note The generated code uses @c $name$ for the name of the generated shader class.
+ */
+extern bool generateHostSrc(const core::String& buffer,
+		const core::String& computeFilename,
+		const core::List<Struct>& structs,
+		HostSrc& hostSrc);
+
+}
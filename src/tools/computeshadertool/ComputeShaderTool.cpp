@@ -9,6 +9,7 @@
 #include "core/TimeProvider.h"
 #include "compute/Shader.h"
 #include "Generator.h"
+#include "CPUGenerator.h"
 #include "Parser.h"
 #include "Util.h"
 #include "util/IncludeUtil.h"
@@ -35,6 +36,7 @@ app::AppState ComputeShaderTool::onConstruct() {
 	registerArg("--shaderdir").setShort("-d").setDescription("Directory to load the shader from").setDefaultValue("shaders/");
 	registerArg("--sourcedir").setDescription("Directory to generate the source in").setMandatory();
 	registerArg("-I").setDescription("Add additional include dir");
+	registerArg("--cpu").setDescription("Generate the host implementation of the kernels for the cpu backend");
 	return Super::onConstruct();
 }
 
@@ -117,8 +119,13 @@ app::AppState ComputeShaderTool::onRunning() {
 		_exitCode = 1;
 		return app::AppState::Cleanup;
 	}
+	computeshadertool::HostSrc hostSrc;
+	if (hasArg("--cpu") && !computeshadertool::generateHostSrc(computeSrcSource, _computeFilename, _structs, hostSrc)) {
+		_exitCode = 1;
+		return app::AppState::Cleanup;
+	}
 	const core::String& templateShader = filesystem()->load(_shaderTemplateFile);
-	if (!computeshadertool::generateSrc(filesystem(), templateShader, _name, _namespaceSrc, _shaderDirectory, _sourceDirectory, _kernels, _structs, _constants, _postfix, computeBuffer.first)) {
+	if (!computeshadertool::generateSrc(filesystem(), templateShader, _name, _namespaceSrc, _shaderDirectory, _sourceDirectory, _kernels, _structs, _constants, _postfix, computeBuffer.first, hostSrc)) {
 		_exitCode = 100;
 		return app::AppState::Cleanup;
 	}
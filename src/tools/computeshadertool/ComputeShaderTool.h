@@ -22,6 +22,7 @@
  *  and size.
  * @li hides all the buffer creation/deletion mambo-jambo from the caller.
  * @li parses OpenCL structs and generate proper aligned C++ struct for them.
+ * @li translates the kernels into c++ code for the cpu backend of the compute module (@c --cpu).
  *
  * @ingroup Tools
  * @ingroup Compute
@@ -404,7 +404,7 @@ static void generateStructs(const core::List<Struct>& _structs, core::String& st
 				const int alignment = util::alignment(clType.type);
 				if (alignment > 1) {
 					structs += "alignas(";
-					structs += alignment;
+					structs += core::string::toString(alignment);
 					structs += ") ";
 				}
 				structs += clType.type;
@@ -414,7 +414,7 @@ static void generateStructs(const core::List<Struct>& _structs, core::String& st
 				structs += p.name;
 				if (clType.arraySize > 0) {
 					structs += "[";
-					structs += clType.arraySize;
+					structs += core::string::toString(clType.arraySize);
 					structs += "]";
 				}
 			}
@@ -454,7 +454,8 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 		const core::List<Struct>& _structs,
 		const core::StringMap<core::String>& _constants,
 		const core::String& postfix,
-		const core::String& shaderBuffer) {
+		const core::String& shaderBuffer,
+		const HostSrc& hostSrc) {
 	const core::String name = _name + "Shader";
 
 	core::DynamicArray<core::String> shaderNameParts;
@@ -476,6 +477,7 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 	}
 
 	core::String createKernels;
+	core::String validKernels;
 	for (const Kernel& k : _kernels) {
 		createKernels += "\t\t_kernel";
 		createKernels += k.name;
@@ -485,6 +487,18 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 		shutdown += "\t\tcompute::deleteKernel(_kernel";
 		shutdown += k.name;
 		shutdown += ");\n";
+		validKernels += validKernels.empty() ? "\t\tif (" : "\n\t\t || ";
+		validKernels += "_kernel";
+		validKernels += k.name;
+		validKernels += " == compute::InvalidId";
+	}
+	if (!validKernels.empty()) {
+		// e.g. the cpu backend doesn't have a host implementation for the kernel
+		createKernels += validKernels;
+		createKernels += ") {\n";
+		createKernels += "\t\t\tshutdown();\n";
+		createKernels += "\t\t\treturn false;\n";
+		createKernels += "\t\t}\n";
 	}
 
 	core::String kernels;
@@ -543,6 +557,10 @@ bool generateSrc(const io::FilesystemPtr& filesystem,
 	generateStructs(_structs, structs);
 
 	core::String src(templateShader);
+	src = core::string::replaceAll(src, "$cpuincludes$", hostSrc.implementation.empty() ? "" : "#include \"compute/cpu/CLBuiltins.h\"\n");
+	src = core::string::replaceAll(src, "$cpudeclarations$", hostSrc.declarations);
+	src = core::string::replaceAll(src, "$registerkernels$", hostSrc.registration);
+	src = core::string::replaceAll(src, "$cpukernels$", hostSrc.implementation);
 	src = core::string::replaceAll(src, "$constant", "//");
 	src = core::string::replaceAll(src, "$name$", filename);
 	src = core::string::replaceAll(src, "$namespace$", namespaceSrc);
@@ -6,6 +6,7 @@
 
 #include "io/Filesystem.h"
 #include "Types.h"
+#include "CPUGenerator.h"
 #include "core/String.h"
 #include "core/collection/StringMap.h"
 #include "core/collection/List.h"
@@ -22,6 +23,7 @@ extern bool generateSrc(const io::FilesystemPtr& filesystem,
 		const core::List<Struct>& structs,
 		const core::StringMap<core::String>& constants,
 		const core::String& postfix,
-		const core::String& shaderBuffer);
+		const core::String& shaderBuffer,
+		const HostSrc& hostSrc);
 
 }
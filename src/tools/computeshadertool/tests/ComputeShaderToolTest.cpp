@@ -5,6 +5,8 @@
 #include "app/tests/AbstractTest.h"
 #include "compute/Types.h"
 #include "../Util.h"
+#include "../CPUGenerator.h"
+#include "core/StringUtil.h"
 
 namespace computeshadertool {
 
@@ -39,4 +41,31 @@ TEST_F(ComputeShaderToolTest, testToString) {
 			util::toString(compute::BufferFlag::ReadWrite | compute::BufferFlag::ReadOnly));
 }
 
+TEST_F(ComputeShaderToolTest, testGenerateHostSrc) {
+	const core::String src =
+		"__constant float2 lut[2] = {(float2)(1.0f, 2.0f), (float2)(3.0f, 4.0f)};\n"
+		"__kernel void scale(__global float2 *out, const float factor) {\n"
+		"	const int x = get_global_id(0);\n"
+		"	out[x] = lut[x].s1 * factor * (float2)(0.5);\n"
+		"}\n";
+	HostSrc hostSrc;
+	ASSERT_TRUE(generateHostSrc(src, "test.cl", core::List<Struct>(), hostSrc));
+	const core::String& impl = hostSrc.implementation;
+	EXPECT_TRUE(core::string::contains(impl, "inline const float2 lut[2] = { float2(1.0f, 2.0f), float2(3.0f, 4.0f) };")) << impl;
+	EXPECT_TRUE(core::string::contains(impl, "inline void scale(float2 * out, const float factor) {")) << impl;
+	EXPECT_TRUE(core::string::contains(impl, "out[x] = lut[x].y * factor * float2(0.5f);")) << impl;
+	EXPECT_TRUE(core::string::contains(impl, "float2 * out = _workGroup.buffer<float2>(0);")) << impl;
+	EXPECT_TRUE(core::string::contains(impl, "const float factor = _workGroup.value<float>(1);")) << impl;
+	EXPECT_TRUE(core::string::contains(hostSrc.registration, "compute::registerKernel(_program, \"scale\", &priv$name$::scaleCPU);"))
+			<< hostSrc.registration;
+}
+
+TEST_F(ComputeShaderToolTest, testGenerateHostSrcUnsupported) {
+	HostSrc hostSrc;
+	EXPECT_FALSE(generateHostSrc("__kernel void k(__global float4 *out) { barrier(CLK_LOCAL_MEM_FENCE); }", "test.cl",
+			core::List<Struct>(), hostSrc));
+	EXPECT_FALSE(generateHostSrc("__kernel void k(__global float2 *out) { out[0] = out[1].yx; }", "test.cl",
+			core::List<Struct>(), hostSrc));
+}
+
 }
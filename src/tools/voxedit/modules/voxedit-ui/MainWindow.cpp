@@ -160,7 +160,7 @@ bool MainWindow::save(const core::String &file) {
 		_popupFailedToSave = true;
 		return false;
 	}
-	Log::info("Saved the model to %s", file.c_str());
+	Log::info("Saving the model to %s", file.c_str());
 	_lastOpenedFile->setVal(file);
 	return true;
 }
@@ -429,6 +429,9 @@ void MainWindow::update() {
 		_lastOpenedFile->markClean();
 		addLastOpenedFile(_lastOpenedFile->strVal());
 	}
+	if (sceneMgr().consumeSaveFailure()) {
+		_popupFailedToSave = true;
+	}
 
 	ImGui::SetNextWindowPos(viewport->WorkPos);
 	ImGui::SetNextWindowSize(ImVec2(viewport->WorkSize.x, viewport->WorkSize.y - statusBarHeight));
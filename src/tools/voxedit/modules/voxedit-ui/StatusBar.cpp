@@ -77,6 +77,10 @@ void StatusBar::update(const char *title, float height, const core::String &last
 				ImGui::Text("Command: %s (%s)", lastExecutedCommand.c_str(), keybindingStr.c_str());
 			}
 		}
+		if (sceneMgr.isSaving()) {
+			ImGui::SameLine();
+			ImGui::Text("Saving: %i%%", (int)(sceneMgr.saveProgress() * 100.0f));
+		}
 	}
 	ImGui::End();
 }
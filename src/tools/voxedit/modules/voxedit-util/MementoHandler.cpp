@@ -15,6 +15,7 @@
 #include "core/StandardLib.h"
 #include "core/Log.h"
 #include "core/Zip.h"
+#include "core/Trace.h"
 #include "voxelformat/SceneGraphNode.h"
 
 namespace voxedit {
@@ -22,8 +23,8 @@ namespace voxedit {
 static const MementoState InvalidMementoState{MementoType::Max, MementoData(), -1, -1, "", voxel::Region::InvalidRegion, glm::mat4(1.0f), 0};
 
 MementoData::MementoData(const uint8_t* buf, size_t bufSize,
-		const voxel::Region& _region) :
-		_compressedSize(bufSize), _region(_region) {
+		const voxel::Region& _region, MementoDataType type) :
+		_compressedSize(bufSize), _region(_region), _type(type) {
 	if (buf != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t*)core_malloc(_compressedSize);
@@ -36,9 +37,12 @@ MementoData::MementoData(const uint8_t* buf, size_t bufSize,
 MementoData::MementoData(MementoData&& o) noexcept :
 		_compressedSize(o._compressedSize),
 		_buffer(o._buffer),
-		_region(o._region) {
+		_region(o._region),
+		_type(o._type),
+		_pendingId(o._pendingId) {
 	o._compressedSize = 0;
 	o._buffer = nullptr;
+	o._pendingId = 0u;
 }
 
 MementoData::~MementoData() {
@@ -50,7 +54,9 @@ MementoData::~MementoData() {
 
 MementoData::MementoData(const MementoData& o) :
 		_compressedSize(o._compressedSize),
-		_region(o._region) {
+		_region(o._region),
+		_type(o._type),
+		_pendingId(o._pendingId) {
 	if (o._buffer != nullptr) {
 		core_assert(_compressedSize > 0);
 		_buffer = (uint8_t*)core_malloc(_compressedSize);
@@ -70,54 +76,225 @@ MementoData& MementoData::operator=(MementoData &&o) noexcept {
 		_buffer = o._buffer;
 		o._buffer = nullptr;
 		_region = o._region;
+		_type = o._type;
+		_pendingId = o._pendingId;
+		o._pendingId = 0u;
 	}
 	return *this;
 }
 
-MementoData MementoData::fromVolume(const voxel::RawVolume* volume) {
-	if (volume == nullptr) {
-		return MementoData();
+/**
+ * @return The offset of the voxel in the raw voxel buffer of a volume with the given region
+ */
+static inline size_t voxelOffset(const voxel::Region& volumeRegion, int x, int y, int z) {
+	const glm::ivec3& mins = volumeRegion.getLowerCorner();
+	const size_t width = volumeRegion.getWidthInVoxels();
+	const size_t height = volumeRegion.getHeightInVoxels();
+	return ((size_t)(x - mins.x) + (size_t)(y - mins.y) * width + (size_t)(z - mins.z) * width * height) * sizeof(voxel::Voxel);
+}
+
+/**
+ * @brief Upper bound of the run length encoded size - literal runs are only interrupted by at least 8 zero bytes
+ */
+static inline size_t rleBound(size_t size) {
+	return size + (size / 8u + 2u) * 2u * sizeof(uint32_t);
+}
+
+static void rleWrite(uint8_t *&out, uint32_t value) {
+	core_memcpy(out, &value, sizeof(value));
+	out += sizeof(value);
+}
+
+static uint32_t rleRead(const uint8_t *&in) {
+	uint32_t value;
+	core_memcpy(&value, in, sizeof(value));
+	in += sizeof(value);
+	return value;
+}
+
+/**
+ * @brief Encodes the buffer as a sequence of zero runs each followed by a literal run
+ * @return The size of the encoded data
+ */
+static size_t rleEncode(const uint8_t *in, size_t size, uint8_t *out) {
+	const uint8_t *outStart = out;
+	size_t pos = 0u;
+	while (pos < size) {
+		const size_t zeroStart = pos;
+		while (pos < size && in[pos] == 0u) {
+			++pos;
+		}
+		const size_t zeros = pos - zeroStart;
+		// the literal run ends at the last non-zero byte before a run of at least 8 zero bytes
+		const size_t literalStart = pos;
+		size_t literalEnd = pos;
+		size_t zeroRun = 0u;
+		for (; pos < size; ++pos) {
+			if (in[pos] != 0u) {
+				zeroRun = 0u;
+				literalEnd = pos + 1u;
+			} else if (++zeroRun >= 8u) {
+				break;
+			}
+		}
+		pos = literalEnd;
+		const size_t literals = literalEnd - literalStart;
+		rleWrite(out, (uint32_t)zeros);
+		rleWrite(out, (uint32_t)literals);
+		core_memcpy(out, in + literalStart, literals);
+		out += literals;
+	}
+	return (size_t)(out - outStart);
+}
+
+static bool rleDecode(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize) {
+	const uint8_t *inEnd = in + inSize;
+	size_t pos = 0u;
+	while (in + 2u * sizeof(uint32_t) <= inEnd) {
+		pos += rleRead(in);
+		const uint32_t literals = rleRead(in);
+		if (pos + literals > outSize || in + literals > inEnd) {
+			return false;
+		}
+		core_memcpy(out + pos, in, literals);
+		in += literals;
+		pos += literals;
 	}
-	const size_t uncompressedBufferSize = volume->region().voxels() * sizeof(voxel::Voxel);
+	return pos <= outSize;
+}
+
+MementoData MementoData::compress(const uint8_t* voxels, const voxel::Region& region, MementoDataType type) {
+	const size_t uncompressedBufferSize = region.voxels() * sizeof(voxel::Voxel);
 	const uint32_t compressedBufferSize = core::zip::compressBound(uncompressedBufferSize);
 	uint8_t* compressedBuf = (uint8_t*)core_malloc(compressedBufferSize);
 	size_t finalBufSize = 0u;
-	if (!core::zip::compress(volume->data(), uncompressedBufferSize, compressedBuf, compressedBufferSize, &finalBufSize)) {
+	if (!core::zip::compress(voxels, uncompressedBufferSize, compressedBuf, compressedBufferSize, &finalBufSize)) {
 		core_free(compressedBuf);
 		return MementoData();
 	}
-	MementoData data(compressedBuf, finalBufSize, volume->region());
+	MementoData data(compressedBuf, finalBufSize, region, type);
 	core_free(compressedBuf);
+	return data;
+}
 
+MementoData MementoData::fromVolume(const voxel::RawVolume* volume) {
+	if (volume == nullptr) {
+		return MementoData();
+	}
+	MementoData data = compress(volume->data(), volume->region(), MementoDataType::Volume);
 	Log::debug("Memento state. Volume: %i, compressed: %i",
-			(int)uncompressedBufferSize, (int)data._compressedSize);
+			(int)(volume->region().voxels() * sizeof(voxel::Voxel)), (int)data._compressedSize);
 	return data;
 }
 
+bool MementoData::toVoxels(const MementoData& mementoData, uint8_t* voxels) {
+	if (mementoData._buffer == nullptr || mementoData._type == MementoDataType::Delta) {
+		return false;
+	}
+	const size_t uncompressedBufferSize = mementoData._region.voxels() * sizeof(voxel::Voxel);
+	return core::zip::uncompress(mementoData._buffer, mementoData._compressedSize, voxels, uncompressedBufferSize);
+}
+
 voxel::RawVolume* MementoData::toVolume(const MementoData& mementoData) {
 	if (mementoData._buffer == nullptr) {
 		return nullptr;
 	}
 	const size_t uncompressedBufferSize = mementoData._region.voxels() * sizeof(voxel::Voxel);
 	uint8_t *uncompressedBuf = (uint8_t*)core_malloc(uncompressedBufferSize);
-	if (!core::zip::uncompress(mementoData._buffer, mementoData._compressedSize, uncompressedBuf, uncompressedBufferSize)) {
+	if (!toVoxels(mementoData, uncompressedBuf)) {
+		core_free(uncompressedBuf);
 		return nullptr;
 	}
 	return voxel::RawVolume::createRaw((voxel::Voxel*)uncompressedBuf, mementoData._region);
 }
 
-MementoHandler::MementoHandler() {
+MementoData MementoData::fromRegion(const uint8_t* voxels, const voxel::Region& volumeRegion, const voxel::Region& region) {
+	core_trace_scoped(MementoDataFromRegion);
+	const size_t rowSize = region.getWidthInVoxels() * sizeof(voxel::Voxel);
+	uint8_t* regionBuf = (uint8_t*)core_malloc(region.voxels() * sizeof(voxel::Voxel));
+	uint8_t* row = regionBuf;
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			core_memcpy(row, voxels + voxelOffset(volumeRegion, region.getLowerX(), y, z), rowSize);
+			row += rowSize;
+		}
+	}
+	MementoData data = compress(regionBuf, region, region == volumeRegion ? MementoDataType::Volume : MementoDataType::Region);
+	core_free(regionBuf);
+	return data;
+}
+
+MementoData MementoData::fromDelta(const uint8_t* xorVoxels, const voxel::Region& region) {
+	core_trace_scoped(MementoDataFromDelta);
+	const size_t deltaSize = region.voxels() * sizeof(voxel::Voxel);
+	uint8_t* rleBuf = (uint8_t*)core_malloc(rleBound(deltaSize));
+	const size_t rleSize = rleEncode(xorVoxels, deltaSize, rleBuf);
+	const uint32_t compressedBufferSize = core::zip::compressBound(rleSize);
+	uint8_t* compressedBuf = (uint8_t*)core_malloc(compressedBufferSize);
+	size_t finalBufSize = 0u;
+	const bool success = core::zip::compress(rleBuf, rleSize, compressedBuf, compressedBufferSize, &finalBufSize);
+	core_free(rleBuf);
+	if (!success) {
+		core_free(compressedBuf);
+		return MementoData();
+	}
+	MementoData data(compressedBuf, finalBufSize, region, MementoDataType::Delta);
+	core_free(compressedBuf);
+	Log::debug("Memento delta. Region: %i, rle: %i, compressed: %i", (int)deltaSize, (int)rleSize, (int)finalBufSize);
+	return data;
+}
+
+bool MementoData::applyDelta(const MementoData& delta, uint8_t* voxels, const voxel::Region& volumeRegion) {
+	core_trace_scoped(MementoDataApplyDelta);
+	if (delta._type != MementoDataType::Delta || delta._buffer == nullptr) {
+		return false;
+	}
+	const voxel::Region& region = delta._region;
+	const size_t deltaSize = region.voxels() * sizeof(voxel::Voxel);
+	const size_t maxRleSize = rleBound(deltaSize);
+	uint8_t* rleBuf = (uint8_t*)core_malloc(maxRleSize);
+	size_t rleSize = 0u;
+	if (!core::zip::uncompress(delta._buffer, delta._compressedSize, rleBuf, maxRleSize, &rleSize)) {
+		core_free(rleBuf);
+		return false;
+	}
+	uint8_t* xorBuf = (uint8_t*)core_malloc(deltaSize);
+	core_memset(xorBuf, 0, deltaSize);
+	const bool success = rleDecode(rleBuf, rleSize, xorBuf, deltaSize);
+	core_free(rleBuf);
+	if (success) {
+		const size_t rowSize = region.getWidthInVoxels() * sizeof(voxel::Voxel);
+		const uint8_t* row = xorBuf;
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				uint8_t* target = voxels + voxelOffset(volumeRegion, region.getLowerX(), y, z);
+				for (size_t i = 0u; i < rowSize; ++i) {
+					target[i] ^= row[i];
+				}
+				row += rowSize;
+			}
+		}
+	}
+	core_free(xorBuf);
+	return success;
+}
+
+MementoHandler::MementoHandler() : _threadPool(1, "Memento") {
 }
 
 MementoHandler::~MementoHandler() {
 }
 
 bool MementoHandler::init() {
+	_threadPool.init();
+	_initialized = true;
 	return true;
 }
 
 void MementoHandler::shutdown() {
 	clearStates();
+	_threadPool.shutdown(true);
+	_initialized = false;
 }
 
 void MementoHandler::lock() {
@@ -151,8 +328,12 @@ void MementoHandler::print() const {
 		if (state.palette.hasValue()) {
 			palHash = core::string::toString(state.palette.value()->hash());
 		}
+		const char *data = "empty";
+		if (state.hasVolumeData()) {
+			data = state.data._type == MementoDataType::Delta ? "delta" : "volume";
+		}
 		Log::info("%4i: (%s) node id: %i (parent: %i) (frame %i) - %s (%s) [mins(%i:%i:%i)/maxs(%i:%i:%i)] (size: %ib) (palette: %s [hash: %s])",
-				i++, states[(int)state.type], state.nodeId, state.parentId, state.keyFrame, state.name.c_str(), state.data._buffer == nullptr ? "empty" : "volume",
+				i++, states[(int)state.type], state.nodeId, state.parentId, state.keyFrame, state.name.c_str(), data,
 						mins.x, mins.y, mins.z, maxs.x, maxs.y, maxs.z, (int)state.data.size(), state.palette.hasValue() ? "true" : "false", palHash.c_str());
 	}
 }
@@ -164,28 +345,317 @@ void MementoHandler::construct() {
 }
 
 void MementoHandler::clearStates() {
+	resolvePending(true);
 	_states.clear();
+	_snapshots.clear();
 	_statePosition = 0u;
 }
 
+size_t MementoHandler::dataSize() {
+	resolvePending(true);
+	size_t size = 0u;
+	for (const MementoState& state : _states) {
+		size += state.data.size() + state.previousData.size();
+	}
+	return size;
+}
+
+void MementoHandler::resolvePending(bool wait) {
+	core_trace_scoped(MementoResolvePending);
+	for (size_t i = 0u; i < _pending.size();) {
+		PendingDelta& pending = _pending[i];
+		if (!wait && pending.data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++i;
+			continue;
+		}
+		MementoData data = pending.data.get();
+		// the state might already be gone because it was cut off or dropped from the ring buffer - snapshot jobs
+		// don't have a state at all
+		for (MementoState& state : _states) {
+			if (state.data._pendingId == pending.id) {
+				state.data = core::move(data);
+				break;
+			}
+			if (state.previousData._pendingId == pending.id) {
+				state.previousData = core::move(data);
+				break;
+			}
+		}
+		_pending.erase(i);
+	}
+}
+
+/**
+ * @brief Copies the voxels of the given region between two raw voxel buffers of volumes with different regions
+ */
+static void copyVoxels(const uint8_t *from, const voxel::Region &fromRegion, uint8_t *to, const voxel::Region &toRegion,
+					   const voxel::Region &region) {
+	const size_t rowSize = region.getWidthInVoxels() * sizeof(voxel::Voxel);
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			core_memcpy(to + voxelOffset(toRegion, region.getLowerX(), y, z),
+						from + voxelOffset(fromRegion, region.getLowerX(), y, z), rowSize);
+		}
+	}
+}
+
+/**
+ * @brief Calls the given function with the index, the region and the part of the given region for every brick of
+ * the snapshot that intersects the given region - stops at the first brick the function returns @c false for
+ */
+template<class FUNC>
+static bool visitBricks(const MementoSnapshot &snapshot, const voxel::Region &region, FUNC &&func) {
+	const glm::ivec3 &lower = snapshot.region.getLowerCorner();
+	const glm::ivec3 mins = (region.getLowerCorner() - lower) / MementoSnapshot::BrickSize;
+	const glm::ivec3 maxs = (region.getUpperCorner() - lower) / MementoSnapshot::BrickSize;
+	glm::ivec3 brick;
+	for (brick.z = mins.z; brick.z <= maxs.z; ++brick.z) {
+		for (brick.y = mins.y; brick.y <= maxs.y; ++brick.y) {
+			for (brick.x = mins.x; brick.x <= maxs.x; ++brick.x) {
+				const glm::ivec3 brickMins = lower + brick * MementoSnapshot::BrickSize;
+				const glm::ivec3 brickMaxs = glm::min(brickMins + (MementoSnapshot::BrickSize - 1), snapshot.region.getUpperCorner());
+				const voxel::Region brickRegion(brickMins, brickMaxs);
+				voxel::Region overlap = brickRegion;
+				overlap.cropTo(region);
+				const int idx = brick.x + (brick.y + brick.z * snapshot.brickCount.y) * snapshot.brickCount.x;
+				if (!func(idx, brickRegion, overlap)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Uncompresses the voxels of the given region of the snapshot into a raw voxel buffer that covers exactly this region
+ */
+static bool readSnapshot(const MementoSnapshot &snapshot, const voxel::Region &region, uint8_t *voxels) {
+	core_trace_scoped(MementoReadSnapshot);
+	uint8_t *brickBuf = (uint8_t *)core_malloc(MementoSnapshot::BrickSize * MementoSnapshot::BrickSize * MementoSnapshot::BrickSize * sizeof(voxel::Voxel));
+	const bool success = visitBricks(snapshot, region, [&] (int idx, const voxel::Region &brickRegion, const voxel::Region &overlap) {
+		if (!MementoData::toVoxels(snapshot.bricks[idx], brickBuf)) {
+			return false;
+		}
+		copyVoxels(brickBuf, brickRegion, voxels, region, overlap);
+		return true;
+	});
+	core_free(brickBuf);
+	return success;
+}
+
+/**
+ * @brief Compresses the voxels of the given region out of the raw voxel buffer of a volume with the region @c volumeRegion
+ * into the bricks of the snapshot
+ */
+static bool writeSnapshot(MementoSnapshot &snapshot, const uint8_t *voxels, const voxel::Region &volumeRegion, const voxel::Region &region) {
+	core_trace_scoped(MementoWriteSnapshot);
+	uint8_t *brickBuf = (uint8_t *)core_malloc(MementoSnapshot::BrickSize * MementoSnapshot::BrickSize * MementoSnapshot::BrickSize * sizeof(voxel::Voxel));
+	const bool success = visitBricks(snapshot, region, [&] (int idx, const voxel::Region &brickRegion, const voxel::Region &overlap) {
+		MementoData &brick = snapshot.bricks[idx];
+		if (overlap == brickRegion) {
+			brick = MementoData::fromRegion(voxels, volumeRegion, brickRegion);
+		} else {
+			// only a part of the brick changed - the rest of it is taken from the previous brick voxels
+			if (!MementoData::toVoxels(brick, brickBuf)) {
+				return false;
+			}
+			copyVoxels(voxels, volumeRegion, brickBuf, brickRegion, overlap);
+			brick = MementoData::fromRegion(brickBuf, brickRegion, brickRegion);
+		}
+		return brick.size() > 0u;
+	});
+	core_free(brickBuf);
+	return success;
+}
+
+MementoSnapshot::MementoSnapshot(const voxel::Region &_region)
+	: region(_region), brickCount((_region.getDimensionsInVoxels() + (BrickSize - 1)) / BrickSize) {
+	bricks.resize((size_t)brickCount.x * brickCount.y * brickCount.z);
+}
+
+/**
+ * @brief Builds the xor of the snapshot and the given voxels of the region and moves the snapshot to the new state
+ * @note Runs on the memento thread
+ */
+static MementoData createDelta(MementoSnapshot &snapshot, const uint8_t *voxels, const voxel::Region &region) {
+	core_trace_scoped(MementoCreateDelta);
+	if (snapshot.failed) {
+		return MementoData();
+	}
+	const size_t deltaSize = region.voxels() * sizeof(voxel::Voxel);
+	uint8_t* xorBuf = (uint8_t*)core_malloc(deltaSize);
+	if (!readSnapshot(snapshot, region, xorBuf) || !writeSnapshot(snapshot, voxels, region, region)) {
+		Log::error("Failed to update the memento snapshot");
+		core_free(xorBuf);
+		snapshot.failed = true;
+		return MementoData();
+	}
+	for (size_t i = 0u; i < deltaSize; ++i) {
+		xorBuf[i] ^= voxels[i];
+	}
+	MementoData data = MementoData::fromDelta(xorBuf, region);
+	core_free(xorBuf);
+	return data;
+}
+
+/**
+ * @return A copy of the raw voxels of the given region of the volume
+ */
+static uint8_t *copyVoxels(const voxel::RawVolume *volume, const voxel::Region &region) {
+	uint8_t *voxels = (uint8_t *)core_malloc(region.voxels() * sizeof(voxel::Voxel));
+	copyVoxels(volume->data(), volume->region(), voxels, region, region);
+	return voxels;
+}
+
+template<class FUNC>
+MementoData MementoHandler::enqueue(FUNC &&func, const voxel::Region &region, MementoDataType type) {
+	std::future<MementoData> future;
+	if (_initialized) {
+		future = _threadPool.enqueue(func);
+	}
+	if (!future.valid()) {
+		return func();
+	}
+	MementoData data;
+	data._type = type;
+	data._region = region;
+	if (++_pendingId == 0u) {
+		++_pendingId;
+	}
+	data._pendingId = _pendingId;
+	_pending.emplace_back(PendingDelta{data._pendingId, core::move(future)});
+	return data;
+}
+
+void MementoHandler::resetSnapshot(int nodeId, uint8_t *voxels, const voxel::Region &region) {
+	const MementoSnapshotPtr snapshot = core::make_shared<MementoSnapshot>(region);
+	_snapshots.put(nodeId, snapshot);
+	enqueue([snapshot, voxels, region] () {
+		if (!writeSnapshot(*snapshot.get(), voxels, region, region)) {
+			Log::error("Failed to compress the memento snapshot");
+			snapshot->failed = true;
+		}
+		core_free(voxels);
+		return MementoData();
+	}, region, MementoDataType::Volume);
+}
+
+void MementoHandler::resetSnapshot(int nodeId, const voxel::RawVolume *volume) {
+	if (volume == nullptr) {
+		_snapshots.remove(nodeId);
+		return;
+	}
+	resetSnapshot(nodeId, copyVoxels(volume, volume->region()), volume->region());
+}
+
+void MementoHandler::resetSnapshot(int nodeId, const MementoData &data) {
+	if (data._buffer == nullptr || data._type != MementoDataType::Volume) {
+		_snapshots.remove(nodeId);
+		return;
+	}
+	const MementoSnapshotPtr snapshot = core::make_shared<MementoSnapshot>(data._region);
+	_snapshots.put(nodeId, snapshot);
+	enqueue([snapshot, data] () {
+		uint8_t *voxels = (uint8_t *)core_malloc(data._region.voxels() * sizeof(voxel::Voxel));
+		if (!MementoData::toVoxels(data, voxels) || !writeSnapshot(*snapshot.get(), voxels, data._region, data._region)) {
+			Log::error("Failed to compress the memento snapshot");
+			snapshot->failed = true;
+		}
+		core_free(voxels);
+		return MementoData();
+	}, data._region, MementoDataType::Volume);
+}
+
+/**
+ * @return An invalid state that still names the node whose snapshot didn't match the state
+ */
+static MementoState failedState(int nodeId) {
+	MementoState state(InvalidMementoState);
+	state.nodeId = nodeId;
+	return state;
+}
+
+MementoState MementoHandler::applyDelta(const MementoState &s) {
+	auto iter = _snapshots.find(s.nodeId);
+	if (iter == _snapshots.end()) {
+		Log::error("No snapshot for node %i to apply the memento delta to", s.nodeId);
+		return failedState(s.nodeId);
+	}
+	MementoSnapshot& snapshot = *iter->value.get();
+	const voxel::Region& region = s.dataRegion();
+	uint8_t* voxels = (uint8_t*)core_malloc(region.voxels() * sizeof(voxel::Voxel));
+	if (snapshot.failed || !snapshot.region.containsRegion(region) || !readSnapshot(snapshot, region, voxels) ||
+		!MementoData::applyDelta(s.data, voxels, region)) {
+		Log::error("Failed to apply the memento delta for node %i", s.nodeId);
+		core_free(voxels);
+		return failedState(s.nodeId);
+	}
+	if (!writeSnapshot(snapshot, voxels, region, region)) {
+		Log::error("Failed to update the memento snapshot for node %i", s.nodeId);
+		core_free(voxels);
+		snapshot.failed = true;
+		return failedState(s.nodeId);
+	}
+	const MementoData& data = MementoData::compress(voxels, region, region == snapshot.region ? MementoDataType::Volume : MementoDataType::Region);
+	core_free(voxels);
+	return MementoState{s.type, data, s.parentId, s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame, s.palette};
+}
+
+MementoState MementoHandler::previousVolume(const MementoState &s) {
+	for (int i = _statePosition; i >= 0; --i) {
+		const MementoState& prevS = _states[i];
+		if ((prevS.type != MementoType::Modification && prevS.type != MementoType::SceneNodeAdded) || prevS.nodeId != s.nodeId) {
+			continue;
+		}
+		if (prevS.data._type != MementoDataType::Volume || prevS.data._buffer == nullptr) {
+			continue;
+		}
+		const voxel::Region& region = prevS.data._region;
+		uint8_t* voxels = (uint8_t*)core_malloc(region.voxels() * sizeof(voxel::Voxel));
+		bool success = MementoData::toVoxels(prevS.data, voxels);
+		for (int j = i + 1; success && j <= _statePosition; ++j) {
+			const MementoState& nextS = _states[j];
+			if (nextS.type == MementoType::Modification && nextS.nodeId == s.nodeId && nextS.data._type == MementoDataType::Delta) {
+				success = MementoData::applyDelta(nextS.data, voxels, region);
+			}
+		}
+		if (!success) {
+			Log::error("Failed to restore the previous volume of node %i", s.nodeId);
+			core_free(voxels);
+			return InvalidMementoState;
+		}
+		const MementoData& data = MementoData::compress(voxels, region, MementoDataType::Volume);
+		resetSnapshot(s.nodeId, voxels, region);
+		// use the region from the current state - but the volume from the previous state of this node
+		return MementoState{s.type, data, s.parentId, s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame};
+	}
+	Log::error("No previous volume for node %i found", s.nodeId);
+	return InvalidMementoState;
+}
+
 MementoState MementoHandler::undo() {
 	if (!canUndo()) {
 		return InvalidMementoState;
 	}
 	Log::debug("Available states: %i, current index: %i", (int)_states.size(), _statePosition);
+	resolvePending(true);
 	const MementoState& s = state();
 	--_statePosition;
 	if (s.type == MementoType::Modification) {
-		for (int i = _statePosition; i >= 0; --i) {
-			MementoState& prevS = _states[i];
-			if ((prevS.type == MementoType::Modification || prevS.type == MementoType::SceneNodeAdded) && prevS.nodeId == s.nodeId) {
-				core_assert(prevS.hasVolumeData());
-				// use the region from the current state - but the volume from the previous state of this node
-				return MementoState{s.type, prevS.data, s.parentId, s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame};
+		if (s.data._type == MementoDataType::Delta) {
+			MementoState undoState = applyDelta(s);
+			if (!undoState.valid()) {
+				++_statePosition;
 			}
+			return undoState;
 		}
-		core_assert(_states[0].type == MementoType::Modification);
-		return _states[0];
+		if (s.previousData._buffer != nullptr) {
+			resetSnapshot(s.nodeId, s.previousData);
+			// use the region from the current state - but the volume from the previous state of this node
+			return MementoState{s.type, s.previousData, s.parentId, s.nodeId, s.name, s.region, s.localMatrix, s.keyFrame};
+		}
+		return previousVolume(s);
 	}
 	if (s.type == MementoType::SceneNodeTransform) {
 		for (int i = _statePosition; i >= 0; --i) {
@@ -206,7 +676,19 @@ MementoState MementoHandler::redo() {
 	}
 	++_statePosition;
 	Log::debug("Available states: %i, current index: %i", (int)_states.size(), _statePosition);
-	return state();
+	resolvePending(true);
+	const MementoState& s = state();
+	if (s.data._type == MementoDataType::Delta) {
+		MementoState redoState = applyDelta(s);
+		if (!redoState.valid()) {
+			--_statePosition;
+		}
+		return redoState;
+	}
+	if (s.hasVolumeData() && s.type != MementoType::SceneNodeRemoved) {
+		resetSnapshot(s.nodeId, s.data);
+	}
+	return s;
 }
 
 void MementoHandler::updateNodeId(int nodeId, int newNodeId) {
@@ -218,6 +700,12 @@ void MementoHandler::updateNodeId(int nodeId, int newNodeId) {
 			state.parentId = newNodeId;
 		}
 	}
+	auto iter = _snapshots.find(nodeId);
+	if (iter != _snapshots.end()) {
+		const MementoSnapshotPtr snapshot = iter->value;
+		_snapshots.remove(nodeId);
+		_snapshots.put(newNodeId, snapshot);
+	}
 }
 
 void MementoHandler::markNodeRemoved(const voxelformat::SceneGraphNode &node) {
@@ -330,10 +818,70 @@ void MementoHandler::markUndo(int parentId, int nodeId, const core::String &name
 	if (!markUndoPreamble(nodeId)) {
 		return;
 	}
+	core_trace_scoped(MementoMarkUndo);
 	Log::debug("New undo state for node %i with name %s (memento state index: %i)", nodeId, name.c_str(), (int)_states.size());
 	voxel::logRegion("MarkUndo", region);
-	const MementoData& data = MementoData::fromVolume(volume);
+	resolvePending(false);
+	auto snapshot = volume == nullptr ? _snapshots.end() : _snapshots.find(nodeId);
+	if (type == MementoType::Modification && snapshot != _snapshots.end() && snapshot->value->region == volume->region() &&
+		!snapshot->value->failed) {
+		// the modified region is also used for the extraction - so we can rely on it to contain all changes
+		voxel::Region deltaRegion = volume->region();
+		if (region.isValid() && voxel::intersects(region, deltaRegion)) {
+			deltaRegion.cropTo(region);
+		}
+		// only the voxels of the modified region are copied here - the memento thread builds the delta out of them
+		uint8_t* voxels = copyVoxels(volume, deltaRegion);
+		const MementoSnapshotPtr &deltaSnapshot = snapshot->value;
+		const MementoData& data = enqueue([deltaSnapshot, voxels, deltaRegion] () {
+			MementoData delta = createDelta(*deltaSnapshot.get(), voxels, deltaRegion);
+			core_free(voxels);
+			return delta;
+		}, deltaRegion, MementoDataType::Delta);
+		MementoState state(type, data, parentId, nodeId, name, region, localMatrix, keyFrameIdx, palette);
+		addState(core::move(state));
+		return;
+	}
+	if (volume == nullptr) {
+		MementoState state(type, MementoData(), parentId, nodeId, name, region, localMatrix, keyFrameIdx, palette);
+		addState(core::move(state));
+		return;
+	}
+	MementoData previousData;
+	if (type == MementoType::Modification && snapshot != _snapshots.end()) {
+		// the volume region changed - remember the whole previous volume for undo
+		const MementoSnapshotPtr prev = snapshot->value;
+		previousData = enqueue([prev] () {
+			if (prev->failed) {
+				return MementoData();
+			}
+			uint8_t* voxels = (uint8_t*)core_malloc(prev->region.voxels() * sizeof(voxel::Voxel));
+			MementoData data;
+			if (readSnapshot(*prev.get(), prev->region, voxels)) {
+				data = MementoData::compress(voxels, prev->region, MementoDataType::Volume);
+			} else {
+				Log::error("Failed to read the memento snapshot");
+			}
+			core_free(voxels);
+			return data;
+		}, prev->region, MementoDataType::Volume);
+	}
+	// the volume and its snapshot bricks are compressed by the memento thread
+	const voxel::Region& volumeRegion = volume->region();
+	uint8_t* voxels = copyVoxels(volume, volumeRegion);
+	const MementoSnapshotPtr newSnapshot = core::make_shared<MementoSnapshot>(volumeRegion);
+	_snapshots.put(nodeId, newSnapshot);
+	const MementoData& data = enqueue([newSnapshot, voxels, volumeRegion] () {
+		if (!writeSnapshot(*newSnapshot.get(), voxels, volumeRegion, volumeRegion)) {
+			Log::error("Failed to compress the memento snapshot");
+			newSnapshot->failed = true;
+		}
+		MementoData volumeData = MementoData::compress(voxels, volumeRegion, MementoDataType::Volume);
+		core_free(voxels);
+		return volumeData;
+	}, volumeRegion, MementoDataType::Volume);
 	MementoState state(type, data, parentId, nodeId, name, region, localMatrix, keyFrameIdx, palette);
+	state.previousData = core::move(previousData);
 	addState(core::move(state));
 }
 
@@ -10,6 +10,11 @@
 #include "voxel/Voxel.h"
 #include "voxelformat/SceneGraphNode.h"
 #include "core/collection/RingBuffer.h"
+#include "core/collection/DynamicArray.h"
+#include "core/collection/HashMap.h"
+#include "core/concurrent/Atomic.h"
+#include "core/concurrent/ThreadPool.h"
+#include "core/SharedPtr.h"
 #include "core/String.h"
 #include <stdint.h>
 #include <stddef.h>
@@ -37,10 +42,26 @@ enum class MementoType {
 	Max
 };
 
+enum class MementoDataType : uint8_t {
+	/**
+	 * compressed voxels of the whole volume
+	 */
+	Volume,
+	/**
+	 * compressed voxels of only a part of the node volume - the undo and redo steps of deltas return these
+	 */
+	Region,
+	/**
+	 * compressed run length encoded xor of the voxels in the region against the previous state of the node
+	 */
+	Delta
+};
+
 /**
  * @brief Holds the data of a memento state
  *
- * The given buffer is owned by this class and represents a compressed volume
+ * The given buffer is owned by this class and represents a compressed volume, a compressed part of a
+ * volume or a compressed delta (see @c MementoDataType)
  */
 class MementoData {
 	friend struct MementoState;
@@ -58,8 +79,17 @@ private:
 	 * The region the given volume data is for
 	 */
 	voxel::Region _region {};
+	MementoDataType _type = MementoDataType::Volume;
+	/**
+	 * The id of the background job that compresses the delta - @c 0 if the buffer is already available
+	 */
+	uint32_t _pendingId = 0u;
 
-	MementoData(const uint8_t* buf, size_t bufSize, const voxel::Region& _region);
+	MementoData(const uint8_t* buf, size_t bufSize, const voxel::Region& _region, MementoDataType type = MementoDataType::Volume);
+	/**
+	 * @brief Compresses the given raw voxel buffer that covers exactly the given region
+	 */
+	static MementoData compress(const uint8_t* voxels, const voxel::Region& region, MementoDataType type);
 public:
 	constexpr MementoData() {}
 	MementoData(MementoData&& o) noexcept;
@@ -67,21 +97,45 @@ public:
 	~MementoData();
 
 	inline size_t size() const { return _compressedSize; }
+	inline MementoDataType type() const { return _type; }
+	inline const voxel::Region& region() const { return _region; }
 
 	MementoData& operator=(MementoData &&o) noexcept;
 
 	/**
 	 * @brief Converts the given @c mementoData into a volume
+	 * @note For @c MementoDataType::Region the volume only covers the region of the data - not the whole node volume
 	 * @note Keep in mind that you own the returned memory
 	 * @return The volume from the given memento data or @c null if the memento data
 	 * did not contain a valid volume buffer
 	 */
 	static voxel::RawVolume* toVolume(const MementoData& mementoData);
+	/**
+	 * @brief Uncompresses @c MementoDataType::Volume or @c MementoDataType::Region data into the given buffer
+	 * @param[out] voxels The raw voxel buffer that must be big enough for the region of the data
+	 */
+	static bool toVoxels(const MementoData& mementoData, uint8_t* voxels);
 	/**
 	 * @brief Converts the given volume into a @c MementoData structure (and perform the compression)
 	 * @param[in] volume The volume to create the memento state for. This might be @c null.
 	 */
 	static MementoData fromVolume(const voxel::RawVolume* volume);
+	/**
+	 * @brief Compresses the voxels of the given @c region out of the raw voxel buffer of a volume with the region @c volumeRegion
+	 * @return @c MementoDataType::Region data
+	 */
+	static MementoData fromRegion(const uint8_t* voxels, const voxel::Region& volumeRegion, const voxel::Region& region);
+	/**
+	 * @brief Run length encodes and compresses the xor of two states of the voxels in the given region
+	 * @param[in] xorVoxels The xor of the voxels of the given region - mostly zero for small modifications
+	 * @return @c MementoDataType::Delta data
+	 */
+	static MementoData fromDelta(const uint8_t* xorVoxels, const voxel::Region& region);
+	/**
+	 * @brief Applies the xor delta to the raw voxel buffer of a volume with the region @c volumeRegion. As xor is its own
+	 * inverse, this converts the previous state into the next state and the next state back into the previous state.
+	 */
+	static bool applyDelta(const MementoData& delta, uint8_t* voxels, const voxel::Region& volumeRegion);
 };
 
 struct MementoState {
@@ -98,6 +152,11 @@ struct MementoState {
 	 */
 	voxel::Region region;
 	core::Optional<voxel::Palette> palette;
+	/**
+	 * @brief The full volume of the node before a modification that was stored as @c MementoDataType::Volume (because
+	 * the volume region changed). Deltas don't need this - undo just applies them again.
+	 */
+	MementoData previousData;
 
 	MementoState() :
 			type(MementoType::Max), parentId(0), nodeId(0), keyFrame(0) {
@@ -122,7 +181,7 @@ struct MementoState {
 	 * Some types (@c MementoType) don't have a volume attached.
 	 */
 	inline bool hasVolumeData() const {
-		return data._buffer != nullptr;
+		return data._buffer != nullptr || data._pendingId != 0u;
 	}
 
 	inline const voxel::Region& dataRegion() const {
@@ -130,17 +189,84 @@ struct MementoState {
 	}
 };
 
+/**
+ * @brief Compressed voxels of a node volume as of the current state position
+ *
+ * The volume is split into bricks that are compressed on their own - modifications and undo or redo steps only
+ * have to uncompress the bricks that intersect their region. The bricks are written by the memento thread - the
+ * main thread only touches them once all queued jobs are done.
+ */
+struct MementoSnapshot {
+	static constexpr int BrickSize = 32;
+	MementoSnapshot(const voxel::Region &_region);
+	const voxel::Region region;
+	const glm::ivec3 brickCount;
+	/**
+	 * @brief The compressed voxels of the bricks - x runs fastest
+	 */
+	core::DynamicArray<MementoData> bricks;
+	/**
+	 * @brief Set if the bricks could not get read or written - the snapshot doesn't match the state position anymore
+	 */
+	core::AtomicBool failed{false};
+};
+using MementoSnapshotPtr = core::SharedPtr<MementoSnapshot>;
+
 /**
  * @brief Class that manages the undo and redo steps for the scene
+ *
+ * Volume modifications are stored as compressed xor deltas of the modified region against a compressed snapshot
+ * of the node volume. The snapshot is always at the current state position - undo and redo apply the deltas to it and
+ * hand out the resulting voxels of the region. The deltas, the full volumes and the snapshot bricks are compressed by
+ * the memento thread - marking an undo state only copies the voxels of the modified region. Only modifications that change the volume region and the scene
+ * node states store the full volume.
  */
 class MementoHandler : public core::IComponent {
 private:
+	struct PendingDelta {
+		uint32_t id;
+		std::future<MementoData> data;
+	};
 	core::RingBuffer<MementoState, 64u> _states;
 	uint8_t _statePosition = 0u;
 	int _locked = 0;
+	core::HashMap<int, MementoSnapshotPtr> _snapshots;
+	/**
+	 * @note A single thread - the jobs that read and write the snapshot of a node run in the order they were queued
+	 */
+	core::ThreadPool _threadPool;
+	core::DynamicArray<PendingDelta> _pending;
+	uint32_t _pendingId = 0u;
+	bool _initialized = false;
 
 	void addState(MementoState &&state);
 	bool markUndoPreamble(int nodeId);
+	/**
+	 * @brief Runs the job on the memento thread
+	 * @return The result of the job or pending data of the given region and type that @c resolvePending() replaces
+	 */
+	template<class FUNC>
+	MementoData enqueue(FUNC &&func, const voxel::Region &region, MementoDataType type);
+	/**
+	 * @brief Replaces the snapshot of the node - the memento thread compresses the bricks and frees the given voxels
+	 */
+	void resetSnapshot(int nodeId, uint8_t *voxels, const voxel::Region &region);
+	void resetSnapshot(int nodeId, const MementoData &data);
+	/**
+	 * @brief Applies the delta to the snapshot of the node and returns the voxels of the delta region
+	 * @return An invalid state with the node id if the snapshot didn't match the delta
+	 */
+	MementoState applyDelta(const MementoState &s);
+	/**
+	 * @brief Restores the previous volume of a modification that has neither a delta nor the previous volume. The last
+	 * full volume of the node is searched and the deltas that follow it are applied to it.
+	 */
+	MementoState previousVolume(const MementoState &s);
+	/**
+	 * @brief Moves the finished background compressions into their states
+	 * @param[in] wait Block until all queued compressions are done
+	 */
+	void resolvePending(bool wait);
 public:
 	MementoHandler();
 	~MementoHandler();
@@ -192,13 +318,21 @@ public:
 	 * This method will update the references for the old node id to the new one
 	 */
 	void updateNodeId(int nodeId, int newNodeId);
+	/**
+	 * @brief Replaces the snapshot of the node with the given volume. Use this with the current node volume if
+	 * @c undo() or @c redo() failed because the snapshot didn't match the state.
+	 */
+	void resetSnapshot(int nodeId, const voxel::RawVolume *volume);
 
 	/**
 	 * @note Keep in mind that the returned state contains memory for the voxel::RawVolume that you take ownership for
+	 * @return An invalid state if the step failed. If the node id of the invalid state is set, the snapshot of that
+	 * node didn't match - the state position is not changed then and the snapshot should get reset.
 	 */
 	MementoState undo();
 	/**
 	 * @note Keep in mind that the returned state contains memory for the voxel::RawVolume that you take ownership for
+	 * @return An invalid state if the step failed - see @c undo()
 	 */
 	MementoState redo();
 	bool canUndo() const;
@@ -208,6 +342,10 @@ public:
 
 	size_t stateSize() const;
 	uint8_t statePosition() const;
+	/**
+	 * @return The amount of bytes the compressed volume data of all states take
+	 */
+	size_t dataSize();
 };
 
 /**
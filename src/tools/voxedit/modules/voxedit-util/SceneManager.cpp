@@ -203,9 +203,7 @@ void SceneManager::autosave() {
 					p.c_str(), f.c_str(), e.c_str());
 		}
 	}
-	if (save(autoSaveFilename, true)) {
-		Log::info("Autosave file %s", autoSaveFilename.c_str());
-	} else {
+	if (!save(autoSaveFilename, true)) {
 		Log::warn("Failed to autosave");
 	}
 	_lastAutoSave = timeProvider->tickSeconds();
@@ -270,7 +268,153 @@ bool SceneManager::saveModels(const core::String& dir) {
 	return state;
 }
 
+static thread_local image::ImagePtr saveJobThumbnail;
+
+/**
+ * @brief The thumbnail needs the renderer and is created on the main thread before the save job is started
+ */
+static image::ImagePtr saveJobThumbnailCreator(const voxelformat::SceneGraph &, const glm::ivec2 &) {
+	return saveJobThumbnail;
+}
+
+static bool embedsThumbnail(const core::String &file) {
+	const core::String &ext = core::string::extractExtension(file);
+	for (const io::FormatDescription *desc = voxelformat::voxelSave(); desc->valid(); ++desc) {
+		if (desc->matchesExtension(ext)) {
+			return (desc->flags & VOX_FORMAT_FLAG_SCREENSHOT_EMBEDDED) != 0;
+		}
+	}
+	return false;
+}
+
+void SceneManager::snapshotNode_r(const voxelformat::SceneGraph &sceneGraph, const voxelformat::SceneGraphNode &node,
+								  int parentIdx, core::DynamicArray<SaveNode> &nodes) {
+	nodes.emplace_back(node.type(), parentIdx);
+	const int idx = (int)nodes.size() - 1;
+	SaveNode &saveNode = nodes[idx];
+	voxelformat::copy(node, saveNode.node);
+	if (node.type() == voxelformat::SceneGraphNodeType::Model) {
+		saveNode.snapshot = node.volume()->snapshot();
+	}
+	for (int childId : node.children()) {
+		snapshotNode_r(sceneGraph, sceneGraph.node(childId), idx, nodes);
+	}
+}
+
+bool SceneManager::runSaveJob(const SaveJobPtr &job) {
+	core_trace_scoped(RunSaveJob);
+	voxelformat::SceneGraph newSceneGraph;
+	const int rootId = newSceneGraph.root().id();
+	voxelformat::SceneGraphNode &root = newSceneGraph.node(rootId);
+	root.setName(job->root.name());
+	root.addProperties(job->root.properties());
+	core::DynamicArray<int> nodeIds;
+	nodeIds.reserve(job->nodes.size());
+	for (SaveNode &saveNode : job->nodes) {
+		if (job->cancelled) {
+			break;
+		}
+		voxelformat::SceneGraphNode node = core::move(saveNode.node);
+		if (saveNode.snapshot) {
+			node.setVolume(saveNode.snapshot->toVolume(), true);
+			saveNode.snapshot = voxel::RawVolumeSnapshotPtr();
+		}
+		const int parent = saveNode.parent == -1 ? rootId : nodeIds[saveNode.parent];
+		nodeIds.push_back(newSceneGraph.emplace(core::move(node), parent));
+		++job->progress;
+	}
+
+	bool success = false;
+	if (!job->cancelled) {
+		io::FileStream stream(job->tmpFile);
+		saveJobThumbnail = job->thumbnail;
+		success = voxelformat::saveFormat(newSceneGraph, job->filename, stream, saveJobThumbnailCreator);
+		saveJobThumbnail = image::ImagePtr();
+	}
+	job->tmpFile->close();
+	// only replace the target file once the new content was completely written
+	if (success && !job->cancelled) {
+		success = io::filesystem()->rename(job->tmpFilename, job->filename);
+		if (!success) {
+			Log::warn("Failed to replace '%s'", job->filename.c_str());
+		}
+	} else {
+		success = false;
+	}
+	if (!success) {
+		io::filesystem()->removeFile(job->tmpFilename);
+	}
+	++job->progress;
+	return success;
+}
+
+void SceneManager::finishSaveJob(const SaveJob &job, bool success) {
+	if (!success) {
+		if (!job.cancelled) {
+			Log::warn("Failed to save to %s", job.filename.c_str());
+			if (!job.autosave) {
+				_saveFailed = true;
+			}
+		}
+		return;
+	}
+	// the scene might have been modified while the save was running
+	const bool unmodified = job.modifications == _modifications;
+	if (job.autosave) {
+		Log::info("Autosave file %s", job.filename.c_str());
+	} else {
+		Log::info("Saved to %s", job.filename.c_str());
+		_lastFilename = job.filename;
+		if (unmodified) {
+			_dirty = false;
+		}
+	}
+	core::Var::get(cfg::VoxEditLastFile)->setVal(job.filename);
+	if (unmodified) {
+		_needAutoSave = false;
+	}
+}
+
+void SceneManager::updateSaveJobs() {
+	using namespace std::chrono_literals;
+	for (size_t i = 0; i < _saveJobs.size();) {
+		SaveJob &job = *_saveJobs[i].get();
+		if (job.future.wait_for(0ms) != std::future_status::ready) {
+			++i;
+			continue;
+		}
+		finishSaveJob(job, job.future.get());
+		_saveJobs.erase(i);
+	}
+}
+
+void SceneManager::waitForSaveJobs() {
+	for (const SaveJobPtr &job : _saveJobs) {
+		job->future.wait();
+	}
+	updateSaveJobs();
+}
+
+bool SceneManager::isSaving() const {
+	return !_saveJobs.empty();
+}
+
+float SceneManager::saveProgress() const {
+	if (_saveJobs.empty()) {
+		return 1.0f;
+	}
+	const SaveJobPtr &job = _saveJobs.back();
+	return (float)job->progress / (float)(job->nodes.size() + 1);
+}
+
+bool SceneManager::consumeSaveFailure() {
+	const bool failed = _saveFailed;
+	_saveFailed = false;
+	return failed;
+}
+
 bool SceneManager::save(const core::String& file, bool autosave) {
+	core_trace_scoped(SaveScene);
 	if (_sceneGraph.empty()) {
 		Log::warn("No volumes for saving found");
 		return false;
@@ -280,23 +424,52 @@ bool SceneManager::save(const core::String& file, bool autosave) {
 		Log::warn("No filename given for saving");
 		return false;
 	}
-	const io::FilePtr& filePtr = io::filesystem()->open(file, io::FileMode::SysWrite);
-	if (!filePtr->validHandle()) {
-		Log::warn("Failed to open the given file '%s' for writing", file.c_str());
+	if (io::Filesystem::isReadableDir(file)) {
+		Log::warn("The given file '%s' is a directory", file.c_str());
 		return false;
 	}
 
-	if (voxelformat::saveFormat(filePtr, _sceneGraph, voxelrender::volumeThumbnail)) {
-		if (!autosave) {
-			_dirty = false;
-			_lastFilename = file;
+	const SaveJobPtr job = SaveJobPtr::create();
+	job->filename = file;
+	job->tmpFilename = core::string::format("%s.%u.tmp", file.c_str(), ++_saveJobCounter);
+	// creating the temporary file checks that the directory is writable without truncating the target file
+	job->tmpFile = io::filesystem()->open(job->tmpFilename, io::FileMode::SysWrite);
+	if (!job->tmpFile->validHandle()) {
+		Log::warn("Failed to open the file '%s' for writing", job->tmpFilename.c_str());
+		return false;
+	}
+	job->autosave = autosave;
+	job->modifications = _modifications;
+
+	for (const SaveJobPtr &running : _saveJobs) {
+		if (running->filename == job->filename) {
+			running->cancelled = true;
 		}
-		core::Var::get(cfg::VoxEditLastFile)->setVal(filePtr->name());
-		_needAutoSave = false;
-		return true;
 	}
-	Log::warn("Failed to save to desired format");
-	return false;
+
+	const voxelformat::SceneGraphNode &root = _sceneGraph.root();
+	job->root.setName(root.name());
+	job->root.addProperties(root.properties());
+	job->nodes.reserve(_sceneGraph.nodeSize());
+	for (int childId : root.children()) {
+		snapshotNode_r(_sceneGraph, _sceneGraph.node(childId), -1, job->nodes);
+	}
+	if (!autosave && embedsThumbnail(job->filename)) {
+		job->thumbnail = voxelrender::volumeThumbnail(_sceneGraph, glm::ivec2(128));
+	}
+
+	core::ThreadPool& threadPool = app::App::getInstance()->threadPool();
+	job->future = threadPool.enqueue([job] () {
+		return runSaveJob(job);
+	});
+	if (!job->future.valid()) {
+		// the thread pool is already shut down
+		const bool success = runSaveJob(job);
+		finishSaveJob(*job.get(), success);
+		return success;
+	}
+	_saveJobs.push_back(job);
+	return true;
 }
 
 static void mergeIfNeeded(voxelformat::SceneGraph &newSceneGraph) {
@@ -412,6 +585,7 @@ void SceneManager::modified(int nodeId, const voxel::Region& modifiedRegion, boo
 	}
 	_dirty = true;
 	_needAutoSave = true;
+	++_modifications;
 #ifdef VOXEDIT_ANIMATION
 	handleAnimationViewUpdate(nodeId);
 #endif
@@ -624,16 +798,36 @@ bool SceneManager::mementoPaletteChange(const MementoState& s) {
 	return false;
 }
 
+void SceneManager::mementoResetSnapshot(int nodeId) {
+	if (nodeId == -1) {
+		return;
+	}
+	// the memento snapshot of the node didn't match the state - the node volume is at the current state position
+	if (voxelformat::SceneGraphNode *node = sceneGraphNode(nodeId)) {
+		_mementoHandler.resetSnapshot(nodeId, node->volume());
+	}
+}
+
 bool SceneManager::mementoModification(const MementoState& s) {
 	Log::debug("Memento: modification in volume of node %i (%s)", s.nodeId, s.name.c_str());
 	voxel::RawVolume* v = MementoData::toVolume(s.data);
 	if (voxelformat::SceneGraphNode *node = sceneGraphNode(s.nodeId)) {
-		node->setVolume(v, true);
+		voxel::Region modifiedRegion = s.region;
+		if (s.data.type() == MementoDataType::Region) {
+			// only the voxels of the modified region are part of the state
+			if (v != nullptr && node->volume() != nullptr) {
+				voxelutil::copyIntoRegion(*v, *node->volume(), s.dataRegion());
+			}
+			delete v;
+			modifiedRegion = s.dataRegion();
+		} else {
+			node->setVolume(v, true);
+		}
 		node->setName(s.name);
 		if (s.palette.hasValue()) {
 			node->setPalette(*s.palette.value());
 		}
-		modified(node->id(), s.region, false);
+		modified(node->id(), modifiedRegion, false);
 		_volumeRenderer.prepare(_sceneGraph);
 		return true;
 	}
@@ -650,7 +844,11 @@ bool SceneManager::undo() {
 	}
 
 	const MementoState& s = _mementoHandler.undo();
-	core_assert(s.valid());
+	if (!s.valid()) {
+		Log::error("Failed to undo the memento state");
+		mementoResetSnapshot(s.nodeId);
+		return false;
+	}
 	ScopedMementoHandlerLock lock(_mementoHandler);
 	if (s.type == MementoType::SceneNodeRenamed) {
 		return mementoRename(s);
@@ -697,7 +895,11 @@ bool SceneManager::redo() {
 	}
 
 	const MementoState& s = _mementoHandler.redo();
-	core_assert(s.valid());
+	if (!s.valid()) {
+		Log::error("Failed to redo the memento state");
+		mementoResetSnapshot(s.nodeId);
+		return false;
+	}
 	ScopedMementoHandlerLock lock(_mementoHandler);
 	if (s.type == MementoType::SceneNodeRenamed) {
 		return mementoRename(s);
@@ -917,6 +1119,7 @@ void SceneManager::onNewNodeAdded(int newNodeId) {
 			_result = voxelutil::PickResult();
 			_needAutoSave = true;
 			_dirty = true;
+			++_modifications;
 
 			nodeActivate(newNodeId);
 #ifdef VOXEDIT_ANIMATION
@@ -2005,6 +2208,7 @@ bool SceneManager::update(double nowSeconds) {
 			_loadingFuture = std::future<voxelformat::SceneGraph>();
 		}
 	}
+	updateSaveJobs();
 	_modifier.update(nowSeconds);
 	_volumeRenderer.update();
 	for (int i = 0; i < lengthof(DIRECTIONS); ++i) {
@@ -2051,6 +2255,7 @@ void SceneManager::shutdown() {
 	}
 
 	autosave();
+	waitForSaveJobs();
 
 	_volumeRenderer.shutdown();
 	_sceneGraph.clear();
@@ -2551,6 +2756,7 @@ bool SceneManager::nodeRemove(voxelformat::SceneGraphNode &node, bool recursive)
 	}
 	_needAutoSave = true;
 	_dirty = true;
+	++_modifications;
 	if (_sceneGraph.empty()) {
 		const voxel::Region region(glm::ivec3(0), glm::ivec3(31));
 		newScene(true, name, region);
@@ -10,6 +10,7 @@
 #include "voxelformat/SceneGraphNode.h"
 #include "voxelutil/Picking.h"
 #include "voxel/RawVolume.h"
+#include "voxel/RawVolumeSnapshot.h"
 #include "voxelgenerator/TreeContext.h"
 #include "voxelgenerator/LSystem.h"
 #include "voxelrender/SceneGraphRenderer.h"
@@ -33,7 +34,9 @@
 #include "voxelgenerator/LUAGenerator.h"
 #include "modifier/ModifierType.h"
 #include "modifier/ModifierFacade.h"
+#include <atomic>
 #include <functional>
+#include <future>
 
 namespace voxedit {
 
@@ -91,6 +94,54 @@ private:
 	EditMode _editMode = EditMode::Scene;
 	std::future<voxelformat::SceneGraph> _loadingFuture;
 
+	/**
+	 * @brief A scene graph node without volume - the voxels are held by the snapshot
+	 */
+	struct SaveNode {
+		SaveNode(voxelformat::SceneGraphNodeType type, int parentIdx) : node(type), parent(parentIdx) {
+		}
+		voxelformat::SceneGraphNode node;
+		voxel::RawVolumeSnapshotPtr snapshot;
+		// index of the parent in SaveJob::nodes or -1 for children of the root node
+		int parent;
+	};
+
+	/**
+	 * @brief A save that runs in the background. The scene graph is captured on the main thread as
+	 * volume snapshots, the volumes are created and written to disk by a worker thread.
+	 */
+	struct SaveJob {
+		core::String filename;
+		core::String tmpFilename;
+		// the temporary file is created on the main thread - the target file is only touched by the final rename
+		io::FilePtr tmpFile;
+		bool autosave = false;
+		// value of @c _modifications at the time the snapshot was taken
+		uint32_t modifications = 0u;
+		core::DynamicArray<SaveNode> nodes;
+		voxelformat::SceneGraphNode root{voxelformat::SceneGraphNodeType::Root};
+		image::ImagePtr thumbnail;
+		std::future<bool> future;
+		// set if a newer save to the same file was started
+		std::atomic_bool cancelled{false};
+		// the amount of finished steps - one for each node plus one for writing the file
+		std::atomic_int progress{0};
+	};
+	using SaveJobPtr = core::SharedPtr<SaveJob>;
+	core::DynamicArray<SaveJobPtr> _saveJobs;
+	uint32_t _saveJobCounter = 0u;
+	// set if a background save that was not an autosave failed
+	bool _saveFailed = false;
+	// increased for each modification of the scene - allows to detect changes that happened while saving
+	uint32_t _modifications = 0u;
+
+	static void snapshotNode_r(const voxelformat::SceneGraph &sceneGraph, const voxelformat::SceneGraphNode &node,
+							   int parentIdx, core::DynamicArray<SaveNode> &nodes);
+	static bool runSaveJob(const SaveJobPtr &job);
+	void finishSaveJob(const SaveJob &job, bool success);
+	void updateSaveJobs();
+	void waitForSaveJobs();
+
 #ifdef VOXEDIT_ANIMATION
 	animation::AnimationSettings::Type _entityType = animation::AnimationSettings::Type::Max;
 	animation::Character _character;
@@ -248,6 +299,10 @@ protected:
 	bool mementoRename(const MementoState& s);
 	bool mementoPaletteChange(const MementoState& s);
 	bool mementoModification(const MementoState& s);
+	/**
+	 * @brief Resets the memento snapshot of the node to its volume after a failed undo or redo step
+	 */
+	void mementoResetSnapshot(int nodeId);
 
 public:
 	~SceneManager();
@@ -339,8 +394,25 @@ public:
 	 * @param[in] file The file to store the volume data in. The file extension defines the volume format.
 	 * @param[in] autosave @c true if this is an auto save action, @c false otherwise. This has e.g. an
 	 * influence on the dirty state handling of the scene.
+	 * @note The scene is written by a worker thread into a temporary file that replaces the target file once
+	 * it was completely written. The dirty state is updated in update() once the file was written. An older save
+	 * to the same file that is still running is cancelled.
+	 * @return @c false if the save couldn't get started. @c true only means that the save is running - see
+	 * @c isSaving() and @c consumeSaveFailure()
 	 */
 	bool save(const core::String& file, bool autosave = false);
+	/**
+	 * @return @c true if there are saves running in the background
+	 */
+	bool isSaving() const;
+	/**
+	 * @return The progress of the most recent background save in the range [0,1]
+	 */
+	float saveProgress() const;
+	/**
+	 * @return @c true if a background save failed since the last call
+	 */
+	bool consumeSaveFailure();
 	/**
 	 * @brief Loads a volume from the given file
 	 * @param[in] file The file to load. The volume format is determined by the file extension.
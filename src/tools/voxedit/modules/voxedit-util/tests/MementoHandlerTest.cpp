@@ -4,6 +4,8 @@
 
 #include "../MementoHandler.h"
 #include "app/tests/AbstractTest.h"
+#include "core/ScopedPtr.h"
+#include "core/TimeProvider.h"
 #include "voxel/RawVolume.h"
 
 namespace voxedit {
@@ -20,6 +22,35 @@ protected:
 		ASSERT_TRUE(mementoHandler.init());
 	}
 
+	void fill(voxel::RawVolume &volume) const {
+		const voxel::Region &region = volume.region();
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, (x * 7 + y * 3 + z) % 255));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Paint a brush stroke into the volume and mark it as undo state
+	 */
+	voxel::Region stroke(voxel::RawVolume &volume, int i, int size) {
+		const int width = volume.region().getWidthInVoxels() - size;
+		const glm::ivec3 mins((i * 13) % width, (i * 7) % width, (i * 3) % width);
+		const voxel::Region region(mins, mins + size - 1);
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					volume.setVoxel(x, y, z, voxel::createVoxel(voxel::VoxelType::Generic, i % 255));
+				}
+			}
+		}
+		mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, region, glm::mat4(1.0f), 0);
+		return region;
+	}
+
 	void TearDown() override {
 		mementoHandler.shutdown();
 	}
@@ -544,6 +575,221 @@ TEST_F(MementoHandlerTest, testAddNewNodeEdit) {
 	}
 }
 
+TEST_F(MementoHandlerTest, testDeltaUndoRedo) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	volume.setVoxel(1, 1, 1, voxel);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region(1, 1), glm::mat4(1.0f), 0);
+	volume.setVoxel(5, 6, 7, voxel);
+	volume.setVoxel(6, 6, 7, voxel);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region(5, 6, 7, 6, 6, 7), glm::mat4(1.0f), 0);
+	ASSERT_EQ(3, (int)mementoHandler.stateSize());
+
+	MementoState state = mementoHandler.undo();
+	ASSERT_TRUE(state.hasVolumeData());
+	EXPECT_EQ(MementoDataType::Region, state.data.type());
+	EXPECT_EQ(voxel::Region(5, 6, 7, 6, 6, 7), state.dataRegion());
+	core::ScopedPtr<voxel::RawVolume> v(MementoData::toVolume(state.data));
+	ASSERT_TRUE(v);
+	EXPECT_TRUE(voxel::isAir(v->voxel(5, 6, 7).getMaterial()));
+	EXPECT_TRUE(voxel::isAir(v->voxel(6, 6, 7).getMaterial()));
+
+	state = mementoHandler.undo();
+	ASSERT_TRUE(state.hasVolumeData());
+	EXPECT_EQ(voxel::Region(1, 1), state.dataRegion());
+	v = MementoData::toVolume(state.data);
+	ASSERT_TRUE(v);
+	EXPECT_TRUE(voxel::isAir(v->voxel(1, 1, 1).getMaterial()));
+	EXPECT_FALSE(mementoHandler.canUndo());
+
+	state = mementoHandler.redo();
+	ASSERT_TRUE(state.hasVolumeData());
+	EXPECT_EQ(voxel::Region(1, 1), state.dataRegion());
+	v = MementoData::toVolume(state.data);
+	ASSERT_TRUE(v);
+	EXPECT_EQ(voxel, v->voxel(1, 1, 1));
+
+	state = mementoHandler.redo();
+	ASSERT_TRUE(state.hasVolumeData());
+	v = MementoData::toVolume(state.data);
+	ASSERT_TRUE(v);
+	EXPECT_EQ(voxel, v->voxel(5, 6, 7));
+	EXPECT_EQ(voxel, v->voxel(6, 6, 7));
+	EXPECT_FALSE(mementoHandler.canRedo());
+}
+
+TEST_F(MementoHandlerTest, testDeltaRegionChange) {
+	// a modification that changes the volume region can't be stored as delta
+	core::SharedPtr<voxel::RawVolume> first = create(4);
+	core::SharedPtr<voxel::RawVolume> second = create(4);
+	core::SharedPtr<voxel::RawVolume> third = create(6);
+	second->setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	mementoHandler.markUndo(0, 0, "", first.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	mementoHandler.markUndo(0, 0, "", second.get(), MementoType::Modification, voxel::Region(1, 1), glm::mat4(1.0f), 0);
+	mementoHandler.markUndo(0, 0, "", third.get(), MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+
+	MementoState state = mementoHandler.undo();
+	ASSERT_TRUE(state.hasVolumeData());
+	EXPECT_EQ(MementoDataType::Volume, state.data.type());
+	EXPECT_EQ(4, state.dataRegion().getWidthInVoxels());
+	core::ScopedPtr<voxel::RawVolume> v(MementoData::toVolume(state.data));
+	ASSERT_TRUE(v);
+	EXPECT_FALSE(voxel::isAir(v->voxel(1, 1, 1).getMaterial()));
+
+	// the snapshot is back at the second state - so the delta must still apply
+	state = mementoHandler.undo();
+	ASSERT_TRUE(state.hasVolumeData());
+	EXPECT_EQ(MementoDataType::Region, state.data.type());
+	v = MementoData::toVolume(state.data);
+	ASSERT_TRUE(v);
+	EXPECT_TRUE(voxel::isAir(v->voxel(1, 1, 1).getMaterial()));
+}
+
+TEST_F(MementoHandlerTest, testDeltaResetSnapshot) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	volume.setVoxel(1, 1, 1, voxel);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region(1, 1), glm::mat4(1.0f), 0);
+
+	// without a snapshot the delta can't be applied - the state position must not change
+	mementoHandler.resetSnapshot(0, nullptr);
+	MementoState state = mementoHandler.undo();
+	EXPECT_FALSE(state.valid());
+	EXPECT_EQ(0, state.nodeId);
+	EXPECT_EQ(1, (int)mementoHandler.statePosition());
+
+	mementoHandler.resetSnapshot(0, &volume);
+	state = mementoHandler.undo();
+	ASSERT_TRUE(state.valid());
+	EXPECT_EQ(0, (int)mementoHandler.statePosition());
+	core::ScopedPtr<voxel::RawVolume> v(MementoData::toVolume(state.data));
+	ASSERT_TRUE(v);
+	EXPECT_TRUE(voxel::isAir(v->voxel(1, 1, 1).getMaterial()));
+}
+
+TEST_F(MementoHandlerTest, testUndoWithoutPreviousData) {
+	core::SharedPtr<voxel::RawVolume> other = create(2);
+	mementoHandler.markUndo(0, 1, "Node 1", other.get(), MementoType::SceneNodeAdded, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	mementoHandler.markUndo(0, 0, "Node 0", &volume, MementoType::SceneNodeAdded, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	volume.setVoxel(1, 1, 1, voxel);
+	mementoHandler.markUndo(0, 0, "Node 0", &volume, MementoType::Modification, voxel::Region(1, 1), glm::mat4(1.0f), 0);
+	// without a snapshot the next modification stores the full volume only
+	mementoHandler.resetSnapshot(0, nullptr);
+	volume.setVoxel(2, 2, 2, voxel);
+	mementoHandler.markUndo(0, 0, "Node 0", &volume, MementoType::Modification, voxel::Region(2, 2), glm::mat4(1.0f), 0);
+
+	// the previous volume of the node is restored from its last full volume and the deltas that follow it
+	MementoState state = mementoHandler.undo();
+	ASSERT_TRUE(state.valid());
+	EXPECT_EQ(0, state.nodeId);
+	EXPECT_EQ(volume.region(), state.dataRegion());
+	core::ScopedPtr<voxel::RawVolume> v(MementoData::toVolume(state.data));
+	ASSERT_TRUE(v);
+	EXPECT_EQ(voxel, v->voxel(1, 1, 1));
+	EXPECT_TRUE(voxel::isAir(v->voxel(2, 2, 2).getMaterial()));
+
+	// the snapshot was reset to the restored volume
+	state = mementoHandler.undo();
+	ASSERT_TRUE(state.valid());
+	v = MementoData::toVolume(state.data);
+	ASSERT_TRUE(v);
+	EXPECT_TRUE(voxel::isAir(v->voxel(1, 1, 1).getMaterial()));
+}
+
+TEST_F(MementoHandlerTest, testDeltaPalette) {
+	voxel::RawVolume volume(voxel::Region(0, 15));
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	volume.setVoxel(1, 1, 1, voxel::createVoxel(voxel::VoxelType::Generic, 1));
+	core::Optional<voxel::Palette> palette;
+	palette.setValue(voxel::Palette());
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region(1, 1), glm::mat4(1.0f), 0, palette);
+	ASSERT_TRUE(mementoHandler.undo().valid());
+	const MementoState &state = mementoHandler.redo();
+	ASSERT_TRUE(state.valid());
+	EXPECT_TRUE(state.palette.hasValue());
+}
+
+TEST_F(MementoHandlerTest, testDeltaBricks) {
+	// the modified region crosses the snapshot bricks and the volume is no multiple of the brick size
+	voxel::RawVolume volume(voxel::Region(-5, 70));
+	fill(volume);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const voxel::RawVolume before(volume);
+	const voxel::Region region(20, 60);
+	const voxel::Voxel voxel = voxel::createVoxel(voxel::VoxelType::Generic, 1);
+	for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+		for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+			for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+				volume.setVoxel(x, y, z, voxel);
+			}
+		}
+	}
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, region, glm::mat4(1.0f), 0);
+
+	for (int i = 0; i < 2; ++i) {
+		MementoState state = mementoHandler.undo();
+		ASSERT_TRUE(state.valid());
+		EXPECT_EQ(region, state.dataRegion());
+		core::ScopedPtr<voxel::RawVolume> v(MementoData::toVolume(state.data));
+		ASSERT_TRUE(v);
+		for (int z = region.getLowerZ(); z <= region.getUpperZ(); ++z) {
+			for (int y = region.getLowerY(); y <= region.getUpperY(); ++y) {
+				for (int x = region.getLowerX(); x <= region.getUpperX(); ++x) {
+					ASSERT_EQ(before.voxel(x, y, z), v->voxel(x, y, z)) << x << ":" << y << ":" << z;
+				}
+			}
+		}
+		state = mementoHandler.redo();
+		ASSERT_TRUE(state.valid());
+		v = MementoData::toVolume(state.data);
+		ASSERT_TRUE(v);
+		EXPECT_EQ(voxel, v->voxel(20, 20, 20));
+		EXPECT_EQ(voxel, v->voxel(60, 60, 60));
+	}
+}
+
+TEST_F(MementoHandlerTest, testDeltaMemory) {
+	voxel::RawVolume volume(voxel::Region(0, 63));
+	fill(volume);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const size_t initialSize = mementoHandler.dataSize();
+	const int strokes = 32;
+	for (int i = 0; i < strokes; ++i) {
+		stroke(volume, i, 4);
+	}
+	const size_t deltaSize = mementoHandler.dataSize() - initialSize;
+	Log::info("Initial state: %i bytes, %i strokes: %i bytes", (int)initialSize, strokes, (int)deltaSize);
+	EXPECT_LT(deltaSize, initialSize);
+}
+
+TEST_F(MementoHandlerTest, testMarkUndoLatency) {
+	voxel::RawVolume volume(voxel::Region(0, 127));
+	fill(volume);
+	mementoHandler.markUndo(0, 0, "", &volume, MementoType::Modification, voxel::Region::InvalidRegion, glm::mat4(1.0f), 0);
+	const int strokes = 16;
+
+	uint64_t start = core::TimeProvider::highResTime();
+	for (int i = 0; i < strokes; ++i) {
+		stroke(volume, i, 8);
+	}
+	const uint64_t deltaTime = core::TimeProvider::highResTime() - start;
+
+	start = core::TimeProvider::highResTime();
+	for (int i = 0; i < strokes; ++i) {
+		const MementoData &data = MementoData::fromVolume(&volume);
+		EXPECT_GT(data.size(), 0u);
+	}
+	const uint64_t fullTime = core::TimeProvider::highResTime() - start;
+	const double resolution = (double)core::TimeProvider::highResTimeResolution() / 1000.0;
+	Log::info("markUndo for %i strokes: %fms (full volume snapshots: %fms)", strokes, (double)deltaTime / resolution,
+			  (double)fullTime / resolution);
+	EXPECT_EQ(strokes + 1, (int)mementoHandler.stateSize());
+}
+
 #if 0
 // TODO
 TEST_F(MementoHandlerTest, testSceneNodeRenamed) {